@@ -192,6 +192,7 @@ int32_t ad713x_set_out_data_frame(struct ad713x_dev *dev,
 				  enum ad713x_adc_data_len adc_data_len,
 				  enum ad713x_crc_header crc_header)
 {
+	int32_t ret;
 	uint8_t id;
 	uint8_t i = 0;
 
@@ -200,10 +201,18 @@ int32_t ad713x_set_out_data_frame(struct ad713x_dev *dev,
 	while (ad713x_output_data_frame[id][i][0] != INVALID) {
 		if((adc_data_len == ad713x_output_data_frame[id][i][0]) &&
 		    (crc_header == ad713x_output_data_frame[id][i][1])) {
-			return ad713x_spi_write_mask(dev,
-						     AD713X_REG_DATA_PACKET_CONFIG,
-						     AD713X_DATA_PACKET_CONFIG_FRAME_MSK,
-						     AD713X_DATA_PACKET_CONFIG_FRAME_MODE(i));
+			ret = ad713x_spi_write_mask(dev,
+						    AD713X_REG_DATA_PACKET_CONFIG,
+						    AD713X_DATA_PACKET_CONFIG_FRAME_MSK,
+						    AD713X_DATA_PACKET_CONFIG_FRAME_MODE(i));
+			if (IS_ERR_VALUE(ret))
+				return ret;
+
+			/* Needed to decode the data output slots */
+			dev->adc_data_len = adc_data_len;
+			dev->crc_header = crc_header;
+
+			return SUCCESS;
 		}
 		i++;
 	}
@@ -211,6 +220,103 @@ int32_t ad713x_set_out_data_frame(struct ad713x_dev *dev,
 	return FAILURE;
 }
 
+/**
+ * @brief Compute the CRC of the conversion data, MSB first.
+ * @param data - The conversion data, right aligned.
+ * @param nb_bits - Number of data bits.
+ * @param poly - CRC polynomial, without the leading term.
+ * @param width - CRC width in bits.
+ * @param seed - CRC initial value.
+ * @return The CRC value.
+ */
+static uint8_t ad713x_compute_crc(uint32_t data, uint8_t nb_bits, uint8_t poly,
+				  uint8_t width, uint8_t seed)
+{
+	uint8_t mask = (1 << width) - 1;
+	uint8_t msb = 1 << (width - 1);
+	uint8_t crc = seed;
+	bool bit;
+
+	while (nb_bits--) {
+		bit = (data >> nb_bits) & 1;
+		if (!!(crc & msb) != bit)
+			crc = ((crc << 1) ^ poly) & mask;
+		else
+			crc = (crc << 1) & mask;
+	}
+
+	return crc;
+}
+
+/**
+ * @brief Decode a data output slot: conversion data followed by the optional
+ *        CRC header, as set by ad713x_set_out_data_frame(). To be used as TDM
+ *        acquisition decoder, the slot must be received right aligned.
+ * @param dev - The device structure.
+ * @param slot - The raw slot value.
+ * @param ch - The channel of the slot (unused).
+ * @param sample - The sign extended conversion result.
+ * @return \ref SUCCESS if the CRC matches, \ref FAILURE otherwise.
+ */
+int32_t ad713x_tdm_decode(void *dev, uint32_t slot, uint8_t ch,
+			  int32_t *sample)
+{
+	struct ad713x_dev *desc = dev;
+	uint8_t data_bits;
+	uint8_t crc_bits;
+	uint32_t data;
+	uint8_t crc;
+
+	switch (desc->adc_data_len) {
+	case ADC_16_BIT_DATA:
+		data_bits = 16;
+		break;
+	case ADC_24_BIT_DATA:
+		data_bits = 24;
+		break;
+	default:
+		data_bits = 32;
+		break;
+	}
+
+	switch (desc->crc_header) {
+	case CRC_6:
+		crc_bits = 6;
+		break;
+	case CRC_8:
+		crc_bits = 8;
+		break;
+	default:
+		crc_bits = 0;
+		break;
+	}
+
+	/* The frame must fit in one 32-bit slot */
+	if (data_bits + crc_bits > 32)
+		return FAILURE;
+
+	data = crc_bits ? slot >> crc_bits : slot;
+	if (data_bits < 32)
+		*sample = (int32_t)(data << (32 - data_bits)) >> (32 - data_bits);
+	else
+		*sample = (int32_t)data;
+
+	if (!crc_bits)
+		return SUCCESS;
+
+	if (crc_bits == 8)
+		crc = ad713x_compute_crc(data, data_bits, AD713X_CRC8_POLY, 8,
+					 AD713X_CRC8_SEED);
+	else
+		crc = ad713x_compute_crc(data, data_bits, AD713X_CRC6_POLY, 6,
+					 AD713X_CRC6_SEED);
+
+	if (crc != (slot & ((1 << crc_bits) - 1)))
+		return FAILURE;
+
+	return SUCCESS;
+}
+
 /**
  * @brief DOUTx output format configuration.
  * @param dev - The device structure.
@@ -558,6 +558,14 @@
 
 #define AD713X_REG_READ(x)				((1 << 7) | (x & 0x7F))
 
+/*
+ * Data output CRC header
+ */
+#define AD713X_CRC8_POLY				0x07
+#define AD713X_CRC8_SEED				0xFF
+#define AD713X_CRC6_POLY				0x27
+#define AD713X_CRC6_SEED				0x3F
+
 /******************************************************************************/
 /*************************** Types Declarations *******************************/
 /******************************************************************************/
@@ -780,6 +788,10 @@ int32_t ad713x_ref_gain_correction_en(struct ad713x_dev *dev, bool enable);
 int32_t ad713x_wideband_bw_sel(struct ad713x_dev *dev,
 			       enum ad713x_channels ch, uint8_t wb_opt);
 
+/** Decode a data output slot (TDM acquisition decoder). */
+int32_t ad713x_tdm_decode(void *dev, uint32_t slot, uint8_t ch,
+			  int32_t *sample);
+
 /** Initialize the device. */
 int32_t ad713x_init(struct ad713x_dev **device,
 		    struct ad713x_init_param *init_param);
@@ -1838,3 +1838,331 @@ int32_t ad77681_setup(struct ad77681_dev **device,
 	return ret;
 }
 
+
+/**
+ * Initialize the continuous read streaming descriptor.
+ * The frame layout (conversion length, status bit, CRC selection) is sampled
+ * at init time, so the descriptor must be reinitialized after changing it.
+ * @param stream - The streaming descriptor.
+ * @param dev - The device structure.
+ * @param init_param - The streaming initialization parameters.
+ * @return 0 in case of success, negative error code otherwise.
+ */
+int32_t ad77681_stream_init(struct ad77681_stream **stream,
+			    struct ad77681_dev *dev,
+			    const struct ad77681_stream_init_param *init_param)
+{
+	struct spi_engine_desc *eng_desc;
+	struct ad77681_stream *strm;
+	uint8_t crc;
+	uint16_t n;
+	uint8_t i;
+	int32_t ret;
+
+	if (!stream || !dev || !init_param)
+		return -EINVAL;
+
+	strm = (struct ad77681_stream *)calloc(1, sizeof(*strm));
+	if (!strm)
+		return -ENOMEM;
+
+	strm->dev = dev;
+	strm->offload = init_param->offload;
+	strm->drdy = init_param->drdy;
+	strm->data_bits = (dev->conv_len == AD77681_CONV_24BIT) ? 24 : 16;
+	strm->data_shift = 0;
+	if (dev->status_bit)
+		strm->data_shift += 8;
+	if (dev->crc_sel != AD77681_NO_CRC)
+		strm->data_shift += 8;
+	strm->frame_bytes = (strm->data_bits + strm->data_shift) / 8;
+
+	/* 24bit ADC data + status + CRC does not fit in a single 32bit word */
+	if (strm->frame_bytes > AD77681_STREAM_MAX_FRAME_BYTES) {
+		free(strm);
+		return -EINVAL;
+	}
+
+	/* ((2*Vref)*code)/2^N */
+	strm->lsb = (2.0 * ((double)dev->vref / 1000.0)) /
+		    (double)(1ul << strm->data_bits);
+
+	for (n = 0; n < 256; n++) {
+		crc = n;
+		for (i = 0; i < 8; i++)
+			crc = (crc & 0x80) ? (crc << 1) ^ AD77681_CRC8_POLY :
+			      (crc << 1);
+		strm->crc_table[n] = crc;
+	}
+
+	if (strm->offload) {
+		eng_desc = dev->spi_desc->extra;
+		strm->reg_data_width = eng_desc->data_width;
+		/* One SPI Engine word holds one complete frame */
+		ret = spi_engine_set_transfer_width(dev->spi_desc,
+						    strm->frame_bytes * 8);
+		if (ret < 0) {
+			free(strm);
+			return ret;
+		}
+	}
+
+	*stream = strm;
+
+	return SUCCESS;
+}
+
+/**
+ * Enter continuous read mode. From this point on, every DRDY pulse makes a
+ * new frame available without sending the ADC data register address.
+ * @param stream - The streaming descriptor.
+ * @return 0 in case of success, negative error code otherwise.
+ */
+int32_t ad77681_stream_start(struct ad77681_stream *stream)
+{
+	if (!stream)
+		return -EINVAL;
+
+	return ad77681_set_continuos_read(stream->dev,
+					  AD77681_CONTINUOUS_READ_ENABLE);
+}
+
+/**
+ * Wait for the next rising edge of DRDY. A level still high from the previous
+ * conversion is skipped, so each frame is read once per DRDY pulse.
+ * @param drdy - The DRDY GPIO.
+ * @return 0 in case of success, negative error code otherwise.
+ */
+static int32_t ad77681_stream_wait_drdy(struct gpio_desc *drdy)
+{
+	uint8_t value;
+	int32_t ret;
+
+	do {
+		ret = gpio_get_value(drdy, &value);
+		if (ret < 0)
+			return ret;
+	} while (value != GPIO_LOW);
+
+	do {
+		ret = gpio_get_value(drdy, &value);
+		if (ret < 0)
+			return ret;
+	} while (value != GPIO_HIGH);
+
+	return SUCCESS;
+}
+
+/**
+ * Capture a block of frames in continuous read mode.
+ * Each frame is stored MSB first, right aligned, in one 32bit word:
+ * [data][status][checksum]. With offload the transfer is done by the DMA and
+ * the caller is responsible for the data cache maintenance of the buffer.
+ * @param stream - The streaming descriptor.
+ * @param frames - Destination buffer, one word per sample.
+ * @param samples - Number of samples to capture.
+ * @return 0 in case of success, negative error code otherwise.
+ */
+int32_t ad77681_stream_capture(struct ad77681_stream *stream,
+			       uint32_t *frames,
+			       uint32_t samples)
+{
+	uint32_t spi_msg_cmds[] = {CS_LOW, WRITE_READ(1), CS_HIGH};
+	/* SDO must stay low, any other value may exit continuous read */
+	uint32_t commands_data[1] = {0};
+	struct spi_engine_offload_message msg;
+	uint8_t buf[AD77681_STREAM_MAX_FRAME_BYTES];
+	uint32_t i;
+	uint8_t j;
+	int32_t ret;
+
+	if (!stream || !frames || !samples)
+		return -EINVAL;
+
+	if (stream->offload) {
+		msg.commands = spi_msg_cmds;
+		msg.no_commands = ARRAY_SIZE(spi_msg_cmds);
+		msg.commands_data = commands_data;
+		msg.rx_addr = (uint32_t)(uintptr_t)frames;
+		msg.tx_addr = 0;
+
+		ret = spi_engine_offload_transfer(stream->dev->spi_desc, msg,
+						  samples);
+		if (ret < 0)
+			return ret;
+
+		stream->samples += samples;
+
+		return SUCCESS;
+	}
+
+	for (i = 0; i < samples; i++) {
+		if (stream->drdy) {
+			ret = ad77681_stream_wait_drdy(stream->drdy);
+			if (ret < 0)
+				return ret;
+		}
+
+		memset(buf, 0, stream->frame_bytes);
+		ret = spi_write_and_read(stream->dev->spi_desc, buf,
+					 stream->frame_bytes);
+		if (ret < 0)
+			return ret;
+
+		frames[i] = 0;
+		for (j = 0; j < stream->frame_bytes; j++)
+			frames[i] = (frames[i] << 8) | buf[j];
+	}
+
+	stream->samples += samples;
+
+	return SUCCESS;
+}
+
+/**
+ * Check the checksum and the status byte of a captured block.
+ * The checksum is computed with a lookup table over the data and status bytes
+ * of each frame, using the continuous read mode seed.
+ * @param stream - The streaming descriptor.
+ * @param frames - Captured frames.
+ * @param samples - Number of frames to check.
+ * @param crc_errors - Number of frames with a checksum mismatch (optional).
+ * @param status - OR of all the status bytes in the block (optional).
+ * @return 0 if the block is valid, FAILURE if any frame has a checksum
+ * mismatch or a status error, negative error code otherwise.
+ */
+int32_t ad77681_stream_check(struct ad77681_stream *stream,
+			     const uint32_t *frames,
+			     uint32_t samples,
+			     uint32_t *crc_errors,
+			     uint8_t *status)
+{
+	enum ad77681_crc_sel crc_sel;
+	uint32_t nb_crc_err = 0;
+	uint32_t nb_status_err = 0;
+	uint8_t status_or = 0;
+	uint8_t payload_bytes;
+	uint8_t checksum;
+	uint8_t status_byte;
+	uint32_t frame;
+	uint32_t i;
+	int8_t j;
+
+	if (!stream || !frames)
+		return -EINVAL;
+
+	crc_sel = stream->dev->crc_sel;
+	payload_bytes = stream->frame_bytes;
+	if (crc_sel != AD77681_NO_CRC)
+		payload_bytes--;
+
+	for (i = 0; i < samples; i++) {
+		frame = frames[i];
+
+		if (stream->dev->status_bit) {
+			status_byte = (crc_sel != AD77681_NO_CRC) ?
+				      (frame >> 8) : frame;
+			status_or |= status_byte;
+			if (status_byte & AD77681_STREAM_STATUS_ERROR_MSK)
+				nb_status_err++;
+		}
+
+		if (crc_sel == AD77681_NO_CRC)
+			continue;
+
+		if (crc_sel == AD77681_CRC) {
+			checksum = INITIAL_CRC_CRC8;
+			for (j = payload_bytes; j > 0; j--)
+				checksum = stream->crc_table[checksum ^
+							     (uint8_t)(frame >> (8 * j))];
+		} else {
+			checksum = INITIAL_CRC_XOR;
+			for (j = payload_bytes; j > 0; j--)
+				checksum ^= (uint8_t)(frame >> (8 * j));
+		}
+
+		if (checksum != (uint8_t)frame)
+			nb_crc_err++;
+	}
+
+	stream->crc_errors += nb_crc_err;
+	stream->status_errors += nb_status_err;
+
+	if (crc_errors)
+		*crc_errors = nb_crc_err;
+	if (status)
+		*status = status_or;
+
+	return (nb_crc_err || nb_status_err) ? FAILURE : SUCCESS;
+}
+
+/**
+ * Convert a captured block to voltage.
+ * @param stream - The streaming descriptor.
+ * @param frames - Captured frames.
+ * @param samples - Number of frames to convert.
+ * @param voltage - Converted values, in volts.
+ * @return 0 in case of success, negative error code otherwise.
+ */
+int32_t ad77681_stream_to_voltage(struct ad77681_stream *stream,
+				  const uint32_t *frames,
+				  uint32_t samples,
+				  float *voltage)
+{
+	uint8_t left_shift;
+	uint8_t right_shift;
+	float lsb;
+	uint32_t i;
+
+	if (!stream || !frames || !voltage)
+		return -EINVAL;
+
+	/* Move the data MSB to bit 31, then sign extend back */
+	left_shift = 32 - stream->data_shift - stream->data_bits;
+	right_shift = 32 - stream->data_bits;
+	lsb = (float)stream->lsb;
+
+	for (i = 0; i < samples; i++)
+		voltage[i] = lsb * (float)((int32_t)(frames[i] << left_shift) >>
+					   right_shift);
+
+	return SUCCESS;
+}
+
+/**
+ * Exit continuous read mode.
+ * @param stream - The streaming descriptor.
+ * @return 0 in case of success, negative error code otherwise.
+ */
+int32_t ad77681_stream_stop(struct ad77681_stream *stream)
+{
+	int32_t ret;
+
+	if (!stream)
+		return -EINVAL;
+
+	if (stream->offload) {
+		ret = spi_engine_set_transfer_width(stream->dev->spi_desc,
+						    stream->reg_data_width);
+		if (ret < 0)
+			return ret;
+	}
+
+	return ad77681_set_continuos_read(stream->dev,
+					  AD77681_CONTINUOUS_READ_DISABLE);
+}
+
+/**
+ * Free the resources allocated by ad77681_stream_init().
+ * @param stream - The streaming descriptor.
+ * @return 0 in case of success, negative error code otherwise.
+ */
+int32_t ad77681_stream_remove(struct ad77681_stream *stream)
+{
+	if (!stream)
+		return -EINVAL;
+
+	free(stream);
+
+	return SUCCESS;
+}
@@ -41,6 +41,7 @@
 #define SRC_AD77681_H_
 
 #include "spi_engine.h"
+#include "gpio.h"
 
 /******************************************************************************/
 /********************** Macros and Constants Definitions **********************/
@@ -344,6 +345,11 @@
 
 #define ARRAY_SIZE(x) (sizeof(x) / sizeof((x)[0]))
 
+/* Largest frame supported by the streaming API: one 32-bit word per sample */
+#define AD77681_STREAM_MAX_FRAME_BYTES			4
+/* Master error flag in the status byte */
+#define AD77681_STREAM_STATUS_ERROR_MSK			(0x1 << 7)
+
 #define ENABLE		1
 #define DISABLE		0
 
@@ -573,6 +579,39 @@ struct ad77681_init_param {
 	uint8_t                         data_frame_16bit;
 };
 
+/* Continuous read streaming initialization parameters */
+struct ad77681_stream_init_param {
+	/* Capture through the SPI Engine offload, triggered by DRDY in HDL.
+	   spi_engine_offload_init() must be called before, with OFFLOAD_RX_EN
+	   and non cyclic DMA flags. */
+	bool				offload;
+	/* DRDY GPIO used to pace the reads when offload is not used (optional) */
+	struct gpio_desc		*drdy;
+};
+
+/* Continuous read streaming descriptor */
+struct ad77681_stream {
+	struct ad77681_dev		*dev;
+	bool				offload;
+	struct gpio_desc		*drdy;
+	/* Frame size in bytes: data + status + checksum */
+	uint8_t				frame_bytes;
+	/* Bits to shift out the status and checksum bytes from a frame */
+	uint8_t				data_shift;
+	/* Bits of conversion data in a frame */
+	uint8_t				data_bits;
+	/* SPI Engine transfer width to restore when the stream stops */
+	uint8_t				reg_data_width;
+	/* Volts per LSB */
+	double				lsb;
+	/* CRC8 lookup table used for block checks */
+	uint8_t				crc_table[256];
+	/* Statistics */
+	uint32_t			samples;
+	uint32_t			crc_errors;
+	uint32_t			status_errors;
+};
+
 /******************************************************************************/
 /************************ Functions Declarations ******************************/
 /******************************************************************************/
@@ -673,4 +712,22 @@ int32_t ad77681_SINC3_ODR(struct ad77681_dev *dev,
 			  float sinc3_odr);
 int32_t ad77681_status(struct ad77681_dev *dev,
 		       struct ad77681_status_registers *status);
+int32_t ad77681_stream_init(struct ad77681_stream **stream,
+			    struct ad77681_dev *dev,
+			    const struct ad77681_stream_init_param *init_param);
+int32_t ad77681_stream_start(struct ad77681_stream *stream);
+int32_t ad77681_stream_capture(struct ad77681_stream *stream,
+			       uint32_t *frames,
+			       uint32_t samples);
+int32_t ad77681_stream_check(struct ad77681_stream *stream,
+			     const uint32_t *frames,
+			     uint32_t samples,
+			     uint32_t *crc_errors,
+			     uint8_t *status);
+int32_t ad77681_stream_to_voltage(struct ad77681_stream *stream,
+				  const uint32_t *frames,
+				  uint32_t samples,
+				  float *voltage);
+int32_t ad77681_stream_stop(struct ad77681_stream *stream);
+int32_t ad77681_stream_remove(struct ad77681_stream *stream);
 #endif /* SRC_AD77681_H_ */
@@ -1236,6 +1236,75 @@ int32_t ad7771_get_sinc5_filter_state(ad7779_dev *dev,
 	return SUCCESS;
 }
 
+/**
+ * Set the data output format. The status header is selected so that each
+ * 32-bit slot carries the channel ID, used to check the frame alignment.
+ * Available only in SPI control mode.
+ * @param dev - The device structure.
+ * @param format - The data output format.
+ *		   Accepted values: AD7779_DOUT_4_LINES
+ *				    AD7779_DOUT_2_LINES
+ *				    AD7779_DOUT_1_LINE
+ * @return SUCCESS in case of success, negative error code otherwise.
+ */
+int32_t ad7779_set_dout_format(ad7779_dev *dev,
+			       ad7779_dout_format format)
+{
+	int32_t ret;
+
+	if (dev->ctrl_mode == AD7779_PIN_CTRL) {
+		printf("%s: This feature is not available in PIN control mode.\n",
+		       __func__);
+		return FAILURE;
+	}
+
+	ret = ad7779_spi_int_reg_write_mask(dev,
+					    AD7779_REG_DOUT_FORMAT,
+					    AD7779_DOUT_FORMAT(0x3) |
+					    AD7779_DOUT_HEADER_FORMAT,
+					    AD7779_DOUT_FORMAT(format));
+	if (ret != SUCCESS)
+		return ret;
+
+	dev->dout_format = format;
+
+	return SUCCESS;
+}
+
+/**
+ * Decode a 32-bit data output slot: 8-bit status header followed by the
+ * 24-bit conversion result. To be used as TDM acquisition decoder, with one
+ * slot per channel. Only AD7779_DOUT_1_LINE is supported: slot N of the frame
+ * must carry channel N. Every slot is rejected in the other formats.
+ * @param dev - The device structure.
+ * @param slot - The raw slot value.
+ * @param ch - The channel expected in the slot.
+ * @param sample - The sign extended conversion result.
+ * @return SUCCESS if the header matches the channel and reports no error,
+ *	   FAILURE otherwise.
+ */
+int32_t ad7779_tdm_decode(void *dev,
+			  uint32_t slot,
+			  uint8_t ch,
+			  int32_t *sample)
+{
+	ad7779_dev *desc = dev;
+	uint8_t header = slot >> 24;
+
+	*sample = (int32_t)(slot << 8) >> 8;
+
+	if (desc->dout_format != AD7779_DOUT_1_LINE)
+		return FAILURE;
+
+	if (AD7779_HDR_CH_ID(header) != (ch & 0x7))
+		return FAILURE;
+
+	if (header & (AD7779_HDR_ALERT | AD7779_HDR_ERR_MSK))
+		return FAILURE;
+
+	return SUCCESS;
+}
+
 /**
  * Initialize the device.
  * @param device - The device structure.
@@ -1357,6 +1426,13 @@ int32_t ad7779_init(ad7779_dev **device,
 	dev->dclk_div = init_param.dclk_div;
 	ad7779_set_dclk_div(dev, dev->dclk_div);
 
+	/* Set by the FORMATx pins in PIN control mode, 4 lines by default */
+	if (dev->ctrl_mode == AD7779_SPI_CTRL)
+		dev->dout_format = (ad7779_dout_format)
+				   ((dev->cached_reg_val[AD7779_REG_DOUT_FORMAT] >> 6) & 0x3);
+	else
+		dev->dout_format = AD7779_DOUT_4_LINES;
+
 	for (i = AD7779_CH0; i <= AD7779_CH7; i++) {
 		dev->sync_offset[i] = init_param.sync_offset[i];
 		dev->offset_corr[i] = init_param.offset_corr[i];
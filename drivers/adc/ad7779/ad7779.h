@@ -145,6 +145,11 @@
 
 #define AD7779_CRC8_POLY			0x07
 
+/* Data output status header */
+#define AD7779_HDR_ALERT			(1 << 7)
+#define AD7779_HDR_CH_ID(x)			(((x) >> 4) & 0x7)
+#define AD7779_HDR_ERR_MSK			0x0F
+
 /******************************************************************************/
 /*************************** Types Declarations *******************************/
 /******************************************************************************/
@@ -193,6 +198,12 @@ typedef enum {
 	AD7779_DCLK_DIV_128,
 } ad7768_dclk_div;
 
+typedef enum {
+	AD7779_DOUT_4_LINES,
+	AD7779_DOUT_2_LINES,
+	AD7779_DOUT_1_LINE,
+} ad7779_dout_format;
+
 typedef enum {
 	AD7779_LOW_PWR,
 	AD7779_HIGH_RES,
@@ -264,6 +275,7 @@ typedef struct {
 	ad7779_ref_type		ref_type;
 	ad7779_pwr_mode		pwr_mode;
 	ad7768_dclk_div		dclk_div;
+	ad7779_dout_format	dout_format;
 	uint8_t			sync_offset[8];
 	uint32_t		offset_corr[8];
 	uint32_t		gain_corr[8];
@@ -436,6 +448,14 @@ int32_t ad7771_set_sinc5_filter_state(ad7779_dev *dev,
 /* Get the state (enable, disable) of the SINC5 filter. */
 int32_t ad7771_get_sinc5_filter_state(ad7779_dev *dev,
 				      ad7779_state *state);
+/* Set the data output format (number of DOUTx lines, status header). */
+int32_t ad7779_set_dout_format(ad7779_dev *dev,
+			       ad7779_dout_format format);
+/* Decode a 32-bit data output slot (TDM acquisition decoder). */
+int32_t ad7779_tdm_decode(void *dev,
+			  uint32_t slot,
+			  uint8_t ch,
+			  int32_t *sample);
 /* Initialize the device. */
 int32_t ad7779_init(ad7779_dev **device,
 		    ad7779_init_param init_param);
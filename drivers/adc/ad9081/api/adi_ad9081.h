@@ -570,6 +570,39 @@ typedef struct {
 	uint8_t virtual_converterf_index; /*! Index for JTX virtual converter15 */
 } adi_ad9081_jtx_conv_sel_t;
 
+/*!
+ * @brief HAL Transaction Sizes
+ */
+#define AD9081_HAL_XACT_QUEUE_SIZE 64 /*!< Writes held before an early flush */
+#define AD9081_HAL_XACT_SHADOW_SIZE 64 /*!< Direct mapped shadow entries */
+#define AD9081_HAL_XACT_BURST_MAX 32 /*!< Data bytes per streaming burst */
+
+/*!
+ * @brief HAL Transaction Queued Write Structure
+ */
+typedef struct {
+	uint16_t reg; /*!< Register address, 8-bit data space only */
+	uint8_t data; /*!< Register value */
+	uint8_t mask; /*!< Bits changed by the writes merged into this entry */
+} adi_ad9081_hal_xact_wr_t;
+
+/*!
+ * @brief HAL Transaction Structure
+ */
+typedef struct {
+	uint8_t depth; /*!< Nesting level of adi_ad9081_hal_xact_begin() */
+	uint8_t count; /*!< Number of queued writes */
+	adi_ad9081_hal_xact_wr_t
+		queue[AD9081_HAL_XACT_QUEUE_SIZE]; /*!< Queued writes */
+	uint16_t shadow_tag
+		[AD9081_HAL_XACT_SHADOW_SIZE]; /*!< Shadowed register | 0x8000, 0 if empty */
+	uint8_t shadow_data
+		[AD9081_HAL_XACT_SHADOW_SIZE]; /*!< Shadowed register values */
+	uint32_t spi_xfers; /*!< SPI transfers issued by transaction flushes */
+	uint32_t reads_saved; /*!< Read-modify-write reads served by the shadow */
+	uint32_t writes_merged; /*!< Bit-field writes merged into a queued write */
+} adi_ad9081_hal_xact_t;
+
 /*!
  * @brief Device Hardware Abstract Layer Structure
  */
@@ -596,6 +629,8 @@ typedef struct {
 		tx_en_pin_ctrl; /*!< Function pointer to hal tx_enable pin control function */
 	adi_reset_pin_ctrl_t
 		reset_pin_ctrl; /*!< Function pointer to hal reset# pin control function */
+	adi_ad9081_hal_xact_t
+		xact; /*!< Bit-field write batching state, zero initialized */
 } adi_ad9081_hal_t;
 
 /*!
@@ -617,6 +652,53 @@ typedef struct {
 	adi_ad9081_serdes_settings_t serdes_info;
 } adi_ad9081_device_t;
 
+/*!
+ * @brief NCO Retune Plan Sizes
+ */
+#define AD9081_NCO_PLAN_MAX_NCOS 24 /*!< 4 coarse + 8 fine DDCs, 4 main + 8 channel DUCs */
+
+/*!
+ * @brief Enumerates NCO Types In A Retune Plan
+ */
+typedef enum {
+	AD9081_NCO_PLAN_CDDC = 0x0, /*!< Coarse DDC NCO, select is one AD9081_ADC_CDDC_x */
+	AD9081_NCO_PLAN_FDDC = 0x1, /*!< Fine DDC NCO, select is one AD9081_ADC_FDDC_x */
+	AD9081_NCO_PLAN_DAC_MAIN = 0x2, /*!< Main DUC NCO, select is one AD9081_DAC_x */
+	AD9081_NCO_PLAN_DAC_CHAN = 0x3 /*!< Channel DUC NCO, select is one AD9081_DAC_CH_x */
+} adi_ad9081_nco_plan_type_e;
+
+/*!
+ * @brief NCO Retune Plan Entry Structure
+ */
+typedef struct {
+	uint8_t type; /*!< @see adi_ad9081_nco_plan_type_e */
+	uint8_t select; /*!< Single NCO selection bit */
+} adi_ad9081_nco_plan_nco_t;
+
+/*!
+ * @brief Free running microsecond counter used to time retunes
+ */
+typedef uint32_t (*adi_ad9081_get_time_us_t)(void *user_data);
+
+/*!
+ * @brief NCO Retune Plan Structure
+ */
+typedef struct {
+	uint8_t num_ncos; /*!< Number of NCOs retuned at every step */
+	adi_ad9081_nco_plan_nco_t
+		ncos[AD9081_NCO_PLAN_MAX_NCOS]; /*!< NCOs retuned at every step */
+	uint16_t num_steps; /*!< Number of steps in the frequency plan */
+	uint64_t *ftw; /*!< num_steps x num_ncos precomputed FTWs, caller storage */
+	adi_ad9081_get_time_us_t
+		get_time_us; /*!< Optional time source, user_data is hal user_data */
+	uint16_t step; /*!< Last applied step */
+	uint32_t steps_applied; /*!< Number of retunes done */
+	uint32_t last_us; /*!< Latency of the last retune in us */
+	uint32_t max_us; /*!< Worst retune latency in us */
+	uint64_t total_us; /*!< Sum of all retune latencies in us */
+	uint32_t last_spi_xfers; /*!< SPI transfers issued by the last retune */
+} adi_ad9081_nco_plan_t;
+
 /*============= E X P O R T S ==============*/
 #ifdef __cplusplus
 extern "C" {
@@ -2324,6 +2406,34 @@ int32_t adi_ad9081_adc_ddc_coarse_nco_channel_select_via_gpio_set(
 int32_t adi_ad9081_adc_ddc_coarse_nco_channel_update_index_set(
 	adi_ad9081_device_t *device, uint8_t cddcs, uint8_t channel);
 
+/**
+ * @brief  Set Coarse DDC NCO phase increment update mode
+ *
+ * @param  device    Pointer to the device structure
+ * @param  cddcs     Coarse DDCs selection, @see adi_ad9081_adc_coarse_ddc_select_e
+ * @param  mode      0: Instantaneous update, 1: Synchronous update on chip transfer
+ *
+ * @return API_CMS_ERROR_OK                     API Completed Successfully
+ * @return <0                                   Failed. @see adi_cms_error_e for details.
+ */
+int32_t adi_ad9081_adc_ddc_coarse_nco_channel_update_mode_set(
+	adi_ad9081_device_t *device, uint8_t cddcs, uint8_t mode);
+
+/**
+ * @brief  Set Coarse DDC NCO chip transfer source
+ *         Used when update mode is synchronous.
+ *
+ * @param  device    Pointer to the device structure
+ * @param  cddcs     Coarse DDCs selection, @see adi_ad9081_adc_coarse_ddc_select_e
+ * @param  mode      0: chip transfer bit, 1: GPIO low to high transition
+ *
+ * @return API_CMS_ERROR_OK                     API Completed Successfully
+ * @return <0                                   Failed. @see adi_cms_error_e for details.
+ */
+int32_t
+adi_ad9081_adc_ddc_coarse_gpio_chip_xfer_mode_set(adi_ad9081_device_t *device,
+						  uint8_t cddcs, uint8_t mode);
+
 /**
  * @brief  Page the targeted fine DDCs
  *
@@ -2559,6 +2669,35 @@ int32_t adi_ad9081_adc_ddc_fine_nco_channel_select_via_gpio_set(
 int32_t adi_ad9081_adc_ddc_fine_nco_channel_update_index_set(
 	adi_ad9081_device_t *device, uint8_t fddcs, uint8_t channel);
 
+/**
+ * @brief  Set Fine DDC NCO phase increment update mode
+ *
+ * @param  device    Pointer to the device structure
+ * @param  fddcs     Fine   DDCs selection, @see adi_ad9081_adc_fine_ddc_select_e
+ * @param  mode      0: Instantaneous update, 1: Synchronous update on chip transfer
+ *
+ * @return API_CMS_ERROR_OK                     API Completed Successfully
+ * @return <0                                   Failed. @see adi_cms_error_e for details.
+ */
+int32_t
+adi_ad9081_adc_ddc_fine_nco_channel_update_mode_set(adi_ad9081_device_t *device,
+						    uint8_t fddcs, uint8_t mode);
+
+/**
+ * @brief  Set Fine DDC NCO chip transfer source
+ *         Used when update mode is synchronous.
+ *
+ * @param  device    Pointer to the device structure
+ * @param  fddcs     Fine   DDCs selection, @see adi_ad9081_adc_fine_ddc_select_e
+ * @param  mode      0: chip transfer bit, 1: GPIO low to high transition
+ *
+ * @return API_CMS_ERROR_OK                     API Completed Successfully
+ * @return <0                                   Failed. @see adi_cms_error_e for details.
+ */
+int32_t
+adi_ad9081_adc_ddc_fine_gpio_chip_xfer_mode_set(adi_ad9081_device_t *device,
+						uint8_t fddcs, uint8_t mode);
+
 /**
  * @brief  Configure Basic Rx Path
  *         Call after adi_ad9081_device_startup_rx().
@@ -4917,6 +5056,72 @@ int32_t adi_ad9081_jesd_sysref_input_mode_set(adi_ad9081_device_t *device,
 int32_t adi_ad9081_jesd_loopback_mode_set(adi_ad9081_device_t *device,
 					  uint8_t mode);
 
+/**
+ * @brief  Precompute a NCO frequency plan and apply its first step
+ *         Call after adi_ad9081_device_startup_rx() and/or adi_ad9081_device_startup_tx().
+ *         DDC NCOs of the plan are switched to synchronous update, so the
+ *         phase increments only take effect on a chip transfer.
+ *
+ * @param  device      Pointer to the device structure
+ * @param  plan        Pointer to the plan, ncos[].type/select and num_ncos set by caller
+ * @param  shift_hz    num_steps x num_ncos NCO shifts in Hz, step major
+ * @param  num_steps   Number of steps in the plan
+ * @param  ftw         Storage for num_steps x num_ncos FTWs
+ *
+ * @return API_CMS_ERROR_OK                     API Completed Successfully
+ * @return <0                                   Failed. @see adi_cms_error_e for details.
+ */
+int32_t adi_ad9081_nco_plan_init(adi_ad9081_device_t *device,
+				 adi_ad9081_nco_plan_t *plan,
+				 const int64_t *shift_hz, uint16_t num_steps,
+				 uint64_t *ftw);
+
+/**
+ * @brief  Retune all NCOs of a plan to one of its steps
+ *         The FTWs of every NCO are written in one batched transfer and
+ *         applied together by a single chip transfer / FTW load request per
+ *         NCO type.
+ *
+ * @param  device      Pointer to the device structure
+ * @param  plan        Pointer to an initialized plan
+ * @param  step        Step index, 0 ~ num_steps - 1
+ *
+ * @return API_CMS_ERROR_OK                     API Completed Successfully
+ * @return <0                                   Failed. @see adi_cms_error_e for details.
+ */
+int32_t adi_ad9081_nco_plan_step_set(adi_ad9081_device_t *device,
+				     adi_ad9081_nco_plan_t *plan, uint16_t step);
+
+/**
+ * @brief  Get retune latency statistics of a plan
+ *         Latencies are only measured when plan->get_time_us is set.
+ *
+ * @param  device      Pointer to the device structure
+ * @param  plan        Pointer to the plan
+ * @param  last_us     Latency of the last retune in us
+ * @param  max_us      Worst retune latency in us
+ * @param  avg_us      Average retune latency in us
+ *
+ * @return API_CMS_ERROR_OK                     API Completed Successfully
+ * @return <0                                   Failed. @see adi_cms_error_e for details.
+ */
+int32_t adi_ad9081_nco_plan_latency_get(adi_ad9081_device_t *device,
+					adi_ad9081_nco_plan_t *plan,
+					uint32_t *last_us, uint32_t *max_us,
+					uint32_t *avg_us);
+
+/**
+ * @brief  Return the DDC NCOs of a plan to instantaneous update
+ *
+ * @param  device      Pointer to the device structure
+ * @param  plan        Pointer to the plan
+ *
+ * @return API_CMS_ERROR_OK                     API Completed Successfully
+ * @return <0                                   Failed. @see adi_cms_error_e for details.
+ */
+int32_t adi_ad9081_nco_plan_deinit(adi_ad9081_device_t *device,
+				   adi_ad9081_nco_plan_t *plan);
+
 #ifdef __cplusplus
 }
 #endif
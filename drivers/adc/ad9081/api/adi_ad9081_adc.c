@@ -1099,8 +1099,9 @@ int32_t adi_ad9081_adc_ddc_coarse_trig_hop_en_set(adi_ad9081_device_t *device,
 	return API_CMS_ERROR_OK;
 }
 
-int32_t adi_ad9081_adc_ddc_coarse_nco_set(adi_ad9081_device_t *device,
-					  uint8_t cddcs, int64_t cddc_shift_hz)
+static int32_t
+adi_ad9081_adc_ddc_coarse_nco_set_xact(adi_ad9081_device_t *device,
+				       uint8_t cddcs, int64_t cddc_shift_hz)
 {
 	int32_t err;
 	uint64_t ftw;
@@ -1116,6 +1117,23 @@ int32_t adi_ad9081_adc_ddc_coarse_nco_set(adi_ad9081_device_t *device,
 	return API_CMS_ERROR_OK;
 }
 
+int32_t adi_ad9081_adc_ddc_coarse_nco_set(adi_ad9081_device_t *device,
+					  uint8_t cddcs, int64_t cddc_shift_hz)
+{
+	int32_t err, commit_err;
+	AD9081_NULL_POINTER_RETURN(device);
+
+	/* batch the bit-field writes of the whole retune */
+	err = adi_ad9081_hal_xact_begin(device);
+	AD9081_ERROR_RETURN(err);
+	err = adi_ad9081_adc_ddc_coarse_nco_set_xact(device, cddcs,
+						     cddc_shift_hz);
+	commit_err = adi_ad9081_hal_xact_commit(device);
+	AD9081_ERROR_RETURN(err);
+
+	return commit_err;
+}
+
 #if AD9081_USE_FLOATING_TYPE > 0
 int32_t adi_ad9081_adc_ddc_coarse_nco_set_f(adi_ad9081_device_t *device,
 					    uint8_t cddcs, double cddc_shift_hz)
@@ -1800,8 +1818,9 @@ int32_t adi_ad9081_adc_ddc_fine_trig_hop_en_set(adi_ad9081_device_t *device,
 	return API_CMS_ERROR_OK;
 }
 
-int32_t adi_ad9081_adc_ddc_fine_nco_set(adi_ad9081_device_t *device,
-					uint8_t fddcs, int64_t fddc_shift_hz)
+static int32_t adi_ad9081_adc_ddc_fine_nco_set_xact(adi_ad9081_device_t *device,
+						    uint8_t fddcs,
+						    int64_t fddc_shift_hz)
 {
 	int32_t err;
 	uint8_t i, fddc, cddc, cc2r_en, cddc_dcm;
@@ -1850,6 +1869,23 @@ int32_t adi_ad9081_adc_ddc_fine_nco_set(adi_ad9081_device_t *device,
 	return API_CMS_ERROR_OK;
 }
 
+int32_t adi_ad9081_adc_ddc_fine_nco_set(adi_ad9081_device_t *device,
+					uint8_t fddcs, int64_t fddc_shift_hz)
+{
+	int32_t err, commit_err;
+	AD9081_NULL_POINTER_RETURN(device);
+
+	/* batch the bit-field writes of the whole retune */
+	err = adi_ad9081_hal_xact_begin(device);
+	AD9081_ERROR_RETURN(err);
+	err = adi_ad9081_adc_ddc_fine_nco_set_xact(device, fddcs,
+						   fddc_shift_hz);
+	commit_err = adi_ad9081_hal_xact_commit(device);
+	AD9081_ERROR_RETURN(err);
+
+	return commit_err;
+}
+
 #if AD9081_USE_FLOATING_TYPE > 0
 int32_t adi_ad9081_adc_ddc_fine_nco_set_f(adi_ad9081_device_t *device,
 					  uint8_t fddcs, double fddc_shift_hz)
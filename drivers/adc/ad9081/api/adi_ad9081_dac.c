@@ -576,8 +576,9 @@ int32_t adi_ad9081_dac_duc_nco_ftw_set(adi_ad9081_device_t *device,
 	return API_CMS_ERROR_OK;
 }
 
-int32_t adi_ad9081_dac_duc_nco_set(adi_ad9081_device_t *device, uint8_t dacs,
-				   uint8_t channels, int64_t nco_shift_hz)
+static int32_t adi_ad9081_dac_duc_nco_set_xact(adi_ad9081_device_t *device,
+					       uint8_t dacs, uint8_t channels,
+					       int64_t nco_shift_hz)
 {
 	int32_t err;
 	uint64_t ftw;
@@ -621,6 +622,23 @@ int32_t adi_ad9081_dac_duc_nco_set(adi_ad9081_device_t *device, uint8_t dacs,
 	return API_CMS_ERROR_OK;
 }
 
+int32_t adi_ad9081_dac_duc_nco_set(adi_ad9081_device_t *device, uint8_t dacs,
+				   uint8_t channels, int64_t nco_shift_hz)
+{
+	int32_t err, commit_err;
+	AD9081_NULL_POINTER_RETURN(device);
+
+	/* batch the bit-field writes of the whole retune */
+	err = adi_ad9081_hal_xact_begin(device);
+	AD9081_ERROR_RETURN(err);
+	err = adi_ad9081_dac_duc_nco_set_xact(device, dacs, channels,
+					    nco_shift_hz);
+	commit_err = adi_ad9081_hal_xact_commit(device);
+	AD9081_ERROR_RETURN(err);
+
+	return commit_err;
+}
+
 #if AD9081_USE_FLOATING_TYPE > 0
 int32_t adi_ad9081_dac_duc_nco_set_f(adi_ad9081_device_t *device, uint8_t dacs,
 				     uint8_t channels, double nco_shift_hz)
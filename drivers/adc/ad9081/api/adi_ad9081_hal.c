@@ -16,6 +16,188 @@
 #include "adi_ad9081_hal.h"
 
 /*============= C O D E ====================*/
+static void adi_ad9081_hal_xact_shadow_clear(adi_ad9081_device_t *device)
+{
+	uint8_t i;
+
+	for (i = 0; i < AD9081_HAL_XACT_SHADOW_SIZE; i++)
+		device->hal_info.xact.shadow_tag[i] = 0;
+}
+
+static uint8_t adi_ad9081_hal_xact_shadow_get(adi_ad9081_device_t *device,
+					      uint32_t reg, uint8_t *data)
+{
+	adi_ad9081_hal_xact_t *xact = &device->hal_info.xact;
+	uint8_t i = reg % AD9081_HAL_XACT_SHADOW_SIZE;
+
+	if (xact->shadow_tag[i] != (reg | 0x8000))
+		return 0;
+	*data = xact->shadow_data[i];
+
+	return 1;
+}
+
+static void adi_ad9081_hal_xact_shadow_put(adi_ad9081_device_t *device,
+					   uint32_t reg, uint8_t data)
+{
+	adi_ad9081_hal_xact_t *xact = &device->hal_info.xact;
+	uint8_t i = reg % AD9081_HAL_XACT_SHADOW_SIZE;
+
+	xact->shadow_tag[i] = reg | 0x8000;
+	xact->shadow_data[i] = data;
+}
+
+/*
+ * Open a transaction scope. Until the matching adi_ad9081_hal_xact_commit()
+ * writes to the 8-bit register space are queued instead of sent, and the
+ * read half of bit-field read-modify-writes is served from a shadow of the
+ * values read or written inside the scope. Scopes nest.
+ */
+int32_t adi_ad9081_hal_xact_begin(adi_ad9081_device_t *device)
+{
+	AD9081_NULL_POINTER_RETURN(device);
+#if AD9081_USE_SPI_BURST_MODE > 0
+	/* burst mode paths call spi_xfer directly, queuing would reorder */
+	return API_CMS_ERROR_OK;
+#endif
+	AD9081_INVALID_PARAM_RETURN(device->hal_info.xact.depth == 0xFF);
+
+	if (device->hal_info.xact.depth++ == 0)
+		adi_ad9081_hal_xact_shadow_clear(device);
+
+	return API_CMS_ERROR_OK;
+}
+
+/*
+ * Close a transaction scope. The outermost commit sends the queued writes
+ * and drops the shadow, so nothing cached outlives the scope.
+ */
+int32_t adi_ad9081_hal_xact_commit(adi_ad9081_device_t *device)
+{
+	int32_t err;
+	AD9081_NULL_POINTER_RETURN(device);
+#if AD9081_USE_SPI_BURST_MODE > 0
+	return API_CMS_ERROR_OK;
+#endif
+	AD9081_INVALID_PARAM_RETURN(device->hal_info.xact.depth == 0);
+
+	if (--device->hal_info.xact.depth > 0)
+		return API_CMS_ERROR_OK;
+
+	err = adi_ad9081_hal_xact_flush(device);
+	adi_ad9081_hal_xact_shadow_clear(device);
+
+	return err;
+}
+
+/*
+ * Send the queued writes in order. Runs of consecutive addresses, following
+ * the configured address increment direction, go out as one streaming burst.
+ */
+int32_t adi_ad9081_hal_xact_flush(adi_ad9081_device_t *device)
+{
+	adi_ad9081_hal_xact_t *xact;
+	uint8_t in_data[2 + AD9081_HAL_XACT_BURST_MAX];
+	uint8_t out_data[2 + AD9081_HAL_XACT_BURST_MAX];
+	uint8_t i = 0, j, n;
+	int32_t step;
+	uint32_t reg;
+	AD9081_NULL_POINTER_RETURN(device);
+
+	xact = &device->hal_info.xact;
+	if (xact->count == 0)
+		return API_CMS_ERROR_OK;
+	AD9081_NULL_POINTER_RETURN(device->hal_info.spi_xfer);
+
+	step = (device->hal_info.addr_inc == SPI_ADDR_INC_AUTO) ? 1 : -1;
+	while (i < xact->count) {
+		reg = xact->queue[i].reg;
+		in_data[0] = (reg >> 8) & 0x3F;
+		in_data[1] = (reg >> 0) & 0xFF;
+		in_data[2] = xact->queue[i].data;
+		n = 1;
+		/* LSB first transfers reorder the payload, keep them single */
+		while ((device->hal_info.msb == SPI_MSB_FIRST) &&
+		       (i + n < xact->count) &&
+		       (n < AD9081_HAL_XACT_BURST_MAX) &&
+		       (xact->queue[i + n].reg == reg + n * step)) {
+			in_data[2 + n] = xact->queue[i + n].data;
+			n++;
+		}
+
+		if (API_CMS_ERROR_OK !=
+		    device->hal_info.spi_xfer(device->hal_info.user_data,
+					      in_data, out_data, 2 + n)) {
+			xact->count = 0;
+			return API_CMS_ERROR_SPI_XFER;
+		}
+		xact->spi_xfers++;
+		for (j = 0; j < n; j++) {
+			if (API_CMS_ERROR_OK !=
+			    AD9081_LOG_SPIW(reg + j * step, in_data[2 + j])) {
+				xact->count = 0;
+				return API_CMS_ERROR_LOG_WRITE;
+			}
+		}
+		i += n;
+	}
+	xact->count = 0;
+
+	return API_CMS_ERROR_OK;
+}
+
+static int32_t adi_ad9081_hal_xact_write(adi_ad9081_device_t *device,
+					 uint32_t reg, uint8_t data)
+{
+	int32_t err;
+	uint8_t old;
+	adi_ad9081_hal_xact_t *xact = &device->hal_info.xact;
+	adi_ad9081_hal_xact_wr_t *wr;
+
+	/*
+	 * Fold into the previous write of the same register only if it does
+	 * not touch bits that write already changed: a 0 then 1 strobe stays
+	 * two writes.
+	 */
+	wr = (xact->count > 0) ? &xact->queue[xact->count - 1] : NULL;
+	if ((wr != NULL) && (wr->reg == reg) &&
+	    (((data ^ wr->data) & wr->mask) == 0)) {
+		wr->mask |= data ^ wr->data;
+		wr->data = data;
+		xact->writes_merged++;
+	} else {
+		if (xact->count == AD9081_HAL_XACT_QUEUE_SIZE) {
+			err = adi_ad9081_hal_xact_flush(device);
+			AD9081_ERROR_RETURN(err);
+		}
+		wr = &xact->queue[xact->count++];
+		wr->reg = reg;
+		wr->data = data;
+		wr->mask = adi_ad9081_hal_xact_shadow_get(device, reg, &old) ?
+				   (old ^ data) :
+				   0xFF;
+	}
+
+	/* page registers change what the paged addresses map to */
+	if ((reg >= 0x18) && (reg <= 0x1F))
+		adi_ad9081_hal_xact_shadow_clear(device);
+	adi_ad9081_hal_xact_shadow_put(device, reg, data);
+
+	return API_CMS_ERROR_OK;
+}
+
+static int32_t adi_ad9081_hal_reg_get_rmw(adi_ad9081_device_t *device,
+					  uint32_t reg, uint8_t *data)
+{
+	if ((device->hal_info.xact.depth > 0) && (reg < 0x4000) &&
+	    adi_ad9081_hal_xact_shadow_get(device, reg, data)) {
+		device->hal_info.xact.reads_saved++;
+		return API_CMS_ERROR_OK;
+	}
+
+	return adi_ad9081_hal_reg_get(device, reg, data);
+}
+
 int32_t adi_ad9081_hal_hw_open(adi_ad9081_device_t *device)
 {
 	AD9081_NULL_POINTER_RETURN(device);
@@ -42,8 +224,12 @@ int32_t adi_ad9081_hal_hw_close(adi_ad9081_device_t *device)
 
 int32_t adi_ad9081_hal_delay_us(adi_ad9081_device_t *device, uint32_t us)
 {
+	int32_t err;
 	AD9081_NULL_POINTER_RETURN(device);
 	AD9081_NULL_POINTER_RETURN(device->hal_info.delay_us);
+	/* queued writes must reach the device before the delay starts */
+	err = adi_ad9081_hal_xact_flush(device);
+	AD9081_ERROR_RETURN(err);
 	if (API_CMS_ERROR_OK !=
 	    device->hal_info.delay_us(device->hal_info.user_data, us)) {
 		return API_CMS_ERROR_DELAY_US;
@@ -55,8 +241,12 @@ int32_t adi_ad9081_hal_delay_us(adi_ad9081_device_t *device, uint32_t us)
 int32_t adi_ad9081_hal_reset_pin_ctrl(adi_ad9081_device_t *device,
 				      uint8_t enable)
 {
+	int32_t err;
 	AD9081_NULL_POINTER_RETURN(device);
 	AD9081_NULL_POINTER_RETURN(device->hal_info.reset_pin_ctrl);
+	err = adi_ad9081_hal_xact_flush(device);
+	AD9081_ERROR_RETURN(err);
+	adi_ad9081_hal_xact_shadow_clear(device);
 	if (API_CMS_ERROR_OK != device->hal_info.reset_pin_ctrl(
 					device->hal_info.user_data, enable)) {
 		return API_CMS_ERROR_RESET_PIN_CTRL;
@@ -175,7 +365,7 @@ int32_t adi_ad9081_hal_bf_set(adi_ad9081_device_t *device, uint32_t reg,
 		for (reg_offset = 0; reg_offset < reg_bytes; reg_offset++) {
 			if ((offset + width) <= 8) { /* last 8bits */
 				if ((offset > 0) || ((offset + width) < 8)) {
-					err = adi_ad9081_hal_reg_get(
+					err = adi_ad9081_hal_reg_get_rmw(
 						device, reg + reg_offset,
 						&data8);
 					AD9081_ERROR_RETURN(err);
@@ -185,7 +375,7 @@ int32_t adi_ad9081_hal_bf_set(adi_ad9081_device_t *device, uint32_t reg,
 				data8 = data8 | ((value & mask) << offset);
 			} else {
 				if (offset > 0) {
-					err = adi_ad9081_hal_reg_get(
+					err = adi_ad9081_hal_reg_get_rmw(
 						device, reg + reg_offset,
 						&data8);
 					AD9081_ERROR_RETURN(err);
@@ -239,11 +429,16 @@ int32_t adi_ad9081_hal_bf_set(adi_ad9081_device_t *device, uint32_t reg,
 int32_t adi_ad9081_hal_reg_get(adi_ad9081_device_t *device, uint32_t reg,
 			       uint8_t *data)
 {
+	int32_t err;
 	uint8_t in_data[6] = { 0 }, out_data[6] = { 0 };
 	AD9081_NULL_POINTER_RETURN(device);
 	AD9081_NULL_POINTER_RETURN(device->hal_info.spi_xfer);
 	AD9081_NULL_POINTER_RETURN(data);
 
+	/* reads always go to the device, after any queued writes */
+	err = adi_ad9081_hal_xact_flush(device);
+	AD9081_ERROR_RETURN(err);
+
 	if (reg < 0x4000) {
 		in_data[0] = ((reg >> 8) & 0x3F) | 0x80;
 		in_data[1] = ((reg >> 0) & 0xFF);
@@ -252,6 +447,8 @@ int32_t adi_ad9081_hal_reg_get(adi_ad9081_device_t *device, uint32_t reg,
 					      in_data, out_data, 0x3))
 			return API_CMS_ERROR_SPI_XFER;
 		*data = out_data[2];
+		if (device->hal_info.xact.depth > 0)
+			adi_ad9081_hal_xact_shadow_put(device, reg, *data);
 		if (API_CMS_ERROR_OK !=
 		    AD9081_LOG_SPIR((in_data[0] << 8) + in_data[1],
 				    out_data[2]))
@@ -335,10 +532,22 @@ int32_t adi_ad9081_hal_reg_get(adi_ad9081_device_t *device, uint32_t reg,
 int32_t adi_ad9081_hal_reg_set(adi_ad9081_device_t *device, uint32_t reg,
 			       uint32_t data)
 {
+	int32_t err;
 	uint8_t in_data[6] = { 0 }, out_data[6] = { 0 };
 	AD9081_NULL_POINTER_RETURN(device);
 	AD9081_NULL_POINTER_RETURN(device->hal_info.spi_xfer);
 
+	if (device->hal_info.xact.depth > 0) {
+		if ((reg >= 0x10) && (reg < 0x4000))
+			return adi_ad9081_hal_xact_write(device, reg,
+							 (uint8_t)data);
+		err = adi_ad9081_hal_xact_flush(device);
+		AD9081_ERROR_RETURN(err);
+		/* spi configuration and soft reset, nothing shadowed holds */
+		if (reg < 0x10)
+			adi_ad9081_hal_xact_shadow_clear(device);
+	}
+
 	if (reg < 0x4000) {
 		in_data[0] = (reg >> 8) & 0x3F;
 		in_data[1] = (reg >> 0) & 0xFF;
@@ -1107,8 +1316,8 @@ int32_t adi_ad9081_hal_multi_bf_set(adi_ad9081_device_t *device, uint32_t reg,
 			if ((reg_read_reqd == 1) &&
 			    ((offset > 0) || ((offset + width) < 8))) {
 				reg_read_reqd = 0;
-				err = adi_ad9081_hal_reg_get(device, reg,
-							     &data8);
+				err = adi_ad9081_hal_reg_get_rmw(device, reg,
+								 &data8);
 				AD9081_ERROR_RETURN(err);
 			}
 			mask = (1 << width) - 1;
@@ -121,6 +121,10 @@ int32_t adi_ad9081_hal_multi_bf_set(adi_ad9081_device_t *device, uint32_t reg,
 				    uint32_t *info, uint64_t *value,
 				    uint8_t num_bfs);
 
+int32_t adi_ad9081_hal_xact_begin(adi_ad9081_device_t *device);
+int32_t adi_ad9081_hal_xact_commit(adi_ad9081_device_t *device);
+int32_t adi_ad9081_hal_xact_flush(adi_ad9081_device_t *device);
+
 int32_t adi_ad9081_hal_reg_get(adi_ad9081_device_t *device, uint32_t reg,
 			       uint8_t *data);
 int32_t adi_ad9081_hal_reg_set(adi_ad9081_device_t *device, uint32_t reg,
@@ -0,0 +1,402 @@
+/*!
+ * @brief     APIs for fast NCO retune from precomputed frequency plans
+ *
+ * @copyright copyright(c) 2018 analog devices, inc. all rights reserved.
+ *            This software is proprietary to Analog Devices, Inc. and its
+ *            licensor. By using this software you agree to the terms of the
+ *            associated analog devices software license agreement.
+ */
+
+/*!
+ * @addtogroup AD9081_NCO_API
+ * @{
+ */
+
+/*============= I N C L U D E S ============*/
+#include "adi_ad9081_config.h"
+#include "adi_ad9081_hal.h"
+
+/*============= C O D E ====================*/
+static uint8_t adi_ad9081_nco_plan_select_valid(uint8_t type, uint8_t select)
+{
+	uint8_t all;
+
+	switch (type) {
+	case AD9081_NCO_PLAN_CDDC:
+		all = AD9081_ADC_CDDC_ALL;
+		break;
+	case AD9081_NCO_PLAN_FDDC:
+		all = AD9081_ADC_FDDC_ALL;
+		break;
+	case AD9081_NCO_PLAN_DAC_MAIN:
+		all = AD9081_DAC_ALL;
+		break;
+	case AD9081_NCO_PLAN_DAC_CHAN:
+		all = AD9081_DAC_CH_ALL;
+		break;
+	default:
+		return 0;
+	}
+
+	/* exactly one NCO per entry, each one gets its own FTW */
+	return (select != 0) && ((select & (select - 1)) == 0) &&
+	       ((select & ~all) == 0);
+}
+
+static int32_t adi_ad9081_nco_plan_fddc_freq_get(adi_ad9081_device_t *device,
+						 uint8_t fddc,
+						 uint64_t *freq_hz)
+{
+	int32_t err;
+	uint8_t cddc, cc2r_en, cddc_dcm;
+	uint64_t adc_freq_hz;
+
+	err = adi_ad9081_adc_xbar_find_cddc(device, fddc, &cddc);
+	AD9081_ERROR_RETURN(err);
+	err = adi_ad9081_adc_ddc_coarse_select_set(device, cddc);
+	AD9081_ERROR_RETURN(err);
+	err = adi_ad9081_hal_bf_get(device, REG_COARSE_DEC_CTRL_ADDR,
+				    BF_COARSE_DEC_SEL_INFO, &cddc_dcm, 1);
+	AD9081_ERROR_RETURN(err);
+	err = adi_ad9081_hal_bf_get(device, REG_COARSE_DEC_CTRL_ADDR,
+				    BF_COARSE_C2R_EN_INFO, &cc2r_en, 1);
+	AD9081_ERROR_RETURN(err);
+	cddc_dcm = adi_ad9081_adc_ddc_coarse_dcm_decode(cddc_dcm);
+	adc_freq_hz = device->dev_info.adc_freq_hz;
+#ifdef __KERNEL__
+	adc_freq_hz = div_u64(adc_freq_hz, cddc_dcm);
+#else
+	adc_freq_hz = adc_freq_hz / cddc_dcm;
+#endif
+	*freq_hz = (cc2r_en > 0) ? (adc_freq_hz * 2) : adc_freq_hz;
+
+	return API_CMS_ERROR_OK;
+}
+
+static int32_t adi_ad9081_nco_plan_sync_mode_set(adi_ad9081_device_t *device,
+						 adi_ad9081_nco_plan_t *plan,
+						 uint8_t mode)
+{
+	int32_t err;
+	uint8_t i, cddcs = 0, fddcs = 0;
+
+	for (i = 0; i < plan->num_ncos; i++) {
+		if (plan->ncos[i].type == AD9081_NCO_PLAN_CDDC)
+			cddcs |= plan->ncos[i].select;
+		if (plan->ncos[i].type == AD9081_NCO_PLAN_FDDC)
+			fddcs |= plan->ncos[i].select;
+	}
+
+	/* mode 1: phase increments move to the NCO on the chip transfer bit */
+	if (cddcs > 0) {
+		err = adi_ad9081_adc_ddc_coarse_gpio_chip_xfer_mode_set(
+			device, cddcs, 0);
+		AD9081_ERROR_RETURN(err);
+		err = adi_ad9081_adc_ddc_coarse_nco_channel_update_mode_set(
+			device, cddcs, mode);
+		AD9081_ERROR_RETURN(err);
+	}
+	if (fddcs > 0) {
+		err = adi_ad9081_adc_ddc_fine_gpio_chip_xfer_mode_set(
+			device, fddcs, 0);
+		AD9081_ERROR_RETURN(err);
+		err = adi_ad9081_adc_ddc_fine_nco_channel_update_mode_set(
+			device, fddcs, mode);
+		AD9081_ERROR_RETURN(err);
+	}
+
+	return API_CMS_ERROR_OK;
+}
+
+int32_t adi_ad9081_nco_plan_init(adi_ad9081_device_t *device,
+				 adi_ad9081_nco_plan_t *plan,
+				 const int64_t *shift_hz, uint16_t num_steps,
+				 uint64_t *ftw)
+{
+	int32_t err;
+	uint8_t i, type, select, main_interp = 0;
+	uint16_t step;
+	uint32_t k;
+	uint64_t freq_hz;
+	int64_t shift;
+	AD9081_NULL_POINTER_RETURN(device);
+	AD9081_NULL_POINTER_RETURN(plan);
+	AD9081_NULL_POINTER_RETURN(shift_hz);
+	AD9081_NULL_POINTER_RETURN(ftw);
+	AD9081_LOG_FUNC();
+	AD9081_INVALID_PARAM_RETURN(num_steps == 0);
+	AD9081_INVALID_PARAM_RETURN(plan->num_ncos == 0);
+	AD9081_INVALID_PARAM_RETURN(plan->num_ncos > AD9081_NCO_PLAN_MAX_NCOS);
+
+	for (i = 0; i < plan->num_ncos; i++) {
+		type = plan->ncos[i].type;
+		AD9081_INVALID_PARAM_RETURN(!adi_ad9081_nco_plan_select_valid(
+			type, plan->ncos[i].select));
+		if ((type == AD9081_NCO_PLAN_DAC_CHAN) && (main_interp == 0)) {
+			err = adi_ad9081_hal_bf_get(device, REG_INTRP_MODE_ADDR,
+						    BF_DP_INTERP_MODE_INFO,
+						    &main_interp, 1);
+			AD9081_ERROR_RETURN(err);
+		}
+	}
+
+	/* all the 64-bit divisions of the sweep happen here, once */
+	for (i = 0; i < plan->num_ncos; i++) {
+		type = plan->ncos[i].type;
+		select = plan->ncos[i].select;
+		if (type == AD9081_NCO_PLAN_CDDC) {
+			freq_hz = device->dev_info.adc_freq_hz;
+		} else if (type == AD9081_NCO_PLAN_FDDC) {
+			err = adi_ad9081_nco_plan_fddc_freq_get(device, select,
+								&freq_hz);
+			AD9081_ERROR_RETURN(err);
+		} else {
+			freq_hz = device->dev_info.dac_freq_hz;
+		}
+		AD9081_INVALID_PARAM_RETURN(freq_hz == 0);
+
+		for (step = 0; step < num_steps; step++) {
+			k = (uint32_t)step * plan->num_ncos + i;
+			shift = shift_hz[k];
+			if (type == AD9081_NCO_PLAN_CDDC) {
+				err = adi_ad9081_hal_calc_rx_nco_ftw(
+					device, freq_hz, shift, &ftw[k]);
+			} else {
+				if (type == AD9081_NCO_PLAN_DAC_CHAN)
+					shift *= main_interp;
+				err = adi_ad9081_hal_calc_tx_nco_ftw(
+					device, freq_hz, shift, &ftw[k]);
+			}
+			AD9081_ERROR_RETURN(err);
+		}
+	}
+
+	plan->num_steps = num_steps;
+	plan->ftw = ftw;
+	plan->step = 0;
+	plan->steps_applied = 0;
+	plan->last_us = 0;
+	plan->max_us = 0;
+	plan->total_us = 0;
+	plan->last_spi_xfers = 0;
+
+	/*
+	 * Put every NCO in integer mode with the first step loaded, so the
+	 * retunes only have to rewrite the six FTW bytes.
+	 */
+	for (i = 0; i < plan->num_ncos; i++) {
+		select = plan->ncos[i].select;
+		switch (plan->ncos[i].type) {
+		case AD9081_NCO_PLAN_CDDC:
+			err = adi_ad9081_adc_ddc_coarse_nco_ftw_set(
+				device, select, ftw[i], 0, 0);
+			break;
+		case AD9081_NCO_PLAN_FDDC:
+			err = adi_ad9081_adc_ddc_fine_nco_ftw_set(
+				device, select, ftw[i], 0, 0);
+			break;
+		case AD9081_NCO_PLAN_DAC_MAIN:
+			err = adi_ad9081_dac_duc_nco_enable_set(
+				device, select, AD9081_DAC_CH_NONE, 1);
+			AD9081_ERROR_RETURN(err);
+			err = adi_ad9081_dac_duc_nco_ftw_set(
+				device, select, AD9081_DAC_CH_NONE, ftw[i], 0,
+				0);
+			break;
+		default:
+			err = adi_ad9081_dac_duc_nco_enable_set(
+				device, AD9081_DAC_NONE, select, 1);
+			AD9081_ERROR_RETURN(err);
+			err = adi_ad9081_dac_duc_nco_ftw_set(
+				device, AD9081_DAC_NONE, select, ftw[i], 0, 0);
+			break;
+		}
+		AD9081_ERROR_RETURN(err);
+	}
+	err = adi_ad9081_nco_plan_sync_mode_set(device, plan, 1);
+	AD9081_ERROR_RETURN(err);
+
+	return adi_ad9081_nco_plan_step_set(device, plan, 0);
+}
+
+static int32_t adi_ad9081_nco_plan_step_set_xact(adi_ad9081_device_t *device,
+						 adi_ad9081_nco_plan_t *plan,
+						 uint16_t step)
+{
+	int32_t err;
+	uint8_t i, j, select, page;
+	uint8_t adc_page = 0, cddcs = 0, fddcs = 0, dacs = 0, channels = 0;
+	uint32_t page_reg, ftw_reg;
+	const uint64_t *ftw = &plan->ftw[(uint32_t)step * plan->num_ncos];
+
+	for (i = 0; i < plan->num_ncos; i++) {
+		if (plan->ncos[i].type == AD9081_NCO_PLAN_CDDC)
+			cddcs |= plan->ncos[i].select;
+	}
+	/* the coarse DDC page shares its register with the ADC page */
+	if (cddcs > 0) {
+		err = adi_ad9081_hal_reg_get(device, REG_ADC_COARSE_PAGE_ADDR,
+					     &adc_page);
+		AD9081_ERROR_RETURN(err);
+		adc_page &= 0x0f;
+	}
+
+	/* whole register writes only, nothing here needs a read back */
+	for (i = 0; i < plan->num_ncos; i++) {
+		select = plan->ncos[i].select;
+		page = select;
+		switch (plan->ncos[i].type) {
+		case AD9081_NCO_PLAN_CDDC:
+			page_reg = REG_ADC_COARSE_PAGE_ADDR;
+			page = (select << 4) | adc_page;
+			ftw_reg = REG_COARSE_DDC_PHASE_INC0_ADDR;
+			break;
+		case AD9081_NCO_PLAN_FDDC:
+			page_reg = REG_FINE_DDC_PAGE_ADDR;
+			ftw_reg = REG_FINE_DDC_PHASE_INC0_ADDR;
+			fddcs |= select;
+			break;
+		case AD9081_NCO_PLAN_DAC_MAIN:
+			page_reg = REG_PAGEINDX_DAC_MAINDP_DAC_ADDR;
+			ftw_reg = REG_DDSM_FTW0_ADDR;
+			dacs |= select;
+			break;
+		default:
+			page_reg = REG_PAGEINDX_DAC_CHAN_ADDR;
+			ftw_reg = REG_DDSC_FTW0_ADDR;
+			channels |= select;
+			break;
+		}
+		err = adi_ad9081_hal_reg_set(device, page_reg, page);
+		AD9081_ERROR_RETURN(err);
+		for (j = 0; j < 6; j++) {
+			err = adi_ad9081_hal_reg_set(
+				device, ftw_reg + j,
+				(uint8_t)((ftw[i] >> (8 * j)) & 0xFF));
+			AD9081_ERROR_RETURN(err);
+		}
+	}
+
+	/* page every NCO of a kind at once and apply them with one strobe */
+	if (cddcs > 0) {
+		err = adi_ad9081_hal_reg_set(device, REG_ADC_COARSE_PAGE_ADDR,
+					     (cddcs << 4) | adc_page);
+		AD9081_ERROR_RETURN(err);
+		err = adi_ad9081_hal_reg_set(
+			device, REG_COARSE_DDC_TRANSFER_CTRL_ADDR, 0x01);
+		AD9081_ERROR_RETURN(err);
+	}
+	if (fddcs > 0) {
+		err = adi_ad9081_hal_reg_set(device, REG_FINE_DDC_PAGE_ADDR,
+					     fddcs);
+		AD9081_ERROR_RETURN(err);
+		err = adi_ad9081_hal_reg_set(
+			device, REG_FINE_DDC_TRANSFER_CTRL_ADDR, 0x01);
+		AD9081_ERROR_RETURN(err);
+	}
+	/* FTW_LOAD_REQ is rising edge, load sysref was cleared by init */
+	if (dacs > 0) {
+		err = adi_ad9081_hal_reg_set(
+			device, REG_PAGEINDX_DAC_MAINDP_DAC_ADDR, dacs);
+		AD9081_ERROR_RETURN(err);
+		err = adi_ad9081_hal_reg_set(device, REG_DDSM_FTW_UPDATE_ADDR,
+					     0x00);
+		AD9081_ERROR_RETURN(err);
+		err = adi_ad9081_hal_reg_set(device, REG_DDSM_FTW_UPDATE_ADDR,
+					     0x01);
+		AD9081_ERROR_RETURN(err);
+	}
+	if (channels > 0) {
+		err = adi_ad9081_hal_reg_set(device, REG_PAGEINDX_DAC_CHAN_ADDR,
+					     channels);
+		AD9081_ERROR_RETURN(err);
+		err = adi_ad9081_hal_reg_set(device, REG_DDSC_FTW_UPDATE_ADDR,
+					     0x00);
+		AD9081_ERROR_RETURN(err);
+		err = adi_ad9081_hal_reg_set(device, REG_DDSC_FTW_UPDATE_ADDR,
+					     0x01);
+		AD9081_ERROR_RETURN(err);
+	}
+
+	return API_CMS_ERROR_OK;
+}
+
+int32_t adi_ad9081_nco_plan_step_set(adi_ad9081_device_t *device,
+				     adi_ad9081_nco_plan_t *plan, uint16_t step)
+{
+	int32_t err, commit_err;
+	uint32_t start_us = 0, spi_xfers;
+	AD9081_NULL_POINTER_RETURN(device);
+	AD9081_NULL_POINTER_RETURN(plan);
+	AD9081_NULL_POINTER_RETURN(plan->ftw);
+	AD9081_LOG_FUNC();
+	AD9081_INVALID_PARAM_RETURN(step >= plan->num_steps);
+
+	if (plan->get_time_us != NULL)
+		start_us = plan->get_time_us(device->hal_info.user_data);
+	spi_xfers = device->hal_info.xact.spi_xfers;
+
+	err = adi_ad9081_hal_xact_begin(device);
+	AD9081_ERROR_RETURN(err);
+	err = adi_ad9081_nco_plan_step_set_xact(device, plan, step);
+	commit_err = adi_ad9081_hal_xact_commit(device);
+	AD9081_ERROR_RETURN(err);
+	AD9081_ERROR_RETURN(commit_err);
+
+	plan->step = step;
+	plan->steps_applied++;
+	plan->last_spi_xfers = device->hal_info.xact.spi_xfers - spi_xfers;
+	if (plan->get_time_us != NULL) {
+		plan->last_us =
+			plan->get_time_us(device->hal_info.user_data) - start_us;
+		if (plan->last_us > plan->max_us)
+			plan->max_us = plan->last_us;
+		plan->total_us += plan->last_us;
+	}
+
+	return API_CMS_ERROR_OK;
+}
+
+int32_t adi_ad9081_nco_plan_latency_get(adi_ad9081_device_t *device,
+					adi_ad9081_nco_plan_t *plan,
+					uint32_t *last_us, uint32_t *max_us,
+					uint32_t *avg_us)
+{
+	AD9081_NULL_POINTER_RETURN(device);
+	AD9081_NULL_POINTER_RETURN(plan);
+	AD9081_NULL_POINTER_RETURN(last_us);
+	AD9081_NULL_POINTER_RETURN(max_us);
+	AD9081_NULL_POINTER_RETURN(avg_us);
+
+	*last_us = plan->last_us;
+	*max_us = plan->max_us;
+	*avg_us = 0;
+	if (plan->steps_applied > 0) {
+#ifdef __KERNEL__
+		*avg_us = (uint32_t)div_u64(plan->total_us,
+					    plan->steps_applied);
+#else
+		*avg_us = (uint32_t)(plan->total_us / plan->steps_applied);
+#endif
+	}
+
+	return API_CMS_ERROR_OK;
+}
+
+int32_t adi_ad9081_nco_plan_deinit(adi_ad9081_device_t *device,
+				   adi_ad9081_nco_plan_t *plan)
+{
+	int32_t err;
+	AD9081_NULL_POINTER_RETURN(device);
+	AD9081_NULL_POINTER_RETURN(plan);
+	AD9081_LOG_FUNC();
+
+	err = adi_ad9081_nco_plan_sync_mode_set(device, plan, 0);
+	AD9081_ERROR_RETURN(err);
+	plan->ftw = NULL;
+	plan->num_steps = 0;
+
+	return API_CMS_ERROR_OK;
+}
+
+/*! @} */
@@ -90,6 +90,21 @@ int32_t axi_adc_set_pnsel(struct axi_adc *adc,
 	return SUCCESS;
 }
 
+/***************************************************************************//**
+ * @brief axi_adc_pn_setup
+*******************************************************************************/
+static void axi_adc_pn_setup(struct axi_adc *adc,
+			     uint32_t chan,
+			     enum axi_adc_pn_sel sel)
+{
+	uint32_t reg_data;
+
+	axi_adc_read(adc, AXI_ADC_REG_CHAN_CNTRL(chan), &reg_data);
+	reg_data |= AXI_ADC_ENABLE;
+	axi_adc_write(adc, AXI_ADC_REG_CHAN_CNTRL(chan), reg_data);
+	axi_adc_set_pnsel(adc, chan, sel);
+}
+
 /***************************************************************************//**
  * @brief axi_adc_pn_mon
 *******************************************************************************/
@@ -99,12 +114,8 @@ int32_t axi_adc_pn_mon(struct axi_adc *adc,
 	uint8_t	ch;
 	uint32_t reg_data;
 
-	for (ch = 0; ch < adc->num_channels; ch++) {
-		axi_adc_read(adc, AXI_ADC_REG_CHAN_CNTRL(ch), &reg_data);
-		reg_data |= AXI_ADC_ENABLE;
-		axi_adc_write(adc, AXI_ADC_REG_CHAN_CNTRL(ch), reg_data);
-		axi_adc_set_pnsel(adc, ch, sel);
-	}
+	for (ch = 0; ch < adc->num_channels; ch++)
+		axi_adc_pn_setup(adc, ch, sel);
 	mdelay(1);
 
 	for (ch = 0; ch < adc->num_channels; ch++) {
@@ -182,86 +193,274 @@ int32_t axi_adc_delay_set(struct axi_adc *adc,
 }
 
 /***************************************************************************//**
- * @brief axi_adc_delay_calibrate
+ * @brief axi_adc_delay_check
+ *
+ * Run the PN monitors of the channels in chan_mask and return the mask of
+ * the channels that saw errors. The dwell starts at dwell_min_ms and is
+ * doubled up to dwell_max_ms while any monitored channel is still clean, so
+ * bad taps are rejected after the first short dwell.
 *******************************************************************************/
-int32_t axi_adc_delay_calibrate(struct axi_adc *adc,
-				uint32_t no_of_lanes,
-				enum axi_adc_pn_sel sel)
+static uint32_t axi_adc_delay_check(struct axi_adc *adc,
+				    const struct axi_adc_delay_tune *tune,
+				    uint32_t chan_mask)
 {
-	uint8_t err_field[32] = {0};
-	uint16_t valid_range[5] = {0};
-	uint16_t invalid_range[5] = {0};
-	uint16_t delay = 0;
-	uint16_t start_valid_delay = 32;
-	uint16_t start_invalid_delay = 32;
-	uint8_t interval = 0;
-	uint8_t max_interval = 0;
-	uint8_t max_valid_range = 0;
-	uint8_t cnt_valid[5] = {0};
-	uint8_t cnt_invalid = 0;
-	uint8_t val = 0;
-	uint8_t max_val = 32;
-
-	for (delay = 0; delay < 32; delay++) {
-		axi_adc_delay_set(adc, no_of_lanes, delay);
-		mdelay(20);
-		if (axi_adc_pn_mon(adc, sel, 100) == 0) {
-			err_field[delay] = 0;
-			start_valid_delay = start_valid_delay == 32 ?
-					    delay : start_valid_delay;
+	uint32_t err_mask = 0;
+	uint32_t elapsed = 0;
+	uint32_t dwell;
+	uint32_t reg_data;
+	uint8_t ch;
+
+	/* Let the monitors resync on the new taps */
+	mdelay(1);
+
+	for (ch = 0; ch < adc->num_channels; ch++)
+		if (chan_mask & BIT(ch))
+			axi_adc_write(adc, AXI_ADC_REG_CHAN_STATUS(ch), 0xff);
+
+	dwell = tune->dwell_min_ms;
+	do {
+		mdelay(dwell - elapsed);
+		elapsed = dwell;
+
+		for (ch = 0; ch < adc->num_channels; ch++) {
+			if (!(chan_mask & BIT(ch)))
+				continue;
+			axi_adc_read(adc, AXI_ADC_REG_CHAN_STATUS(ch), &reg_data);
+			if (reg_data & (AXI_ADC_PN_ERR | AXI_ADC_PN_OOS))
+				err_mask |= BIT(ch);
+		}
+
+		dwell = min(dwell * 2, tune->dwell_max_ms);
+	} while (err_mask != chan_mask && elapsed < tune->dwell_max_ms);
+
+	return err_mask;
+}
+
+/***************************************************************************//**
+ * @brief axi_adc_delay_lane_chan
+*******************************************************************************/
+static uint32_t axi_adc_delay_lane_chan(struct axi_adc *adc,
+					const struct axi_adc_delay_tune *tune,
+					uint32_t lane)
+{
+	if (tune->lane_chan)
+		return BIT(tune->lane_chan[lane]);
+
+	return BIT(adc->num_channels) - 1;
+}
+
+/***************************************************************************//**
+ * @brief axi_adc_delay_common
+ *
+ * Find a tap shared by all lanes: the center of the longest passing run on
+ * a coarse_step grid, or on every tap if the coarse grid misses the window.
+*******************************************************************************/
+static int32_t axi_adc_delay_common(struct axi_adc *adc,
+				    const struct axi_adc_delay_tune *tune,
+				    uint32_t step)
+{
+	uint32_t all_chan = BIT(adc->num_channels) - 1;
+	int32_t run_start = -1, best_start = -1;
+	uint32_t best_len = 0;
+	uint32_t tap, lane;
+
+	for (tap = 0; tap < AXI_ADC_DELAY_TAPS; tap += step) {
+		for (lane = 0; lane < tune->num_lanes; lane++)
+			axi_adc_idelay_set(adc, lane, tap);
+
+		if (!axi_adc_delay_check(adc, tune, all_chan)) {
+			if (run_start < 0)
+				run_start = tap;
+			if (tap - run_start + 1 > best_len) {
+				best_len = tap - run_start + 1;
+				best_start = run_start;
+			}
 		} else {
-			err_field[delay] = 1;
+			run_start = -1;
+		}
+	}
+
+	if (best_start < 0)
+		return step > 1 ? axi_adc_delay_common(adc, tune, 1) : FAILURE;
+
+	return best_start + (best_len - 1) / 2;
+}
+
+/***************************************************************************//**
+ * @brief axi_adc_delay_edges
+ *
+ * Binary search of the lower (dir < 0) or upper (dir > 0) window edge of the
+ * lanes in lane_mask, starting from the passing tap common. Lanes on
+ * different channels are searched together. The edges are returned in edge,
+ * entries of the other lanes are left untouched.
+*******************************************************************************/
+static void axi_adc_delay_edges(struct axi_adc *adc,
+				const struct axi_adc_delay_tune *tune,
+				uint32_t lane_mask, uint32_t common, int32_t dir,
+				int8_t *edge)
+{
+	int8_t fail[AXI_ADC_DELAY_MAX_LANES];
+	uint32_t chan_mask, err_mask, active;
+	uint32_t lane;
+
+	for (lane = 0; lane < tune->num_lanes; lane++) {
+		if (!(lane_mask & BIT(lane)))
+			continue;
+		edge[lane] = common;
+		fail[lane] = dir < 0 ? -1 : AXI_ADC_DELAY_TAPS;
+	}
+
+	do {
+		active = 0;
+		chan_mask = 0;
+		for (lane = 0; lane < tune->num_lanes; lane++) {
+			if (!(lane_mask & BIT(lane)) || abs(fail[lane] - edge[lane]) <= 1)
+				continue;
+			axi_adc_idelay_set(adc, lane, (edge[lane] + fail[lane]) / 2);
+			chan_mask |= axi_adc_delay_lane_chan(adc, tune, lane);
+			active |= BIT(lane);
+		}
+		if (!active)
+			break;
+
+		err_mask = axi_adc_delay_check(adc, tune, chan_mask);
+
+		for (lane = 0; lane < tune->num_lanes; lane++) {
+			if (!(active & BIT(lane)))
+				continue;
+			if (err_mask & axi_adc_delay_lane_chan(adc, tune, lane))
+				fail[lane] = (edge[lane] + fail[lane]) / 2;
+			else
+				edge[lane] = (edge[lane] + fail[lane]) / 2;
+			axi_adc_idelay_set(adc, lane, common);
 		}
+	} while (1);
+}
+
+/***************************************************************************//**
+ * @brief axi_adc_delay_tune
+ *
+ * Per lane interface delay tuning against the PN sequence sel. A common
+ * passing tap is found on a coarse grid first, then both edges of the
+ * window of each lane are located by binary search while the other lanes
+ * stay on the common tap, and each lane is centered in its own window.
+ * Lanes that never fail (e.g. an over-range bit) keep the common tap.
+ * When cache holds the taps of a previous run they are only verified, and
+ * the full search runs if the verification fails. cache is updated with
+ * the result and may be NULL.
+*******************************************************************************/
+int32_t axi_adc_delay_tune(struct axi_adc *adc,
+			   const struct axi_adc_delay_tune *tune,
+			   struct axi_adc_delay_cache *cache)
+{
+	int8_t lo[AXI_ADC_DELAY_MAX_LANES], hi[AXI_ADC_DELAY_MAX_LANES];
+	uint8_t taps[AXI_ADC_DELAY_MAX_LANES];
+	uint32_t all_chan = BIT(adc->num_channels) - 1;
+	uint32_t done = 0, group, used;
+	uint32_t lane, chan;
+	int32_t common;
+	uint8_t ch;
+
+	if (!tune->num_lanes || tune->num_lanes > AXI_ADC_DELAY_MAX_LANES ||
+	    !tune->dwell_min_ms || tune->dwell_max_ms < tune->dwell_min_ms)
+		return -EINVAL;
+
+	if (axi_adc_delay_set(adc, tune->num_lanes, 0))
+		return FAILURE;
+
+	for (ch = 0; ch < adc->num_channels; ch++)
+		axi_adc_pn_setup(adc, ch, tune->sel);
+
+	if (cache && cache->magic == AXI_ADC_DELAY_CACHE_MAGIC &&
+	    cache->num_lanes == tune->num_lanes) {
+		for (lane = 0; lane < tune->num_lanes; lane++)
+			axi_adc_idelay_set(adc, lane, cache->taps[lane]);
+		if (!axi_adc_delay_check(adc, tune, all_chan)) {
+			printf("adc_delay: cached delays verified\n\r");
+			return SUCCESS;
+		}
+		printf("adc_delay: cached delays failed, tuning\n\r");
 	}
-	if (start_valid_delay > 31) {
+
+	common = axi_adc_delay_common(adc, tune,
+				      tune->coarse_step ? tune->coarse_step : 1);
+	if (common < 0) {
 		printf("%s FAILED.\n", __func__);
-		axi_adc_delay_set(adc, no_of_lanes, 0);
+		axi_adc_delay_set(adc, tune->num_lanes, 0);
 		return FAILURE;
 	}
 
-	start_valid_delay = 32;
-	start_invalid_delay = 32;
-	for (val = 0; val < max_val; val++) {
-		if (err_field[val] == 0) {
-			if (start_valid_delay == 32) {
-				start_valid_delay = val;
-			}
-			if (start_valid_delay != 32 && start_invalid_delay != 32 ) {
-				start_valid_delay = 32;
-				start_invalid_delay = 32;
-			}
-			cnt_valid[interval]++;
+	for (lane = 0; lane < tune->num_lanes; lane++)
+		axi_adc_idelay_set(adc, lane, common);
+
+	/* One lane per monitoring channel at a time */
+	while (done != BIT(tune->num_lanes) - 1) {
+		group = 0;
+		used = 0;
+		for (lane = 0; lane < tune->num_lanes; lane++) {
+			chan = axi_adc_delay_lane_chan(adc, tune, lane);
+			if ((done & BIT(lane)) || (used & chan))
+				continue;
+			group |= BIT(lane);
+			used |= chan;
 		}
-		if((err_field[val] == 1) || (val == max_val - 1)) {
-			if (start_invalid_delay == 32) {
-				start_invalid_delay = val;
-			}
-			if (start_valid_delay != 32 && start_invalid_delay != 32 ) {
-				valid_range[interval] = start_valid_delay;
-				invalid_range[interval] = start_invalid_delay;
-				start_valid_delay = 32;
-				start_invalid_delay = 32;
-				interval++;
-			}
-			cnt_invalid++;
+
+		axi_adc_delay_edges(adc, tune, group, common, -1, lo);
+		axi_adc_delay_edges(adc, tune, group, common, 1, hi);
+		for (lane = 0; lane < tune->num_lanes; lane++) {
+			if (!(group & BIT(lane)))
+				continue;
+			if (lo[lane] == 0 && hi[lane] == AXI_ADC_DELAY_TAPS - 1)
+				taps[lane] = common;
+			else
+				taps[lane] = (lo[lane] + hi[lane]) / 2;
 		}
+
+		done |= group;
 	}
 
-	for (val = 0; val < 5; val++) {
-		if (cnt_valid[val] > max_valid_range) {
-			max_valid_range = cnt_valid[val];
-			max_interval = val;
-		}
+	for (lane = 0; lane < tune->num_lanes; lane++) {
+		printf("adc_delay: lane %"PRIu32": window %d-%d, delay %d\n\r",
+		       lane, lo[lane], hi[lane], taps[lane]);
+		axi_adc_idelay_set(adc, lane, taps[lane]);
 	}
 
-	delay = (valid_range[max_interval] + invalid_range[max_interval] - 1) / 2;
+	if (axi_adc_delay_check(adc, tune, all_chan)) {
+		printf("adc_delay: per lane delays failed, using common delay (%"
+		       PRId32")\n\r", common);
+		for (lane = 0; lane < tune->num_lanes; lane++)
+			taps[lane] = common;
+		axi_adc_delay_set(adc, tune->num_lanes, common);
+	}
 
-	printf("adc_delay: setting zero error delay (%d)\n\r", delay);
-	axi_adc_delay_set(adc, no_of_lanes, delay);
+	if (cache) {
+		cache->magic = AXI_ADC_DELAY_CACHE_MAGIC;
+		cache->num_lanes = tune->num_lanes;
+		for (lane = 0; lane < tune->num_lanes; lane++)
+			cache->taps[lane] = taps[lane];
+	}
 
 	return SUCCESS;
 }
 
+/***************************************************************************//**
+ * @brief axi_adc_delay_calibrate
+*******************************************************************************/
+int32_t axi_adc_delay_calibrate(struct axi_adc *adc,
+				uint32_t no_of_lanes,
+				enum axi_adc_pn_sel sel)
+{
+	struct axi_adc_delay_tune tune = {
+		.num_lanes = no_of_lanes,
+		.sel = sel,
+		.dwell_min_ms = 1,
+		.dwell_max_ms = 16,
+		.coarse_step = 4,
+	};
+
+	return axi_adc_delay_tune(adc, &tune, NULL);
+}
+
 /***************************************************************************//**
  * @brief axi_adc_set_calib_phase_scale
 *******************************************************************************/
@@ -114,6 +114,10 @@
 
 #define AXI_ADC_REG_DELAY(l)		(0x0800 + (l) * 0x4)
 
+#define AXI_ADC_DELAY_TAPS		32
+#define AXI_ADC_DELAY_MAX_LANES		16
+#define AXI_ADC_DELAY_CACHE_MAGIC	0x4144454C
+
 /******************************************************************************/
 /*************************** Types Declarations *******************************/
 /******************************************************************************/
@@ -144,6 +148,25 @@ enum axi_adc_pn_sel {
 	AXI_ADC_PN_END = 12,
 };
 
+struct axi_adc_delay_tune {
+	uint32_t num_lanes;
+	enum axi_adc_pn_sel sel;
+	/* Channel whose PN monitor checks each lane, NULL for all channels */
+	const uint8_t *lane_chan;
+	/* PN monitor dwell per tap, extended up to max while error free */
+	uint32_t dwell_min_ms;
+	uint32_t dwell_max_ms;
+	/* Grid of the common tap search */
+	uint32_t coarse_step;
+};
+
+/* Tuning result to keep in non-volatile storage between boots */
+struct axi_adc_delay_cache {
+	uint32_t magic;
+	uint32_t num_lanes;
+	uint8_t taps[AXI_ADC_DELAY_MAX_LANES];
+};
+
 /******************************************************************************/
 /************************ Functions Declarations ******************************/
 /******************************************************************************/
@@ -174,6 +197,9 @@ int32_t axi_adc_delay_set(struct axi_adc *adc,
 int32_t axi_adc_delay_calibrate(struct axi_adc *core,
 				uint32_t no_of_lanes,
 				enum axi_adc_pn_sel sel);
+int32_t axi_adc_delay_tune(struct axi_adc *adc,
+			   const struct axi_adc_delay_tune *tune,
+			   struct axi_adc_delay_cache *cache);
 int32_t axi_adc_set_calib_phase(struct axi_adc *adc,
 				uint32_t chan,
 				int32_t val,
@@ -52,6 +52,10 @@
 /******************************************************************************/
 /********************** Macros and Constants Definitions **********************/
 /******************************************************************************/
+/* Words assembled in the staging buffer before a bulk write */
+#define AXI_DAC_STAGING_WORDS			4096
+#define AXI_DAC_SET_BUFF_CHUNK			256
+
 #define AXI_DAC_REG_RSTN				0x40
 #define AXI_DAC_MMCM_RSTN				BIT(1)
 #define AXI_DAC_RSTN					BIT(0)
@@ -683,64 +687,145 @@ int32_t axi_dac_dds_get_calib_phase(struct axi_dac *dac,
 	return axi_dac_dds_get_calib_phase_scale(dac, 1, chan, val, val2);
 }
 
+/***************************************************************************//**
+ * @brief axi_dac_write_words
+ *
+ * Write a buffer of DAC words, each word repeated nb_copies times (one copy
+ * per TX channel). The copies are assembled in a staging buffer which is
+ * transferred with bulk writes, instead of one bus write per word.
+*******************************************************************************/
+static int32_t axi_dac_write_words(uint32_t address,
+				   const uint32_t *words,
+				   uint32_t count,
+				   uint8_t nb_copies)
+{
+	uint32_t *staging;
+	uint32_t staging_len;
+	uint32_t offset;
+	uint32_t index;
+	uint32_t len;
+	uint8_t copy;
+	int32_t ret;
+
+	if (nb_copies <= 1)
+		return axi_io_write_buff(address, 0, words, count);
+
+	staging_len = min(count * nb_copies, (uint32_t)AXI_DAC_STAGING_WORDS);
+	staging_len -= staging_len % nb_copies;
+	staging = (uint32_t *)malloc(staging_len * sizeof(*staging));
+	if (!staging)
+		return FAILURE;
+
+	offset = 0;
+	ret = SUCCESS;
+	while (count) {
+		len = min(count, staging_len / nb_copies);
+		for (index = 0; index < len; index++)
+			for (copy = 0; copy < nb_copies; copy++)
+				staging[index * nb_copies + copy] = words[index];
+
+		ret = axi_io_write_buff(address, offset, staging,
+					len * nb_copies);
+		if (ret != SUCCESS)
+			break;
+
+		words += len;
+		count -= len;
+		offset += len * nb_copies * sizeof(*staging);
+	}
+
+	free(staging);
+
+	return ret;
+}
+
 /***************************************************************************//**
  * @brief axi_dac_set_sine_lut
+ *
+ * Return the length of the loaded buffer in bytes, or a negative error code.
 *******************************************************************************/
-uint32_t axi_dac_set_sine_lut(struct axi_dac *dac,
-			      uint32_t address)
+int32_t axi_dac_set_sine_lut(struct axi_dac *dac,
+			     uint32_t address)
 {
-	uint32_t length;
+	uint32_t words[ARRAY_SIZE(sine_lut)];
 	uint32_t tx_count;
-	uint32_t index_mem;
+	uint32_t q_offset;
 	uint32_t index;
-	uint32_t index_i1;
-	uint32_t index_q1;
-	uint32_t index_i2;
-	uint32_t index_q2;
-	uint32_t data_i1;
-	uint32_t data_q1;
-	uint32_t data_i2;
-	uint32_t data_q2;
-	tx_count = sizeof(sine_lut) / sizeof(uint16_t);
-	if(dac->num_channels == 4) {
-		for(index = 0, index_mem = 0; index < (tx_count * 2);
-		    index += 2, index_mem += 2) {
-			index_i1 = index;
-			index_q1 = index + (tx_count / 2);
-			if(index_q1 >= (tx_count * 2))
-				index_q1 -= (tx_count * 2);
-			data_i1 = (sine_lut[index_i1 / 2] << 20);
-			data_q1 = (sine_lut[index_q1 / 2] << 4);
-
-			axi_io_write(address, index_mem * 4, data_i1 | data_q1);
-
-			index_i2 = index_i1;
-			index_q2 = index_q1;
-			if(index_i2 >= (tx_count * 2))
-				index_i2 -= (tx_count * 2);
-			if(index_q2 >= (tx_count * 2))
-				index_q2 -= (tx_count * 2);
-			data_i2 = (sine_lut[index_i2 / 2] << 20);
-			data_q2 = (sine_lut[index_q2 / 2] << 4);
-
-			axi_io_write(address, (index_mem + 1) * 4, data_i2 | data_q2);
+	int32_t ret;
+
+	tx_count = ARRAY_SIZE(sine_lut);
+	/* Q is I delayed by a quarter of period */
+	q_offset = tx_count / 4;
+	for (index = 0; index < tx_count - q_offset; index++)
+		words[index] = (sine_lut[index] << 20) |
+			       (sine_lut[index + q_offset] << 4);
+	for (; index < tx_count; index++)
+		words[index] = (sine_lut[index] << 20) |
+			       (sine_lut[index + q_offset - tx_count] << 4);
+
+	ret = axi_dac_write_words(address, words, tx_count,
+				  (dac->num_channels == 4) ? 2 : 1);
+	if (ret != SUCCESS)
+		return ret;
+
+	return tx_count * dac->num_channels * 2;
+}
 
+/***************************************************************************//**
+ * @brief axi_dac_load_iq
+ *
+ * Pack I/Q samples in DAC buffer words (I in the lower half, Q in the upper
+ * half) and load them, replicated for all the TX channels, with bulk writes.
+*******************************************************************************/
+int32_t axi_dac_load_iq(struct axi_dac *dac,
+			uint32_t address,
+			const uint16_t *data_i,
+			const uint16_t *data_q,
+			uint32_t nb_samples)
+{
+	uint32_t *staging;
+	uint32_t staging_len;
+	uint32_t index;
+	uint32_t len;
+	uint32_t offset;
+	uint8_t num_tx_channels;
+	uint8_t chan;
+	uint32_t word;
+	int32_t ret;
+
+	num_tx_channels = max(dac->num_channels / 2, 1);
+
+	staging_len = min(nb_samples * num_tx_channels,
+			  (uint32_t)AXI_DAC_STAGING_WORDS);
+	staging_len -= staging_len % num_tx_channels;
+	staging = (uint32_t *)malloc(staging_len * sizeof(*staging));
+	if (!staging)
+		return FAILURE;
+
+	offset = 0;
+	ret = SUCCESS;
+	while (nb_samples) {
+		len = min(nb_samples, staging_len / num_tx_channels);
+		for (index = 0; index < len; index++) {
+			word = data_i[index] | ((uint32_t)data_q[index] << 16);
+			for (chan = 0; chan < num_tx_channels; chan++)
+				staging[index * num_tx_channels + chan] = word;
 		}
-	} else {
-		for(index = 0; index < tx_count; index += 1) {
-			index_i1 = index;
-			index_q1 = index + (tx_count / 4);
-			if(index_q1 >= tx_count)
-				index_q1 -= tx_count;
-			data_i1 = (sine_lut[index_i1] << 20);
-			data_q1 = (sine_lut[index_q1] << 4);
-
-			axi_io_write(address, index * 4, data_i1 | data_q1);
-		}
+
+		ret = axi_io_write_buff(address, offset, staging,
+					len * num_tx_channels);
+		if (ret != SUCCESS)
+			break;
+
+		data_i += len;
+		data_q += len;
+		nb_samples -= len;
+		offset += len * num_tx_channels * sizeof(*staging);
 	}
 
-	length = tx_count * dac->num_channels * 2;
-	return length;
+	free(staging);
+
+	return ret;
 }
 
 /***************************************************************************//**
@@ -751,15 +836,26 @@ int32_t axi_dac_set_buff(struct axi_dac *dac,
 			 uint16_t *buff,
 			 uint32_t buff_size)
 {
+	uint32_t staging[AXI_DAC_SET_BUFF_CHUNK];
+	uint32_t offset;
 	uint32_t index;
-	uint32_t data_i;
-	uint32_t data_q;
-
-	for(index = 0; index < buff_size; index += 2) {
-		data_i = (buff[index]);
-		data_q = (buff[index + 1] << 16);
-
-		axi_io_write(address, index * 2, data_i | data_q);
+	uint32_t len;
+	int32_t ret;
+
+	offset = 0;
+	while (buff_size >= 2) {
+		len = min(buff_size / 2, (uint32_t)AXI_DAC_SET_BUFF_CHUNK);
+		for (index = 0; index < len; index++)
+			staging[index] = buff[2 * index] |
+					 ((uint32_t)buff[2 * index + 1] << 16);
+
+		ret = axi_io_write_buff(address, offset, staging, len);
+		if (ret != SUCCESS)
+			return ret;
+
+		buff += 2 * len;
+		buff_size -= 2 * len;
+		offset += len * sizeof(uint32_t);
 	}
 
 	return SUCCESS;
@@ -773,20 +869,15 @@ int32_t axi_dac_load_custom_data(struct axi_dac *dac,
 				 uint32_t custom_tx_count,
 				 uint32_t address)
 {
-	uint32_t index, index_mem = 0;
 	uint8_t chan;
 	uint8_t num_tx_channels = dac->num_channels / 2;
+	int32_t ret;
 
-	for(index = 0; index < custom_tx_count; index++) {
-		/* Send the same data on all the channels */
-		for (chan = 0; chan < num_tx_channels; chan++) {
-
-			axi_io_write(address, index_mem * sizeof(uint32_t),
-				     custom_data_iq[index]);
-
-			index_mem++;
-		}
-	}
+	/* Send the same data on all the channels */
+	ret = axi_dac_write_words(address, custom_data_iq, custom_tx_count,
+				  num_tx_channels);
+	if (ret != SUCCESS)
+		return ret;
 
 	for (chan = 0; chan < dac->num_channels; chan++) {
 		axi_dac_write(dac, AXI_DAC_REG_DATA_SELECT((chan*2)+0), 0x2);
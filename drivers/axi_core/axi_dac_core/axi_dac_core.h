@@ -114,8 +114,13 @@ int32_t axi_dac_set_buff(struct axi_dac *dac,
 			 uint32_t address,
 			 uint16_t *buff,
 			 uint32_t buff_size);
-uint32_t axi_dac_set_sine_lut(struct axi_dac *dac,
-			      uint32_t address);
+int32_t axi_dac_set_sine_lut(struct axi_dac *dac,
+			     uint32_t address);
+int32_t axi_dac_load_iq(struct axi_dac *dac,
+			uint32_t address,
+			const uint16_t *data_i,
+			const uint16_t *data_q,
+			uint32_t nb_samples);
 int32_t axi_dac_dds_get_calib_scale(struct axi_dac *dac,
 				    uint32_t chan,
 				    int32_t *val,
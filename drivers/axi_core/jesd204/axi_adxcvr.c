@@ -304,6 +304,145 @@ int32_t adxcvr_clk_disable(struct adxcvr *xcvr)
 	return SUCCESS;
 }
 
+/**
+ * @brief adxcvr_set_lpm_dfe_mode
+ *
+ * Switch the receiver equalizer of all lanes and reset the transceiver,
+ * the link has to be brought up again afterwards.
+ */
+static int32_t adxcvr_set_lpm_dfe_mode(struct adxcvr *xcvr, bool lpm)
+{
+	uint32_t i, val, out_div;
+	int32_t ret;
+
+	adxcvr_write(xcvr, ADXCVR_REG_RESETN, 0);
+
+	adxcvr_read(xcvr, ADXCVR_REG_CONTROL, &val);
+	if (lpm)
+		val |= ADXCVR_LPM_DFE_N;
+	else
+		val &= ~ADXCVR_LPM_DFE_N;
+	adxcvr_write(xcvr, ADXCVR_REG_CONTROL, val);
+
+	for (i = 0; i < xcvr->num_lanes; i++) {
+		xilinx_xcvr_configure_lpm_dfe_mode(&xcvr->xlx_xcvr,
+						   ADXCVR_DRP_PORT_CHANNEL(i), lpm);
+
+		if (!xcvr->lane_rate_khz)
+			continue;
+
+		ret = xilinx_xcvr_read_out_div(&xcvr->xlx_xcvr,
+					       ADXCVR_DRP_PORT_CHANNEL(i),
+					       &out_div, NULL);
+		if (ret < 0)
+			return ret;
+
+		ret = xilinx_xcvr_configure_cdr(&xcvr->xlx_xcvr,
+						ADXCVR_DRP_PORT_CHANNEL(i),
+						xcvr->lane_rate_khz, out_div, lpm);
+		if (ret < 0)
+			return ret;
+	}
+
+	xcvr->lpm_enable = lpm;
+
+	return adxcvr_clk_enable(xcvr);
+}
+
+/**
+ * @brief adxcvr_eyescan
+ *
+ * Statistical eye scan of one receive lane in the current equalizer mode.
+ * See xilinx_xcvr_eyescan(), the map has to be released with
+ * xilinx_xcvr_eyescan_free().
+ */
+int32_t adxcvr_eyescan(struct adxcvr *xcvr, uint32_t lane,
+		       const struct xilinx_xcvr_eyescan_config *conf,
+		       struct xilinx_xcvr_eyescan_map *map)
+{
+	struct xilinx_xcvr_eyescan_config es_conf = *conf;
+	uint32_t out_div;
+	int32_t ret;
+
+	if (xcvr->tx_enable || lane >= xcvr->num_lanes)
+		return FAILURE;
+
+	ret = xilinx_xcvr_read_out_div(&xcvr->xlx_xcvr,
+				       ADXCVR_DRP_PORT_CHANNEL(lane),
+				       &out_div, NULL);
+	if (ret < 0)
+		return ret;
+
+	es_conf.lpm = xcvr->lpm_enable;
+
+	return xilinx_xcvr_eyescan(&xcvr->xlx_xcvr, ADXCVR_DRP_PORT_CHANNEL(lane),
+				   out_div, &es_conf, map);
+}
+
+/**
+ * @brief adxcvr_lpm_dfe_select
+ *
+ * Scan every lane in LPM and in DFE mode, settle_ms after the transceiver
+ * reset for the equalizer to adapt, and keep the mode whose worst lane has
+ * the larger error free area. The current mode wins ties. The link is
+ * interrupted by the mode switches and has to be brought up again
+ * afterwards.
+ */
+int32_t adxcvr_lpm_dfe_select(struct adxcvr *xcvr,
+			      const struct xilinx_xcvr_eyescan_config *conf,
+			      uint32_t settle_ms)
+{
+	struct xilinx_xcvr_eyescan_map map;
+	uint32_t area[2], mode, lane;
+	bool lpm[2];
+	int32_t ret;
+
+	if (xcvr->tx_enable)
+		return FAILURE;
+
+	/* Current mode first, it saves a switch when it stays */
+	lpm[0] = xcvr->lpm_enable;
+	lpm[1] = !xcvr->lpm_enable;
+
+	for (mode = 0; mode < 2; mode++) {
+		if (mode) {
+			ret = adxcvr_set_lpm_dfe_mode(xcvr, lpm[mode]);
+			if (ret < 0)
+				goto restore;
+		}
+
+		mdelay(settle_ms);
+
+		area[mode] = UINT32_MAX;
+		for (lane = 0; lane < xcvr->num_lanes; lane++) {
+			ret = adxcvr_eyescan(xcvr, lane, conf, &map);
+			if (ret < 0)
+				goto restore;
+
+			area[mode] = min(area[mode], map.open_area);
+			xilinx_xcvr_eyescan_free(&map);
+		}
+
+		printf("%s: %s: worst lane open area %"PRIu32"\n", xcvr->name,
+		       lpm[mode] ? "LPM" : "DFE", area[mode]);
+	}
+
+	if (area[1] > area[0]) {
+		printf("%s: %s mode selected\n", xcvr->name, lpm[1] ? "LPM" : "DFE");
+		return SUCCESS;
+	}
+
+	ret = SUCCESS;
+restore:
+	if (xcvr->lpm_enable != lpm[0])
+		adxcvr_set_lpm_dfe_mode(xcvr, lpm[0]);
+
+	if (!ret)
+		printf("%s: %s mode selected\n", xcvr->name, lpm[0] ? "LPM" : "DFE");
+
+	return ret;
+}
+
 /**
  * @brief adxcvr_get_info
  */
@@ -94,4 +94,10 @@ int32_t adxcvr_remove(struct adxcvr *xcvr);
 int32_t adxcvr_clk_set_rate(struct adxcvr *xcvr,
 			    uint32_t rate,
 			    uint32_t parent_rate);
+int32_t adxcvr_eyescan(struct adxcvr *xcvr, uint32_t lane,
+		       const struct xilinx_xcvr_eyescan_config *conf,
+		       struct xilinx_xcvr_eyescan_map *map);
+int32_t adxcvr_lpm_dfe_select(struct adxcvr *xcvr,
+			      const struct xilinx_xcvr_eyescan_config *conf,
+			      uint32_t settle_ms);
 #endif
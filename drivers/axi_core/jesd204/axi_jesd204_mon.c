@@ -0,0 +1,381 @@
+/***************************************************************************//**
+ *   @file   axi_jesd204_mon.c
+ *   @brief  Non-blocking link monitor for the AXI-JESD204 RX/TX peripherals.
+********************************************************************************
+ * Copyright 2021(c) Analog Devices, Inc.
+ *
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *  - Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ *  - Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ *  - Neither the name of Analog Devices, Inc. nor the names of its
+ *    contributors may be used to endorse or promote products derived
+ *    from this software without specific prior written permission.
+ *  - The use of this software may or may not infringe the patent rights
+ *    of one or more patent holders.  This license does not release you
+ *    from the requirement that you obtain separate licenses from these
+ *    patent holders to use this software.
+ *  - Use of the software either in source or binary form, must be run
+ *    on or directly connected to an Analog Devices Inc. component.
+ *
+ * THIS SOFTWARE IS PROVIDED BY ANALOG DEVICES "AS IS" AND ANY EXPRESS OR
+ * IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, NON-INFRINGEMENT,
+ * MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED.
+ * IN NO EVENT SHALL ANALOG DEVICES BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, INTELLECTUAL PROPERTY RIGHTS, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*******************************************************************************/
+/******************************************************************************/
+/***************************** Include Files **********************************/
+/******************************************************************************/
+#include <stdlib.h>
+#include <string.h>
+#include "error.h"
+#include "util.h"
+#include "axi_jesd204_mon.h"
+
+/******************************************************************************/
+/********************** Macros and Constants Definitions **********************/
+/******************************************************************************/
+#define JESD204_LINK_STATUS_DATA	0x3
+
+static const char *axi_jesd204_mon_state_label[] = {
+	"disabled",
+	"down",
+	"up",
+	"restart",
+};
+
+static const char *axi_jesd204_mon_event_label[] = {
+	"link_up",
+	"link_down",
+	"lane_desync",
+	"ilas_missing",
+	"restart",
+};
+
+/******************************************************************************/
+/************************** Functions Implementation **************************/
+/******************************************************************************/
+
+/**
+ * @brief axi_jesd204_mon_event
+ */
+static void axi_jesd204_mon_event(struct axi_jesd204_mon *mon, uint32_t now,
+				  enum axi_jesd204_mon_event_type type,
+				  uint8_t lane)
+{
+	struct axi_jesd204_mon_event *evt;
+
+	evt = &mon->history[mon->nb_events % AXI_JESD204_MON_HISTORY];
+	evt->time_ms = now;
+	evt->type = type;
+	evt->lane = lane;
+	mon->nb_events++;
+}
+
+/**
+ * @brief axi_jesd204_mon_set_state
+ */
+static void axi_jesd204_mon_set_state(struct axi_jesd204_mon *mon,
+				      uint32_t now,
+				      enum axi_jesd204_mon_state state)
+{
+	if (mon->state == AXI_JESD204_MON_UP) {
+		mon->up_ms += now - mon->state_ms;
+		mon->link_losses++;
+		axi_jesd204_mon_event(mon, now, AXI_JESD204_MON_EVT_LINK_DOWN, 0);
+	}
+	if (state == AXI_JESD204_MON_UP) {
+		mon->link_ups++;
+		axi_jesd204_mon_event(mon, now, AXI_JESD204_MON_EVT_LINK_UP, 0);
+	}
+
+	mon->state = state;
+	mon->state_ms = now;
+}
+
+/**
+ * @brief axi_jesd204_mon_link_enable
+ */
+static void axi_jesd204_mon_link_enable(struct axi_jesd204_mon *mon,
+					bool enable)
+{
+	if (mon->rx && enable)
+		axi_jesd204_rx_lane_clk_enable(mon->rx);
+	else if (mon->rx)
+		axi_jesd204_rx_lane_clk_disable(mon->rx);
+	else if (enable)
+		axi_jesd204_tx_lane_clk_enable(mon->tx);
+	else
+		axi_jesd204_tx_lane_clk_disable(mon->tx);
+}
+
+/**
+ * @brief Disable the link, it is enabled again by a later poll.
+ */
+static void axi_jesd204_mon_restart(struct axi_jesd204_mon *mon, uint32_t now)
+{
+	axi_jesd204_mon_link_enable(mon, false);
+	axi_jesd204_mon_set_state(mon, now, AXI_JESD204_MON_RESTART);
+	mon->restarts++;
+	axi_jesd204_mon_event(mon, now, AXI_JESD204_MON_EVT_RESTART, 0);
+}
+
+/**
+ * @brief Update the lane statistics of an RX link.
+ * @param mon - The monitor descriptor.
+ * @param now - Current time in ms.
+ * @param up - The link is going up in this poll.
+ * @return true if all lanes are synchronized.
+ */
+static bool axi_jesd204_mon_rx_lanes(struct axi_jesd204_mon *mon, uint32_t now,
+				     bool up)
+{
+	struct axi_jesd204_mon_lane *lane;
+	bool synced, ilas, all_synced = true;
+	uint32_t errors;
+	uint32_t i;
+
+	for (i = 0; i < mon->num_lanes; i++) {
+		lane = &mon->lanes[i];
+
+		if (axi_jesd204_rx_get_lane_errors(mon->rx, i, &errors) == SUCCESS) {
+			/* the core counter is cleared on link reset */
+			lane->errors += errors >= lane->hw_errors ?
+					errors - lane->hw_errors : errors;
+			lane->hw_errors = errors;
+		}
+
+		axi_jesd204_rx_get_lane_state(mon->rx, i, &synced, &ilas);
+		if (!synced) {
+			if (mon->state == AXI_JESD204_MON_UP) {
+				lane->desyncs++;
+				axi_jesd204_mon_event(mon, now,
+						      AXI_JESD204_MON_EVT_LANE_DESYNC,
+						      i);
+			}
+			all_synced = false;
+		} else if (up && !ilas) {
+			lane->ilas_missing++;
+			axi_jesd204_mon_event(mon, now,
+					      AXI_JESD204_MON_EVT_ILAS_MISSING, i);
+		}
+	}
+
+	return all_synced;
+}
+
+/**
+ * @brief Check the link and advance the restart state machine. Meant to be
+ * called periodically from the main loop or from a timer interrupt, it never
+ * blocks and does not print. When it runs from an interrupt, the other calls
+ * on the monitor must be made with that interrupt masked.
+ * @param mon - The monitor descriptor.
+ * @return SUCCESS in case of success, negative error code otherwise.
+ */
+int32_t axi_jesd204_mon_poll(struct axi_jesd204_mon *mon)
+{
+	uint32_t link_disabled;
+	uint32_t link_status;
+	bool data, synced;
+	uint32_t now;
+
+	if (!mon)
+		return -EINVAL;
+
+	now = mon->get_time_ms();
+	if (mon->period_ms && now - mon->poll_ms < mon->period_ms)
+		return SUCCESS;
+	mon->poll_ms = now;
+
+	if (mon->state == AXI_JESD204_MON_RESTART) {
+		if (now - mon->state_ms < mon->restart_ms)
+			return SUCCESS;
+		axi_jesd204_mon_link_enable(mon, true);
+		axi_jesd204_mon_set_state(mon, now, AXI_JESD204_MON_DOWN);
+
+		return SUCCESS;
+	}
+
+	if (mon->rx)
+		axi_jesd204_rx_get_link_state(mon->rx, &link_disabled,
+					      &link_status);
+	else
+		axi_jesd204_tx_get_link_state(mon->tx, &link_disabled,
+					      &link_status);
+
+	if (link_disabled) {
+		if (mon->state != AXI_JESD204_MON_DISABLED)
+			axi_jesd204_mon_set_state(mon, now,
+						  AXI_JESD204_MON_DISABLED);
+		return SUCCESS;
+	}
+	if (mon->state == AXI_JESD204_MON_DISABLED)
+		axi_jesd204_mon_set_state(mon, now, AXI_JESD204_MON_DOWN);
+
+	data = (link_status & 0x3) == JESD204_LINK_STATUS_DATA;
+	synced = true;
+	if (mon->rx && data)
+		synced = axi_jesd204_mon_rx_lanes(mon, now,
+						  mon->state == AXI_JESD204_MON_DOWN);
+
+	if (mon->state == AXI_JESD204_MON_UP) {
+		/* a lane that lost sync needs the link to be reset */
+		if (!synced)
+			axi_jesd204_mon_restart(mon, now);
+		else if (!data)
+			axi_jesd204_mon_set_state(mon, now,
+						  AXI_JESD204_MON_DOWN);
+	} else if (data && synced) {
+		axi_jesd204_mon_set_state(mon, now, AXI_JESD204_MON_UP);
+	} else if (mon->up_timeout_ms &&
+		   now - mon->state_ms >= mon->up_timeout_ms) {
+		axi_jesd204_mon_restart(mon, now);
+	}
+
+	return SUCCESS;
+}
+
+/**
+ * @brief Time since the link came up.
+ * @param mon - The monitor descriptor.
+ * @return Up time in ms, 0 if the link is not up.
+ */
+uint32_t axi_jesd204_mon_uptime_ms(struct axi_jesd204_mon *mon)
+{
+	if (!mon || mon->state != AXI_JESD204_MON_UP)
+		return 0;
+
+	return mon->get_time_ms() - mon->state_ms;
+}
+
+/**
+ * @brief axi_jesd204_mon_state_name
+ */
+const char *axi_jesd204_mon_state_name(enum axi_jesd204_mon_state state)
+{
+	if (state >= ARRAY_SIZE(axi_jesd204_mon_state_label))
+		return "unknown";
+
+	return axi_jesd204_mon_state_label[state];
+}
+
+/**
+ * @brief axi_jesd204_mon_event_name
+ */
+const char *axi_jesd204_mon_event_name(enum axi_jesd204_mon_event_type type)
+{
+	if (type >= ARRAY_SIZE(axi_jesd204_mon_event_label))
+		return "unknown";
+
+	return axi_jesd204_mon_event_label[type];
+}
+
+/**
+ * @brief Clear the statistics and the event history. The error counters of
+ * the core are left untouched.
+ * @param mon - The monitor descriptor.
+ * @return SUCCESS in case of success, negative error code otherwise.
+ */
+int32_t axi_jesd204_mon_clear(struct axi_jesd204_mon *mon)
+{
+	uint32_t now, i;
+
+	if (!mon)
+		return -EINVAL;
+
+	now = mon->get_time_ms();
+	for (i = 0; i < mon->num_lanes; i++) {
+		mon->lanes[i].errors = 0;
+		mon->lanes[i].desyncs = 0;
+		mon->lanes[i].ilas_missing = 0;
+	}
+	mon->link_ups = 0;
+	mon->link_losses = 0;
+	mon->restarts = 0;
+	mon->up_ms = 0;
+	mon->nb_events = 0;
+	if (mon->state == AXI_JESD204_MON_UP)
+		mon->state_ms = now;
+
+	return SUCCESS;
+}
+
+/**
+ * @brief Initialize the link monitor. The current link state is taken as
+ * the starting point, the link is not reset.
+ * @param mon - The monitor descriptor.
+ * @param param - The structure that contains the monitor parameters.
+ * @return SUCCESS in case of success, negative error code otherwise.
+ */
+int32_t axi_jesd204_mon_init(struct axi_jesd204_mon **mon,
+			     const struct axi_jesd204_mon_init_param *param)
+{
+	struct axi_jesd204_mon *m;
+	uint32_t i;
+
+	if (!mon || !param || !param->get_time_ms || !param->rx == !param->tx)
+		return -EINVAL;
+
+	m = (struct axi_jesd204_mon *)calloc(1, sizeof(*m));
+	if (!m)
+		return -ENOMEM;
+
+	m->rx = param->rx;
+	m->tx = param->tx;
+	m->name = param->rx ? param->rx->name : param->tx->name;
+	m->num_lanes = param->rx ? param->rx->num_lanes : param->tx->num_lanes;
+	m->get_time_ms = param->get_time_ms;
+	m->period_ms = param->period_ms;
+	m->restart_ms = param->restart_ms ? param->restart_ms :
+			AXI_JESD204_MON_RESTART_MS;
+	m->up_timeout_ms = param->up_timeout_ms;
+
+	m->lanes = (struct axi_jesd204_mon_lane *)calloc(m->num_lanes,
+			sizeof(*m->lanes));
+	if (!m->lanes) {
+		free(m);
+		return -ENOMEM;
+	}
+
+	/* count only the errors seen from now on */
+	if (m->rx)
+		for (i = 0; i < m->num_lanes; i++)
+			axi_jesd204_rx_get_lane_errors(m->rx, i,
+						       &m->lanes[i].hw_errors);
+
+	m->state = AXI_JESD204_MON_DISABLED;
+	m->state_ms = m->get_time_ms();
+	m->poll_ms = m->state_ms - m->period_ms;
+
+	*mon = m;
+
+	return axi_jesd204_mon_poll(m);
+}
+
+/**
+ * @brief Free the resources allocated by axi_jesd204_mon_init().
+ * @param mon - The monitor descriptor.
+ * @return SUCCESS in case of success, negative error code otherwise.
+ */
+int32_t axi_jesd204_mon_remove(struct axi_jesd204_mon *mon)
+{
+	if (!mon)
+		return -EINVAL;
+
+	free(mon->lanes);
+	free(mon);
+
+	return SUCCESS;
+}
@@ -0,0 +1,196 @@
+/***************************************************************************//**
+ *   @file   axi_jesd204_mon.h
+ *   @brief  Non-blocking link monitor for the AXI-JESD204 RX/TX peripherals.
+********************************************************************************
+ * Copyright 2021(c) Analog Devices, Inc.
+ *
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *  - Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ *  - Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ *  - Neither the name of Analog Devices, Inc. nor the names of its
+ *    contributors may be used to endorse or promote products derived
+ *    from this software without specific prior written permission.
+ *  - The use of this software may or may not infringe the patent rights
+ *    of one or more patent holders.  This license does not release you
+ *    from the requirement that you obtain separate licenses from these
+ *    patent holders to use this software.
+ *  - Use of the software either in source or binary form, must be run
+ *    on or directly connected to an Analog Devices Inc. component.
+ *
+ * THIS SOFTWARE IS PROVIDED BY ANALOG DEVICES "AS IS" AND ANY EXPRESS OR
+ * IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, NON-INFRINGEMENT,
+ * MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED.
+ * IN NO EVENT SHALL ANALOG DEVICES BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, INTELLECTUAL PROPERTY RIGHTS, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*******************************************************************************/
+#ifndef AXI_JESD204_MON_H_
+#define AXI_JESD204_MON_H_
+
+/******************************************************************************/
+/***************************** Include Files **********************************/
+/******************************************************************************/
+#include <stdint.h>
+#include <stdbool.h>
+#include "axi_jesd204_rx.h"
+#include "axi_jesd204_tx.h"
+
+/******************************************************************************/
+/********************** Macros and Constants Definitions **********************/
+/******************************************************************************/
+/* Number of link events kept in the history */
+#define AXI_JESD204_MON_HISTORY		16
+/* Default time the link is held disabled on restart */
+#define AXI_JESD204_MON_RESTART_MS	100
+
+/******************************************************************************/
+/*************************** Types Declarations *******************************/
+/******************************************************************************/
+/* Link monitor state */
+enum axi_jesd204_mon_state {
+	/* Link disabled by software or held in external reset */
+	AXI_JESD204_MON_DISABLED,
+	/* Link enabled, waiting for DATA */
+	AXI_JESD204_MON_DOWN,
+	/* Link in DATA, all lanes synchronized */
+	AXI_JESD204_MON_UP,
+	/* Link disabled by the monitor, re-enabled after restart_ms */
+	AXI_JESD204_MON_RESTART,
+};
+
+/* Link events recorded in the history */
+enum axi_jesd204_mon_event_type {
+	AXI_JESD204_MON_EVT_LINK_UP,
+	AXI_JESD204_MON_EVT_LINK_DOWN,
+	/* Lane lost code group sync (8b10b) or multiblock lock (64b66b) */
+	AXI_JESD204_MON_EVT_LANE_DESYNC,
+	/* Lane came up without a valid ILAS */
+	AXI_JESD204_MON_EVT_ILAS_MISSING,
+	AXI_JESD204_MON_EVT_RESTART,
+};
+
+/**
+ * @struct axi_jesd204_mon_event
+ * @brief One entry of the link event history.
+ */
+struct axi_jesd204_mon_event {
+	/** Time of the event, in ms */
+	uint32_t time_ms;
+	/** enum axi_jesd204_mon_event_type */
+	uint8_t type;
+	/** Lane the event refers to, if any */
+	uint8_t lane;
+};
+
+/**
+ * @struct axi_jesd204_mon_lane
+ * @brief Per lane statistics.
+ */
+struct axi_jesd204_mon_lane {
+	/** Errors counted since the monitor was started or cleared */
+	uint32_t errors;
+	/** Last value of the core error counter */
+	uint32_t hw_errors;
+	/** Number of code group sync / multiblock lock losses */
+	uint32_t desyncs;
+	/** Number of link ups without a valid ILAS on this lane */
+	uint32_t ilas_missing;
+};
+
+/**
+ * @struct axi_jesd204_mon_init_param
+ * @brief Link monitor initialization parameters. Exactly one of rx and tx
+ * must be set.
+ */
+struct axi_jesd204_mon_init_param {
+	/** RX link to monitor */
+	struct axi_jesd204_rx *rx;
+	/** TX link to monitor */
+	struct axi_jesd204_tx *tx;
+	/** Free running time source in ms */
+	uint32_t (*get_time_ms)(void);
+	/** Minimum time between two link checks in ms, 0 checks on every
+	 *  axi_jesd204_mon_poll() call */
+	uint32_t period_ms;
+	/** Time the link is held disabled on restart in ms, 0 for
+	 *  AXI_JESD204_MON_RESTART_MS */
+	uint32_t restart_ms;
+	/** Restart the link if it does not come up within this time in ms,
+	 *  0 to never restart a link that is down */
+	uint32_t up_timeout_ms;
+};
+
+/**
+ * @struct axi_jesd204_mon
+ * @brief Link monitor descriptor.
+ */
+struct axi_jesd204_mon {
+	/** RX link */
+	struct axi_jesd204_rx *rx;
+	/** TX link */
+	struct axi_jesd204_tx *tx;
+	/** Link name */
+	const char *name;
+	/** Time source in ms */
+	uint32_t (*get_time_ms)(void);
+	/** Minimum time between two link checks in ms */
+	uint32_t period_ms;
+	/** Time the link is held disabled on restart in ms */
+	uint32_t restart_ms;
+	/** Restart timeout of a link that is down, 0 if disabled */
+	uint32_t up_timeout_ms;
+	/** Current state */
+	enum axi_jesd204_mon_state state;
+	/** Time the current state was entered, in ms */
+	uint32_t state_ms;
+	/** Time of the last link check, in ms */
+	uint32_t poll_ms;
+	/** Number of lanes */
+	uint32_t num_lanes;
+	/** Per lane statistics */
+	struct axi_jesd204_mon_lane *lanes;
+	/** Number of times the link went up */
+	uint32_t link_ups;
+	/** Number of times the link was lost */
+	uint32_t link_losses;
+	/** Number of restarts issued by the monitor */
+	uint32_t restarts;
+	/** Up time of the previous link ups, in ms */
+	uint32_t up_ms;
+	/** Event history, a ring of the last AXI_JESD204_MON_HISTORY events */
+	struct axi_jesd204_mon_event history[AXI_JESD204_MON_HISTORY];
+	/** Number of events recorded since the monitor was started or cleared */
+	uint32_t nb_events;
+};
+
+/******************************************************************************/
+/************************ Functions Declarations ******************************/
+/******************************************************************************/
+/* Initialize the link monitor. */
+int32_t axi_jesd204_mon_init(struct axi_jesd204_mon **mon,
+			     const struct axi_jesd204_mon_init_param *param);
+/* Check the link and advance the restart state machine, never blocks. */
+int32_t axi_jesd204_mon_poll(struct axi_jesd204_mon *mon);
+/* Time since the link came up, 0 if it is not up. */
+uint32_t axi_jesd204_mon_uptime_ms(struct axi_jesd204_mon *mon);
+/* Name of a monitor state. */
+const char *axi_jesd204_mon_state_name(enum axi_jesd204_mon_state state);
+/* Name of an event type. */
+const char *axi_jesd204_mon_event_name(enum axi_jesd204_mon_event_type type);
+/* Clear the statistics and the event history. */
+int32_t axi_jesd204_mon_clear(struct axi_jesd204_mon *mon);
+/* Free the resources allocated by axi_jesd204_mon_init(). */
+int32_t axi_jesd204_mon_remove(struct axi_jesd204_mon *mon);
+
+#endif
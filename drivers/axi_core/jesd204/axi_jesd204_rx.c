@@ -266,9 +266,56 @@ uint32_t axi_jesd204_rx_status_read(struct axi_jesd204_rx *jesd)
 int32_t axi_jesd204_rx_get_lane_errors(struct axi_jesd204_rx *jesd,
 				       uint32_t lane, uint32_t *errors)
 {
+	if (PCORE_VERSION_MINOR(jesd->version) < 2)
+		return FAILURE;
+
 	return axi_jesd204_rx_read(jesd, JESD204_RX_REG_LANE_ERRORS(lane), errors);
 }
 
+/**
+ * @brief axi_jesd204_rx_get_link_state
+ */
+int32_t axi_jesd204_rx_get_link_state(struct axi_jesd204_rx *jesd,
+				      uint32_t *link_disabled,
+				      uint32_t *link_status)
+{
+	axi_jesd204_rx_read(jesd, JESD204_RX_REG_LINK_STATE, link_disabled);
+
+	return axi_jesd204_rx_read(jesd, JESD204_RX_REG_LINK_STATUS, link_status);
+}
+
+/**
+ * @brief axi_jesd204_rx_lane_synced
+ */
+static bool axi_jesd204_rx_lane_synced(struct axi_jesd204_rx *jesd,
+				       uint32_t status)
+{
+	if (jesd->encoder == JESD204_RX_ENCODER_8B10B)
+		return (status & 0x3) != 0x0;
+
+	status = JESD204_EMB_STATE_GET(status);
+
+	return status > JESD204_EMB_STATE_INIT &&
+	       status <= JESD204_EMB_STATE_LOCK;
+}
+
+/**
+ * @brief axi_jesd204_rx_get_lane_state
+ */
+int32_t axi_jesd204_rx_get_lane_state(struct axi_jesd204_rx *jesd,
+				      uint32_t lane, bool *synced, bool *ilas)
+{
+	uint32_t status;
+
+	axi_jesd204_rx_read(jesd, JESD204_RX_REG_LANE_STATUS(lane), &status);
+
+	*synced = axi_jesd204_rx_lane_synced(jesd, status);
+	/* there is no ILAS with 64b66b */
+	*ilas = jesd->encoder != JESD204_RX_ENCODER_8B10B || (status & BIT(5));
+
+	return SUCCESS;
+}
+
 /**
  * @brief axi_jesd204_rx_laneinfo_8b10b_read
  */
@@ -404,16 +451,8 @@ bool axi_jesd204_rx_check_lane_status(struct axi_jesd204_rx *jesd,
 
 	axi_jesd204_rx_read(jesd, JESD204_RX_REG_LANE_STATUS(lane), &status);
 
-	if (jesd->encoder == JESD204_RX_ENCODER_8B10B) {
-		status &= 0x3;
-		if (status != 0x0)
-			return false;
-	} else {
-		status = JESD204_EMB_STATE_GET(status);
-		if (status > JESD204_EMB_STATE_INIT &&
-		    status <= JESD204_EMB_STATE_LOCK)
-			return false;
-	}
+	if (axi_jesd204_rx_lane_synced(jesd, status))
+		return false;
 
 	if (PCORE_VERSION_MINOR(jesd->version) >= 2) {
 		axi_jesd204_rx_read(jesd, JESD204_RX_REG_LANE_ERRORS(lane), &errors);
@@ -136,6 +136,18 @@ int32_t axi_jesd204_tx_lane_clk_disable(struct axi_jesd204_tx *jesd)
 	return axi_jesd204_tx_write(jesd, JESD204_TX_REG_LINK_DISABLE, 0x1);
 }
 
+/**
+ * @brief axi_jesd204_tx_get_link_state
+ */
+int32_t axi_jesd204_tx_get_link_state(struct axi_jesd204_tx *jesd,
+				      uint32_t *link_disabled,
+				      uint32_t *link_status)
+{
+	axi_jesd204_tx_read(jesd, JESD204_TX_REG_LINK_STATE, link_disabled);
+
+	return axi_jesd204_tx_read(jesd, JESD204_TX_REG_LINK_STATUS, link_status);
+}
+
 /**
  * @brief axi_jesd204_tx_status_read
  */
@@ -106,6 +106,9 @@ struct jesd204_tx_init {
 int32_t axi_jesd204_tx_lane_clk_enable(struct axi_jesd204_tx *jesd);
 int32_t axi_jesd204_tx_lane_clk_disable(struct axi_jesd204_tx *jesd);
 uint32_t axi_jesd204_tx_status_read(struct axi_jesd204_tx *jesd);
+int32_t axi_jesd204_tx_get_link_state(struct axi_jesd204_tx *jesd,
+				      uint32_t *link_disabled,
+				      uint32_t *link_status);
 int32_t axi_jesd204_tx_init(struct axi_jesd204_tx **jesd204,
 			    const struct jesd204_tx_init *init);
 int32_t axi_jesd204_tx_remove(struct axi_jesd204_tx *jesd);
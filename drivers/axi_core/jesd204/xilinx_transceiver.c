@@ -46,6 +46,7 @@
 #include <inttypes.h>
 #include "util.h"
 #include "error.h"
+#include "delay.h"
 #include "axi_adxcvr.h"
 #include "xilinx_transceiver.h"
 
@@ -106,6 +107,82 @@
 #define TX_CLK25_DIV			0x6a
 #define TX_CLK25_DIV_MASK		0x1f
 
+#define ES_CONTROL_MASK			0xfc00
+#define ES_CONTROL_RUN			BIT(10)
+
+#define ES_STATUS_DONE			BIT(0)
+#define ES_STATUS_STATE(x)		(((x) >> 1) & 0x7)
+#define ES_STATUS_STATE_END		0x2
+
+#define ES_MASK_REGS			5
+#define ES_VERT_MAX			127
+
+/*
+ * Statistical eye scan DRP map (UG476, UG576, UG578). The
+ * horizontal offset is a 12-bit two's complement field on all types,
+ * bit 11 doubling as the GTH/GTY phase unification bit. The vertical
+ * offset is a sign-magnitude DAC code with an unrolled tap sign bit.
+ */
+struct xilinx_xcvr_es_regs {
+	uint32_t control;
+	uint32_t prescale;
+	uint32_t prescale_mask;
+	uint32_t prescale_shift;
+	uint32_t qual_mask;
+	uint32_t sdata_mask;
+	uint32_t horz;
+	uint32_t horz_mask;
+	uint32_t horz_shift;
+	uint32_t vert;
+	uint32_t vert_mask;
+	uint32_t vert_shift;
+	uint32_t vert_neg;
+	uint32_t vert_ut_sign;
+	uint32_t error_count;
+	uint32_t sample_count;
+	uint32_t status;
+};
+
+static const struct xilinx_xcvr_es_regs xilinx_xcvr_gtx2_es_regs = {
+	.control = 0x03d,
+	.prescale = 0x03b,
+	.prescale_mask = 0xf800,
+	.prescale_shift = 11,
+	.qual_mask = 0x031,
+	.sdata_mask = 0x036,
+	.horz = 0x03c,
+	.horz_mask = 0x0fff,
+	.horz_shift = 0,
+	.vert = 0x03b,
+	.vert_mask = 0x01ff,
+	.vert_shift = 0,
+	.vert_neg = BIT(7),
+	.vert_ut_sign = BIT(8),
+	.error_count = 0x14f,
+	.sample_count = 0x150,
+	.status = 0x151,
+};
+
+static const struct xilinx_xcvr_es_regs xilinx_xcvr_gth34_es_regs = {
+	.control = 0x03c,
+	.prescale = 0x03c,
+	.prescale_mask = 0x001f,
+	.prescale_shift = 0,
+	.qual_mask = 0x044,
+	.sdata_mask = 0x049,
+	.horz = 0x04f,
+	.horz_mask = 0xfff0,
+	.horz_shift = 4,
+	.vert = 0x097,
+	.vert_mask = 0x07fc,
+	.vert_shift = 2,
+	.vert_neg = BIT(8),
+	.vert_ut_sign = BIT(7),
+	.error_count = 0x151,
+	.sample_count = 0x152,
+	.status = 0x153,
+};
+
 /**
  * @brief xilinx_xcvr_write
  */
@@ -1143,9 +1220,9 @@ int32_t xilinx_xcvr_gtx2_read_out_div(struct xilinx_xcvr *xcvr,
 		return ret;
 
 	if (rx_out_div)
-		*rx_out_div = 1 << ((ret >> OUT_DIV_RX_OFFSET) & 7);
+		*rx_out_div = 1 << ((val >> OUT_DIV_RX_OFFSET) & 7);
 	if (tx_out_div)
-		*tx_out_div = 1 << ((ret >> OUT_DIV_TX_OFFSET) & 7);
+		*tx_out_div = 1 << ((val >> OUT_DIV_TX_OFFSET) & 7);
 
 	return SUCCESS;
 }
@@ -1318,3 +1395,352 @@ int32_t xilinx_xcvr_write_tx_clk25_div(struct xilinx_xcvr *xcvr,
 
 	return xilinx_xcvr_drp_update(xcvr, drp_port, reg, mask, div);
 }
+
+/**
+ * @brief xilinx_xcvr_es_regs_get
+ */
+static const struct xilinx_xcvr_es_regs *xilinx_xcvr_es_regs_get(
+	struct xilinx_xcvr *xcvr)
+{
+	switch (xcvr->type) {
+	case XILINX_XCVR_TYPE_S7_GTX2:
+		return &xilinx_xcvr_gtx2_es_regs;
+	case XILINX_XCVR_TYPE_US_GTH3:
+	case XILINX_XCVR_TYPE_US_GTH4:
+	case XILINX_XCVR_TYPE_US_GTY4:
+		return &xilinx_xcvr_gth34_es_regs;
+	default:
+		return NULL;
+	}
+}
+
+/**
+ * @brief xilinx_xcvr_ilog2
+ */
+static uint8_t xilinx_xcvr_ilog2(uint64_t val)
+{
+	uint8_t log = 0;
+
+	while (val >>= 1)
+		log++;
+
+	return log;
+}
+
+/**
+ * @brief xilinx_xcvr_eyescan_setup
+ *
+ * Program the sample prescale and the qualifier and data masks of one lane.
+ * Every received bit is qualified; only the data_width LSBs of the 80-bit
+ * masks, aligned to bit 39, are compared. The eye scan circuitry itself
+ * (ES_EYE_SCAN_EN, ES_ERRDET_EN) is enabled by the HDL transceiver
+ * wrapper since changing it needs a PMA reset.
+ */
+static int32_t xilinx_xcvr_eyescan_setup(struct xilinx_xcvr *xcvr,
+		uint32_t drp_port, const struct xilinx_xcvr_eyescan_config *conf)
+{
+	const struct xilinx_xcvr_es_regs *regs;
+	uint64_t sdata_mask;
+	uint32_t i;
+	int32_t ret;
+
+	regs = xilinx_xcvr_es_regs_get(xcvr);
+	if (!regs)
+		return FAILURE;
+
+	switch (conf->data_width) {
+	case 16:
+	case 20:
+	case 32:
+	case 40:
+		break;
+	default:
+		return -EINVAL;
+	}
+
+	if (conf->prescale > 31)
+		return -EINVAL;
+
+	ret = xilinx_xcvr_drp_update(xcvr, drp_port, regs->prescale,
+				     regs->prescale_mask,
+				     conf->prescale << regs->prescale_shift);
+	if (ret < 0)
+		return ret;
+
+	/* Mask bits [79:40] and the bits below the data word */
+	sdata_mask = (~0ULL << 40) | ((1ULL << (40 - conf->data_width)) - 1);
+
+	for (i = 0; i < ES_MASK_REGS; i++) {
+		ret = xilinx_xcvr_drp_write(xcvr, drp_port,
+					    regs->qual_mask + i, 0xffff);
+		if (ret < 0)
+			return ret;
+
+		/* SDATA_MASK4, bits [79:64], is all ones */
+		ret = xilinx_xcvr_drp_write(xcvr, drp_port, regs->sdata_mask + i,
+					    i < 4 ? (sdata_mask >> (16 * i)) & 0xffff :
+					    0xffff);
+		if (ret < 0)
+			return ret;
+	}
+
+	return SUCCESS;
+}
+
+/**
+ * @brief xilinx_xcvr_eyescan_run
+ */
+static int32_t xilinx_xcvr_eyescan_run(struct xilinx_xcvr *xcvr,
+				       uint32_t drp_port, const struct xilinx_xcvr_es_regs *regs,
+				       uint32_t timeout_ms, uint32_t *samples, uint32_t *errors)
+{
+	uint32_t timeout = timeout_ms * 100;
+	uint32_t status;
+	int32_t ret;
+
+	ret = xilinx_xcvr_drp_update(xcvr, drp_port, regs->control,
+				     ES_CONTROL_MASK, ES_CONTROL_RUN);
+	if (ret < 0)
+		return ret;
+
+	do {
+		ret = xilinx_xcvr_drp_read(xcvr, drp_port, regs->status, &status);
+		if (ret < 0)
+			goto out;
+
+		if ((status & ES_STATUS_DONE) &&
+		    ES_STATUS_STATE(status) == ES_STATUS_STATE_END)
+			break;
+
+		udelay(10);
+	} while (--timeout);
+
+	if (!timeout) {
+		printf("%s: port %"PRIu32": timeout\n", __func__, drp_port);
+		ret = FAILURE;
+		goto out;
+	}
+
+	ret = xilinx_xcvr_drp_read(xcvr, drp_port, regs->error_count, errors);
+	if (ret < 0)
+		goto out;
+
+	ret = xilinx_xcvr_drp_read(xcvr, drp_port, regs->sample_count, samples);
+
+out:
+	/* Back to WAIT, ready for the next offset */
+	xilinx_xcvr_drp_update(xcvr, drp_port, regs->control,
+			       ES_CONTROL_MASK, 0);
+
+	return ret;
+}
+
+/**
+ * @brief xilinx_xcvr_eyescan_point
+ *
+ * Measure one point of the statistical eye. h_offset is in phase
+ * interpolator taps (+/- 32 * RXOUT_DIV is one UI), v_offset in DAC
+ * codes (+/- 127). In DFE mode the errors of both unrolled tap signs are
+ * accumulated. Returns the number of compared bits and bit errors.
+ */
+int32_t xilinx_xcvr_eyescan_point(struct xilinx_xcvr *xcvr, uint32_t drp_port,
+				  const struct xilinx_xcvr_eyescan_config *conf,
+				  int32_t h_offset, int32_t v_offset,
+				  uint64_t *bits, uint64_t *errors)
+{
+	const struct xilinx_xcvr_es_regs *regs;
+	uint32_t samples, errs, vert, ut;
+	int32_t ret;
+
+	regs = xilinx_xcvr_es_regs_get(xcvr);
+	if (!regs)
+		return FAILURE;
+
+	if (abs(v_offset) > ES_VERT_MAX || abs(h_offset) > 0x7ff)
+		return -EINVAL;
+
+	ret = xilinx_xcvr_drp_update(xcvr, drp_port, regs->horz,
+				     regs->horz_mask,
+				     ((uint32_t)h_offset << regs->horz_shift) &
+				     regs->horz_mask);
+	if (ret < 0)
+		return ret;
+
+	*bits = 0;
+	*errors = 0;
+
+	for (ut = 0; ut < (conf->lpm ? 1 : 2); ut++) {
+		vert = abs(v_offset);
+		if (v_offset < 0)
+			vert |= regs->vert_neg;
+		if (ut)
+			vert |= regs->vert_ut_sign;
+
+		ret = xilinx_xcvr_drp_update(xcvr, drp_port, regs->vert,
+					     regs->vert_mask,
+					     vert << regs->vert_shift);
+		if (ret < 0)
+			return ret;
+
+		ret = xilinx_xcvr_eyescan_run(xcvr, drp_port, regs,
+					      conf->timeout_ms, &samples, &errs);
+		if (ret < 0)
+			return ret;
+
+		*bits += ((uint64_t)samples * conf->data_width) <<
+			 (1 + conf->prescale);
+		*errors += errs;
+	}
+
+	return SUCCESS;
+}
+
+/**
+ * @brief xilinx_xcvr_eyescan_summary
+ */
+static void xilinx_xcvr_eyescan_summary(struct xilinx_xcvr_eyescan_map *map)
+{
+	uint32_t h_zero = -map->h_min / (int32_t)map->h_step;
+	uint32_t v_zero = -map->v_min / (int32_t)map->v_step;
+	uint8_t *row = &map->data[v_zero * map->h_points];
+	int32_t i;
+
+	map->open_area = 0;
+	for (i = 0; i < (int32_t)(map->h_points * map->v_points); i++)
+		if (map->data[i] == XILINX_XCVR_EYESCAN_OPEN)
+			map->open_area++;
+
+	/* Width and height of the open region through the eye center */
+	map->width = 0;
+	for (i = h_zero; i < (int32_t)map->h_points &&
+	     row[i] == XILINX_XCVR_EYESCAN_OPEN; i++)
+		map->width += map->h_step;
+	for (i = h_zero - 1; i >= 0 && row[i] == XILINX_XCVR_EYESCAN_OPEN; i--)
+		map->width += map->h_step;
+
+	map->height = 0;
+	for (i = v_zero; i < (int32_t)map->v_points &&
+	     map->data[i * map->h_points + h_zero] == XILINX_XCVR_EYESCAN_OPEN; i++)
+		map->height += map->v_step;
+	for (i = v_zero - 1; i >= 0 &&
+	     map->data[i * map->h_points + h_zero] == XILINX_XCVR_EYESCAN_OPEN; i--)
+		map->height += map->v_step;
+}
+
+/**
+ * @brief xilinx_xcvr_eyescan
+ *
+ * Sweep the full horizontal range of the lane (one UI, out_div being the
+ * receiver output divider) and +/- v_max vertically. Each point of the map
+ * holds floor(log2(bits / errors)), i.e. the negated BER exponent in base
+ * 2, or XILINX_XCVR_EYESCAN_OPEN when no error was seen within 2^depth
+ * compared bits. map->data is allocated here and released by
+ * xilinx_xcvr_eyescan_free().
+ */
+int32_t xilinx_xcvr_eyescan(struct xilinx_xcvr *xcvr, uint32_t drp_port,
+			    uint32_t out_div,
+			    const struct xilinx_xcvr_eyescan_config *conf,
+			    struct xilinx_xcvr_eyescan_map *map)
+{
+	uint64_t bits, errors, min_bits = UINT64_MAX;
+	int32_t h_range, v_range, h, v;
+	uint8_t *point;
+	int32_t ret;
+
+	if (!conf->h_step || !conf->v_step || !out_div ||
+	    conf->v_max > ES_VERT_MAX)
+		return -EINVAL;
+
+	ret = xilinx_xcvr_eyescan_setup(xcvr, drp_port, conf);
+	if (ret < 0)
+		return ret;
+
+	h_range = (32 * out_div) / conf->h_step;
+	v_range = conf->v_max / conf->v_step;
+
+	map->h_step = conf->h_step;
+	map->v_step = conf->v_step;
+	map->h_min = -h_range * conf->h_step;
+	map->v_min = -v_range * conf->v_step;
+	map->h_points = 2 * h_range + 1;
+	map->v_points = 2 * v_range + 1;
+	map->data = calloc(map->h_points * map->v_points, sizeof(*map->data));
+	if (!map->data)
+		return -ENOMEM;
+
+	point = map->data;
+	for (v = -v_range; v <= v_range; v++) {
+		for (h = -h_range; h <= h_range; h++) {
+			ret = xilinx_xcvr_eyescan_point(xcvr, drp_port, conf,
+							h * conf->h_step,
+							v * conf->v_step,
+							&bits, &errors);
+			if (ret < 0)
+				goto error;
+
+			if (bits < min_bits)
+				min_bits = bits;
+
+			if (errors)
+				*point = xilinx_xcvr_ilog2(bits / errors);
+			else
+				*point = XILINX_XCVR_EYESCAN_OPEN;
+			point++;
+		}
+	}
+
+	map->depth = xilinx_xcvr_ilog2(min_bits);
+	xilinx_xcvr_eyescan_summary(map);
+
+	return SUCCESS;
+
+error:
+	xilinx_xcvr_eyescan_free(map);
+
+	return ret;
+}
+
+/**
+ * @brief xilinx_xcvr_eyescan_print
+ *
+ * One character per point, top row first: ' ' for error free points,
+ * otherwise the BER exponent in base 2 as a base-36 digit ('0' being
+ * an error on every bit, 'Z' or above a BER of 2^-35 or better).
+ */
+void xilinx_xcvr_eyescan_print(const struct xilinx_xcvr_eyescan_map *map)
+{
+	uint32_t h, v;
+	uint8_t val;
+
+	printf("eye: %"PRIu32"x%"PRIu32" points, %"PRIu32" taps/%"PRIu32
+	       " codes per step, 2^%u bits per point\n",
+	       map->h_points, map->v_points, map->h_step, map->v_step,
+	       map->depth);
+
+	for (v = map->v_points; v > 0; v--) {
+		printf("%4"PRId32" |", map->v_min +
+		       (int32_t)((v - 1) * map->v_step));
+		for (h = 0; h < map->h_points; h++) {
+			val = map->data[(v - 1) * map->h_points + h];
+			if (val == XILINX_XCVR_EYESCAN_OPEN)
+				putchar(' ');
+			else if (val < 10)
+				putchar('0' + val);
+			else
+				putchar('A' + min(val - 10, 25));
+		}
+		printf("|\n");
+	}
+
+	printf("width %"PRIu32" taps, height %"PRIu32" codes, open area %"
+	       PRIu32" points\n", map->width, map->height, map->open_area);
+}
+
+/**
+ * @brief xilinx_xcvr_eyescan_free
+ */
+void xilinx_xcvr_eyescan_free(struct xilinx_xcvr_eyescan_map *map)
+{
+	free(map->data);
+	map->data = NULL;
+}
@@ -164,6 +164,45 @@ struct xilinx_xcvr_qpll_config {
 
 #define ENC_8B10B		810
 
+/* Eye map point whose measurement saw no errors */
+#define XILINX_XCVR_EYESCAN_OPEN	0xff
+
+struct xilinx_xcvr_eyescan_config {
+	/* Sample count prescale, 2^(1 + prescale) samples per count (0..31) */
+	uint32_t prescale;
+	/* Internal data width in bits: 16, 20, 32 or 40 */
+	uint32_t data_width;
+	/* Horizontal step in phase interpolator taps */
+	uint32_t h_step;
+	/* Vertical step and maximum vertical offset in DAC codes (max 127) */
+	uint32_t v_step;
+	uint32_t v_max;
+	/* Receiver equalizer mode, DFE scans both unrolled tap signs */
+	bool lpm;
+	/* Timeout of one point measurement */
+	uint32_t timeout_ms;
+};
+
+struct xilinx_xcvr_eyescan_map {
+	int32_t h_min;
+	int32_t v_min;
+	uint32_t h_step;
+	uint32_t v_step;
+	uint32_t h_points;
+	uint32_t v_points;
+	/* floor(log2()) of the bits compared at each point */
+	uint8_t depth;
+	/* floor(log2(bits / errors)) per point, row major from v_min */
+	uint8_t *data;
+	/*
+	 * Error free points in total, and the error free width (taps) and
+	 * height (codes) through the eye center
+	 */
+	uint32_t open_area;
+	uint32_t width;
+	uint32_t height;
+};
+
 /******************************************************************************/
 /************************ Functions Declarations ******************************/
 /******************************************************************************/
@@ -200,4 +239,14 @@ int32_t xilinx_xcvr_write_rx_clk25_div(struct xilinx_xcvr *xcvr,
 				       uint32_t drp_port, uint32_t div);
 int32_t xilinx_xcvr_write_tx_clk25_div(struct xilinx_xcvr *xcvr,
 				       uint32_t drp_port, uint32_t div);
+int32_t xilinx_xcvr_eyescan_point(struct xilinx_xcvr *xcvr, uint32_t drp_port,
+				  const struct xilinx_xcvr_eyescan_config *conf,
+				  int32_t h_offset, int32_t v_offset,
+				  uint64_t *bits, uint64_t *errors);
+int32_t xilinx_xcvr_eyescan(struct xilinx_xcvr *xcvr, uint32_t drp_port,
+			    uint32_t out_div,
+			    const struct xilinx_xcvr_eyescan_config *conf,
+			    struct xilinx_xcvr_eyescan_map *map);
+void xilinx_xcvr_eyescan_print(const struct xilinx_xcvr_eyescan_map *map);
+void xilinx_xcvr_eyescan_free(struct xilinx_xcvr_eyescan_map *map);
 #endif
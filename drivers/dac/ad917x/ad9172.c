@@ -276,7 +276,7 @@ static int32_t ad9172_spi_xfer(void *user_data, uint8_t *wbuf,
 	struct spi_desc *spi = user_data;
 	uint8_t * buffer = (uint8_t *) malloc(len);
 
-	memcpy(buffer, wbuf, 3);
+	memcpy(buffer, wbuf, len);
 	ret = spi_write_and_read(spi, buffer, len);
 	if (ret < 0) {
 		printf("Read Error %"PRId32, ret);
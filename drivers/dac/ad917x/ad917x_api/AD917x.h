@@ -99,6 +99,27 @@ typedef struct {
 	hw_close;    /**< Function Pointer to HAL de-initialization function*/
 } ad917x_handle_t;
 
+/** Maximum NCOs in a retune plan: 2 main + 6 channel NCOs */
+#define AD917X_NCO_PLAN_MAX_NCOS 8
+
+/** Free running microsecond counter used to time retunes */
+typedef uint32_t(*get_time_us_t)(void *user_data);
+
+/** AD917X NCO retune plan */
+typedef struct {
+	ad917x_dac_select_t dacs;   /**< Main NCOs retuned at every step */
+	ad917x_channel_select_t channels; /**< Channel NCOs retuned at every step */
+	uint8_t num_ncos;       /**< Main NCOs then channel NCOs, in bit order */
+	uint16_t num_steps;     /**< Number of steps in the frequency plan */
+	uint64_t *ftw;          /**< num_steps x num_ncos FTWs, caller storage */
+	get_time_us_t get_time_us; /**< Optional time source, gets h->user_data */
+	uint16_t step;          /**< Last applied step */
+	uint32_t steps_applied; /**< Number of retunes done */
+	uint32_t last_us;       /**< Latency of the last retune in us */
+	uint32_t max_us;        /**< Worst retune latency in us */
+	uint64_t total_us;      /**< Sum of all retune latencies in us */
+} ad917x_nco_plan_t;
+
 /**
  * \brief Initialize AD917X Device
  * This API must be called first before any other API calls.
@@ -1047,6 +1068,69 @@ int32_t ad917x_nco_main_freq_get(ad917x_handle_t *h,
 				 ad917x_dac_select_t dac,
 				 int64_t *carrier_freq_hz);
 
+/**
+ * \brief  Precompute a NCO frequency plan and apply its first step
+ *
+ * Compute the integer FTWs of every step once, put the selected NCOs in
+ * integer mode and load the first step.
+ *
+ * \param h     Pointer to the AD917x device reference handle.
+ * \param plan  Pointer to the plan, get_time_us may be set by the caller
+ * \param dacs  Main data path NCOs in the plan
+ * \param channels  Channel NCOs in the plan
+ * \param carrier_freq_hz  num_steps x num_ncos frequencies in Hz, step major.
+ *              In each step main NCOs come first, then channels, in bit order.
+ * \param num_steps  Number of steps in the plan
+ * \param ftw   Storage for num_steps x num_ncos FTWs
+ *
+ * \retval API_ERROR_OK API Completed Successfully
+ * \retval API_ERROR_INVALID_HANDLE_PTR Invalid reference handle.
+ * \retval API_ERROR_INVALID_XFER_PTR SPI Access Failed
+ * \retval API_ERROR_INVALID_PARAM    Invalid Parameter
+ */
+int32_t ad917x_nco_plan_init(ad917x_handle_t *h, ad917x_nco_plan_t *plan,
+			     const ad917x_dac_select_t dacs,
+			     const ad917x_channel_select_t channels,
+			     const int64_t *carrier_freq_hz,
+			     const uint16_t num_steps, uint64_t *ftw);
+
+/**
+ * \brief  Retune all NCOs of a plan to one of its steps
+ *
+ * Each FTW goes out as a single streaming SPI write, then all main NCOs and
+ * all channel NCOs are paged together and loaded by one FTW_LOAD_REQ edge.
+ *
+ * \param h     Pointer to the AD917x device reference handle.
+ * \param plan  Pointer to an initialized plan
+ * \param step  Step index, 0 to num_steps - 1
+ *
+ * \retval API_ERROR_OK API Completed Successfully
+ * \retval API_ERROR_INVALID_HANDLE_PTR Invalid reference handle.
+ * \retval API_ERROR_INVALID_XFER_PTR SPI Access Failed
+ * \retval API_ERROR_INVALID_PARAM    Invalid Parameter
+ */
+int32_t ad917x_nco_plan_step_set(ad917x_handle_t *h, ad917x_nco_plan_t *plan,
+				 const uint16_t step);
+
+/**
+ * \brief  Get retune latency statistics of a plan
+ *
+ * Latencies are only measured when plan->get_time_us is set.
+ *
+ * \param h     Pointer to the AD917x device reference handle.
+ * \param plan  Pointer to the plan
+ * \param last_us  Latency of the last retune in us
+ * \param max_us   Worst retune latency in us
+ * \param avg_us   Average retune latency in us
+ *
+ * \retval API_ERROR_OK API Completed Successfully
+ * \retval API_ERROR_INVALID_HANDLE_PTR Invalid reference handle.
+ * \retval API_ERROR_INVALID_PARAM    Invalid Parameter
+ */
+int32_t ad917x_nco_plan_latency_get(ad917x_handle_t *h, ad917x_nco_plan_t *plan,
+				    uint32_t *last_us, uint32_t *max_us,
+				    uint32_t *avg_us);
+
 /** @} */
 
 #endif /* !__AD917XAPI_H__ */
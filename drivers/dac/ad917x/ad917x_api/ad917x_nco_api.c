@@ -986,3 +986,244 @@ int32_t ad917x_nco_channel_freq_get(ad917x_handle_t *h,
 				   carrier_freq_hz);
 }
 
+
+static int32_t ad917x_nco_plan_ftw_calc(ad917x_handle_t *h,
+					int64_t carrier_freq_hz, uint64_t *ftw)
+{
+	uint64_t freq, tmp_hi, tmp_lo;
+
+	if (!((carrier_freq_hz >= (int64_t)(0ll - h->dac_freq_hz / 2)) &&
+	      (carrier_freq_hz < (int64_t)(h->dac_freq_hz / 2))))
+		return API_ERROR_INVALID_PARAM;
+
+	/* integer mode: FTW = round(f * 2^48 / fdac), negative as 2's complement */
+	freq = (carrier_freq_hz < 0) ? -carrier_freq_hz : carrier_freq_hz;
+	adi_api_utils_mult_128(freq, ADI_POW2_48, &tmp_hi, &tmp_lo);
+	adi_api_utils_add_128(tmp_hi, tmp_lo, 0, h->dac_freq_hz / 2,
+			      &tmp_hi, &tmp_lo);
+	adi_api_utils_div_128(tmp_hi, tmp_lo, 0, h->dac_freq_hz,
+			      &tmp_hi, &tmp_lo);
+	if (carrier_freq_hz < 0)
+		tmp_lo = ADI_POW2_48 - tmp_lo;
+	*ftw = tmp_lo & ADI_MAXUINT48;
+
+	return API_ERROR_OK;
+}
+
+static int32_t ad917x_nco_plan_ftw_write(ad917x_handle_t *h,
+		const ad917x_dds_select_t dds, uint64_t ftw)
+{
+	uint8_t in_data[8];
+	uint8_t out_data[8];
+	/* the SPI runs with descending addresses: start at FTW5, MSB first */
+	uint16_t address = AD917X_X_FTW0_REG(dds) + 5;
+	int32_t i;
+
+	in_data[0] = ((address >> 8) & 0xFF);
+	in_data[1] = ((address >> 0) & 0xFF);
+	for (i = 0; i < 6; i++)
+		in_data[2 + i] = ADI_GET_BYTE(ftw, 40 - 8 * i);
+	if (h->dev_xfer(h->user_data, in_data, out_data, sizeof(in_data)) != 0)
+		return API_ERROR_SPI_XFER;
+
+	return API_ERROR_OK;
+}
+
+static int32_t ad917x_nco_plan_load(ad917x_handle_t *h,
+				    const ad917x_dds_select_t dds,
+				    uint8_t page)
+{
+	int32_t err;
+
+	err = ad917x_register_write(h, AD917X_SPI_PAGEINDX_REG, page);
+	if (err != API_ERROR_OK)
+		return err;
+	/* FTW_LOAD_REQ (rising edge), FTW_LOAD_SYSREF was cleared by init */
+	err = ad917x_register_write(h, AD917X_X_FTW_UPDATE_REG(dds), 0);
+	if (err != API_ERROR_OK)
+		return err;
+
+	return ad917x_register_write(h, AD917X_X_FTW_UPDATE_REG(dds),
+				     AD917X_DDSM_FTW_LOAD_REQ);
+}
+
+static uint8_t ad917x_nco_plan_page(const ad917x_nco_plan_t *plan, uint8_t i,
+				    ad917x_dds_select_t *dds)
+{
+	uint8_t bit;
+
+	/* main NCOs first, then channels, both in bit order */
+	for (bit = 0; bit < 2; bit++) {
+		if ((plan->dacs & (AD917X_DAC0 << bit)) && (i-- == 0)) {
+			*dds = AD917X_DDSM;
+			return AD917X_CHANNEL_PAGE_0 |
+			       (AD917X_MAINDAC_PAGE_0 << bit);
+		}
+	}
+	for (bit = 0; bit < 6; bit++) {
+		if ((plan->channels & (AD917X_CH_0 << bit)) && (i-- == 0)) {
+			*dds = AD917X_DDSC;
+			return AD917X_CHANNEL_PAGE_0 << bit;
+		}
+	}
+
+	return 0;
+}
+
+int32_t ad917x_nco_plan_init(ad917x_handle_t *h, ad917x_nco_plan_t *plan,
+			     const ad917x_dac_select_t dacs,
+			     const ad917x_channel_select_t channels,
+			     const int64_t *carrier_freq_hz,
+			     const uint16_t num_steps, uint64_t *ftw)
+{
+	ad917x_dds_select_t dds;
+	uint8_t i, page, tmp_reg, num_ncos = 0;
+	uint32_t k;
+	int32_t err;
+
+	if (h == NULL)
+		return API_ERROR_INVALID_HANDLE_PTR;
+	if (h->dev_xfer == NULL)
+		return API_ERROR_INVALID_XFER_PTR;
+	if ((plan == NULL) || (carrier_freq_hz == NULL) || (ftw == NULL) ||
+	    (num_steps == 0) || (h->dac_freq_hz == 0))
+		return API_ERROR_INVALID_PARAM;
+	if ((dacs & ~(AD917X_DAC0 | AD917X_DAC1)) || (channels & ~0x3F))
+		return API_ERROR_INVALID_PARAM;
+
+	for (i = 0; i < 8; i++)
+		if ((((channels & 0x3F) << 2) | (dacs & 0x3)) & (1 << i))
+			num_ncos++;
+	if (num_ncos == 0)
+		return API_ERROR_INVALID_PARAM;
+
+	/* all the 128-bit divisions of the sweep happen here, once */
+	for (k = 0; k < (uint32_t)num_steps * num_ncos; k++) {
+		err = ad917x_nco_plan_ftw_calc(h, carrier_freq_hz[k], &ftw[k]);
+		if (err != API_ERROR_OK)
+			return err;
+	}
+
+	plan->dacs = dacs;
+	plan->channels = channels;
+	plan->num_ncos = num_ncos;
+	plan->num_steps = num_steps;
+	plan->ftw = ftw;
+	plan->step = 0;
+	plan->steps_applied = 0;
+	plan->last_us = 0;
+	plan->max_us = 0;
+	plan->total_us = 0;
+
+	/* integer mode, no sysref load, so a step only rewrites the FTW */
+	for (i = 0; i < num_ncos; i++) {
+		page = ad917x_nco_plan_page(plan, i, &dds);
+		err = ad917x_register_write(h, AD917X_SPI_PAGEINDX_REG, page);
+		if (err != API_ERROR_OK)
+			return err;
+		if (dds == AD917X_DDSM) {
+			err = ad917x_register_read(h, AD917X_DDSM_DATAPATH_CFG_REG,
+						   &tmp_reg);
+			if (err != API_ERROR_OK)
+				return err;
+			tmp_reg |= AD917X_DDSM_NCO_EN;
+			tmp_reg &= ~AD917X_DDSM_MODULUS_EN;
+			err = ad917x_register_write(h, AD917X_DDSM_DATAPATH_CFG_REG,
+						    tmp_reg);
+		} else {
+			err = ad917x_register_read(h, AD917X_DDSC_DATAPATH_CFG_REG,
+						   &tmp_reg);
+			if (err != API_ERROR_OK)
+				return err;
+			tmp_reg |= AD917X_DDSC_NCO_EN;
+			tmp_reg &= ~AD917X_DDSC_MODULUS_EN;
+			err = ad917x_register_write(h, AD917X_DDSC_DATAPATH_CFG_REG,
+						    tmp_reg);
+		}
+		if (err != API_ERROR_OK)
+			return err;
+		err = ad917x_register_write(h, AD917X_X_FTW_UPDATE_REG(dds), 0);
+		if (err != API_ERROR_OK)
+			return err;
+	}
+
+	return ad917x_nco_plan_step_set(h, plan, 0);
+}
+
+int32_t ad917x_nco_plan_step_set(ad917x_handle_t *h, ad917x_nco_plan_t *plan,
+				 const uint16_t step)
+{
+	ad917x_dds_select_t dds;
+	const uint64_t *ftw;
+	uint32_t start_us = 0;
+	uint8_t i, page;
+	int32_t err;
+
+	if (h == NULL)
+		return API_ERROR_INVALID_HANDLE_PTR;
+	if (h->dev_xfer == NULL)
+		return API_ERROR_INVALID_XFER_PTR;
+	if ((plan == NULL) || (plan->ftw == NULL) || (step >= plan->num_steps))
+		return API_ERROR_INVALID_PARAM;
+
+	if (plan->get_time_us != NULL)
+		start_us = plan->get_time_us(h->user_data);
+
+	ftw = &plan->ftw[(uint32_t)step * plan->num_ncos];
+	for (i = 0; i < plan->num_ncos; i++) {
+		page = ad917x_nco_plan_page(plan, i, &dds);
+		err = ad917x_register_write(h, AD917X_SPI_PAGEINDX_REG, page);
+		if (err != API_ERROR_OK)
+			return err;
+		err = ad917x_nco_plan_ftw_write(h, dds, ftw[i]);
+		if (err != API_ERROR_OK)
+			return err;
+	}
+
+	/* one load request per data path, all its NCOs paged together */
+	if (plan->dacs != 0) {
+		page = AD917X_CHANNEL_PAGE_0;
+		if (plan->dacs & AD917X_DAC0)
+			page |= AD917X_MAINDAC_PAGE_0;
+		if (plan->dacs & AD917X_DAC1)
+			page |= AD917X_MAINDAC_PAGE_1;
+		err = ad917x_nco_plan_load(h, AD917X_DDSM, page);
+		if (err != API_ERROR_OK)
+			return err;
+	}
+	if (plan->channels != 0) {
+		err = ad917x_nco_plan_load(h, AD917X_DDSC, plan->channels & 0x3F);
+		if (err != API_ERROR_OK)
+			return err;
+	}
+
+	plan->step = step;
+	plan->steps_applied++;
+	if (plan->get_time_us != NULL) {
+		plan->last_us = plan->get_time_us(h->user_data) - start_us;
+		if (plan->last_us > plan->max_us)
+			plan->max_us = plan->last_us;
+		plan->total_us += plan->last_us;
+	}
+
+	return API_ERROR_OK;
+}
+
+int32_t ad917x_nco_plan_latency_get(ad917x_handle_t *h, ad917x_nco_plan_t *plan,
+				    uint32_t *last_us, uint32_t *max_us,
+				    uint32_t *avg_us)
+{
+	if (h == NULL)
+		return API_ERROR_INVALID_HANDLE_PTR;
+	if ((plan == NULL) || (last_us == NULL) || (max_us == NULL) ||
+	    (avg_us == NULL))
+		return API_ERROR_INVALID_PARAM;
+
+	*last_us = plan->last_us;
+	*max_us = plan->max_us;
+	*avg_us = 0;
+	if (plan->steps_applied > 0)
+		*avg_us = (uint32_t)DIV_U64(plan->total_us, plan->steps_applied);
+
+	return API_ERROR_OK;
+}
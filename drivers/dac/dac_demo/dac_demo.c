@@ -48,6 +48,7 @@
 #include "dac_demo.h"
 #include "error.h"
 #include "util.h"
+#include "wavegen.h"
 
 /******************************************************************************/
 /************************ Functions Definitions *******************************/
@@ -179,6 +180,35 @@ int32_t dac_write_samples(void* dev, uint16_t* buff, uint32_t samples)
 	return samples;
 }
 
+/**********************************************************************//**
+ * @brief fill the loopback buffers of the active channels from a waveform
+ * generator: even channels get the in-phase and odd channels the quadrature
+ * component.
+ * @param desc - descriptor for the dac
+ * @param gen - waveform generator
+ * @return SUCCESS in case of success, negative error code otherwise.
+**************************************************************************/
+int32_t dac_demo_generate(struct dac_demo_desc *desc, struct wavegen_desc *gen)
+{
+	uint16_t data_i[DEFAULT_LOCAL_SAMPLES];
+	uint16_t data_q[DEFAULT_LOCAL_SAMPLES];
+	uint32_t ch = -1;
+	int32_t ret;
+
+	if(!desc || !gen)
+		return -EINVAL;
+
+	ret = wavegen_fill(gen, data_i, data_q, DEFAULT_LOCAL_SAMPLES);
+	if (ret != SUCCESS)
+		return ret;
+
+	while (get_next_ch_idx(desc->active_ch, ch, &ch))
+		memcpy(desc->loopback_buffers[ch], (ch & 1) ? data_q : data_i,
+		       sizeof(data_i));
+
+	return SUCCESS;
+}
+
 /**
  * @brief get attributes for dac.
  * @param device- Physical instance of a iio_demo_device.
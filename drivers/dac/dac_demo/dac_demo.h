@@ -45,6 +45,7 @@
 /******************************************************************************/
 
 #include <stdint.h>
+#include "wavegen.h"
 
 /******************************************************************************/
 /*************************** Types Declarations *******************************/
@@ -106,6 +107,8 @@ int32_t close_dac_channels(void* dev);
 
 int32_t dac_write_samples(void* dev, uint16_t* buff, uint32_t samples);
 
+int32_t dac_demo_generate(struct dac_demo_desc *desc, struct wavegen_desc *gen);
+
 ssize_t get_dac_demo_attr(void *device, char *buf, size_t len,
 			  const struct iio_ch_info *channel, intptr_t priv);
 
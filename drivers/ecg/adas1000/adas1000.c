@@ -43,14 +43,37 @@
 /***************************** Include Files *********************************/
 /*****************************************************************************/
 #include <stdlib.h>
+#include <string.h>
 #include "error.h"
 #include "adas1000.h"
 #include "crc.h"
 
+/*****************************************************************************/
+/************************ Variable Definitions *******************************/
+/*****************************************************************************/
+DECLARE_CRC16_TABLE(adas1000_crc16);
+DECLARE_CRC24_TABLE(adas1000_crc24);
+static bool adas1000_crc_tables_ready;
+
 /*****************************************************************************/
 /************************ Function Definitions *******************************/
 /*****************************************************************************/
 
+/**
+ * @brief Populates the CRC lookup tables. The tables depend only on the
+ * polynomials so they are computed once and reused for every frame.
+ * @return None.
+ */
+static void adas1000_crc_tables_populate(void)
+{
+	if (adas1000_crc_tables_ready)
+		return;
+
+	crc16_populate_msb(adas1000_crc16, CRC_POLY_128KHZ);
+	crc24_populate_msb(adas1000_crc24, CRC_POLY_2KHZ_16KHZ);
+	adas1000_crc_tables_ready = true;
+}
+
 /**
  * @brief Preliminary function which computes the spi frequency based on the
  * frame rate value passed input parameter.
@@ -408,14 +431,296 @@ uint32_t adas1000_compute_frame_crc(struct adas1000_dev * device, uint8_t *buff)
 {
 	uint32_t crc = 0xFFFFFFFFul;
 
+	adas1000_crc_tables_populate();
+
 	/** Select the CRC poly and word size based on the frame rate. */
-	if(device->frame_rate == ADAS1000_128KHZ_FRAME_RATE) {
-		DECLARE_CRC16_TABLE(adas1000_crc16);
-		crc16_populate_msb(adas1000_crc16, CRC_POLY_128KHZ);
+	if(device->frame_rate == ADAS1000_128KHZ_FRAME_RATE)
 		return crc16(adas1000_crc16, buff, device->frame_size, (uint16_t)crc);
-	} else {
-		DECLARE_CRC24_TABLE(adas1000_crc24);
-		crc24_populate_msb(adas1000_crc24, CRC_POLY_2KHZ_16KHZ);
+	else
 		return crc24(adas1000_crc24, buff, device->frame_size, crc);
+}
+
+/**
+ * @brief Checks the CRC of a frame. The CRC computed over the whole frame,
+ * including the CRC word, must match the residue constant of the polynomial.
+ * @param stream - Stream structure.
+ * @param frame - Buffer holding the frame data.
+ * @return true if the frame CRC is valid, false otherwise.
+ */
+static bool adas1000_stream_crc_valid(struct adas1000_stream *stream,
+				      uint8_t *frame)
+{
+	if (stream->word_size == ADAS1000_128KHZ_WORD_SIZE / 8)
+		return crc16(adas1000_crc16, frame, stream->frame_size,
+			     0xFFFF) == CRC_CHECK_CONST_128KHz;
+
+	return crc24(adas1000_crc24, frame, stream->frame_size,
+		     0xFFFFFFul) == CRC_CHECK_CONST_2KHZ_16KHZ;
+}
+
+/**
+ * @brief Pushes a run of consecutive valid frames in the ring.
+ * @param stream - Stream structure.
+ * @param frames - Address of the first frame of the run.
+ * @param size - Size of the run in bytes.
+ * @return SUCCESS in case of success, negative error code otherwise.
+ */
+static int32_t adas1000_stream_push(struct adas1000_stream *stream,
+				    uint8_t *frames, uint32_t size)
+{
+	uint32_t used;
+	int32_t ret;
+
+	if (!size)
+		return SUCCESS;
+
+	/* cb_write overwrites unread data without reporting it */
+	ret = cb_size(stream->ring, &used);
+	if (ret != SUCCESS && ret != -EOVERRUN)
+		return ret;
+
+	if (used + size > stream->ring_size)
+		stream->overruns++;
+
+	return cb_write(stream->ring, frames, size);
+}
+
+/**
+ * @brief Initializes the frame stream reader. The frame configuration of the
+ * device (frame rate, inactive words) must not change while the stream is used.
+ * @param stream - The stream structure.
+ * @param device - The device structure.
+ * @param init_param - The stream initialization parameters.
+ * @return SUCCESS in case of success, negative error code otherwise.
+ */
+int32_t adas1000_stream_init(struct adas1000_stream **stream,
+			     struct adas1000_dev *device,
+			     const struct adas1000_stream_init_param *init_param)
+{
+	struct adas1000_stream *strm;
+	int32_t ret;
+
+	if (!stream || !device || !init_param || !device->frame_size ||
+	    !init_param->burst_frames || !init_param->ring_frames)
+		return -EINVAL;
+
+	/** A burst must fit in a single SPI transfer. */
+	if (init_param->burst_frames > UINT16_MAX / device->frame_size)
+		return -EINVAL;
+
+	if (init_param->ring_frames > UINT32_MAX / device->frame_size)
+		return -EINVAL;
+
+	strm = (struct adas1000_stream *)calloc(1, sizeof(*strm));
+	if (!strm)
+		return -ENOMEM;
+
+	strm->dev = device;
+	strm->frame_size = device->frame_size;
+	strm->burst_size = init_param->burst_frames * device->frame_size;
+	strm->crc_check = init_param->crc_check;
+	strm->ready_repeat = init_param->ready_repeat;
+	if (device->frame_rate == ADAS1000_128KHZ_FRAME_RATE)
+		strm->word_size = ADAS1000_128KHZ_WORD_SIZE / 8;
+	else
+		strm->word_size = ADAS1000_2KHZ_WORD_SIZE / 8;
+
+	strm->burst_buff = (uint8_t *)calloc(1, strm->burst_size);
+	if (!strm->burst_buff) {
+		ret = -ENOMEM;
+		goto error_strm;
 	}
+
+	strm->ring_size = init_param->ring_frames * device->frame_size;
+	ret = cb_init(&strm->ring, strm->ring_size);
+	if (ret != SUCCESS)
+		goto error_buff;
+
+	adas1000_crc_tables_populate();
+
+	*stream = strm;
+
+	return SUCCESS;
+
+error_buff:
+	free(strm->burst_buff);
+error_strm:
+	free(strm);
+
+	return ret;
+}
+
+/**
+ * @brief Sends the FRAMES command and starts the frame stream.
+ * @param stream - The stream structure.
+ * @return SUCCESS in case of success, negative error code otherwise.
+ */
+int32_t adas1000_stream_start(struct adas1000_stream *stream)
+{
+	if (!stream)
+		return -EINVAL;
+
+	stream->pending = 0;
+
+	return adas1000_write(stream->dev, ADAS1000_FRAMES, 0);
+}
+
+/**
+ * @brief Reads one burst of frames with a single SPI transfer and pushes the
+ * valid frames in the ring. Frames that are not ready or that fail the CRC
+ * check are dropped in the same pass. An incomplete frame at the end of the
+ * burst is carried over to the next call.
+ * @param stream - The stream structure.
+ * @param frames_added - Number of valid frames pushed in the ring. May be NULL.
+ * @return SUCCESS in case of success, negative error code otherwise.
+ */
+int32_t adas1000_stream_fill(struct adas1000_stream *stream,
+			     uint32_t *frames_added)
+{
+	uint32_t frame_size;
+	uint32_t run_start;
+	uint32_t offset;
+	uint32_t added;
+	uint8_t *buff;
+	int32_t ret;
+
+	if (!stream)
+		return -EINVAL;
+
+	buff = stream->burst_buff;
+	frame_size = stream->frame_size;
+
+	/** Keep SDI low (NOP) while the frames are clocked out. */
+	memset(buff + stream->pending, 0, stream->burst_size - stream->pending);
+	ret = spi_write_and_read(stream->dev->spi_desc, buff + stream->pending,
+				 stream->burst_size - stream->pending);
+	if (ret != SUCCESS)
+		return ret;
+
+	added = 0;
+	offset = 0;
+	run_start = 0;
+	while (stream->burst_size - offset >= frame_size) {
+		if (buff[offset] & ADAS1000_RDY_MASK) {
+			/** Not ready: drop the header or the whole frame. */
+			ret = adas1000_stream_push(stream, buff + run_start,
+						   offset - run_start);
+			if (ret != SUCCESS)
+				return ret;
+			stream->frames_not_ready++;
+			offset += stream->ready_repeat ? stream->word_size :
+				  frame_size;
+			run_start = offset;
+			continue;
+		}
+
+		if (stream->crc_check &&
+		    !adas1000_stream_crc_valid(stream, buff + offset)) {
+			ret = adas1000_stream_push(stream, buff + run_start,
+						   offset - run_start);
+			if (ret != SUCCESS)
+				return ret;
+			stream->crc_errors++;
+			offset += frame_size;
+			run_start = offset;
+			continue;
+		}
+
+		added++;
+		offset += frame_size;
+	}
+
+	ret = adas1000_stream_push(stream, buff + run_start, offset - run_start);
+	if (ret != SUCCESS)
+		return ret;
+
+	stream->pending = stream->burst_size - offset;
+	if (stream->pending)
+		memmove(buff, buff + offset, stream->pending);
+
+	stream->frames_ok += added;
+	if (frames_added)
+		*frames_added = added;
+
+	return SUCCESS;
+}
+
+/**
+ * @brief Reads the specified number of valid frames from the stream. New
+ * bursts are read from the device only when the ring runs out of frames.
+ * @param stream - The stream structure.
+ * @param data_buff - Buffer to store the read frames.
+ * @param frame_cnt - Number of frames to read.
+ * @return SUCCESS in case of success, negative error code otherwise.
+ */
+int32_t adas1000_stream_read(struct adas1000_stream *stream,
+			     uint8_t *data_buff, uint32_t frame_cnt)
+{
+	uint32_t available;
+	uint32_t size;
+	int32_t ret;
+
+	if (!stream || !data_buff)
+		return -EINVAL;
+
+	while (frame_cnt) {
+		ret = cb_size(stream->ring, &available);
+		if (ret != SUCCESS && ret != -EOVERRUN)
+			return ret;
+
+		available /= stream->frame_size;
+		if (!available) {
+			ret = adas1000_stream_fill(stream, NULL);
+			if (ret != SUCCESS)
+				return ret;
+			continue;
+		}
+
+		if (available > frame_cnt)
+			available = frame_cnt;
+		size = available * stream->frame_size;
+
+		ret = cb_read(stream->ring, data_buff, size);
+		if (ret != SUCCESS && ret != -EOVERRUN)
+			return ret;
+
+		data_buff += size;
+		frame_cnt -= available;
+	}
+
+	return SUCCESS;
+}
+
+/**
+ * @brief Stops the frame stream by reading a register.
+ * @param stream - The stream structure.
+ * @return SUCCESS in case of success, negative error code otherwise.
+ */
+int32_t adas1000_stream_stop(struct adas1000_stream *stream)
+{
+	uint32_t reg_data;
+
+	if (!stream)
+		return -EINVAL;
+
+	stream->pending = 0;
+
+	return adas1000_read(stream->dev, ADAS1000_FRMCTL, &reg_data);
+}
+
+/**
+ * @brief Frees the resources allocated by adas1000_stream_init().
+ * @param stream - The stream structure.
+ * @return SUCCESS in case of success, negative error code otherwise.
+ */
+int32_t adas1000_stream_remove(struct adas1000_stream *stream)
+{
+	if (!stream)
+		return -EINVAL;
+
+	cb_remove(stream->ring);
+	free(stream->burst_buff);
+	free(stream);
+
+	return SUCCESS;
 }
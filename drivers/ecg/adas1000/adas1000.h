@@ -49,6 +49,7 @@
 #include <stdint.h>
 #include <stdbool.h>
 #include "spi.h"
+#include "circular_buffer.h"
 
 /******************************************************************************/
 /* ADAS1000 SPI Registers Memory Map */
@@ -1105,6 +1106,49 @@ struct read_param {
 	bool ready_repeat;
 };
 
+struct adas1000_stream_init_param {
+	/** Number of frames clocked out in a single SPI transfer. The burst
+	    size (burst_frames * frame_size) must fit in one SPI transfer. */
+	uint32_t burst_frames;
+	/** Number of valid frames the ring buffer can hold */
+	uint32_t ring_frames;
+	/** Set to true if the frames carry a CRC word that must be checked */
+	bool crc_check;
+	/** Set to true if the device was configured to repeat the
+	    header until the READY bit is set. */
+	bool ready_repeat;
+};
+
+struct adas1000_stream {
+	/** ADAS1000 device the frames are read from */
+	struct adas1000_dev *dev;
+	/** Ring holding the valid frames until they are consumed */
+	struct circular_buffer *ring;
+	/** Size of the ring in bytes */
+	uint32_t ring_size;
+	/** Buffer used for the burst SPI transfers */
+	uint8_t *burst_buff;
+	/** Size of the burst buffer in bytes */
+	uint32_t burst_size;
+	/** Bytes of an incomplete frame carried over to the next burst */
+	uint32_t pending;
+	/** Size in bytes of a frame word */
+	uint32_t word_size;
+	/** Frame size in bytes at the time the stream was initialized */
+	uint32_t frame_size;
+	/** Set to true if the frames carry a CRC word that must be checked */
+	bool crc_check;
+	/** Set to true if the header is repeated until the READY bit is set */
+	bool ready_repeat;
+	/** Number of valid frames pushed in the ring */
+	uint32_t frames_ok;
+	/** Number of frames dropped because the READY bit was not set */
+	uint32_t frames_not_ready;
+	/** Number of frames dropped because of a CRC mismatch */
+	uint32_t crc_errors;
+	/** Number of times unread frames were overwritten in the ring */
+	uint32_t overruns;
+};
 
 /******************************************************************************/
 /* Functions Prototypes */
@@ -1146,4 +1190,26 @@ int32_t adas1000_read_data(struct adas1000_dev *device, uint8_t *data_buff,
 uint32_t adas1000_compute_frame_crc(struct adas1000_dev * device,
 				    uint8_t *buff);
 
+/* Initializes the frame stream reader */
+int32_t adas1000_stream_init(struct adas1000_stream **stream,
+			     struct adas1000_dev *device,
+			     const struct adas1000_stream_init_param *init_param);
+
+/* Sends the FRAMES command and starts the frame stream */
+int32_t adas1000_stream_start(struct adas1000_stream *stream);
+
+/* Reads one burst of frames and pushes the valid ones in the ring */
+int32_t adas1000_stream_fill(struct adas1000_stream *stream,
+			     uint32_t *frames_added);
+
+/* Reads the specified number of valid frames from the stream */
+int32_t adas1000_stream_read(struct adas1000_stream *stream,
+			     uint8_t *data_buff, uint32_t frame_cnt);
+
+/* Stops the frame stream */
+int32_t adas1000_stream_stop(struct adas1000_stream *stream);
+
+/* Frees the resources allocated by adas1000_stream_init() */
+int32_t adas1000_stream_remove(struct adas1000_stream *stream);
+
 #endif /* _ADAS1000_H_ */
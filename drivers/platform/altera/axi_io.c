@@ -77,3 +77,21 @@ int32_t axi_io_write(uint32_t base, uint32_t offset, uint32_t data)
 	return SUCCESS;
 }
 
+/**
+ * @brief AXI IO Altera specific buffer write function.
+ * @param base - Base address
+ * @param offset - Address offset of the first word
+ * @param data - words to be written
+ * @param nb_words - number of words to be written
+ * @return SUCCESS in case of success, FAILURE otherwise.
+ */
+int32_t axi_io_write_buff(uint32_t base, uint32_t offset, const uint32_t *data,
+			  uint32_t nb_words)
+{
+	while (nb_words--) {
+		IOWR_32DIRECT(base, offset, *data++);
+		offset += sizeof(uint32_t);
+	}
+
+	return SUCCESS;
+}
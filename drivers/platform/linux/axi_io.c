@@ -189,3 +189,97 @@ int32_t axi_io_write(uint32_t base, uint32_t offset, uint32_t data)
 	return uio_read_write(base, offset, NULL, &data);
 #endif
 }
+
+/**
+ * @brief AXI IO through UIO buffer write function. The region is mapped once
+ * and the buffer is written one word at a time, instead of one map per word.
+ * @param base - UIO index (/dev/uioX).
+ * @param offset - Address offset of the first word.
+ * @param data - Words to be written.
+ * @param nb_words - Number of words to be written.
+ * @return SUCCESS in case of success, FAILURE otherwise.
+ */
+static int32_t uio_write_buff(uint32_t base, uint32_t offset,
+			      const uint32_t *data, uint32_t nb_words)
+{
+	char buf[32];
+	int ret;
+	int uio_fd;
+	int32_t status = SUCCESS;
+	size_t map_size;
+	void *uio_addr;
+	volatile uint32_t *regs;
+	uint32_t i;
+
+	sprintf(buf, "/dev/uio%"PRIu32"", base);
+
+	uio_fd = open(buf, O_RDWR);
+	if (uio_fd < 0) {
+		printf("%s: Can't open %s\n\r", __func__, buf);
+		return FAILURE;
+	}
+
+	map_size = offset + nb_words * sizeof(*data);
+	uio_addr = mmap(NULL,
+			map_size,
+			PROT_READ|PROT_WRITE,
+			MAP_SHARED,
+			uio_fd,
+			0);
+	if (uio_addr == MAP_FAILED) {
+		printf("%s: mmap() failed\n\r", __func__);
+		status = FAILURE;
+		goto close;
+	}
+
+	/* 32-bit stores only, AXI-Lite slaves don't accept other accesses */
+	regs = (volatile uint32_t *)((uintptr_t)uio_addr + offset);
+	for (i = 0; i < nb_words; i++)
+		regs[i] = data[i];
+
+	ret = munmap(uio_addr, map_size);
+	if (ret < 0) {
+		printf("%s: munmap() failed\n\r", __func__);
+		status = FAILURE;
+	}
+
+close:
+	ret = close(uio_fd);
+	if (ret < 0) {
+		printf("%s: Can't close %s\n\r", __func__, buf);
+		status = FAILURE;
+	}
+
+	return status;
+}
+
+/**
+ * @brief AXI IO through UIO/devmem buffer write function.
+ * @param base - UIO index (/dev/uioX)/base address.
+ * @param offset - Address offset of the first word.
+ * @param data - Words to be written.
+ * @param nb_words - Number of words to be written.
+ * @return SUCCESS in case of success, FAILURE otherwise.
+ */
+int32_t axi_io_write_buff(uint32_t base, uint32_t offset, const uint32_t *data,
+			  uint32_t nb_words)
+{
+#ifdef DEVMEM
+	uint32_t i;
+	int32_t ret;
+
+	for (i = 0; i < nb_words; i++) {
+		ret = devmem_read_write(base, offset + i * sizeof(*data), NULL,
+					(uint32_t *)&data[i]);
+		if (ret != SUCCESS)
+			return ret;
+	}
+
+	return SUCCESS;
+#else
+	if (!nb_words)
+		return SUCCESS;
+
+	return uio_write_buff(base, offset, data, nb_words);
+#endif
+}
@@ -0,0 +1,545 @@
+/***************************************************************************//**
+ *   @file   linux/linux_socket.c
+ *   @brief  Implementation of Linux platform socket driver.
+********************************************************************************
+ * Copyright 2021(c) Analog Devices, Inc.
+ *
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *  - Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ *  - Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ *  - Neither the name of Analog Devices, Inc. nor the names of its
+ *    contributors may be used to endorse or promote products derived
+ *    from this software without specific prior written permission.
+ *  - The use of this software may or may not infringe the patent rights
+ *    of one or more patent holders.  This license does not release you
+ *    from the requirement that you obtain separate licenses from these
+ *    patent holders to use this software.
+ *  - Use of the software either in source or binary form, must be run
+ *    on or directly connected to an Analog Devices Inc. component.
+ *
+ * THIS SOFTWARE IS PROVIDED BY ANALOG DEVICES "AS IS" AND ANY EXPRESS OR
+ * IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, NON-INFRINGEMENT,
+ * MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED.
+ * IN NO EVENT SHALL ANALOG DEVICES BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, INTELLECTUAL PROPERTY RIGHTS, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*******************************************************************************/
+
+/******************************************************************************/
+/***************************** Include Files **********************************/
+/******************************************************************************/
+
+#include "error.h"
+#include "linux_socket.h"
+
+#include <fcntl.h>
+#include <netdb.h>
+#include <stdbool.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <sys/poll.h>
+#include <sys/socket.h>
+
+/******************************************************************************/
+/*************************** Types Declarations *******************************/
+/******************************************************************************/
+
+/**
+ * @struct linux_sock
+ * @brief State of one socket
+ */
+struct linux_sock {
+	/** File descriptor, -1 if the socket is unused */
+	int fd;
+	enum socket_protocol proto;
+	/** Storage for the address returned by socket_recvfrom */
+	char from_addr[INET_ADDRSTRLEN];
+};
+
+/**
+ * @struct linux_socket_desc
+ * @brief Linux platform socket descriptor
+ */
+struct linux_socket_desc {
+	struct network_interface interface;
+	struct linux_sock sockets[LINUX_SOCKET_MAX];
+};
+
+/******************************************************************************/
+/************************ Functions Definitions *******************************/
+/******************************************************************************/
+
+static struct linux_sock *_get_sock(struct linux_socket_desc *desc,
+				    uint32_t sock_id)
+{
+	if (!desc || sock_id >= LINUX_SOCKET_MAX ||
+	    desc->sockets[sock_id].fd < 0)
+		return NULL;
+
+	return &desc->sockets[sock_id];
+}
+
+static int32_t _resolve(const struct socket_address *addr,
+			enum socket_protocol proto, struct sockaddr_in *sa)
+{
+	struct addrinfo hints;
+	struct addrinfo *res;
+
+	if (!addr || !addr->addr)
+		return -EINVAL;
+
+	memset(&hints, 0, sizeof(hints));
+	hints.ai_family = AF_INET;
+	hints.ai_socktype = proto == PROTOCOL_TCP ? SOCK_STREAM : SOCK_DGRAM;
+	if (getaddrinfo(addr->addr, NULL, &hints, &res))
+		return -EHOSTUNREACH;
+
+	memcpy(sa, res->ai_addr, sizeof(*sa));
+	sa->sin_port = htons(addr->port);
+	freeaddrinfo(res);
+
+	return SUCCESS;
+}
+
+static int32_t _set_nonblocking(int fd)
+{
+	int flags;
+
+	flags = fcntl(fd, F_GETFL, 0);
+	if (flags < 0 || fcntl(fd, F_SETFL, flags | O_NONBLOCK) < 0)
+		return -errno;
+
+	return SUCCESS;
+}
+
+/** @brief See \ref network_interface.socket_open */
+static int32_t linux_socket_open(struct linux_socket_desc *desc,
+				 uint32_t *sock_id, enum socket_protocol proto,
+				 uint32_t buff_size)
+{
+	struct linux_sock	*sock;
+	uint32_t		i;
+	int			fd;
+	int			opt;
+
+	if (!desc || !sock_id)
+		return -EINVAL;
+
+	for (i = 0; i < LINUX_SOCKET_MAX; i++)
+		if (desc->sockets[i].fd < 0)
+			break;
+	if (i == LINUX_SOCKET_MAX)
+		return -ENOMEM;
+
+	fd = socket(AF_INET, proto == PROTOCOL_TCP ? SOCK_STREAM : SOCK_DGRAM,
+		    0);
+	if (fd < 0)
+		return -errno;
+
+	/* Small messages are sent as they are, like on the embedded stacks */
+	opt = 1;
+	if (proto == PROTOCOL_TCP)
+		setsockopt(fd, IPPROTO_TCP, TCP_NODELAY, &opt, sizeof(opt));
+	if (buff_size) {
+		opt = buff_size;
+		setsockopt(fd, SOL_SOCKET, SO_RCVBUF, &opt, sizeof(opt));
+	}
+
+	sock = &desc->sockets[i];
+	sock->fd = fd;
+	sock->proto = proto;
+	*sock_id = i;
+
+	return SUCCESS;
+}
+
+/** @brief See \ref network_interface.socket_close */
+static int32_t linux_socket_close(struct linux_socket_desc *desc,
+				  uint32_t sock_id)
+{
+	struct linux_sock *sock;
+
+	sock = _get_sock(desc, sock_id);
+	if (!sock)
+		return -EINVAL;
+
+	close(sock->fd);
+	sock->fd = -1;
+
+	return SUCCESS;
+}
+
+/**
+ * @brief See \ref network_interface.socket_connect
+ *
+ * The connect is blocking, the socket is non blocking afterwards.
+ */
+static int32_t linux_socket_connect(struct linux_socket_desc *desc,
+				    uint32_t sock_id,
+				    struct socket_address *addr)
+{
+	struct linux_sock	*sock;
+	struct sockaddr_in	sa;
+	int32_t			ret;
+
+	sock = _get_sock(desc, sock_id);
+	if (!sock)
+		return -EINVAL;
+
+	ret = _resolve(addr, sock->proto, &sa);
+	if (IS_ERR_VALUE(ret))
+		return ret;
+
+	if (connect(sock->fd, (struct sockaddr *)&sa, sizeof(sa)))
+		return -errno;
+
+	return _set_nonblocking(sock->fd);
+}
+
+/** @brief See \ref network_interface.socket_disconnect */
+static int32_t linux_socket_disconnect(struct linux_socket_desc *desc,
+				       uint32_t sock_id)
+{
+	struct linux_sock *sock;
+
+	sock = _get_sock(desc, sock_id);
+	if (!sock)
+		return -EINVAL;
+
+	if (sock->proto == PROTOCOL_TCP && shutdown(sock->fd, SHUT_RDWR))
+		return -errno;
+
+	return SUCCESS;
+}
+
+/** @brief See \ref network_interface.socket_send */
+static int32_t linux_socket_send(struct linux_socket_desc *desc,
+				 uint32_t sock_id, const void *data,
+				 uint32_t size)
+{
+	struct linux_sock	*sock;
+	struct pollfd		pfd;
+	uint32_t		i;
+	ssize_t			ret;
+
+	sock = _get_sock(desc, sock_id);
+	if (!sock)
+		return -EINVAL;
+
+	/* Like the AT driver, return only when all the data was sent */
+	i = 0;
+	while (i < size) {
+		ret = send(sock->fd, (const uint8_t *)data + i, size - i,
+			   MSG_NOSIGNAL);
+		if (ret < 0) {
+			if (errno == EAGAIN || errno == EWOULDBLOCK) {
+				/* Wait for space in the socket buffer */
+				pfd.fd = sock->fd;
+				pfd.events = POLLOUT;
+				poll(&pfd, 1, -1);
+				continue;
+			}
+			if (errno == EINTR)
+				continue;
+			if (errno == EPIPE || errno == ECONNRESET)
+				return -ENOTCONN;
+			return -errno;
+		}
+		i += ret;
+	}
+
+	return size;
+}
+
+/** @brief See \ref network_interface.socket_recv */
+static int32_t linux_socket_recv(struct linux_socket_desc *desc,
+				 uint32_t sock_id, void *data, uint32_t size)
+{
+	struct linux_sock	*sock;
+	ssize_t			ret;
+
+	sock = _get_sock(desc, sock_id);
+	if (!sock || !size)
+		return -EINVAL;
+
+	ret = recv(sock->fd, data, size, MSG_DONTWAIT);
+	if (ret < 0) {
+		if (errno == EAGAIN || errno == EWOULDBLOCK || errno == EINTR)
+			return -EAGAIN;
+		if (errno == ECONNRESET)
+			return -ENOTCONN;
+		return -errno;
+	}
+	/* Orderly shutdown of the remote */
+	if (ret == 0 && sock->proto == PROTOCOL_TCP)
+		return -ENOTCONN;
+
+	return ret;
+}
+
+/** @brief See \ref network_interface.socket_sendto */
+static int32_t linux_socket_sendto(struct linux_socket_desc *desc,
+				   uint32_t sock_id, const void *data,
+				   uint32_t size,
+				   const struct socket_address *to)
+{
+	struct linux_sock	*sock;
+	struct sockaddr_in	sa;
+	int32_t			ret;
+
+	sock = _get_sock(desc, sock_id);
+	if (!sock || sock->proto != PROTOCOL_UDP)
+		return -EINVAL;
+
+	ret = _resolve(to, sock->proto, &sa);
+	if (IS_ERR_VALUE(ret))
+		return ret;
+
+	if (sendto(sock->fd, data, size, 0, (struct sockaddr *)&sa,
+		   sizeof(sa)) < 0)
+		return -errno;
+
+	return size;
+}
+
+/**
+ * @brief See \ref network_interface.socket_recvfrom
+ *
+ * from->addr points to storage of the socket, valid until the next call.
+ */
+static int32_t linux_socket_recvfrom(struct linux_socket_desc *desc,
+				     uint32_t sock_id, void *data,
+				     uint32_t size,
+				     struct socket_address *from)
+{
+	struct linux_sock	*sock;
+	struct sockaddr_in	sa;
+	socklen_t		len;
+	ssize_t			ret;
+
+	sock = _get_sock(desc, sock_id);
+	if (!sock || sock->proto != PROTOCOL_UDP)
+		return -EINVAL;
+
+	len = sizeof(sa);
+	ret = recvfrom(sock->fd, data, size, MSG_DONTWAIT,
+		       (struct sockaddr *)&sa, &len);
+	if (ret < 0) {
+		if (errno == EAGAIN || errno == EWOULDBLOCK || errno == EINTR)
+			return -EAGAIN;
+		return -errno;
+	}
+
+	if (from) {
+		inet_ntop(AF_INET, &sa.sin_addr, sock->from_addr,
+			  sizeof(sock->from_addr));
+		from->addr = sock->from_addr;
+		from->port = ntohs(sa.sin_port);
+	}
+
+	return ret;
+}
+
+/** @brief See \ref network_interface.socket_bind */
+static int32_t linux_socket_bind(struct linux_socket_desc *desc,
+				 uint32_t sock_id, uint16_t port)
+{
+	struct linux_sock	*sock;
+	struct sockaddr_in	sa;
+	int			opt;
+
+	sock = _get_sock(desc, sock_id);
+	if (!sock)
+		return -EINVAL;
+
+	opt = 1;
+	setsockopt(sock->fd, SOL_SOCKET, SO_REUSEADDR, &opt, sizeof(opt));
+
+	memset(&sa, 0, sizeof(sa));
+	sa.sin_family = AF_INET;
+	sa.sin_addr.s_addr = htonl(INADDR_ANY);
+	sa.sin_port = htons(port);
+	if (bind(sock->fd, (struct sockaddr *)&sa, sizeof(sa)))
+		return -errno;
+
+	return SUCCESS;
+}
+
+/** @brief See \ref network_interface.socket_listen */
+static int32_t linux_socket_listen(struct linux_socket_desc *desc,
+				   uint32_t sock_id, uint32_t back_log)
+{
+	struct linux_sock *sock;
+
+	sock = _get_sock(desc, sock_id);
+	if (!sock)
+		return -EINVAL;
+
+	if (listen(sock->fd, back_log ? back_log : SOMAXCONN))
+		return -errno;
+
+	return _set_nonblocking(sock->fd);
+}
+
+/**
+ * @brief See \ref network_interface.socket_accept
+ *
+ * Returns -EAGAIN if no connection is waiting, like the AT driver.
+ */
+static int32_t linux_socket_accept(struct linux_socket_desc *desc,
+				   uint32_t sock_id,
+				   uint32_t *client_socket_id)
+{
+	struct linux_sock	*sock;
+	uint32_t		i;
+	int32_t			ret;
+	int			fd;
+	int			opt;
+
+	sock = _get_sock(desc, sock_id);
+	if (!sock || !client_socket_id)
+		return -EINVAL;
+
+	for (i = 0; i < LINUX_SOCKET_MAX; i++)
+		if (desc->sockets[i].fd < 0)
+			break;
+	if (i == LINUX_SOCKET_MAX)
+		return -ENOMEM;
+
+	fd = accept(sock->fd, NULL, NULL);
+	if (fd < 0) {
+		if (errno == EAGAIN || errno == EWOULDBLOCK || errno == EINTR)
+			return -EAGAIN;
+		return -errno;
+	}
+
+	opt = 1;
+	setsockopt(fd, IPPROTO_TCP, TCP_NODELAY, &opt, sizeof(opt));
+	ret = _set_nonblocking(fd);
+	if (IS_ERR_VALUE(ret)) {
+		close(fd);
+		return ret;
+	}
+
+	desc->sockets[i].fd = fd;
+	desc->sockets[i].proto = PROTOCOL_TCP;
+	*client_socket_id = i;
+
+	return SUCCESS;
+}
+
+/**
+ * @brief Initialize the network_interface backed by BSD sockets.
+ *
+ * Addresses are IPv4 addresses or host names. Sockets are non blocking except
+ * for connect and send, which return when done.
+ * @param desc - Address where to store the descriptor.
+ * @return SUCCESS in case of success, error code otherwise.
+ */
+int32_t linux_socket_init(struct linux_socket_desc **desc)
+{
+	struct linux_socket_desc	*ldesc;
+	uint32_t			i;
+
+	if (!desc)
+		return -EINVAL;
+
+	ldesc = (struct linux_socket_desc *)calloc(1, sizeof(*ldesc));
+	if (!ldesc)
+		return -ENOMEM;
+
+	for (i = 0; i < LINUX_SOCKET_MAX; i++)
+		ldesc->sockets[i].fd = -1;
+
+	ldesc->interface.net = ldesc;
+	ldesc->interface.socket_open =
+		(int32_t (*)(void *, uint32_t *, enum socket_protocol,
+			     uint32_t))linux_socket_open;
+	ldesc->interface.socket_close =
+		(int32_t (*)(void *, uint32_t))linux_socket_close;
+	ldesc->interface.socket_connect =
+		(int32_t (*)(void *, uint32_t, struct socket_address *))
+		linux_socket_connect;
+	ldesc->interface.socket_disconnect =
+		(int32_t (*)(void *, uint32_t))linux_socket_disconnect;
+	ldesc->interface.socket_send =
+		(int32_t (*)(void *, uint32_t, const void *, uint32_t))
+		linux_socket_send;
+	ldesc->interface.socket_recv =
+		(int32_t (*)(void *, uint32_t, void *, uint32_t))
+		linux_socket_recv;
+	ldesc->interface.socket_sendto =
+		(int32_t (*)(void *, uint32_t, const void *, uint32_t,
+			     const struct socket_address *))
+		linux_socket_sendto;
+	ldesc->interface.socket_recvfrom =
+		(int32_t (*)(void *, uint32_t, void *, uint32_t,
+			     struct socket_address *))
+		linux_socket_recvfrom;
+	ldesc->interface.socket_bind =
+		(int32_t (*)(void *, uint32_t, uint16_t))
+		linux_socket_bind;
+	ldesc->interface.socket_listen =
+		(int32_t (*)(void *, uint32_t, uint32_t))
+		linux_socket_listen;
+	ldesc->interface.socket_accept =
+		(int32_t (*)(void *, uint32_t, uint32_t*))
+		linux_socket_accept;
+
+	*desc = ldesc;
+
+	return SUCCESS;
+}
+
+/**
+ * @brief Close all the sockets and free the resources.
+ * @param desc - Descriptor returned by linux_socket_init().
+ * @return SUCCESS in case of success, error code otherwise.
+ */
+int32_t linux_socket_remove(struct linux_socket_desc *desc)
+{
+	uint32_t i;
+
+	if (!desc)
+		return -EINVAL;
+
+	for (i = 0; i < LINUX_SOCKET_MAX; i++)
+		if (desc->sockets[i].fd >= 0)
+			close(desc->sockets[i].fd);
+	free(desc);
+
+	return SUCCESS;
+}
+
+/**
+ * @brief Get the network interface.
+ * @param desc - Descriptor returned by linux_socket_init().
+ * @param net - Address where to store the reference to the interface.
+ * @return SUCCESS in case of success, error code otherwise.
+ */
+int32_t linux_socket_get_network_interface(struct linux_socket_desc *desc,
+		struct network_interface **net)
+{
+	if (!desc || !net)
+		return -EINVAL;
+
+	*net = &desc->interface;
+
+	return SUCCESS;
+}
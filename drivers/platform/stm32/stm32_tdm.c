@@ -44,13 +44,21 @@
 #include "stm32_tdm.h"
 #include "error.h"
 
+/* Maximum number of SAI blocks doing cyclic reads at the same time */
+#define STM32_TDM_MAX_CYCLIC	4
+
+/* Descriptors of the running cyclic reads, looked up by SAI handle */
+static struct stm32_tdm_desc *stm32_tdm_cyclic[STM32_TDM_MAX_CYCLIC];
+
 /**
  * @brief stm32 platform specific TDM platform ops structure
  */
 const struct tdm_platform_ops stm32_tdm_platform_ops = {
 	.tdm_ops_init = &stm32_tdm_init,
 	.tdm_ops_read = &stm32_tdm_read,
-	.tdm_ops_remove = &stm32_tdm_remove
+	.tdm_ops_remove = &stm32_tdm_remove,
+	.tdm_ops_read_cyclic_start = &stm32_tdm_read_cyclic_start,
+	.tdm_ops_read_cyclic_stop = &stm32_tdm_read_cyclic_stop
 };
 
 /**
@@ -130,6 +138,13 @@ int32_t stm32_tdm_init(struct tdm_desc **desc,
 		break;
 	};
 	tdesc->hsai.Init.DataSize = tmp;
+	/* SAI FIFO accesses are byte, half-word or word wide */
+	if (param->data_size <= 8)
+		tdesc->sample_bytes = 1;
+	else if (param->data_size <= 16)
+		tdesc->sample_bytes = 2;
+	else
+		tdesc->sample_bytes = 4;
 	tdesc->hsai.Init.FirstBit = param->data_lsb_first ? SAI_FIRSTBIT_LSB :
 				    SAI_FIRSTBIT_MSB;
 	tdesc->hsai.Init.ClockStrobing = param->rising_edge_sampling ?
@@ -219,3 +234,138 @@ int32_t stm32_tdm_read(struct tdm_desc *desc,
 
 	return ret;
 }
+
+/**
+ * @brief Find the descriptor of the cyclic read running on a SAI block.
+ * @param hsai - SAI handle.
+ * @return The descriptor, NULL if the SAI block is not used by this driver.
+ */
+static struct stm32_tdm_desc *stm32_tdm_find(SAI_HandleTypeDef *hsai)
+{
+	uint32_t i;
+
+	for (i = 0; i < STM32_TDM_MAX_CYCLIC; i++)
+		if (stm32_tdm_cyclic[i] && &stm32_tdm_cyclic[i]->hsai == hsai)
+			return stm32_tdm_cyclic[i];
+
+	return NULL;
+}
+
+/**
+ * @brief Hand the first half of the circular buffer to the user. Registered
+ * on the SAI handle when USE_HAL_SAI_REGISTER_CALLBACKS is set, otherwise it
+ * must be called from the application HAL_SAI_RxHalfCpltCallback().
+ * @param hsai - SAI handle. Handles not used by this driver are ignored.
+ */
+void stm32_tdm_rx_half_cplt_callback(SAI_HandleTypeDef *hsai)
+{
+	struct stm32_tdm_desc *tdesc = stm32_tdm_find(hsai);
+
+	if (tdesc && tdesc->rx_callback)
+		tdesc->rx_callback(tdesc->rx_ctx, tdesc->rx_data,
+				   tdesc->rx_nb_samples / 2);
+}
+
+/**
+ * @brief Hand the second half of the circular buffer to the user. Registered
+ * on the SAI handle when USE_HAL_SAI_REGISTER_CALLBACKS is set, otherwise it
+ * must be called from the application HAL_SAI_RxCpltCallback().
+ * @param hsai - SAI handle. Handles not used by this driver are ignored.
+ */
+void stm32_tdm_rx_cplt_callback(SAI_HandleTypeDef *hsai)
+{
+	struct stm32_tdm_desc *tdesc = stm32_tdm_find(hsai);
+	uint16_t half;
+
+	if (!tdesc || !tdesc->rx_callback)
+		return;
+
+	half = tdesc->rx_nb_samples / 2;
+	tdesc->rx_callback(tdesc->rx_ctx,
+			   tdesc->rx_data + half * tdesc->sample_bytes, half);
+}
+
+/**
+ * @brief Start a cyclic read using SAI TDM mode. The DMA channel linked to the
+ * SAI block must be configured in circular mode.
+ * @param desc - The TDM descriptor.
+ * @param data - The circular buffer.
+ * @param nb_samples - Number of samples in the whole buffer (must be even).
+ * @param callback - Function called when a half of the buffer is filled.
+ * @param ctx - Context passed to the callback.
+ * @return SUCCESS in case of success, negative error code otherwise.
+ */
+int32_t stm32_tdm_read_cyclic_start(struct tdm_desc *desc, void *data,
+				    uint16_t nb_samples,
+				    tdm_rx_callback callback, void *ctx)
+{
+	struct stm32_tdm_desc *tdesc;
+	uint32_t i;
+
+	if (!desc || !desc->extra || !data || !callback || !nb_samples ||
+	    (nb_samples % 2))
+		return -EINVAL;
+
+	tdesc = desc->extra;
+
+	if (!tdesc->hsai.hdmarx || tdesc->hsai.hdmarx->Init.Mode != DMA_CIRCULAR)
+		return -ENOTSUP;
+
+	for (i = 0; i < STM32_TDM_MAX_CYCLIC; i++)
+		if (!stm32_tdm_cyclic[i] || stm32_tdm_cyclic[i] == tdesc)
+			break;
+	if (i == STM32_TDM_MAX_CYCLIC)
+		return -EBUSY;
+
+	tdesc->rx_callback = callback;
+	tdesc->rx_ctx = ctx;
+	tdesc->rx_data = data;
+	tdesc->rx_nb_samples = nb_samples;
+	stm32_tdm_cyclic[i] = tdesc;
+
+#if (USE_HAL_SAI_REGISTER_CALLBACKS == 1)
+	if (HAL_SAI_RegisterCallback(&tdesc->hsai,
+				     HAL_SAI_RX_HALFCOMPLETE_CB_ID,
+				     stm32_tdm_rx_half_cplt_callback) != HAL_OK ||
+	    HAL_SAI_RegisterCallback(&tdesc->hsai, HAL_SAI_RX_COMPLETE_CB_ID,
+				     stm32_tdm_rx_cplt_callback) != HAL_OK) {
+		stm32_tdm_cyclic[i] = NULL;
+		tdesc->rx_callback = NULL;
+		return -EIO;
+	}
+#endif
+
+	if (HAL_SAI_Receive_DMA(&tdesc->hsai, data, nb_samples) != HAL_OK) {
+		stm32_tdm_cyclic[i] = NULL;
+		tdesc->rx_callback = NULL;
+		return -EIO;
+	}
+
+	return SUCCESS;
+}
+
+/**
+ * @brief Stop a cyclic read.
+ * @param desc - The TDM descriptor.
+ * @return SUCCESS in case of success, negative error code otherwise.
+ */
+int32_t stm32_tdm_read_cyclic_stop(struct tdm_desc *desc)
+{
+	struct stm32_tdm_desc *tdesc;
+	uint32_t i;
+
+	if (!desc || !desc->extra)
+		return -EINVAL;
+
+	tdesc = desc->extra;
+
+	if (HAL_SAI_DMAStop(&tdesc->hsai) != HAL_OK)
+		return -EIO;
+
+	tdesc->rx_callback = NULL;
+	for (i = 0; i < STM32_TDM_MAX_CYCLIC; i++)
+		if (stm32_tdm_cyclic[i] == tdesc)
+			stm32_tdm_cyclic[i] = NULL;
+
+	return SUCCESS;
+}
@@ -60,6 +60,16 @@ typedef struct stm32_tdm_init_param {
 typedef struct stm32_tdm_desc {
 	/** TDM instance */
 	SAI_HandleTypeDef hsai;
+	/** Callback for the cyclic read */
+	tdm_rx_callback rx_callback;
+	/** Context of the cyclic read callback */
+	void *rx_ctx;
+	/** Buffer of the cyclic read */
+	uint8_t *rx_data;
+	/** Number of samples in the cyclic read buffer */
+	uint16_t rx_nb_samples;
+	/** Size in bytes of a sample in memory */
+	uint8_t sample_bytes;
 } stm32_tdm_desc;
 
 /**
@@ -79,4 +89,21 @@ int32_t stm32_tdm_remove(struct tdm_desc *desc);
 int32_t stm32_tdm_read(struct tdm_desc *desc, void *data,
 		       uint16_t bytes_number);
 
+/* Start a cyclic read using SAI TDM mode with circular DMA. */
+int32_t stm32_tdm_read_cyclic_start(struct tdm_desc *desc, void *data,
+				    uint16_t nb_samples,
+				    tdm_rx_callback callback, void *ctx);
+
+/* Stop a cyclic read. */
+int32_t stm32_tdm_read_cyclic_stop(struct tdm_desc *desc);
+
+/*
+ * SAI DMA half transfer and transfer complete handlers of the cyclic read.
+ * They are registered on the SAI handle when USE_HAL_SAI_REGISTER_CALLBACKS
+ * is set. Otherwise the application must call them from its
+ * HAL_SAI_RxHalfCpltCallback() and HAL_SAI_RxCpltCallback().
+ */
+void stm32_tdm_rx_half_cplt_callback(SAI_HandleTypeDef *hsai);
+void stm32_tdm_rx_cplt_callback(SAI_HandleTypeDef *hsai);
+
 #endif // STM32_TDM_H_
@@ -77,3 +77,24 @@ int32_t axi_io_write(uint32_t base, uint32_t offset, uint32_t data)
 	return SUCCESS;
 }
 
+
+/**
+ * @brief AXI IO Xilinx specific buffer write function.
+ * @param base - Base address
+ * @param offset - Address offset of the first word
+ * @param data - words to be written.
+ * @param nb_words - number of words to be written.
+ * @return SUCCESS in case of success, FAILURE otherwise.
+ */
+int32_t axi_io_write_buff(uint32_t base, uint32_t offset, const uint32_t *data,
+			  uint32_t nb_words)
+{
+	uint32_t addr = base + offset;
+
+	while (nb_words--) {
+		Xil_Out32(addr, *data++);
+		addr += sizeof(uint32_t);
+	}
+
+	return SUCCESS;
+}
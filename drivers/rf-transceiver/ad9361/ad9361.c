@@ -1282,10 +1282,13 @@ static int32_t ad9361_check_cal_done(struct ad9361_rf_phy *phy, uint32_t reg,
 		if (state == done_state)
 			return 0;
 
-		if (reg == REG_CALIBRATION_CTRL)
+		if (reg == REG_CALIBRATION_CTRL) {
 			udelay(1200);
-		else
+			phy->cal_wait_us += 1200;
+		} else {
 			udelay(120);
+			phy->cal_wait_us += 120;
+		}
 	} while (timeout--);
 
 	dev_err(&phy->spi->dev, "Calibration TIMEOUT (0x%"PRIX32", 0x%"PRIX32")", reg,
@@ -1313,6 +1316,95 @@ static int32_t ad9361_run_calibration(struct ad9361_rf_phy *phy, uint32_t mask)
 	return ad9361_check_cal_done(phy, REG_CALIBRATION_CTRL, mask, 0);
 }
 
+/**
+ * Calibration result registers kept in the calibration cache.
+ */
+static const struct {
+	uint16_t reg;
+	uint8_t len;
+} ad9361_cal_cache_regs[AD9361_CAL_CACHE_NUM][2] = {
+	[AD9361_CAL_CACHE_RX_BBF] = {
+		{ REG_RX1_BBF_R1A, 2 },
+		{ REG_RX1_BBF_R5, REG_RX_BBF_C3_LSB - REG_RX1_BBF_R5 + 1 },
+	},
+	[AD9361_CAL_CACHE_TX_BBF] = {
+		{ REG_TX_BBF_R1, REG_TX_BBF_CP - REG_TX_BBF_R1 + 1 },
+		{ REG_TX_BBF_R2B, REG_TX_BBF_TUNE - REG_TX_BBF_R2B + 1 },
+	},
+	[AD9361_CAL_CACHE_TX_QUAD] = {
+		{ REG_TX1_OUT_1_PHASE_CORR, AD9361_CAL_CACHE_MAX_REGS },
+	},
+};
+
+/**
+ * Read or write the result registers of a calibration cache section, with
+ * burst transfers. The values are stored in ascending register order.
+ * @param phy The AD9361 state structure.
+ * @param section The cache section.
+ * @param regs The register values.
+ * @param write Write the registers instead of reading them.
+ * @return 0 in case of success, negative error code otherwise.
+ */
+static int32_t ad9361_cal_cache_xfer(struct ad9361_rf_phy *phy,
+				     enum ad9361_cal_cache_section section,
+				     uint8_t *regs, bool write)
+{
+	uint8_t buf[MAX_MBYTE_SPI];
+	uint32_t i, j, len, top, done;
+	int32_t ret;
+
+	for (i = 0; i < ARRAY_SIZE(ad9361_cal_cache_regs[section]); i++) {
+		for (done = 0; done < ad9361_cal_cache_regs[section][i].len;
+		     done += len) {
+			len = min_t(uint32_t, MAX_MBYTE_SPI,
+				    ad9361_cal_cache_regs[section][i].len - done);
+			/* Multi byte transfers go down from the given address */
+			top = ad9361_cal_cache_regs[section][i].reg + done + len - 1;
+			if (write) {
+				for (j = 0; j < len; j++)
+					buf[j] = regs[done + len - 1 - j];
+				ret = ad9361_spi_writem(phy->spi, top, buf, len);
+			} else {
+				ret = ad9361_spi_readm(phy->spi, top, buf, len);
+				for (j = 0; j < len; j++)
+					regs[done + len - 1 - j] = buf[j];
+			}
+			if (ret < 0)
+				return ret;
+		}
+		regs += ad9361_cal_cache_regs[section][i].len;
+	}
+
+	return 0;
+}
+
+/**
+ * Restore a calibration from the calibration cache during a warm boot, or
+ * run it and record how long it took.
+ * @param phy The AD9361 state structure.
+ * @param section The cache section.
+ * @param mask The calibration bit mask.
+ * @return 0 in case of success, negative error code otherwise.
+ */
+static int32_t ad9361_run_calibration_cached(struct ad9361_rf_phy *phy,
+		enum ad9361_cal_cache_section section, uint32_t mask)
+{
+	uint32_t start;
+	int32_t ret;
+
+	if (phy->cal_cache_restore && (phy->cal_cache->valid & BIT(section))) {
+		phy->cal_cache_saved_us += phy->cal_cache->cal_time_us[section];
+		return ad9361_cal_cache_xfer(phy, section,
+					     phy->cal_cache->regs[section], true);
+	}
+
+	start = phy->cal_wait_us;
+	ret = ad9361_run_calibration(phy, mask);
+	phy->cal_time_us[section] = phy->cal_wait_us - start;
+
+	return ret;
+}
+
 /**
  * Choose the right RX gain table index for the selected frequency.
  * @param freq The frequency value [Hz].
@@ -2708,7 +2800,8 @@ static int32_t ad9361_rx_bb_analog_filter_calib(struct ad9361_rf_phy *phy,
 
 	/* Start the RX Baseband Filter calibration in register 0x016[7] */
 	/* Calibration is complete when register 0x016[7] self clears */
-	ret = ad9361_run_calibration(phy, RX_BB_TUNE_CAL);
+	ret = ad9361_run_calibration_cached(phy, AD9361_CAL_CACHE_RX_BBF,
+					    RX_BB_TUNE_CAL);
 
 	/* Disable the RX baseband filter tune circuit, write 0x1E2=3, 0x1E3=3 */
 	ad9361_spi_write(phy->spi, REG_RX1_TUNE_CTRL,
@@ -2752,7 +2845,8 @@ static int32_t ad9361_tx_bb_analog_filter_calib(struct ad9361_rf_phy *phy,
 
 	/* Start the TX Baseband Filter calibration in register 0x016[6] */
 	/* Calibration is complete when register 0x016[] self clears */
-	ret = ad9361_run_calibration(phy, TX_BB_TUNE_CAL);
+	ret = ad9361_run_calibration_cached(phy, AD9361_CAL_CACHE_TX_BBF,
+					    TX_BB_TUNE_CAL);
 
 	/* Disable the TX baseband filter tune circuit by writing 0x0CA=0x26. */
 	ad9361_spi_write(phy->spi, REG_TX_TUNE_CTRL,
@@ -4994,72 +5088,122 @@ int32_t ad9361_fastlock_load(struct ad9361_rf_phy *phy, bool tx,
 }
 
 /**
- * Fastlock store.
+ * Fastlock capture. Read the current synthesizer state (including the VCO
+ * calibration results) as fastlock profile program data. Neighbouring
+ * registers are fetched with burst reads.
  * @param phy The AD9361 state structure.
  * @param tx
- * @param profile
+ * @param values Fastlock profile program data (RX_FAST_LOCK_CONFIG_WORD_NUM).
  * @return 0 in case of success, negative error code otherwise.
  */
-int32_t ad9361_fastlock_store(struct ad9361_rf_phy *phy, bool tx,
-			      uint32_t profile)
+int32_t ad9361_fastlock_capture(struct ad9361_rf_phy *phy, bool tx,
+				uint8_t *values)
 {
 	struct spi_desc *spi = phy->spi;
-	uint8_t val[16];
+	uint8_t synth[8];	/* REG_RX_FORCE_VCO_TUNE_1 down to REG_RX_INTEGER_BYTE_0 */
+	uint8_t loop[8];	/* REG_RX_LOOP_FILTER_3 down to REG_RX_ALC_VARACTOR */
+	uint8_t varactor[2];	/* REG_RX_VCO_VARACTOR_CTRL_1 and _CTRL_0 */
+	uint8_t bias, dividers;
 	uint32_t offs = 0, x, y;
+	int32_t ret;
 
-	dev_dbg(&phy->spi->dev, "%s: %s Profile %"PRIu32":",
-		__func__, tx ? "TX" : "RX", profile);
+#define SYNTH(reg)	synth[REG_RX_FORCE_VCO_TUNE_1 - (reg)]
+#define LOOP(reg)	loop[REG_RX_LOOP_FILTER_3 - (reg)]
+#define FIELD(val, mask) (((val) & (mask)) >> find_first_bit(mask))
 
 	if (tx)
 		offs = REG_TX_FAST_LOCK_SETUP - REG_RX_FAST_LOCK_SETUP;
 
-	val[0] = ad9361_spi_read(spi, REG_RX_INTEGER_BYTE_0 + offs);
-	val[1] = ad9361_spi_read(spi, REG_RX_INTEGER_BYTE_1 + offs);
-	val[2] = ad9361_spi_read(spi, REG_RX_FRACT_BYTE_0 + offs);
-	val[3] = ad9361_spi_read(spi, REG_RX_FRACT_BYTE_1 + offs);
-	val[4] = ad9361_spi_read(spi, REG_RX_FRACT_BYTE_2 + offs);
+	ret = ad9361_spi_readm(spi, REG_RX_FORCE_VCO_TUNE_1 + offs, synth,
+			       ARRAY_SIZE(synth));
+	if (ret < 0)
+		return ret;
+	ret = ad9361_spi_readm(spi, REG_RX_LOOP_FILTER_3 + offs, loop,
+			       ARRAY_SIZE(loop));
+	if (ret < 0)
+		return ret;
+	ret = ad9361_spi_readm(spi, REG_RX_VCO_VARACTOR_CTRL_1 + offs, varactor,
+			       ARRAY_SIZE(varactor));
+	if (ret < 0)
+		return ret;
+	ret = ad9361_spi_readm(spi, REG_RX_VCO_BIAS_1 + offs, &bias, 1);
+	if (ret < 0)
+		return ret;
+	ret = ad9361_spi_readm(spi, REG_RFPLL_DIVIDERS, &dividers, 1);
+	if (ret < 0)
+		return ret;
+
+	values[0] = SYNTH(REG_RX_INTEGER_BYTE_0);
+	values[1] = SYNTH(REG_RX_INTEGER_BYTE_1);
+	values[2] = SYNTH(REG_RX_FRACT_BYTE_0);
+	values[3] = SYNTH(REG_RX_FRACT_BYTE_1);
+	values[4] = SYNTH(REG_RX_FRACT_BYTE_2);
 
-	x = ad9361_spi_readf(spi, REG_RX_VCO_BIAS_1 + offs, VCO_BIAS_REF(~0));
-	y = ad9361_spi_readf(spi, REG_RX_ALC_VARACTOR + offs, VCO_VARACTOR(~0));
-	val[5] = (x << 4) | y;
+	x = FIELD(bias, VCO_BIAS_REF(~0));
+	y = FIELD(LOOP(REG_RX_ALC_VARACTOR), VCO_VARACTOR(~0));
+	values[5] = (x << 4) | y;
 
-	x = ad9361_spi_readf(spi, REG_RX_VCO_BIAS_1 + offs, VCO_BIAS_TCF(~0));
-	y = ad9361_spi_readf(spi, REG_RX_CP_CURRENT + offs, CHARGE_PUMP_CURRENT(~0));
+	x = FIELD(bias, VCO_BIAS_TCF(~0));
+	y = FIELD(LOOP(REG_RX_CP_CURRENT), CHARGE_PUMP_CURRENT(~0));
 	/* Wide BW option: N = 1
 	* Set init and steady state values to the same - let user space handle it
 	*/
-	val[6] = (x << 3) | y;
-	val[7] = y;
+	values[6] = (x << 3) | y;
+	values[7] = y;
+
+	x = FIELD(LOOP(REG_RX_LOOP_FILTER_3), LOOP_FILTER_R3(~0));
+	values[8] = (x << 4) | x;
+
+	x = FIELD(LOOP(REG_RX_LOOP_FILTER_2), LOOP_FILTER_C3(~0));
+	values[9] = (x << 4) | x;
+
+	x = FIELD(LOOP(REG_RX_LOOP_FILTER_1), LOOP_FILTER_C1(~0));
+	y = FIELD(LOOP(REG_RX_LOOP_FILTER_1), LOOP_FILTER_C2(~0));
+	values[10] = (x << 4) | y;
 
-	x = ad9361_spi_readf(spi, REG_RX_LOOP_FILTER_3 + offs, LOOP_FILTER_R3(~0));
-	val[8] = (x << 4) | x;
+	x = FIELD(LOOP(REG_RX_LOOP_FILTER_2), LOOP_FILTER_R1(~0));
+	values[11] = (x << 4) | x;
 
-	x = ad9361_spi_readf(spi, REG_RX_LOOP_FILTER_2 + offs, LOOP_FILTER_C3(~0));
-	val[9] = (x << 4) | x;
+	x = FIELD(varactor[1], VCO_VARACTOR_REFERENCE_TCF(~0));
+	y = FIELD(dividers, tx ? TX_VCO_DIVIDER(~0) : RX_VCO_DIVIDER(~0));
+	values[12] = (x << 4) | y;
 
-	x = ad9361_spi_readf(spi, REG_RX_LOOP_FILTER_1 + offs, LOOP_FILTER_C1(~0));
-	y = ad9361_spi_readf(spi, REG_RX_LOOP_FILTER_1 + offs, LOOP_FILTER_C2(~0));
-	val[10] = (x << 4) | y;
+	x = FIELD(SYNTH(REG_RX_FORCE_VCO_TUNE_1), VCO_CAL_OFFSET(~0));
+	y = FIELD(varactor[0], VCO_VARACTOR_REFERENCE(~0));
+	values[13] = (x << 4) | y;
 
-	x = ad9361_spi_readf(spi, REG_RX_LOOP_FILTER_2 + offs, LOOP_FILTER_R1(~0));
-	val[11] = (x << 4) | x;
+	values[14] = SYNTH(REG_RX_FORCE_VCO_TUNE_0);
 
-	x = ad9361_spi_readf(spi, REG_RX_VCO_VARACTOR_CTRL_0 + offs,
-			     VCO_VARACTOR_REFERENCE_TCF(~0));
-	y = ad9361_spi_readf(spi, REG_RFPLL_DIVIDERS,
-			     tx ? TX_VCO_DIVIDER(~0) : RX_VCO_DIVIDER(~0));
-	val[12] = (x << 4) | y;
+	x = FIELD(SYNTH(REG_RX_FORCE_ALC), FORCE_ALC_WORD(~0));
+	y = FIELD(SYNTH(REG_RX_FORCE_VCO_TUNE_1), FORCE_VCO_TUNE);
+	values[15] = (x << 1) | y;
 
-	x = ad9361_spi_readf(spi, REG_RX_FORCE_VCO_TUNE_1 + offs, VCO_CAL_OFFSET(~0));
-	y = ad9361_spi_readf(spi, REG_RX_VCO_VARACTOR_CTRL_1 + offs,
-			     VCO_VARACTOR_REFERENCE(~0));
-	val[13] = (x << 4) | y;
+#undef SYNTH
+#undef LOOP
+#undef FIELD
 
-	val[14] = ad9361_spi_read(spi, REG_RX_FORCE_VCO_TUNE_0 + offs);
+	return 0;
+}
 
-	x = ad9361_spi_readf(spi, REG_RX_FORCE_ALC + offs, FORCE_ALC_WORD(~0));
-	y = ad9361_spi_readf(spi, REG_RX_FORCE_VCO_TUNE_1 + offs, FORCE_VCO_TUNE);
-	val[15] = (x << 1) | y;
+/**
+ * Fastlock store.
+ * @param phy The AD9361 state structure.
+ * @param tx
+ * @param profile
+ * @return 0 in case of success, negative error code otherwise.
+ */
+int32_t ad9361_fastlock_store(struct ad9361_rf_phy *phy, bool tx,
+			      uint32_t profile)
+{
+	uint8_t val[RX_FAST_LOCK_CONFIG_WORD_NUM];
+	int32_t ret;
+
+	dev_dbg(&phy->spi->dev, "%s: %s Profile %"PRIu32":",
+		__func__, tx ? "TX" : "RX", profile);
+
+	ret = ad9361_fastlock_capture(phy, tx, val);
+	if (ret < 0)
+		return ret;
 
 	return ad9361_fastlock_load(phy, tx, profile, val);
 }
@@ -5315,6 +5459,100 @@ static uint32_t ad9361_ref_div_sel(uint32_t refin_Hz, uint32_t max)
 		return 0;
 }
 
+/**
+ * Check if the calibration cache matches the requested operating context.
+ * @param phy The AD9361 state structure.
+ * @param refin_Hz The reference clock rate [Hz].
+ * @return true if the cached results can be restored.
+ */
+static bool ad9361_cal_cache_match(struct ad9361_rf_phy *phy,
+				   uint32_t refin_Hz)
+{
+	struct ad9361_cal_cache *cache = phy->cal_cache;
+	struct ad9361_phy_platform_data *pd = phy->pdata;
+	uint64_t lo_tol = phy->cal_cache_lo_tolerance_hz;
+	int32_t temp;
+
+	if (cache->magic != AD9361_CAL_CACHE_MAGIC ||
+	    cache->version != AD9361_CAL_CACHE_VERSION || !cache->valid)
+		return false;
+
+	if (cache->ctx.refin_hz != refin_Hz ||
+	    cache->ctx.rx_bw_hz != pd->rf_rx_bandwidth_Hz ||
+	    cache->ctx.tx_bw_hz != pd->rf_tx_bandwidth_Hz ||
+	    memcmp(cache->ctx.rx_path_clks, pd->rx_path_clks,
+		   sizeof(cache->ctx.rx_path_clks)) ||
+	    memcmp(cache->ctx.tx_path_clks, pd->tx_path_clks,
+		   sizeof(cache->ctx.tx_path_clks))) {
+		dev_dbg(dev, "%s: configuration mismatch", __func__);
+		return false;
+	}
+
+	if ((cache->ctx.rx_lo_hz > pd->rx_synth_freq ?
+	     cache->ctx.rx_lo_hz - pd->rx_synth_freq :
+	     pd->rx_synth_freq - cache->ctx.rx_lo_hz) > lo_tol ||
+	    (cache->ctx.tx_lo_hz > pd->tx_synth_freq ?
+	     cache->ctx.tx_lo_hz - pd->tx_synth_freq :
+	     pd->tx_synth_freq - cache->ctx.tx_lo_hz) > lo_tol) {
+		dev_dbg(dev, "%s: LO mismatch", __func__);
+		return false;
+	}
+
+	temp = ad9361_get_temp(phy);
+	if ((uint32_t)abs(temp - cache->ctx.temp_mdeg) >
+	    phy->cal_cache_temp_tolerance_mdeg) {
+		dev_dbg(dev, "%s: temperature mismatch (%"PRId32" / %"PRId32")",
+			__func__, temp, cache->ctx.temp_mdeg);
+		return false;
+	}
+
+	return true;
+}
+
+/**
+ * Export the calibration results and their operating context. To be called
+ * after a full calibration (ad9361_setup() without a matching cache).
+ * @param phy The AD9361 state structure.
+ * @param cache The calibration cache to fill.
+ * @return 0 in case of success, negative error code otherwise.
+ */
+int32_t ad9361_cal_cache_export(struct ad9361_rf_phy *phy,
+				struct ad9361_cal_cache *cache)
+{
+	struct ad9361_phy_platform_data *pd = phy->pdata;
+	uint32_t i;
+	int32_t ret;
+
+	memset(cache, 0, sizeof(*cache));
+
+	cache->ctx.rx_lo_hz = ad9361_from_clk(clk_get_rate(phy,
+					      phy->ref_clk_scale[RX_RFPLL]));
+	cache->ctx.tx_lo_hz = ad9361_from_clk(clk_get_rate(phy,
+					      phy->ref_clk_scale[TX_RFPLL]));
+	cache->ctx.rx_bw_hz = phy->current_rx_bw_Hz;
+	cache->ctx.tx_bw_hz = phy->current_tx_bw_Hz;
+	cache->ctx.refin_hz = phy->clk_refin->rate;
+	memcpy(cache->ctx.rx_path_clks, pd->rx_path_clks,
+	       sizeof(cache->ctx.rx_path_clks));
+	memcpy(cache->ctx.tx_path_clks, pd->tx_path_clks,
+	       sizeof(cache->ctx.tx_path_clks));
+	cache->ctx.temp_mdeg = ad9361_get_temp(phy);
+
+	for (i = 0; i < AD9361_CAL_CACHE_NUM; i++) {
+		ret = ad9361_cal_cache_xfer(phy, i, cache->regs[i], false);
+		if (ret < 0)
+			return ret;
+		cache->cal_time_us[i] = phy->cal_time_us[i];
+		cache->valid |= BIT(i);
+	}
+	cache->tx_quad_phase = phy->last_tx_quad_cal_phase;
+
+	cache->magic = AD9361_CAL_CACHE_MAGIC;
+	cache->version = AD9361_CAL_CACHE_VERSION;
+
+	return 0;
+}
+
 /**
  * Setup the AD9361 device.
  * @param phy The AD9361 state structure.
@@ -5329,9 +5567,14 @@ int32_t ad9361_setup(struct ad9361_rf_phy *phy)
 	uint32_t real_rx_bandwidth, real_tx_bandwidth;
 	bool tmp_use_ext_rx_lo = pd->use_ext_rx_lo;
 	bool tmp_use_ext_tx_lo = pd->use_ext_tx_lo;
+	uint32_t start;
 
 	dev_dbg(dev, "%s", __func__);
 
+	phy->cal_cache_restore = false;
+	phy->cal_cache_hit = false;
+	phy->cal_cache_saved_us = 0;
+
 	pd->rf_rx_bandwidth_Hz = ad9361_validate_rf_bw(phy, pd->rf_rx_bandwidth_Hz);
 	pd->rf_tx_bandwidth_Hz = ad9361_validate_rf_bw(phy, pd->rf_tx_bandwidth_Hz);
 
@@ -5445,6 +5688,11 @@ int32_t ad9361_setup(struct ad9361_rf_phy *phy)
 	if (ret < 0)
 		return ret;
 
+	if (phy->cal_cache) {
+		phy->cal_cache_hit = ad9361_cal_cache_match(phy, refin_Hz);
+		phy->cal_cache_restore = phy->cal_cache_hit;
+	}
+
 	/*
 	 * This allows forcing a lower F_REF window
 	 * (worse phase noise, better fractional spurs)
@@ -5572,9 +5820,24 @@ int32_t ad9361_setup(struct ad9361_rf_phy *phy)
 	phy->current_rx_bw_Hz = pd->rf_rx_bandwidth_Hz;
 	phy->current_tx_bw_Hz = pd->rf_tx_bandwidth_Hz;
 	phy->last_tx_quad_cal_phase = ~0;
-	ret = ad9361_tx_quad_calib(phy, real_rx_bandwidth, real_tx_bandwidth, -1);
+	if (phy->cal_cache_restore &&
+	    (phy->cal_cache->valid & BIT(AD9361_CAL_CACHE_TX_QUAD))) {
+		ret = ad9361_cal_cache_xfer(phy, AD9361_CAL_CACHE_TX_QUAD,
+					    phy->cal_cache->regs[AD9361_CAL_CACHE_TX_QUAD],
+					    true);
+		phy->last_tx_quad_cal_phase = phy->cal_cache->tx_quad_phase;
+		phy->cal_cache_saved_us +=
+			phy->cal_cache->cal_time_us[AD9361_CAL_CACHE_TX_QUAD];
+	} else {
+		start = phy->cal_wait_us;
+		ret = ad9361_tx_quad_calib(phy, real_rx_bandwidth,
+					   real_tx_bandwidth, -1);
+		phy->cal_time_us[AD9361_CAL_CACHE_TX_QUAD] =
+			phy->cal_wait_us - start;
+	}
 	if (ret < 0)
 		return ret;
+	phy->cal_cache_restore = false;
 
 	ret = ad9361_tracking_control(phy, phy->bbdc_track_en,
 				      phy->rfdc_track_en, phy->quad_track_en);
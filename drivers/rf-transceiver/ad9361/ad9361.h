@@ -3310,6 +3310,42 @@ struct ad9361_fastlock {
 	struct ad9361_fastlock_entry entry[2][8];
 };
 
+#define AD9361_CAL_CACHE_MAGIC		0x41443631 /* "AD61" */
+#define AD9361_CAL_CACHE_VERSION	1
+#define AD9361_CAL_CACHE_MAX_REGS	16
+
+enum ad9361_cal_cache_section {
+	AD9361_CAL_CACHE_RX_BBF,
+	AD9361_CAL_CACHE_TX_BBF,
+	AD9361_CAL_CACHE_TX_QUAD,
+	AD9361_CAL_CACHE_NUM,
+};
+
+/* Operating context the cached calibration results are valid for. */
+struct ad9361_cal_context {
+	uint64_t	rx_lo_hz;
+	uint64_t	tx_lo_hz;
+	uint32_t	rx_bw_hz;
+	uint32_t	tx_bw_hz;
+	uint32_t	refin_hz;
+	uint32_t	rx_path_clks[NUM_RX_CLOCKS];
+	uint32_t	tx_path_clks[NUM_TX_CLOCKS];
+	int32_t		temp_mdeg;
+};
+
+/* Calibration results, exported after a full calibration and meant to be kept
+ * in non-volatile memory. */
+struct ad9361_cal_cache {
+	uint32_t	magic;
+	uint32_t	version;
+	struct ad9361_cal_context ctx;
+	uint32_t	valid;	/* BIT(enum ad9361_cal_cache_section) */
+	uint8_t		regs[AD9361_CAL_CACHE_NUM][AD9361_CAL_CACHE_MAX_REGS];
+	uint8_t		tx_quad_phase;
+	/* Time the calibration took when the results were produced */
+	uint32_t	cal_time_us[AD9361_CAL_CACHE_NUM];
+};
+
 enum dig_tune_flags {
 	BE_VERBOSE = 1,
 	BE_MOREVERBOSE = 2,
@@ -3416,6 +3452,14 @@ struct ad9361_rf_phy {
 	uint32_t				bist_tone_level_dB;
 	uint32_t				bist_tone_mask;
 	bool			bbpll_initialized;
+	struct ad9361_cal_cache	*cal_cache;
+	uint32_t		cal_cache_lo_tolerance_hz;
+	uint32_t		cal_cache_temp_tolerance_mdeg;
+	bool			cal_cache_restore;
+	bool			cal_cache_hit;
+	uint32_t		cal_cache_saved_us;
+	uint32_t		cal_wait_us;
+	uint32_t		cal_time_us[AD9361_CAL_CACHE_NUM];
 };
 
 struct refclk_scale {
@@ -3530,6 +3574,10 @@ int32_t ad9361_rf_port_setup(struct ad9361_rf_phy *phy, bool is_out,
 int32_t ad9361_mcs(struct ad9361_rf_phy *phy, int32_t step);
 int32_t ad9361_do_calib_run(struct ad9361_rf_phy *phy, uint32_t cal,
 			    int32_t arg);
+int32_t ad9361_cal_cache_export(struct ad9361_rf_phy *phy,
+				struct ad9361_cal_cache *cache);
+int32_t ad9361_fastlock_capture(struct ad9361_rf_phy *phy, bool tx,
+				uint8_t *values);
 int32_t ad9361_fastlock_store(struct ad9361_rf_phy *phy, bool tx,
 			      uint32_t profile);
 int32_t ad9361_fastlock_recall(struct ad9361_rf_phy *phy, bool tx,
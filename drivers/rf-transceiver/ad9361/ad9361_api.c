@@ -543,6 +543,11 @@ int32_t ad9361_init (struct ad9361_rf_phy **ad9361_phy,
 	phy->ad9361_rfpll_ext_round_rate = init_param->ad9361_rfpll_ext_round_rate;
 	phy->ad9361_rfpll_ext_set_rate = init_param->ad9361_rfpll_ext_set_rate;
 
+	phy->cal_cache = init_param->cal_cache;
+	phy->cal_cache_lo_tolerance_hz = init_param->cal_cache_lo_tolerance_hz;
+	phy->cal_cache_temp_tolerance_mdeg =
+		init_param->cal_cache_temp_tolerance_mdeg;
+
 	ret = ad9361_register_clocks(phy);
 	if (ret < 0)
 		goto out;
@@ -2213,3 +2218,269 @@ int32_t ad9361_get_temperature(struct ad9361_rf_phy *phy,
 
 	return 0;
 }
+
+/**
+ * Export the calibration results and their operating context (LO, bandwidth,
+ * clock chain, temperature). Passed back through init_param->cal_cache on the
+ * next boot, the calibrations are restored instead of run if the context
+ * matches within the configured tolerances.
+ * @param phy The AD9361 current state structure.
+ * @param cache The calibration cache to fill.
+ * @return 0 in case of success, negative error code otherwise.
+ */
+int32_t ad9361_save_cal_cache(struct ad9361_rf_phy *phy,
+			      struct ad9361_cal_cache *cache)
+{
+	return ad9361_cal_cache_export(phy, cache);
+}
+
+/**
+ * Get whether the last setup restored the calibrations from the cache and
+ * the calibration time it saved (as measured when the cache was produced).
+ * @param phy The AD9361 current state structure.
+ * @param hit Set if the cache was used.
+ * @param saved_us Calibration time saved [us].
+ * @return 0 in case of success, negative error code otherwise.
+ */
+int32_t ad9361_get_cal_cache_status(struct ad9361_rf_phy *phy,
+				    uint8_t *hit, uint32_t *saved_us)
+{
+	*hit = phy->cal_cache_hit;
+	*saved_us = phy->cal_cache_saved_us;
+
+	return 0;
+}
+
+/**
+ * Characterize the hop frequencies: tune the synthesizer to each frequency
+ * once (full VCO calibration) and keep the resulting fastlock profile in
+ * RAM. The first frequency is then loaded in a fastlock profile and recalled.
+ * @param table The hop table.
+ * @param phy The AD9361 current state structure.
+ * @param init_param The hop table parameters.
+ * @return 0 in case of success, negative error code otherwise.
+ */
+int32_t ad9361_hop_init(struct ad9361_hop_table **table,
+			struct ad9361_rf_phy *phy,
+			const struct ad9361_hop_init_param *init_param)
+{
+	struct ad9361_hop_table *t;
+	bool pins = init_param->profile_pins[0] != NULL;
+	uint32_t i;
+	int32_t ret;
+
+	if (!init_param->nb_freqs || !init_param->freqs_hz ||
+	    init_param->slot[0] > 7 || init_param->slot[1] > 7 ||
+	    init_param->slot[0] == init_param->slot[1])
+		return -EINVAL;
+
+	if (pins && !phy->pdata->trx_fastlock_pinctrl_en[init_param->tx])
+		return -EINVAL;
+
+	t = (struct ad9361_hop_table *)calloc(1, sizeof(*t));
+	if (!t)
+		return -ENOMEM;
+
+	t->freqs_hz = (uint64_t *)calloc(init_param->nb_freqs,
+					 sizeof(*t->freqs_hz));
+	t->profiles = calloc(init_param->nb_freqs, sizeof(*t->profiles));
+	if (!t->freqs_hz || !t->profiles) {
+		ret = -ENOMEM;
+		goto error;
+	}
+
+	t->phy = phy;
+	t->tx = init_param->tx;
+	t->nb_freqs = init_param->nb_freqs;
+	memcpy(t->freqs_hz, init_param->freqs_hz,
+	       t->nb_freqs * sizeof(*t->freqs_hz));
+	memcpy(t->slot, init_param->slot, sizeof(t->slot));
+	memcpy(t->profile_pins, init_param->profile_pins,
+	       sizeof(t->profile_pins));
+	t->get_time_ns = init_param->get_time_ns;
+	t->stats.min_switch_ns = UINT32_MAX;
+
+	for (i = 0; i < t->nb_freqs; i++) {
+		if (t->tx)
+			ret = ad9361_set_tx_lo_freq(phy, t->freqs_hz[i]);
+		else
+			ret = ad9361_set_rx_lo_freq(phy, t->freqs_hz[i]);
+		if (ret < 0)
+			goto error;
+
+		ret = ad9361_fastlock_capture(phy, t->tx, t->profiles[i]);
+		if (ret < 0)
+			goto error;
+	}
+
+	t->active = 0;
+	t->loaded[0] = 0;
+	t->loaded[1] = -1;
+	t->alc_written[0] = t->profiles[0][15];
+	ret = ad9361_fastlock_load(phy, t->tx, t->slot[0], t->profiles[0]);
+	if (ret < 0)
+		goto error;
+
+	/* Enter fastlock mode, selecting the pin control if enabled. */
+	ret = ad9361_fastlock_recall(phy, t->tx, t->slot[0]);
+	if (ret < 0)
+		goto error;
+
+	if (pins)
+		for (i = 0; i < ARRAY_SIZE(t->profile_pins); i++)
+			gpio_direction_output(t->profile_pins[i],
+					      (t->slot[0] >> i) & 1);
+
+	t->current = 0;
+	*table = t;
+
+	return 0;
+
+error:
+	free(t->profiles);
+	free(t->freqs_hz);
+	free(t);
+
+	return ret;
+}
+
+/**
+ * Load a hop frequency in the fastlock profile which is not in use, from the
+ * RAM copy. Can be done ahead of time, while still on the current frequency.
+ * @param table The hop table.
+ * @param index The frequency index.
+ * @return 0 in case of success, negative error code otherwise.
+ */
+int32_t ad9361_hop_prepare(struct ad9361_hop_table *table, uint32_t index)
+{
+	uint8_t values[RX_FAST_LOCK_CONFIG_WORD_NUM];
+	uint8_t idle = !table->active;
+	uint32_t start = 0;
+	int32_t ret;
+
+	if (index >= table->nb_freqs)
+		return -EINVAL;
+
+	if (table->loaded[idle] == (int32_t)index)
+		return 0;
+
+	if (table->get_time_ns)
+		start = table->get_time_ns();
+
+	memcpy(values, table->profiles[index], sizeof(values));
+	/* Workaround: Lock problem with same ALC word */
+	if ((values[15] >> 1) == (table->alc_written[table->active] >> 1))
+		values[15] += 2;
+
+	ret = ad9361_fastlock_load(table->phy, table->tx, table->slot[idle],
+				   values);
+	if (ret < 0) {
+		table->loaded[idle] = -1;
+		return ret;
+	}
+
+	table->loaded[idle] = index;
+	table->alc_written[idle] = values[15];
+
+	if (table->get_time_ns)
+		table->stats.last_prepare_ns = table->get_time_ns() - start;
+
+	return 0;
+}
+
+/**
+ * Switch to the fastlock profile prepared with ad9361_hop_prepare(), using
+ * the profile select pins if available, or a single SPI write otherwise.
+ * @param table The hop table.
+ * @return 0 in case of success, negative error code otherwise.
+ */
+int32_t ad9361_hop_switch(struct ad9361_hop_table *table)
+{
+	uint8_t idle = !table->active;
+	uint8_t slot = table->slot[idle];
+	uint32_t start = 0, elapsed;
+	int32_t ret = 0;
+	uint32_t i;
+
+	if (table->loaded[idle] < 0)
+		return -EINVAL;
+
+	if (table->get_time_ns)
+		start = table->get_time_ns();
+
+	if (table->profile_pins[0])
+		for (i = 0; i < ARRAY_SIZE(table->profile_pins); i++)
+			ret |= gpio_set_value(table->profile_pins[i],
+					      (slot >> i) & 1);
+	else
+		ret = ad9361_fastlock_recall(table->phy, table->tx, slot);
+	if (ret < 0)
+		return ret;
+
+	table->active = idle;
+	table->current = table->loaded[idle];
+	table->stats.hops++;
+
+	if (table->get_time_ns) {
+		elapsed = table->get_time_ns() - start;
+		table->stats.last_switch_ns = elapsed;
+		table->stats.total_switch_ns += elapsed;
+		table->stats.min_switch_ns = min(table->stats.min_switch_ns, elapsed);
+		table->stats.max_switch_ns = max(table->stats.max_switch_ns, elapsed);
+	}
+
+	return 0;
+}
+
+/**
+ * Hop to the specified frequency (prepare and switch).
+ * @param table The hop table.
+ * @param index The frequency index.
+ * @return 0 in case of success, negative error code otherwise.
+ */
+int32_t ad9361_hop(struct ad9361_hop_table *table, uint32_t index)
+{
+	int32_t ret;
+
+	if (index == table->current)
+		return 0;
+
+	ret = ad9361_hop_prepare(table, index);
+	if (ret < 0)
+		return ret;
+
+	return ad9361_hop_switch(table);
+}
+
+/**
+ * Get the hop latency statistics. The latencies are only measured if a time
+ * base was provided at initialization.
+ * @param table The hop table.
+ * @param stats The statistics.
+ * @return 0 in case of success, negative error code otherwise.
+ */
+int32_t ad9361_hop_get_stats(struct ad9361_hop_table *table,
+			     struct ad9361_hop_stats *stats)
+{
+	*stats = table->stats;
+
+	return 0;
+}
+
+/**
+ * Free the resources allocated by ad9361_hop_init(). The synthesizer leaves
+ * fastlock mode on the next regular LO frequency change.
+ * @param table The hop table.
+ * @return 0 in case of success, negative error code otherwise.
+ */
+int32_t ad9361_hop_remove(struct ad9361_hop_table *table)
+{
+	if (!table)
+		return -EINVAL;
+
+	free(table->profiles);
+	free(table->freqs_hz);
+	free(table);
+
+	return 0;
+}
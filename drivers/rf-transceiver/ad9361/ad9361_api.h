@@ -297,6 +297,10 @@ typedef struct {
 	struct axi_adc_init	*rx_adc_init;
 	struct axi_dac_init	*tx_dac_init;
 #endif
+	/* Calibration cache (warm boot) */
+	struct ad9361_cal_cache	*cal_cache;	/* results of a previous boot, NULL to always calibrate */
+	uint32_t	cal_cache_lo_tolerance_hz;
+	uint32_t	cal_cache_temp_tolerance_mdeg;
 } AD9361_InitParam;
 
 typedef struct {
@@ -367,6 +371,48 @@ enum ad9361_ensm_mode {
 #define ON			0
 #define OFF			1
 
+/* Fastlock profiles used by default by the frequency hopping engine. */
+#define AD9361_HOP_DEFAULT_SLOT_A	6
+#define AD9361_HOP_DEFAULT_SLOT_B	7
+
+struct ad9361_hop_init_param {
+	bool		tx;				/* hop the TX synthesizer instead of RX */
+	const uint64_t	*freqs_hz;		/* hop frequencies */
+	uint32_t	nb_freqs;
+	uint8_t		slot[2];		/* two fastlock profiles used alternately */
+	/* CTRL_IN pins selecting the fastlock profile (pin control mode must be
+	 * enabled in the init parameters). NULL selects the profile over SPI. */
+	struct gpio_desc	*profile_pins[3];
+	/* Optional time base used for the latency statistics. */
+	uint32_t	(*get_time_ns)(void);
+};
+
+struct ad9361_hop_stats {
+	uint32_t	hops;
+	uint32_t	last_switch_ns;
+	uint32_t	min_switch_ns;
+	uint32_t	max_switch_ns;
+	uint64_t	total_switch_ns;
+	uint32_t	last_prepare_ns;
+};
+
+struct ad9361_hop_table {
+	struct ad9361_rf_phy	*phy;
+	bool		tx;
+	uint32_t	nb_freqs;
+	uint64_t	*freqs_hz;
+	/* Characterized synthesizer state (VCO cal results) of each frequency. */
+	uint8_t		(*profiles)[RX_FAST_LOCK_CONFIG_WORD_NUM];
+	uint8_t		slot[2];
+	uint8_t		active;			/* index in slot[] in use */
+	int32_t		loaded[2];		/* frequency index held by each slot */
+	uint8_t		alc_written[2];	/* ALC word programmed in each slot */
+	uint32_t	current;		/* current frequency index */
+	struct gpio_desc	*profile_pins[3];
+	uint32_t	(*get_time_ns)(void);
+	struct ad9361_hop_stats	stats;
+};
+
 /******************************************************************************/
 /************************ Functions Declarations ******************************/
 /******************************************************************************/
@@ -554,4 +600,25 @@ int32_t ad9361_do_dcxo_tune_fine(struct ad9361_rf_phy *phy,
 /* Get the temperature. */
 int32_t ad9361_get_temperature(struct ad9361_rf_phy *phy,
 			       int32_t *temp);
+/* Export the calibration results for the next boot. */
+int32_t ad9361_save_cal_cache(struct ad9361_rf_phy *phy,
+			      struct ad9361_cal_cache *cache);
+/* Get whether the calibration cache was used and the time it saved. */
+int32_t ad9361_get_cal_cache_status(struct ad9361_rf_phy *phy,
+				    uint8_t *hit, uint32_t *saved_us);
+/* Characterize the hop frequencies and enter fastlock mode. */
+int32_t ad9361_hop_init(struct ad9361_hop_table **table,
+			struct ad9361_rf_phy *phy,
+			const struct ad9361_hop_init_param *init_param);
+/* Load a hop frequency in the idle fastlock profile. */
+int32_t ad9361_hop_prepare(struct ad9361_hop_table *table, uint32_t index);
+/* Switch to the idle fastlock profile. */
+int32_t ad9361_hop_switch(struct ad9361_hop_table *table);
+/* Hop to the specified frequency. */
+int32_t ad9361_hop(struct ad9361_hop_table *table, uint32_t index);
+/* Get the hop latency statistics. */
+int32_t ad9361_hop_get_stats(struct ad9361_hop_table *table,
+			     struct ad9361_hop_stats *stats);
+/* Free the resources allocated by ad9361_hop_init(). */
+int32_t ad9361_hop_remove(struct ad9361_hop_table *table);
 #endif
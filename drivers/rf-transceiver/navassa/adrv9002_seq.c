@@ -0,0 +1,559 @@
+/***************************************************************************//**
+ *   @file   adrv9002_seq.c
+ *   @brief  adrv9002 binary init sequence recorder and player.
+********************************************************************************
+ * Copyright 2021(c) Analog Devices, Inc.
+ *
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *  - Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ *  - Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ *  - Neither the name of Analog Devices, Inc. nor the names of its
+ *    contributors may be used to endorse or promote products derived
+ *    from this software without specific prior written permission.
+ *  - The use of this software may or may not infringe the patent rights
+ *    of one or more patent holders.  This license does not release you
+ *    from the requirement that you obtain separate licenses from these
+ *    patent holders to use this software.
+ *  - Use of the software either in source or binary form, must be run
+ *    on or directly connected to an Analog Devices Inc. component.
+ *
+ * THIS SOFTWARE IS PROVIDED BY ANALOG DEVICES "AS IS" AND ANY EXPRESS OR
+ * IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, NON-INFRINGEMENT,
+ * MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED.
+ * IN NO EVENT SHALL ANALOG DEVICES BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, INTELLECTUAL PROPERTY RIGHTS, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*******************************************************************************/
+#include <stdlib.h>
+#include <string.h>
+#include "error.h"
+#include "util.h"
+#include "crc16.h"
+#include "adrv9002_seq.h"
+#include "adi_adrv9001_hal.h"
+#include "adi_platform.h"
+
+#define ADRV9002_SEQ_SPI_READ		0x80
+#define ADRV9002_SEQ_CONFIG_B		0x0001
+#define ADRV9002_SEQ_SINGLE_INSTR	0x80
+
+/* The HAL entries are global, so only one recording can run at a time. */
+static struct adrv9002_seq_rec *seq_rec;
+
+static void seq_put_le16(uint8_t *p, uint16_t v)
+{
+	p[0] = v;
+	p[1] = v >> 8;
+}
+
+static void seq_put_le32(uint8_t *p, uint32_t v)
+{
+	seq_put_le16(p, v);
+	seq_put_le16(p + 2, v >> 16);
+}
+
+static uint16_t seq_get_le16(const uint8_t *p)
+{
+	return p[0] | (p[1] << 8);
+}
+
+static uint32_t seq_get_le32(const uint8_t *p)
+{
+	return seq_get_le16(p) | ((uint32_t)seq_get_le16(p + 2) << 16);
+}
+
+/* Reserve a new record and return its payload, NULL once the buffer is full. */
+static uint8_t *seq_rec_alloc(struct adrv9002_seq_rec *rec, uint8_t type,
+			      uint32_t len)
+{
+	uint8_t *p;
+
+	if (rec->err)
+		return NULL;
+
+	if (rec->len + ADRV9002_SEQ_REC_HDR_SIZE + len > rec->size) {
+		rec->err = -ENOMEM;
+		return NULL;
+	}
+
+	p = &rec->buff[rec->len];
+	p[0] = type;
+	seq_put_le16(&p[1], len);
+	rec->len += ADRV9002_SEQ_REC_HDR_SIZE + len;
+	rec->records++;
+	rec->open_write = 0;
+	rec->last_poll = 0;
+
+	return &p[ADRV9002_SEQ_REC_HDR_SIZE];
+}
+
+static void seq_rec_flush_wait(struct adrv9002_seq_rec *rec)
+{
+	uint8_t *p;
+
+	if (!rec->pending_wait_us)
+		return;
+
+	p = seq_rec_alloc(rec, ADRV9002_SEQ_WAIT, 4);
+	if (p)
+		seq_put_le32(p, rec->pending_wait_us);
+	rec->pending_wait_us = 0;
+}
+
+/* Track the instruction mode so only 3-byte instruction streams get merged. */
+static void seq_rec_track_mode(struct adrv9002_seq_rec *rec,
+			       const uint8_t *tx, uint32_t n)
+{
+	uint32_t i;
+	uint16_t addr;
+
+	for (i = 0; i + 2 < n; i += 3) {
+		if (tx[i] & ADRV9002_SEQ_SPI_READ)
+			continue;
+		addr = ((tx[i] & 0x7F) << 8) | tx[i + 1];
+		if (addr == ADRV9002_SEQ_CONFIG_B)
+			rec->single_instr = !!(tx[i + 2] & ADRV9002_SEQ_SINGLE_INSTR);
+	}
+}
+
+static void seq_rec_write(struct adrv9002_seq_rec *rec, const uint8_t *tx,
+			  uint32_t n)
+{
+	uint32_t chunk, wlen, left = n;
+	const uint8_t *src = tx;
+	uint8_t *p;
+	bool burst;
+
+	seq_rec_flush_wait(rec);
+
+	burst = rec->single_instr && !(n % 3) && n <= ADRV9002_SEQ_MAX_BURST;
+	wlen = rec->open_write ?
+	       seq_get_le16(&rec->buff[rec->open_write + 1]) : 0;
+	if (burst && rec->open_write && wlen + n <= ADRV9002_SEQ_MAX_BURST &&
+	    rec->len + n <= rec->size) {
+		memcpy(&rec->buff[rec->len], tx, n);
+		seq_put_le16(&rec->buff[rec->open_write + 1], wlen + n);
+		rec->len += n;
+	} else {
+		/* Split like the HAL does, one record per chip select frame. */
+		do {
+			chunk = min_t(uint32_t, left, ADRV9002_SEQ_MAX_PAYLOAD);
+			p = seq_rec_alloc(rec, ADRV9002_SEQ_SPI_WRITE, chunk);
+			if (!p)
+				return;
+			memcpy(p, src, chunk);
+			src += chunk;
+			left -= chunk;
+		} while (left);
+
+		if (burst)
+			rec->open_write = p - ADRV9002_SEQ_REC_HDR_SIZE - rec->buff;
+	}
+
+	if (burst || n == 3) {
+		seq_rec_track_mode(rec, tx, n);
+		if (!rec->single_instr)
+			rec->open_write = 0;
+	}
+}
+
+static void seq_rec_read(struct adrv9002_seq_rec *rec, const uint8_t *tx,
+			 const uint8_t *rx, uint32_t n)
+{
+	uint32_t i, timeout;
+	uint16_t addr;
+	uint8_t *p;
+
+	if (rec->read_mode == ADRV9002_SEQ_READ_SKIP || !rec->single_instr ||
+	    n % 3)
+		return;
+
+	for (i = 0; i < n; i += 3) {
+		addr = ((tx[i] & 0x7F) << 8) | tx[i + 1];
+		p = rec->last_poll ? &rec->buff[rec->last_poll] : NULL;
+		/* A poll loop: fold the waits in between into the timeout. */
+		if (p && seq_get_le16(p) == addr) {
+			timeout = seq_get_le32(&p[4]) + rec->pending_wait_us;
+			rec->pending_wait_us = 0;
+			p[3] = rx[i + 2] & p[2];
+			seq_put_le32(&p[4], timeout);
+			continue;
+		}
+
+		seq_rec_flush_wait(rec);
+		p = seq_rec_alloc(rec, ADRV9002_SEQ_POLL, 8);
+		if (!p)
+			return;
+		seq_put_le16(p, addr);
+		p[2] = rec->poll_mask;
+		p[3] = rx[i + 2] & rec->poll_mask;
+		seq_put_le32(&p[4], rec->poll_margin_us);
+		rec->last_poll = p - rec->buff;
+	}
+}
+
+static int32_t seq_rec_spi_write(void *devHalCfg, const uint8_t txData[],
+				 uint32_t numTxBytes)
+{
+	int32_t ret;
+
+	ret = seq_rec->spi_write(devHalCfg, txData, numTxBytes);
+	seq_rec->spi_xfers++;
+	if (!ret)
+		seq_rec_write(seq_rec, txData, numTxBytes);
+
+	return ret;
+}
+
+static int32_t seq_rec_spi_read(void *devHalCfg, const uint8_t txData[],
+				uint8_t rxData[], uint32_t numRxBytes)
+{
+	int32_t ret;
+
+	ret = seq_rec->spi_read(devHalCfg, txData, rxData, numRxBytes);
+	seq_rec->spi_xfers++;
+	if (!ret)
+		seq_rec_read(seq_rec, txData, rxData, numRxBytes);
+
+	return ret;
+}
+
+static int32_t seq_rec_wait_us(void *devHalCfg, uint32_t time_us)
+{
+	int32_t ret;
+
+	ret = seq_rec->wait_us(devHalCfg, time_us);
+	if (!ret)
+		seq_rec->pending_wait_us += time_us;
+
+	return ret;
+}
+
+static int32_t seq_rec_resetb_set(void *devHalCfg, uint8_t pinLevel)
+{
+	int32_t ret;
+	uint8_t *p;
+
+	ret = seq_rec->resetb_set(devHalCfg, pinLevel);
+	if (ret)
+		return ret;
+
+	seq_rec_flush_wait(seq_rec);
+	p = seq_rec_alloc(seq_rec, ADRV9002_SEQ_RESETB, 1);
+	if (p)
+		p[0] = pinLevel;
+	/* The device comes out of reset with its default SPI configuration. */
+	seq_rec->single_instr = false;
+
+	return ret;
+}
+
+static uint16_t seq_crc16(const uint8_t *data, uint32_t len, uint16_t crc)
+{
+	DECLARE_CRC16_TABLE(seq_crc16_table);
+	static bool populated;
+
+	if (!populated) {
+		crc16_populate_msb(seq_crc16_table, ADRV9002_SEQ_CRC16_POLY);
+		populated = true;
+	}
+
+	return crc16(seq_crc16_table, data, len, crc);
+}
+
+/**
+ * @brief Start recording the HAL traffic generated by the ADRV9001 API.
+ *
+ * The HAL SPI, wait and RESETB entries are redirected through the recorder,
+ * which still forwards every call to the device. Run the usual init (for
+ * example adrv9002_setup()) on a reference board while recording, then call
+ * adrv9002_seq_record_stop() to get a self contained image. Register writes
+ * sent in single instruction mode are merged into bursts, waits are merged
+ * and polling loops collapse into a single poll record.
+ * @param rec - The recorder descriptor.
+ * @param param - The recorder parameters. A poll_mask of 0 compares all bits.
+ * @return 0 in case of success, negative error code otherwise.
+ */
+int32_t adrv9002_seq_record_start(struct adrv9002_seq_rec **rec,
+				  const struct adrv9002_seq_rec_init_param *param)
+{
+	struct adrv9002_seq_rec *r;
+
+	if (!rec || !param || !param->buff ||
+	    param->size < ADRV9002_SEQ_HDR_SIZE)
+		return -EINVAL;
+
+	if (seq_rec)
+		return -EBUSY;
+
+	r = calloc(1, sizeof(*r));
+	if (!r)
+		return -ENOMEM;
+
+	r->buff = param->buff;
+	r->size = param->size;
+	r->len = ADRV9002_SEQ_HDR_SIZE;
+	r->read_mode = param->read_mode;
+	r->poll_mask = param->poll_mask ? param->poll_mask : 0xFF;
+	r->poll_margin_us = param->poll_margin_us;
+
+	r->spi_write = adi_hal_SpiWrite;
+	r->spi_read = adi_hal_SpiRead;
+	r->wait_us = adi_hal_Wait_us;
+	r->resetb_set = adi_adrv9001_hal_resetbPin_set;
+
+	seq_rec = r;
+	adi_hal_SpiWrite = seq_rec_spi_write;
+	adi_hal_SpiRead = seq_rec_spi_read;
+	adi_hal_Wait_us = seq_rec_wait_us;
+	adi_adrv9001_hal_resetbPin_set = seq_rec_resetb_set;
+
+	*rec = r;
+
+	return 0;
+}
+
+/**
+ * @brief Stop recording and finalize the sequence image.
+ * @param rec - The recorder descriptor.
+ * @param len - Size of the image in bytes, to be saved from rec->buff.
+ * @return 0 in case of success, negative error code otherwise.
+ */
+int32_t adrv9002_seq_record_stop(struct adrv9002_seq_rec *rec, uint32_t *len)
+{
+	uint32_t size;
+
+	if (!rec || rec != seq_rec)
+		return -EINVAL;
+
+	seq_rec_flush_wait(rec);
+
+	adi_hal_SpiWrite = rec->spi_write;
+	adi_hal_SpiRead = rec->spi_read;
+	adi_hal_Wait_us = rec->wait_us;
+	adi_adrv9001_hal_resetbPin_set = rec->resetb_set;
+	seq_rec = NULL;
+
+	if (rec->err)
+		return rec->err;
+
+	size = rec->len - ADRV9002_SEQ_HDR_SIZE;
+	seq_put_le32(&rec->buff[0], ADRV9002_SEQ_MAGIC);
+	rec->buff[4] = ADRV9002_SEQ_VERSION;
+	rec->buff[5] = 0;
+	seq_put_le16(&rec->buff[6],
+		     seq_crc16(&rec->buff[ADRV9002_SEQ_HDR_SIZE], size, 0));
+	seq_put_le32(&rec->buff[8], size);
+
+	if (len)
+		*len = rec->len;
+
+	return 0;
+}
+
+/**
+ * @brief Free the recorder, stopping it first if still running.
+ * @param rec - The recorder descriptor.
+ * @return 0 in case of success, negative error code otherwise.
+ */
+int32_t adrv9002_seq_record_remove(struct adrv9002_seq_rec *rec)
+{
+	if (!rec)
+		return -EINVAL;
+
+	if (rec == seq_rec)
+		adrv9002_seq_record_stop(rec, NULL);
+
+	free(rec);
+
+	return 0;
+}
+
+static int32_t seq_play_poll(void *devHalCfg, const uint8_t *p)
+{
+	uint8_t tx[3], rx[3];
+	uint32_t elapsed = 0;
+	uint32_t timeout;
+	uint16_t addr;
+	int32_t ret;
+
+	addr = seq_get_le16(p);
+	timeout = seq_get_le32(&p[4]);
+	tx[0] = ADRV9002_SEQ_SPI_READ | ((addr >> 8) & 0x7F);
+	tx[1] = addr;
+	tx[2] = 0;
+
+	while (true) {
+		ret = adi_hal_SpiRead(devHalCfg, tx, rx, sizeof(tx));
+		if (ret)
+			return ret;
+		if ((rx[2] & p[2]) == p[3])
+			return 0;
+		if (elapsed >= timeout)
+			return -ETIMEDOUT;
+
+		ret = adi_hal_Wait_us(devHalCfg, ADRV9002_SEQ_POLL_STEP_US);
+		if (ret)
+			return ret;
+		elapsed += ADRV9002_SEQ_POLL_STEP_US;
+	}
+}
+
+static int32_t seq_play_record(void *devHalCfg, uint8_t type,
+			       const uint8_t *p, uint32_t len)
+{
+	switch (type) {
+	case ADRV9002_SEQ_SPI_WRITE:
+		return adi_hal_SpiWrite(devHalCfg, p, len);
+	case ADRV9002_SEQ_WAIT:
+		if (len != 4)
+			return -EINVAL;
+		return adi_hal_Wait_us(devHalCfg, seq_get_le32(p));
+	case ADRV9002_SEQ_POLL:
+		if (len != 8)
+			return -EINVAL;
+		return seq_play_poll(devHalCfg, p);
+	case ADRV9002_SEQ_RESETB:
+		if (len != 1)
+			return -EINVAL;
+		return adi_adrv9001_hal_resetbPin_set(devHalCfg, p[0]);
+	default:
+		return -EINVAL;
+	}
+}
+
+/**
+ * @brief Replay a sequence image fetched in pages.
+ *
+ * The image is checked against its crc before anything reaches the device,
+ * then every record is replayed through the HAL: write bursts go out as one
+ * transfer each. The HAL must already be open (adi_adrv9001_HwOpen()).
+ * @param devHalCfg - The HAL configuration (adrv9002_hal_cfg).
+ * @param get - Reads size bytes at offset from the start of the image.
+ * @param ctx - Passed to get.
+ * @return 0 in case of success, negative error code otherwise.
+ */
+int32_t adrv9002_seq_play_paged(void *devHalCfg, adrv9002_seq_page_get get,
+				void *ctx)
+{
+	uint8_t hdr[ADRV9002_SEQ_HDR_SIZE];
+	uint32_t size, off, end, len;
+	uint16_t crc = 0;
+	uint8_t *buff;
+	int32_t ret;
+
+	if (!get)
+		return -EINVAL;
+
+	ret = get(ctx, 0, hdr, sizeof(hdr));
+	if (ret)
+		return ret;
+
+	if (seq_get_le32(hdr) != ADRV9002_SEQ_MAGIC ||
+	    hdr[4] != ADRV9002_SEQ_VERSION)
+		return -EINVAL;
+
+	size = seq_get_le32(&hdr[8]);
+	end = ADRV9002_SEQ_HDR_SIZE + size;
+
+	buff = calloc(1, ADRV9002_SEQ_REC_HDR_SIZE + ADRV9002_SEQ_MAX_PAYLOAD);
+	if (!buff)
+		return -ENOMEM;
+
+	for (off = ADRV9002_SEQ_HDR_SIZE; off < end; off += len) {
+		len = min_t(uint32_t, end - off,
+			    ADRV9002_SEQ_REC_HDR_SIZE + ADRV9002_SEQ_MAX_PAYLOAD);
+		ret = get(ctx, off, buff, len);
+		if (ret)
+			goto out;
+		crc = seq_crc16(buff, len, crc);
+	}
+
+	if (crc != seq_get_le16(&hdr[6])) {
+		ret = -EINVAL;
+		goto out;
+	}
+
+	for (off = ADRV9002_SEQ_HDR_SIZE; off < end; off += len) {
+		if (end - off < ADRV9002_SEQ_REC_HDR_SIZE) {
+			ret = -EINVAL;
+			goto out;
+		}
+
+		ret = get(ctx, off, buff, ADRV9002_SEQ_REC_HDR_SIZE);
+		if (ret)
+			goto out;
+
+		len = seq_get_le16(&buff[1]);
+		if (len > ADRV9002_SEQ_MAX_PAYLOAD ||
+		    len > end - off - ADRV9002_SEQ_REC_HDR_SIZE) {
+			ret = -EINVAL;
+			goto out;
+		}
+
+		ret = get(ctx, off + ADRV9002_SEQ_REC_HDR_SIZE,
+			  &buff[ADRV9002_SEQ_REC_HDR_SIZE], len);
+		if (ret)
+			goto out;
+
+		ret = seq_play_record(devHalCfg, buff[0],
+				      &buff[ADRV9002_SEQ_REC_HDR_SIZE], len);
+		if (ret)
+			goto out;
+
+		len += ADRV9002_SEQ_REC_HDR_SIZE;
+	}
+out:
+	free(buff);
+
+	return ret;
+}
+
+struct seq_mem {
+	const uint8_t *seq;
+	uint32_t size;
+};
+
+static int32_t seq_mem_get(void *ctx, uint32_t offset, uint8_t *buff,
+			   uint32_t size)
+{
+	struct seq_mem *mem = ctx;
+
+	if (offset > mem->size || size > mem->size - offset)
+		return -EINVAL;
+
+	memcpy(buff, &mem->seq[offset], size);
+
+	return 0;
+}
+
+/**
+ * @brief Replay a sequence image held in memory (flash or RAM).
+ * @param devHalCfg - The HAL configuration (adrv9002_hal_cfg).
+ * @param seq - The sequence image.
+ * @param size - Size of the image in bytes.
+ * @return 0 in case of success, negative error code otherwise.
+ */
+int32_t adrv9002_seq_play(void *devHalCfg, const uint8_t *seq, uint32_t size)
+{
+	struct seq_mem mem = {
+		.seq = seq,
+		.size = size,
+	};
+
+	if (!seq)
+		return -EINVAL;
+
+	return adrv9002_seq_play_paged(devHalCfg, seq_mem_get, &mem);
+}
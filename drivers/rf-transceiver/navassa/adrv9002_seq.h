@@ -0,0 +1,153 @@
+/***************************************************************************//**
+ *   @file   adrv9002_seq.h
+ *   @brief  adrv9002 binary init sequence recorder and player.
+********************************************************************************
+ * Copyright 2021(c) Analog Devices, Inc.
+ *
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *  - Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ *  - Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ *  - Neither the name of Analog Devices, Inc. nor the names of its
+ *    contributors may be used to endorse or promote products derived
+ *    from this software without specific prior written permission.
+ *  - The use of this software may or may not infringe the patent rights
+ *    of one or more patent holders.  This license does not release you
+ *    from the requirement that you obtain separate licenses from these
+ *    patent holders to use this software.
+ *  - Use of the software either in source or binary form, must be run
+ *    on or directly connected to an Analog Devices Inc. component.
+ *
+ * THIS SOFTWARE IS PROVIDED BY ANALOG DEVICES "AS IS" AND ANY EXPRESS OR
+ * IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, NON-INFRINGEMENT,
+ * MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED.
+ * IN NO EVENT SHALL ANALOG DEVICES BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, INTELLECTUAL PROPERTY RIGHTS, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*******************************************************************************/
+#ifndef ADRV9002_SEQ_H_
+#define ADRV9002_SEQ_H_
+
+#include <stdint.h>
+#include <stdbool.h>
+
+/*
+ * Sequence image layout (all fields little endian):
+ *
+ *   header:  magic (4) | version (1) | reserved (1) | crc16 (2) | size (4)
+ *   record:  type (1) | length (2) | payload (length)
+ *
+ * crc16 (CCITT, msb first, initial value 0) and size cover the records only.
+ */
+#define ADRV9002_SEQ_MAGIC		0x51533941 /* "A9SQ" */
+#define ADRV9002_SEQ_VERSION		1
+#define ADRV9002_SEQ_HDR_SIZE		12
+#define ADRV9002_SEQ_REC_HDR_SIZE	3
+/* One chip select frame of the no-OS HAL. */
+#define ADRV9002_SEQ_MAX_PAYLOAD	4096
+/* Largest burst of 3-byte SPI instructions fitting in one frame. */
+#define ADRV9002_SEQ_MAX_BURST		4095
+#define ADRV9002_SEQ_CRC16_POLY		0x1021
+/* Player poll interval while waiting for a recorded register value. */
+#define ADRV9002_SEQ_POLL_STEP_US	10
+
+enum adrv9002_seq_rec_type {
+	/* Raw adi_hal_SpiWrite() payload, sent in a single transfer. */
+	ADRV9002_SEQ_SPI_WRITE = 1,
+	/* u32 delay in microseconds. */
+	ADRV9002_SEQ_WAIT,
+	/* u16 address, u8 mask, u8 value, u32 timeout in microseconds. */
+	ADRV9002_SEQ_POLL,
+	/* u8 RESETB pin level. */
+	ADRV9002_SEQ_RESETB,
+};
+
+enum adrv9002_seq_read_mode {
+	/* Register reads are not part of the sequence. */
+	ADRV9002_SEQ_READ_SKIP,
+	/* Register reads become polls on the value seen while recording. */
+	ADRV9002_SEQ_READ_POLL,
+};
+
+/**
+ * @struct adrv9002_seq_rec_init_param
+ * @brief Recorder initialization parameters.
+ */
+struct adrv9002_seq_rec_init_param {
+	/** Buffer that receives the sequence image */
+	uint8_t *buff;
+	/** Buffer size in bytes */
+	uint32_t size;
+	/** What to do with register reads */
+	enum adrv9002_seq_read_mode read_mode;
+	/** Bits compared by recorded polls */
+	uint8_t poll_mask;
+	/** Extra time granted to every recorded poll */
+	uint32_t poll_margin_us;
+};
+
+/**
+ * @struct adrv9002_seq_rec
+ * @brief Recorder descriptor.
+ */
+struct adrv9002_seq_rec {
+	uint8_t *buff;
+	uint32_t size;
+	/** Bytes used, header included */
+	uint32_t len;
+	enum adrv9002_seq_read_mode read_mode;
+	uint8_t poll_mask;
+	uint32_t poll_margin_us;
+	/** Offset of the write record still accepting instructions, 0 if none */
+	uint32_t open_write;
+	/** Offset of the last poll record, 0 if the last record is not a poll */
+	uint32_t last_poll;
+	/** Wait not yet emitted, may still be folded into a poll */
+	uint32_t pending_wait_us;
+	/** Device is in single instruction (3-byte transaction) mode */
+	bool single_instr;
+	/** First error hit while recording */
+	int32_t err;
+	/** Number of HAL SPI transfers seen while recording */
+	uint32_t spi_xfers;
+	/** Number of records emitted */
+	uint32_t records;
+	/** Saved HAL entries, restored on stop */
+	int32_t (*spi_write)(void *devHalCfg, const uint8_t txData[],
+			     uint32_t numTxBytes);
+	int32_t (*spi_read)(void *devHalCfg, const uint8_t txData[],
+			    uint8_t rxData[], uint32_t numRxBytes);
+	int32_t (*wait_us)(void *devHalCfg, uint32_t time_us);
+	int32_t (*resetb_set)(void *devHalCfg, uint8_t pinLevel);
+};
+
+/**
+ * @brief Page reader used by the player, see adi_hal_ArmImagePageGet().
+ */
+typedef int32_t (*adrv9002_seq_page_get)(void *ctx, uint32_t offset,
+		uint8_t *buff, uint32_t size);
+
+/* Start recording the HAL traffic of the following API calls. */
+int32_t adrv9002_seq_record_start(struct adrv9002_seq_rec **rec,
+				  const struct adrv9002_seq_rec_init_param *param);
+/* Stop recording, restore the HAL and finalize the image header. */
+int32_t adrv9002_seq_record_stop(struct adrv9002_seq_rec *rec, uint32_t *len);
+/* Free the recorder. */
+int32_t adrv9002_seq_record_remove(struct adrv9002_seq_rec *rec);
+/* Replay a sequence image held in memory. */
+int32_t adrv9002_seq_play(void *devHalCfg, const uint8_t *seq, uint32_t size);
+/* Replay a sequence image fetched in pages (SD card, flash). */
+int32_t adrv9002_seq_play_paged(void *devHalCfg, adrv9002_seq_page_get get,
+				void *ctx);
+
+#endif
@@ -85,6 +85,9 @@
 #define STOP_TRANSMISSION_TOKEN		(0xFDu)
 #define MASK_RESPONSE_TOKEN		(0x0Eu)
 #define MASK_ERROR_TOKEN		(0xF0u)
+#define DATA_ACCEPTED_TOKEN		(0x04u)
+
+#define ACMD23_MAX_BLOCKS		(0x7FFFFFu)
 
 
 /******************************************************************************/
@@ -175,7 +178,8 @@ static int32_t send_command(struct sd_desc *sd_desc, struct cmd_desc *cmd_desc)
 		cmd_desc_local.response_len = R1_LEN;
 		if (SUCCESS != send_command(sd_desc, &cmd_desc_local))
 			return FAILURE;
-		if (cmd_desc_local.response[0] != R1_IDLE_STATE) {
+		/* Idle during initialization, ready afterwards */
+		if (cmd_desc_local.response[0] & ~R1_IDLE_STATE) {
 			DEBUG_MSG("Not the expected response for CMD55\n");
 			return FAILURE;
 		}
@@ -422,7 +426,7 @@ int32_t sd_read(struct sd_desc *sd_desc,
 	/* Initial checks */
 	if (data == NULL || address > sd_desc->memory_size ||
 	    len > sd_desc->memory_size ||
-	    address + len > sd_desc->memory_size)
+	    address + len > sd_desc->memory_size || sd_desc->streaming)
 		return FAILURE;
 
 	/* Send read command */
@@ -474,7 +478,8 @@ int32_t sd_write(struct sd_desc *sd_desc, uint8_t *data, uint64_t address,
 
 	/* Initial checks */
 	if (data == NULL || address > sd_desc->memory_size ||
-	    len > sd_desc->memory_size || address + len > sd_desc->memory_size)
+	    len > sd_desc->memory_size || address + len > sd_desc->memory_size ||
+	    sd_desc->streaming)
 		return FAILURE;
 
 	/* Read first and last block in memory if needed to be updated with user data and then written back                                                                        */
@@ -519,6 +524,189 @@ int32_t sd_write(struct sd_desc *sd_desc, uint8_t *data, uint64_t address,
 	return SUCCESS;
 }
 
+/**
+ * Send the block in the stream frame as part of the open multiple block write.
+ * The card programs it while the caller fills the next one, the busy state
+ * is only polled before the next block is sent.
+ * @param stream	- Instance of the stream
+ * @return SUCCESS in case of success, FAILURE otherwise.
+ */
+static int32_t stream_send_block(struct sd_stream *stream)
+{
+	struct sd_desc	*sd_desc = stream->sd_desc;
+	uint8_t		response = 0xFF;
+
+	if (stream->block == stream->end_block) {
+		DEBUG_MSG("Stream reserved area full\n");
+		return FAILURE;
+	}
+
+	if (stream->busy && SUCCESS != wait_until_not_busy(sd_desc))
+		return FAILURE;
+
+	/* Start token, data and CRC in a single transfer */
+	stream->frame[0] = START_N_BLOCK_TOKEN;
+	stream->frame[1 + DATA_BLOCK_LEN] = 0xFF;
+	stream->frame[2 + DATA_BLOCK_LEN] = 0xFF;
+	if (SUCCESS != spi_write_and_read(sd_desc->spi_desc, stream->frame,
+					  SD_STREAM_FRAME_LEN))
+		return FAILURE;
+
+	if (SUCCESS != wait_for_response(sd_desc, &response))
+		return FAILURE;
+	if ((response & MASK_RESPONSE_TOKEN) != DATA_ACCEPTED_TOKEN) {
+		DEBUG_MSG("Stream block rejected\n");
+		return FAILURE;
+	}
+
+	stream->busy = true;
+	stream->block++;
+	stream->fill = 0;
+
+	return SUCCESS;
+}
+
+/**
+ * Open an append-only stream at a block aligned address. The len bytes
+ * reserved for the stream are pre-erased with ACMD23 and a multiple block
+ * write is started that stays open until sd_stream_close(). No other
+ * access to the card is allowed while the stream is open.
+ * @param sd_desc	- Instance of the SD card
+ * @param stream	- Where the stream instance is stored
+ * @param address	- Block aligned address of the stream
+ * @param len		- Bytes reserved for the stream
+ * @return SUCCESS in case of success, FAILURE otherwise.
+ */
+int32_t sd_stream_open(struct sd_desc *sd_desc, struct sd_stream **stream,
+		       uint64_t address, uint64_t len)
+{
+	struct sd_stream	*local_stream;
+	struct cmd_desc		cmd_desc;
+	uint64_t		nb_of_blocks;
+
+	if (!sd_desc || !stream || !len || sd_desc->streaming ||
+	    (address & MASK_ADDR_IN_BLOCK) || address > sd_desc->memory_size ||
+	    len > sd_desc->memory_size - address)
+		return FAILURE;
+
+	local_stream = calloc(1, sizeof(*local_stream));
+	if (!local_stream)
+		return FAILURE;
+
+	nb_of_blocks = (len + DATA_BLOCK_LEN - 1) >> DATA_BLOCK_BITS;
+
+	/* Pre-erase the reserved blocks */
+	cmd_desc.cmd = ACMD(23);
+	cmd_desc.arg = nb_of_blocks > ACMD23_MAX_BLOCKS ? ACMD23_MAX_BLOCKS :
+		       nb_of_blocks;
+	cmd_desc.response_len = R1_LEN;
+	if (SUCCESS != send_command(sd_desc, &cmd_desc))
+		goto failure;
+	if (cmd_desc.response[0] != R1_READY_STATE) {
+		DEBUG_MSG("Failed to set pre-erase block count\n");
+		goto failure;
+	}
+
+	cmd_desc.cmd = CMD(25);
+	cmd_desc.arg = address >> DATA_BLOCK_BITS;
+	cmd_desc.response_len = R1_LEN;
+	if (SUCCESS != send_command(sd_desc, &cmd_desc))
+		goto failure;
+	if (cmd_desc.response[0] != R1_READY_STATE) {
+		DEBUG_MSG("Failed to write Data command\n");
+		goto failure;
+	}
+
+	local_stream->sd_desc = sd_desc;
+	local_stream->block = address >> DATA_BLOCK_BITS;
+	local_stream->end_block = local_stream->block + nb_of_blocks;
+	sd_desc->streaming = true;
+	*stream = local_stream;
+
+	return SUCCESS;
+failure:
+	free(local_stream);
+	return FAILURE;
+}
+
+/**
+ * Append data to an open stream. Every completed block is sent right away,
+ * a trailing partial block is kept until more data arrives or the stream
+ * is closed.
+ * @param stream	- Instance of the stream
+ * @param data		- Data to append
+ * @param len		- Length of data in bytes
+ * @return SUCCESS in case of success, FAILURE otherwise.
+ */
+int32_t sd_stream_write(struct sd_stream *stream, const uint8_t *data,
+			uint64_t len)
+{
+	uint32_t	copy_len;
+
+	if (!stream || (!data && len))
+		return FAILURE;
+
+	while (len) {
+		copy_len = DATA_BLOCK_LEN - stream->fill;
+		if (copy_len > len)
+			copy_len = len;
+		memcpy(stream->frame + 1 + stream->fill, data, copy_len);
+		stream->fill += copy_len;
+		stream->len += copy_len;
+		data += copy_len;
+		len -= copy_len;
+
+		if (stream->fill == DATA_BLOCK_LEN &&
+		    SUCCESS != stream_send_block(stream))
+			return FAILURE;
+	}
+
+	return SUCCESS;
+}
+
+/**
+ * Close a stream: the last partial block is padded with zeros, the multiple
+ * block write is stopped and the stream instance is freed.
+ * @param stream	- Instance of the stream
+ * @param len		- If not NULL, the number of bytes appended to the stream
+ * @return SUCCESS in case of success, FAILURE otherwise.
+ */
+int32_t sd_stream_close(struct sd_stream *stream, uint64_t *len)
+{
+	struct sd_desc	*sd_desc;
+	int32_t		ret = SUCCESS;
+
+	if (!stream)
+		return FAILURE;
+
+	sd_desc = stream->sd_desc;
+
+	if (stream->fill) {
+		memset(stream->frame + 1 + stream->fill, 0,
+		       DATA_BLOCK_LEN - stream->fill);
+		ret = stream_send_block(stream);
+	}
+
+	/* The card must not be busy when the stop token is sent */
+	if (stream->busy && SUCCESS != wait_until_not_busy(sd_desc))
+		ret = FAILURE;
+
+	sd_desc->buff[0] = STOP_TRANSMISSION_TOKEN;
+	sd_desc->buff[1] = 0xFF;
+	if (SUCCESS != spi_write_and_read(sd_desc->spi_desc, sd_desc->buff, 2))
+		ret = FAILURE;
+	if (SUCCESS != wait_until_not_busy(sd_desc))
+		ret = FAILURE;
+
+	if (len)
+		*len = stream->len;
+
+	sd_desc->streaming = false;
+	free(stream);
+
+	return ret;
+}
+
 /**
  * Initialize an instance of SD card and stores it to the parameter desc
  * @param sd_desc	- Pointer where to store the instance of the SD
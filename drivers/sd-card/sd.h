@@ -66,6 +66,8 @@
 
 #define DATA_BLOCK_LEN			(512u)
 #define MAX_RESPONSE_LEN		(18u)
+/* Start block token, data block and CRC */
+#define SD_STREAM_FRAME_LEN		(1u + DATA_BLOCK_LEN + 2u)
 
 #ifdef SD_DEBUG
 #include <stdio.h>
@@ -100,6 +102,29 @@ struct sd_desc {
 	uint8_t		high_capacity;
 	/** Buffer used for the driver implementation */
 	uint8_t		buff[18];
+	/** true while a stream holds a multiple block write open */
+	bool		streaming;
+};
+
+/**
+ * @struct sd_stream
+ * @brief Append-only multiple block write kept open across calls
+ */
+struct sd_stream {
+	/** Instance of the SD card */
+	struct sd_desc	*sd_desc;
+	/** Next block to be written */
+	uint64_t	block;
+	/** First block after the area reserved for the stream */
+	uint64_t	end_block;
+	/** Bytes appended since the stream was opened */
+	uint64_t	len;
+	/** Bytes of the next block already in the frame */
+	uint32_t	fill;
+	/** true while the card may still program the last block sent */
+	bool		busy;
+	/** Next block with its start token and CRC */
+	uint8_t		frame[SD_STREAM_FRAME_LEN];
 };
 
 /**
@@ -132,6 +157,15 @@ int32_t sd_write(struct sd_desc *desc,
 		 uint8_t *data,
 		 uint64_t address,
 		 uint64_t len);
+int32_t sd_stream_open(struct sd_desc *sd_desc,
+		       struct sd_stream **stream,
+		       uint64_t address,
+		       uint64_t len);
+int32_t sd_stream_write(struct sd_stream *stream,
+			const uint8_t *data,
+			uint64_t len);
+int32_t sd_stream_close(struct sd_stream *stream,
+			uint64_t *len);
 
 #endif /* __SD_H__ */
 
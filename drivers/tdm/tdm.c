@@ -58,6 +58,7 @@ int32_t tdm_init(struct tdm_desc **desc,
 		return FAILURE;
 
 	(*desc)->platform_ops = param->platform_ops;
+	(*desc)->data_size = param->data_size;
 
 	return SUCCESS;
 }
@@ -99,3 +100,40 @@ int32_t tdm_write(struct tdm_desc *desc,
 {
 	return desc->platform_ops->tdm_ops_write(desc, data, nb_samples);
 }
+
+/**
+ * @brief Start a cyclic read using the TDM interface. The platform fills the
+ * buffer continuously (circular DMA) and calls the callback each time one
+ * half of the buffer is ready to be processed.
+ * @param desc - The TDM descriptor.
+ * @param data - The circular buffer.
+ * @param nb_samples - Number of samples in the whole buffer (must be even).
+ * @param callback - Function called when a half of the buffer is filled.
+ * @param ctx - Context passed to the callback.
+ * @return SUCCESS in case of success, negative error code otherwise.
+ */
+int32_t tdm_read_cyclic_start(struct tdm_desc *desc,
+			      void *data,
+			      uint16_t nb_samples,
+			      tdm_rx_callback callback,
+			      void *ctx)
+{
+	if (!desc->platform_ops->tdm_ops_read_cyclic_start)
+		return -ENOSYS;
+
+	return desc->platform_ops->tdm_ops_read_cyclic_start(desc, data,
+			nb_samples, callback, ctx);
+}
+
+/**
+ * @brief Stop a cyclic read started by tdm_read_cyclic_start().
+ * @param desc - The TDM descriptor.
+ * @return SUCCESS in case of success, negative error code otherwise.
+ */
+int32_t tdm_read_cyclic_stop(struct tdm_desc *desc)
+{
+	if (!desc->platform_ops->tdm_ops_read_cyclic_stop)
+		return -ENOSYS;
+
+	return desc->platform_ops->tdm_ops_read_cyclic_stop(desc);
+}
@@ -0,0 +1,249 @@
+/***************************************************************************//**
+ *   @file   tdm_acq.c
+ *   @brief  Implementation of the TDM multi-channel acquisition layer
+********************************************************************************
+ * Copyright 2021(c) Analog Devices, Inc.
+ *
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *  - Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ *  - Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ *  - Neither the name of Analog Devices, Inc. nor the names of its
+ *    contributors may be used to endorse or promote products derived
+ *    from this software without specific prior written permission.
+ *  - The use of this software may or may not infringe the patent rights
+ *    of one or more patent holders.  This license does not release you
+ *    from the requirement that you obtain separate licenses from these
+ *    patent holders to use this software.
+ *  - Use of the software either in source or binary form, must be run
+ *    on or directly connected to an Analog Devices Inc. component.
+ *
+ * THIS SOFTWARE IS PROVIDED BY ANALOG DEVICES "AS IS" AND ANY EXPRESS OR
+ * IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, NON-INFRINGEMENT,
+ * MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED.
+ * IN NO EVENT SHALL ANALOG DEVICES BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, INTELLECTUAL PROPERTY RIGHTS, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*******************************************************************************/
+
+#include <stdlib.h>
+#include "tdm_acq.h"
+#include "error.h"
+
+/**
+ * @brief Cyclic read callback, called from the DMA interrupt. Only flags the
+ * filled buffer half, the processing is done by tdm_acq_process().
+ * @param ctx - The acquisition descriptor.
+ * @param data - Start of the buffer half that was filled.
+ * @param nb_samples - Number of slots in the buffer half.
+ */
+static void tdm_acq_rx_callback(void *ctx, void *data, uint16_t nb_samples)
+{
+	struct tdm_acq_desc *desc = ctx;
+	uint8_t half;
+
+	half = ((uint8_t *)data == desc->dma_buff) ? 0 : 1;
+
+	if (desc->half_ready[half])
+		desc->overruns++;
+
+	desc->half_ready[half] = true;
+}
+
+/**
+ * @brief Initialize the acquisition layer.
+ * @param desc - The acquisition descriptor.
+ * @param param - The structure that contains the acquisition parameters.
+ * @return SUCCESS in case of success, negative error code otherwise.
+ */
+int32_t tdm_acq_init(struct tdm_acq_desc **desc,
+		     const struct tdm_acq_init_param *param)
+{
+	struct tdm_acq_desc *acq;
+	uint32_t dma_samples;
+	uint8_t data_size;
+	uint8_t i;
+
+	if (!desc || !param || !param->tdm || !param->nb_channels ||
+	    !param->block_samples || !param->decode || !param->block_ready)
+		return -EINVAL;
+
+	/* The DMA stores each slot in a byte, half-word or word */
+	data_size = param->tdm->data_size;
+	if (param->slot_bytes != (data_size <= 8 ? 1 : data_size <= 16 ? 2 : 4))
+		return -EINVAL;
+
+	/* Two blocks of frames must fit in one cyclic TDM read */
+	dma_samples = 2 * param->block_samples * param->nb_channels;
+	if (dma_samples > UINT16_MAX)
+		return -EINVAL;
+
+	acq = (struct tdm_acq_desc *)calloc(1, sizeof(*acq));
+	if (!acq)
+		return -ENOMEM;
+
+	acq->tdm = param->tdm;
+	acq->nb_channels = param->nb_channels;
+	acq->slot_bytes = param->slot_bytes;
+	acq->block_samples = param->block_samples;
+	acq->decode = param->decode;
+	acq->decode_ctx = param->decode_ctx;
+	acq->block_ready = param->block_ready;
+	acq->block_ctx = param->block_ctx;
+
+	acq->dma_buff = (uint8_t *)calloc(dma_samples, param->slot_bytes);
+	if (!acq->dma_buff)
+		goto error;
+
+	acq->channels = (int32_t **)calloc(param->nb_channels,
+					   sizeof(*acq->channels));
+	if (!acq->channels)
+		goto error;
+
+	for (i = 0; i < param->nb_channels; i++) {
+		acq->channels[i] = (int32_t *)calloc(param->block_samples,
+						     sizeof(int32_t));
+		if (!acq->channels[i])
+			goto error;
+	}
+
+	*desc = acq;
+
+	return SUCCESS;
+error:
+	tdm_acq_remove(acq);
+
+	return -ENOMEM;
+}
+
+/**
+ * @brief Start the circular DMA acquisition.
+ * @param desc - The acquisition descriptor.
+ * @return SUCCESS in case of success, negative error code otherwise.
+ */
+int32_t tdm_acq_start(struct tdm_acq_desc *desc)
+{
+	if (!desc)
+		return -EINVAL;
+
+	desc->half_ready[0] = false;
+	desc->half_ready[1] = false;
+	desc->next_half = 0;
+
+	return tdm_read_cyclic_start(desc->tdm, desc->dma_buff,
+				     2 * desc->block_samples * desc->nb_channels,
+				     tdm_acq_rx_callback, desc);
+}
+
+/**
+ * @brief De-interleave one block of frames into the channel buffers.
+ * @param desc - The acquisition descriptor.
+ * @param half - Half of the DMA buffer holding the block.
+ */
+static void tdm_acq_deinterleave(struct tdm_acq_desc *desc, uint8_t half)
+{
+	uint32_t block_slots = desc->block_samples * desc->nb_channels;
+	uint32_t errors = 0;
+	uint32_t slot;
+	uint32_t i;
+	uint8_t ch;
+	void *buff;
+
+	buff = desc->dma_buff + half * block_slots * desc->slot_bytes;
+
+	for (i = 0; i < desc->block_samples; i++) {
+		for (ch = 0; ch < desc->nb_channels; ch++) {
+			switch (desc->slot_bytes) {
+			case 1:
+				slot = ((uint8_t *)buff)[i * desc->nb_channels + ch];
+				break;
+			case 2:
+				slot = ((uint16_t *)buff)[i * desc->nb_channels + ch];
+				break;
+			default:
+				slot = ((uint32_t *)buff)[i * desc->nb_channels + ch];
+				break;
+			}
+
+			if (desc->decode(desc->decode_ctx, slot, ch,
+					 &desc->channels[ch][i]))
+				errors++;
+		}
+	}
+
+	desc->slot_errors += errors;
+}
+
+/**
+ * @brief De-interleave the blocks filled by the DMA and deliver them through
+ * the block callback. Must be called from the main loop faster than a block
+ * is acquired, otherwise the overrun counter is incremented.
+ * @param desc - The acquisition descriptor.
+ * @return Number of blocks delivered, negative error code otherwise.
+ */
+int32_t tdm_acq_process(struct tdm_acq_desc *desc)
+{
+	int32_t delivered = 0;
+
+	if (!desc)
+		return -EINVAL;
+
+	while (desc->half_ready[desc->next_half]) {
+		tdm_acq_deinterleave(desc, desc->next_half);
+		desc->half_ready[desc->next_half] = false;
+		desc->next_half ^= 1;
+
+		desc->block_ready(desc->block_ctx, desc->channels,
+				  desc->block_samples);
+		desc->blocks++;
+		delivered++;
+	}
+
+	return delivered;
+}
+
+/**
+ * @brief Stop the circular DMA acquisition.
+ * @param desc - The acquisition descriptor.
+ * @return SUCCESS in case of success, negative error code otherwise.
+ */
+int32_t tdm_acq_stop(struct tdm_acq_desc *desc)
+{
+	if (!desc)
+		return -EINVAL;
+
+	return tdm_read_cyclic_stop(desc->tdm);
+}
+
+/**
+ * @brief Free the resources allocated by tdm_acq_init().
+ * @param desc - The acquisition descriptor.
+ * @return SUCCESS in case of success, negative error code otherwise.
+ */
+int32_t tdm_acq_remove(struct tdm_acq_desc *desc)
+{
+	uint8_t i;
+
+	if (!desc)
+		return -EINVAL;
+
+	if (desc->channels) {
+		for (i = 0; i < desc->nb_channels; i++)
+			free(desc->channels[i]);
+		free(desc->channels);
+	}
+	free(desc->dma_buff);
+	free(desc);
+
+	return SUCCESS;
+}
@@ -0,0 +1,156 @@
+/***************************************************************************//**
+ *   @file   tdm_acq.h
+ *   @brief  Header file of the TDM multi-channel acquisition layer
+********************************************************************************
+ * Copyright 2021(c) Analog Devices, Inc.
+ *
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *  - Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ *  - Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ *  - Neither the name of Analog Devices, Inc. nor the names of its
+ *    contributors may be used to endorse or promote products derived
+ *    from this software without specific prior written permission.
+ *  - The use of this software may or may not infringe the patent rights
+ *    of one or more patent holders.  This license does not release you
+ *    from the requirement that you obtain separate licenses from these
+ *    patent holders to use this software.
+ *  - Use of the software either in source or binary form, must be run
+ *    on or directly connected to an Analog Devices Inc. component.
+ *
+ * THIS SOFTWARE IS PROVIDED BY ANALOG DEVICES "AS IS" AND ANY EXPRESS OR
+ * IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, NON-INFRINGEMENT,
+ * MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED.
+ * IN NO EVENT SHALL ANALOG DEVICES BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, INTELLECTUAL PROPERTY RIGHTS, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*******************************************************************************/
+
+#ifndef TDM_ACQ_H_
+#define TDM_ACQ_H_
+
+/******************************************************************************/
+/***************************** Include Files **********************************/
+/******************************************************************************/
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "tdm.h"
+
+/******************************************************************************/
+/*************************** Types Declarations *******************************/
+/******************************************************************************/
+
+/**
+ * @brief Decode one TDM slot into a sample.
+ * @param ctx - Decoder context (usually the ADC device structure).
+ * @param slot - Raw slot value, right aligned.
+ * @param ch - Channel (slot index in the frame) the value was received on.
+ * @param sample - Decoded, sign extended sample.
+ * @return SUCCESS if the slot header/CRC is valid, negative error code
+ * otherwise. The sample is stored in both cases.
+ */
+typedef int32_t (*tdm_acq_decode)(void *ctx, uint32_t slot, uint8_t ch,
+				  int32_t *sample);
+
+/**
+ * @brief Called when a block of de-interleaved samples is available.
+ * @param ctx - Context given in the initialization parameters.
+ * @param channels - One buffer of nb_samples samples for each channel.
+ * @param nb_samples - Number of samples in each channel buffer.
+ */
+typedef void (*tdm_acq_block_callback)(void *ctx, int32_t **channels,
+				       uint32_t nb_samples);
+
+/**
+ * @struct tdm_acq_init_param
+ * @brief Structure holding the parameters for the acquisition initialization
+ */
+struct tdm_acq_init_param {
+	/** Initialized TDM descriptor, one slot per channel */
+	struct tdm_desc *tdm;
+	/** Number of channels (slots) in a frame */
+	uint8_t nb_channels;
+	/** Size in bytes of a slot in memory: 1, 2 or 4, must match the TDM
+	 *  data size (up to 8, 16 or 32 bits) */
+	uint8_t slot_bytes;
+	/** Number of samples per channel delivered in a block */
+	uint32_t block_samples;
+	/** Slot decoder */
+	tdm_acq_decode decode;
+	/** Slot decoder context */
+	void *decode_ctx;
+	/** Block ready callback */
+	tdm_acq_block_callback block_ready;
+	/** Block ready callback context */
+	void *block_ctx;
+};
+
+/**
+ * @struct tdm_acq_desc
+ * @brief Structure holding the acquisition descriptor
+ */
+struct tdm_acq_desc {
+	/** TDM descriptor */
+	struct tdm_desc *tdm;
+	/** Number of channels (slots) in a frame */
+	uint8_t nb_channels;
+	/** Size in bytes of a slot in memory */
+	uint8_t slot_bytes;
+	/** Number of samples per channel delivered in a block */
+	uint32_t block_samples;
+	/** Slot decoder */
+	tdm_acq_decode decode;
+	/** Slot decoder context */
+	void *decode_ctx;
+	/** Block ready callback */
+	tdm_acq_block_callback block_ready;
+	/** Block ready callback context */
+	void *block_ctx;
+	/** Circular DMA buffer, two blocks of interleaved frames */
+	uint8_t *dma_buff;
+	/** De-interleaved per channel buffers */
+	int32_t **channels;
+	/** Set from the DMA interrupt when a half of dma_buff is filled */
+	volatile bool half_ready[2];
+	/** Next buffer half to be processed */
+	uint8_t next_half;
+	/** Number of blocks delivered */
+	uint32_t blocks;
+	/** Number of slots that failed the header/CRC check */
+	uint32_t slot_errors;
+	/** Number of blocks overwritten before being processed */
+	volatile uint32_t overruns;
+};
+
+/******************************************************************************/
+/************************ Functions Declarations ******************************/
+/******************************************************************************/
+
+/* Initialize the acquisition layer. */
+int32_t tdm_acq_init(struct tdm_acq_desc **desc,
+		     const struct tdm_acq_init_param *param);
+
+/* Start the circular DMA acquisition. */
+int32_t tdm_acq_start(struct tdm_acq_desc *desc);
+
+/* De-interleave the filled blocks and deliver them. */
+int32_t tdm_acq_process(struct tdm_acq_desc *desc);
+
+/* Stop the circular DMA acquisition. */
+int32_t tdm_acq_stop(struct tdm_acq_desc *desc);
+
+/* Free the resources allocated by tdm_acq_init(). */
+int32_t tdm_acq_remove(struct tdm_acq_desc *desc);
+
+#endif // TDM_ACQ_H_
@@ -0,0 +1,345 @@
+/***************************************************************************//**
+ *   @file   iio_axi_jesd204_mon.c
+ *   @brief  Implementation of iio_axi_jesd204_mon.
+********************************************************************************
+ * Copyright 2021(c) Analog Devices, Inc.
+ *
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *  - Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ *  - Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ *  - Neither the name of Analog Devices, Inc. nor the names of its
+ *    contributors may be used to endorse or promote products derived
+ *    from this software without specific prior written permission.
+ *  - The use of this software may or may not infringe the patent rights
+ *    of one or more patent holders.  This license does not release you
+ *    from the requirement that you obtain separate licenses from these
+ *    patent holders to use this software.
+ *  - Use of the software either in source or binary form, must be run
+ *    on or directly connected to an Analog Devices Inc. component.
+ *
+ * THIS SOFTWARE IS PROVIDED BY ANALOG DEVICES "AS IS" AND ANY EXPRESS OR
+ * IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, NON-INFRINGEMENT,
+ * MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED.
+ * IN NO EVENT SHALL ANALOG DEVICES BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, INTELLECTUAL PROPERTY RIGHTS, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*******************************************************************************/
+
+/******************************************************************************/
+/***************************** Include Files **********************************/
+/******************************************************************************/
+
+#include <inttypes.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include "error.h"
+#include "util.h"
+#include "iio.h"
+#include "iio_axi_jesd204_mon.h"
+
+/******************************************************************************/
+/********************** Macros and Constants Definitions **********************/
+/******************************************************************************/
+
+/* Size of the buffer the iio library provides for one attribute value */
+#define IIO_ATTR_MAX_LEN	256
+
+enum iio_axi_jesd204_mon_attr {
+	LINK_STATE,
+	LINK_UPTIME_MS,
+	LINK_UP_TOTAL_MS,
+	LINK_UPS,
+	LINK_LOSSES,
+	RESTARTS,
+	LANE_ERRORS,
+	LANE_DESYNCS,
+	LANE_ILAS_MISSING,
+	EVENTS,
+};
+
+/******************************************************************************/
+/************************ Functions Definitions *******************************/
+/******************************************************************************/
+
+/**
+ * @brief Print one value per lane.
+ * @param mon - Link monitor.
+ * @param buf - Where the values are stored.
+ * @param len - Maximum length of the values.
+ * @param attr - Lane statistic to print.
+ * @return Length of chars written in buf.
+ */
+static ssize_t iio_axi_jesd204_mon_lanes(struct axi_jesd204_mon *mon,
+		char *buf, size_t len, intptr_t attr)
+{
+	ssize_t n = 0;
+	uint32_t val;
+	uint32_t i;
+
+	buf[0] = '\0';
+	for (i = 0; i < mon->num_lanes && n < (ssize_t)len; i++) {
+		if (attr == LANE_ERRORS)
+			val = mon->lanes[i].errors;
+		else if (attr == LANE_DESYNCS)
+			val = mon->lanes[i].desyncs;
+		else
+			val = mon->lanes[i].ilas_missing;
+		n += snprintf(buf + n, len - n, "%s%"PRIu32"", i ? " " : "", val);
+	}
+
+	return min_t(ssize_t, n, len - 1);
+}
+
+/**
+ * @brief Print the event history, newest first, as "time_ms:event[:lane]"
+ * entries. The oldest events are left out when they don't fit.
+ * @param mon - Link monitor.
+ * @param buf - Where the events are stored.
+ * @param len - Maximum length of the events.
+ * @return Length of chars written in buf.
+ */
+static ssize_t iio_axi_jesd204_mon_events(struct axi_jesd204_mon *mon,
+		char *buf, size_t len)
+{
+	struct axi_jesd204_mon_event *evt;
+	uint32_t nb, i;
+	ssize_t n = 0, ret;
+
+	buf[0] = '\0';
+	nb = min_t(uint32_t, mon->nb_events, AXI_JESD204_MON_HISTORY);
+	for (i = 1; i <= nb; i++) {
+		evt = &mon->history[(mon->nb_events - i) % AXI_JESD204_MON_HISTORY];
+		if (evt->type == AXI_JESD204_MON_EVT_LANE_DESYNC ||
+		    evt->type == AXI_JESD204_MON_EVT_ILAS_MISSING)
+			ret = snprintf(buf + n, len - n, "%s%"PRIu32":%s:%u",
+				       n ? " " : "", evt->time_ms,
+				       axi_jesd204_mon_event_name(evt->type),
+				       evt->lane);
+		else
+			ret = snprintf(buf + n, len - n, "%s%"PRIu32":%s",
+				       n ? " " : "", evt->time_ms,
+				       axi_jesd204_mon_event_name(evt->type));
+		if (ret >= (ssize_t)len - n) {
+			buf[n] = '\0';
+			break;
+		}
+		n += ret;
+	}
+
+	return n;
+}
+
+/**
+ * @brief Get a link monitor statistic.
+ * @param device - Physical instance of a iio_axi_jesd204_mon_desc device.
+ * @param buf - Where value is stored.
+ * @param len - Maximum length of value to be stored in buf.
+ * @param channel - Channel properties.
+ * @param priv - Statistic to read.
+ * @return Length of chars written in buf, or negative value on failure.
+ */
+static ssize_t _get_jesd204_mon_attr(void *device, char *buf, size_t len,
+				     const struct iio_ch_info *channel,
+				     intptr_t priv)
+{
+	struct iio_axi_jesd204_mon_desc *desc = device;
+	struct axi_jesd204_mon *mon = desc->mon;
+	uint32_t val;
+
+	switch (priv) {
+	case LINK_STATE:
+		return snprintf(buf, len, "%s",
+				axi_jesd204_mon_state_name(mon->state));
+	case LINK_UPTIME_MS:
+		val = axi_jesd204_mon_uptime_ms(mon);
+		break;
+	case LINK_UP_TOTAL_MS:
+		val = mon->up_ms + axi_jesd204_mon_uptime_ms(mon);
+		break;
+	case LINK_UPS:
+		val = mon->link_ups;
+		break;
+	case LINK_LOSSES:
+		val = mon->link_losses;
+		break;
+	case RESTARTS:
+		val = mon->restarts;
+		break;
+	case LANE_ERRORS:
+	case LANE_DESYNCS:
+	case LANE_ILAS_MISSING:
+		return iio_axi_jesd204_mon_lanes(mon, buf, len, priv);
+	case EVENTS:
+		return iio_axi_jesd204_mon_events(mon, buf, len);
+	default:
+		return -EINVAL;
+	}
+
+	return snprintf(buf, len, "%"PRIu32"", val);
+}
+
+/**
+ * @brief Get a link monitor statistic, with the polling interrupt masked.
+ * @param device - Physical instance of a iio_axi_jesd204_mon_desc device.
+ * @param buf - Where value is stored.
+ * @param len - Maximum length of value to be stored in buf.
+ * @param channel - Channel properties.
+ * @param priv - Statistic to read.
+ * @return Length of chars written in buf, or negative value on failure.
+ */
+static ssize_t get_jesd204_mon_attr(void *device, char *buf, size_t len,
+				    const struct iio_ch_info *channel,
+				    intptr_t priv)
+{
+	struct iio_axi_jesd204_mon_desc *desc = device;
+	ssize_t ret;
+
+	len = min_t(size_t, len, IIO_ATTR_MAX_LEN);
+
+	if (desc->irq_desc)
+		irq_disable(desc->irq_desc, desc->irq_id);
+	ret = _get_jesd204_mon_attr(device, buf, len, channel, priv);
+	if (desc->irq_desc)
+		irq_enable(desc->irq_desc, desc->irq_id);
+
+	return ret;
+}
+
+/**
+ * @brief Clear the statistics and the event history, whatever the value.
+ * @param device - Physical instance of a iio_axi_jesd204_mon_desc device.
+ * @param buf - Value to be written to attribute.
+ * @param len - Length of the data in "buf".
+ * @param channel - Channel properties.
+ * @param priv - Unused.
+ * @return Number of bytes written to device, or negative value on failure.
+ */
+static ssize_t set_jesd204_mon_clear(void *device, char *buf, size_t len,
+				     const struct iio_ch_info *channel,
+				     intptr_t priv)
+{
+	struct iio_axi_jesd204_mon_desc *desc = device;
+	int32_t ret;
+
+	if (desc->irq_desc)
+		irq_disable(desc->irq_desc, desc->irq_id);
+	ret = axi_jesd204_mon_clear(desc->mon);
+	if (desc->irq_desc)
+		irq_enable(desc->irq_desc, desc->irq_id);
+	if (ret < 0)
+		return ret;
+
+	return len;
+}
+
+/**
+ * @brief Show a constant value for write only attributes.
+ * @param device - Physical instance of a iio_axi_jesd204_mon_desc device.
+ * @param buf - Where value is stored.
+ * @param len - Maximum length of value to be stored in buf.
+ * @param channel - Channel properties.
+ * @param priv - Unused.
+ * @return Length of chars written in buf.
+ */
+static ssize_t get_jesd204_mon_clear(void *device, char *buf, size_t len,
+				     const struct iio_ch_info *channel,
+				     intptr_t priv)
+{
+	return snprintf(buf, len, "0");
+}
+
+#define JESD204_MON_ATTR(_name, _priv) {	\
+	.name = _name,				\
+	.priv = _priv,				\
+	.show = get_jesd204_mon_attr,		\
+	.store = NULL,				\
+}
+
+/**
+ * List containing the device attributes.
+ */
+static struct iio_attribute iio_jesd204_mon_attributes[] = {
+	JESD204_MON_ATTR("link_state", LINK_STATE),
+	JESD204_MON_ATTR("link_uptime_ms", LINK_UPTIME_MS),
+	JESD204_MON_ATTR("link_up_total_ms", LINK_UP_TOTAL_MS),
+	JESD204_MON_ATTR("link_ups", LINK_UPS),
+	JESD204_MON_ATTR("link_losses", LINK_LOSSES),
+	JESD204_MON_ATTR("restarts", RESTARTS),
+	JESD204_MON_ATTR("lane_errors", LANE_ERRORS),
+	JESD204_MON_ATTR("lane_desyncs", LANE_DESYNCS),
+	JESD204_MON_ATTR("lane_ilas_missing", LANE_ILAS_MISSING),
+	JESD204_MON_ATTR("events", EVENTS),
+	{
+		.name = "stats_clear",
+		.show = get_jesd204_mon_clear,
+		.store = set_jesd204_mon_clear,
+	},
+	END_ATTRIBUTES_ARRAY
+};
+
+/**
+ * @brief Get device descriptor.
+ * @param desc - iio_axi_jesd204_mon descriptor.
+ * @param dev_descriptor - iio device.
+ * @return None.
+ */
+void iio_axi_jesd204_mon_get_dev_descriptor(struct iio_axi_jesd204_mon_desc *desc,
+		struct iio_device **dev_descriptor)
+{
+	*dev_descriptor = &desc->dev_descriptor;
+}
+
+/**
+ * @brief Expose the statistics of a link monitor as iio attributes.
+ * @param desc - Descriptor.
+ * @param init - Configuration structure.
+ * @return SUCCESS in case of success, FAILURE otherwise.
+ */
+int32_t iio_axi_jesd204_mon_init(struct iio_axi_jesd204_mon_desc **desc,
+				 struct iio_axi_jesd204_mon_init_param *init)
+{
+	struct iio_axi_jesd204_mon_desc *iio_mon;
+
+	if (!desc || !init || !init->mon)
+		return FAILURE;
+
+	iio_mon = (struct iio_axi_jesd204_mon_desc *)calloc(1, sizeof(*iio_mon));
+	if (!iio_mon)
+		return FAILURE;
+
+	iio_mon->mon = init->mon;
+	iio_mon->irq_desc = init->irq_desc;
+	iio_mon->irq_id = init->irq_id;
+	iio_mon->dev_descriptor.num_ch = 0;
+	iio_mon->dev_descriptor.attributes = iio_jesd204_mon_attributes;
+
+	*desc = iio_mon;
+
+	return SUCCESS;
+}
+
+/**
+ * @brief Release resources.
+ * @param desc - Descriptor.
+ * @return SUCCESS in case of success, FAILURE otherwise.
+ */
+int32_t iio_axi_jesd204_mon_remove(struct iio_axi_jesd204_mon_desc *desc)
+{
+	if (!desc)
+		return FAILURE;
+
+	free(desc);
+
+	return SUCCESS;
+}
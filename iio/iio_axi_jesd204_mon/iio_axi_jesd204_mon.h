@@ -0,0 +1,99 @@
+/***************************************************************************//**
+ *   @file   iio_axi_jesd204_mon.h
+ *   @brief  Header file of iio_axi_jesd204_mon.
+********************************************************************************
+ * Copyright 2021(c) Analog Devices, Inc.
+ *
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *  - Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ *  - Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ *  - Neither the name of Analog Devices, Inc. nor the names of its
+ *    contributors may be used to endorse or promote products derived
+ *    from this software without specific prior written permission.
+ *  - The use of this software may or may not infringe the patent rights
+ *    of one or more patent holders.  This license does not release you
+ *    from the requirement that you obtain separate licenses from these
+ *    patent holders to use this software.
+ *  - Use of the software either in source or binary form, must be run
+ *    on or directly connected to an Analog Devices Inc. component.
+ *
+ * THIS SOFTWARE IS PROVIDED BY ANALOG DEVICES "AS IS" AND ANY EXPRESS OR
+ * IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, NON-INFRINGEMENT,
+ * MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED.
+ * IN NO EVENT SHALL ANALOG DEVICES BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, INTELLECTUAL PROPERTY RIGHTS, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*******************************************************************************/
+
+#ifndef IIO_AXI_JESD204_MON_H_
+#define IIO_AXI_JESD204_MON_H_
+
+/******************************************************************************/
+/***************************** Include Files **********************************/
+/******************************************************************************/
+
+#include "iio_types.h"
+#include "irq.h"
+#include "axi_jesd204_mon.h"
+
+/******************************************************************************/
+/*************************** Types Declarations *******************************/
+/******************************************************************************/
+
+/**
+ * @struct iio_axi_jesd204_mon_desc
+ * @brief iio_axi_jesd204_mon descriptor
+ */
+struct iio_axi_jesd204_mon_desc {
+	/** Link monitor */
+	struct axi_jesd204_mon *mon;
+	/** Interrupt controller of the interrupt polling the monitor */
+	struct irq_ctrl_desc *irq_desc;
+	/** Interrupt polling the monitor */
+	uint32_t irq_id;
+	/** iio device descriptor */
+	struct iio_device dev_descriptor;
+};
+
+/**
+ * @struct iio_axi_jesd204_mon_init_param
+ * @brief iio_axi_jesd204_mon configuration.
+ */
+struct iio_axi_jesd204_mon_init_param {
+	/** Link monitor, polled by the application */
+	struct axi_jesd204_mon *mon;
+	/** Interrupt controller of the interrupt polling the monitor, NULL if
+	 *  it is polled from the main loop. The interrupt is masked while the
+	 *  attributes access the monitor. */
+	struct irq_ctrl_desc *irq_desc;
+	/** Interrupt polling the monitor */
+	uint32_t irq_id;
+};
+
+/******************************************************************************/
+/************************ Functions Declarations ******************************/
+/******************************************************************************/
+
+/* Init iio. */
+int32_t iio_axi_jesd204_mon_init(struct iio_axi_jesd204_mon_desc **desc,
+				 struct iio_axi_jesd204_mon_init_param *param);
+
+/* Get device descriptor. */
+void iio_axi_jesd204_mon_get_dev_descriptor(struct iio_axi_jesd204_mon_desc *desc,
+		struct iio_device **dev_descriptor);
+
+/* Free the resources allocated by iio_axi_jesd204_mon_init(). */
+int32_t iio_axi_jesd204_mon_remove(struct iio_axi_jesd204_mon_desc *desc);
+
+#endif // IIO_AXI_JESD204_MON_H_
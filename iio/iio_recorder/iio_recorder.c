@@ -0,0 +1,464 @@
+/***************************************************************************//**
+ *   @file   iio_recorder.c
+ *   @brief  Recorder of IIO buffers to FatFs capture files.
+********************************************************************************
+ * Copyright 2021(c) Analog Devices, Inc.
+ *
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *  - Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ *  - Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ *  - Neither the name of Analog Devices, Inc. nor the names of its
+ *    contributors may be used to endorse or promote products derived
+ *    from this software without specific prior written permission.
+ *  - The use of this software may or may not infringe the patent rights
+ *    of one or more patent holders.  This license does not release you
+ *    from the requirement that you obtain separate licenses from these
+ *    patent holders to use this software.
+ *  - Use of the software either in source or binary form, must be run
+ *    on or directly connected to an Analog Devices Inc. component.
+ *
+ * THIS SOFTWARE IS PROVIDED BY ANALOG DEVICES "AS IS" AND ANY EXPRESS OR
+ * IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, NON-INFRINGEMENT,
+ * MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED.
+ * IN NO EVENT SHALL ANALOG DEVICES BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, INTELLECTUAL PROPERTY RIGHTS, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*******************************************************************************/
+
+/******************************************************************************/
+/***************************** Include Files **********************************/
+/******************************************************************************/
+
+#include <stdlib.h>
+#include <string.h>
+#include "error.h"
+#include "util.h"
+#include "iio_recorder.h"
+
+/******************************************************************************/
+/************************ Functions Definitions *******************************/
+/******************************************************************************/
+
+/**
+ * @brief Write len bytes at the current file position.
+ * @param rec - Recorder descriptor.
+ * @param data - Data to write.
+ * @param len - Number of bytes.
+ * @return SUCCESS in case of success, FAILURE otherwise.
+ */
+static int32_t iio_recorder_write(struct iio_recorder *rec, const void *data,
+				  uint32_t len)
+{
+	UINT bw;
+
+	if (f_write(&rec->file, data, len, &bw) != FR_OK || bw != len) {
+		rec->stats.errors++;
+		return FAILURE;
+	}
+
+	return SUCCESS;
+}
+
+/**
+ * @brief Write the file header and the channel descriptors.
+ * @param rec - Recorder descriptor.
+ * @param param - Recorder configuration.
+ * @param nb_channels - Number of recorded channels.
+ * @return SUCCESS in case of success, FAILURE otherwise.
+ */
+static int32_t iio_recorder_write_header(struct iio_recorder *rec,
+		struct iio_recorder_init_param *param, uint32_t nb_channels)
+{
+	struct iio_rec_file_header hdr = {0};
+	struct iio_rec_channel ch;
+	struct iio_channel *chan;
+	uint32_t i;
+	int32_t ret;
+
+	hdr.magic = IIO_REC_MAGIC;
+	hdr.version = IIO_REC_VERSION;
+	hdr.header_len = sizeof(hdr) + nb_channels * sizeof(ch);
+	hdr.nb_channels = nb_channels;
+	hdr.frame_bytes = rec->frame_bytes;
+	hdr.sample_rate_hz = param->sample_rate_hz;
+	hdr.start_us = rec->get_time_us ? rec->get_time_us() : 0;
+	if (param->name)
+		strncpy(hdr.name, param->name, IIO_REC_NAME_LEN - 1);
+
+	ret = iio_recorder_write(rec, &hdr, sizeof(hdr));
+	if (ret != SUCCESS)
+		return ret;
+
+	for (i = 0; i < rec->iio_dev->num_ch; i++) {
+		if (!(rec->ch_mask & BIT(i)))
+			continue;
+
+		chan = &rec->iio_dev->channels[i];
+		memset(&ch, 0, sizeof(ch));
+		ch.scan_index = chan->scan_index;
+		if (chan->scan_type) {
+			ch.sign = chan->scan_type->sign;
+			ch.realbits = chan->scan_type->realbits;
+			ch.storagebits = chan->scan_type->storagebits;
+			ch.shift = chan->scan_type->shift;
+			ch.is_big_endian = chan->scan_type->is_big_endian;
+		}
+		if (chan->name)
+			strncpy(ch.name, chan->name, IIO_REC_CH_NAME_LEN - 1);
+
+		ret = iio_recorder_write(rec, &ch, sizeof(ch));
+		if (ret != SUCCESS)
+			return ret;
+	}
+
+	return SUCCESS;
+}
+
+/**
+ * @brief Create the capture file and allocate the chunk buffers.
+ * @param rec - Recorder descriptor.
+ * @param param - Recorder configuration.
+ * @return SUCCESS in case of success, negative error code otherwise.
+ */
+int32_t iio_recorder_init(struct iio_recorder **rec,
+			  struct iio_recorder_init_param *param)
+{
+	struct iio_recorder *r;
+	struct iio_channel *chan;
+	uint32_t nb_channels = 0;
+	uint32_t i;
+	int32_t ret = FAILURE;
+
+	if (!rec || !param || !param->path || !param->iio_dev ||
+	    !param->ch_mask || !param->chunk_samples || !param->max_index)
+		return -EINVAL;
+
+	r = calloc(1, sizeof(*r));
+	if (!r)
+		return -ENOMEM;
+
+	r->iio_dev = param->iio_dev;
+	r->dev_instance = param->dev_instance;
+	r->ch_mask = param->ch_mask;
+	r->chunk_samples = param->chunk_samples;
+	r->sync_chunks = param->sync_chunks;
+	r->get_time_us = param->get_time_us;
+	r->max_index = param->max_index;
+	r->index_stride = 1;
+	r->pending = -1;
+
+	for (i = 0; i < r->iio_dev->num_ch; i++) {
+		if (!(r->ch_mask & BIT(i)))
+			continue;
+		chan = &r->iio_dev->channels[i];
+		if (!chan->scan_type)
+			goto error;
+		r->frame_bytes += chan->scan_type->storagebits / 8;
+		nb_channels++;
+	}
+	if (!r->frame_bytes)
+		goto error;
+
+	r->buff[0] = calloc(2, r->chunk_samples * r->frame_bytes);
+	r->index = calloc(r->max_index, sizeof(*r->index));
+	if (!r->buff[0] || !r->index)
+		goto error;
+	r->buff[1] = r->buff[0] + r->chunk_samples * r->frame_bytes;
+
+	if (f_open(&r->file, param->path, FA_WRITE | FA_CREATE_ALWAYS) != FR_OK)
+		goto error;
+
+	if (iio_recorder_write_header(r, param, nb_channels) != SUCCESS) {
+		f_close(&r->file);
+		goto error;
+	}
+
+	if (r->iio_dev->prepare_transfer) {
+		ret = r->iio_dev->prepare_transfer(r->dev_instance, r->ch_mask);
+		if (ret < 0) {
+			f_close(&r->file);
+			goto error;
+		}
+	}
+
+	*rec = r;
+
+	return SUCCESS;
+
+error:
+	free(r->buff[0]);
+	free(r->index);
+	free(r);
+
+	return ret;
+}
+
+/**
+ * @brief Hand the filled buffer over to iio_recorder_process(). The chunk
+ * is dropped if the previous one was not written yet.
+ * @param rec - Recorder descriptor.
+ */
+static void iio_recorder_swap(struct iio_recorder *rec)
+{
+	if (rec->pending >= 0) {
+		rec->stats.overruns++;
+		rec->fill_samples = 0;
+		return;
+	}
+
+	rec->pending_first_sample = rec->fill_first_sample;
+	rec->pending_timestamp_us = rec->fill_timestamp_us;
+	rec->pending_samples = rec->fill_samples;
+	rec->pending = rec->fill;
+	rec->fill ^= 1;
+	rec->fill_samples = 0;
+}
+
+/**
+ * @brief Account for nb_samples just stored in the fill buffer.
+ * @param rec - Recorder descriptor.
+ * @param nb_samples - Number of samples.
+ */
+static void iio_recorder_commit(struct iio_recorder *rec, uint32_t nb_samples)
+{
+	rec->fill_samples += nb_samples;
+	rec->next_sample += nb_samples;
+
+	if (rec->fill_samples == rec->chunk_samples)
+		iio_recorder_swap(rec);
+}
+
+/**
+ * @brief Get the room left in the fill buffer, starting a new chunk if
+ * it is empty.
+ * @param rec - Recorder descriptor.
+ * @param dst - Where the next sample goes.
+ * @return Number of samples that fit in the fill buffer.
+ */
+static uint32_t iio_recorder_room(struct iio_recorder *rec, uint8_t **dst)
+{
+	if (!rec->fill_samples) {
+		rec->fill_first_sample = rec->next_sample;
+		rec->fill_timestamp_us = rec->get_time_us ? rec->get_time_us() : 0;
+	}
+
+	*dst = rec->buff[rec->fill] + rec->fill_samples * rec->frame_bytes;
+
+	return rec->chunk_samples - rec->fill_samples;
+}
+
+/**
+ * @brief Read nb_samples from the IIO device straight into the chunk
+ * buffers, with read_dev() or transfer_dev_to_mem() and read_data().
+ * @param rec - Recorder descriptor.
+ * @param nb_samples - Number of samples.
+ * @return SUCCESS in case of success, negative error code otherwise.
+ */
+int32_t iio_recorder_acquire(struct iio_recorder *rec, uint32_t nb_samples)
+{
+	struct iio_device *dev = rec->iio_dev;
+	uint32_t n, bytes;
+	uint8_t *dst;
+	ssize_t ret;
+
+	if (!dev->read_dev && !(dev->transfer_dev_to_mem && dev->read_data))
+		return -EINVAL;
+
+	while (nb_samples) {
+		n = min(nb_samples, iio_recorder_room(rec, &dst));
+		bytes = n * rec->frame_bytes;
+
+		if (dev->read_dev) {
+			ret = dev->read_dev(rec->dev_instance, dst, n);
+		} else {
+			ret = dev->transfer_dev_to_mem(rec->dev_instance, bytes,
+						       rec->ch_mask);
+			if (ret >= 0)
+				ret = dev->read_data(rec->dev_instance, (char *)dst,
+						     0, bytes, rec->ch_mask);
+		}
+		if (ret < 0)
+			return ret;
+
+		iio_recorder_commit(rec, n);
+		nb_samples -= n;
+	}
+
+	return SUCCESS;
+}
+
+/**
+ * @brief Record nb_samples frames delivered by the caller's own read path.
+ * Safe to call from the acquisition interrupt while the main loop runs
+ * iio_recorder_process().
+ * @param rec - Recorder descriptor.
+ * @param data - Interleaved sample frames.
+ * @param nb_samples - Number of samples.
+ * @return SUCCESS in case of success, negative error code otherwise.
+ */
+int32_t iio_recorder_push(struct iio_recorder *rec, const void *data,
+			  uint32_t nb_samples)
+{
+	const uint8_t *src = data;
+	uint8_t *dst;
+	uint32_t n;
+
+	if (!rec || (!data && nb_samples))
+		return -EINVAL;
+
+	while (nb_samples) {
+		n = min(nb_samples, iio_recorder_room(rec, &dst));
+		memcpy(dst, src, n * rec->frame_bytes);
+		src += n * rec->frame_bytes;
+		iio_recorder_commit(rec, n);
+		nb_samples -= n;
+	}
+
+	return SUCCESS;
+}
+
+/**
+ * @brief Add the chunk at offset to the seek index, halving the index
+ * resolution when it is full.
+ * @param rec - Recorder descriptor.
+ * @param offset - File offset of the chunk header.
+ */
+static void iio_recorder_index(struct iio_recorder *rec, uint64_t offset)
+{
+	uint32_t i;
+
+	if (rec->stats.chunks % rec->index_stride)
+		return;
+
+	if (rec->nb_index == rec->max_index) {
+		for (i = 0; 2 * i < rec->nb_index; i++)
+			rec->index[i] = rec->index[2 * i];
+		rec->nb_index = i;
+		rec->index_stride *= 2;
+		if (rec->stats.chunks % rec->index_stride)
+			return;
+	}
+
+	rec->index[rec->nb_index].offset = offset;
+	rec->index[rec->nb_index].first_sample = rec->pending_first_sample;
+	rec->index[rec->nb_index].timestamp_us = rec->pending_timestamp_us;
+	rec->nb_index++;
+}
+
+/**
+ * @brief Write the pending chunk, if any, to the capture file. To be
+ * called from the main loop, it never runs concurrently with itself.
+ * @param rec - Recorder descriptor.
+ * @return 1 if a chunk was written, 0 if none was pending, negative error
+ * code otherwise.
+ */
+int32_t iio_recorder_process(struct iio_recorder *rec)
+{
+	struct iio_rec_chunk_header hdr = {0};
+	uint64_t offset;
+	int32_t ret;
+
+	if (rec->pending < 0)
+		return 0;
+
+	offset = f_tell(&rec->file);
+
+	hdr.magic = IIO_REC_CHUNK_MAGIC;
+	hdr.payload_bytes = rec->pending_samples * rec->frame_bytes;
+	hdr.nb_samples = rec->pending_samples;
+	hdr.first_sample = rec->pending_first_sample;
+	hdr.timestamp_us = rec->pending_timestamp_us;
+
+	ret = iio_recorder_write(rec, &hdr, sizeof(hdr));
+	if (ret == SUCCESS)
+		ret = iio_recorder_write(rec, rec->buff[rec->pending],
+					 hdr.payload_bytes);
+	if (ret == SUCCESS) {
+		iio_recorder_index(rec, offset);
+		rec->stats.chunks++;
+		rec->stats.samples += hdr.nb_samples;
+
+		if (rec->sync_chunks && !(rec->stats.chunks % rec->sync_chunks) &&
+		    f_sync(&rec->file) != FR_OK)
+			rec->stats.errors++;
+	}
+
+	/* Release the buffer even on error, acquisition must go on */
+	rec->pending = -1;
+
+	return ret == SUCCESS ? 1 : ret;
+}
+
+/**
+ * @brief Get the recorder counters.
+ * @param rec - Recorder descriptor.
+ * @param stats - Where the counters are copied.
+ * @return SUCCESS in case of success, FAILURE otherwise.
+ */
+int32_t iio_recorder_get_stats(struct iio_recorder *rec,
+			       struct iio_recorder_stats *stats)
+{
+	if (!rec || !stats)
+		return FAILURE;
+
+	*stats = rec->stats;
+
+	return SUCCESS;
+}
+
+/**
+ * @brief Write the remaining samples, the seek index and the trailer, then
+ * close the capture file and free the recorder. The acquisition must be
+ * stopped before.
+ * @param rec - Recorder descriptor.
+ * @return SUCCESS in case of success, FAILURE otherwise.
+ */
+int32_t iio_recorder_close(struct iio_recorder *rec)
+{
+	struct iio_rec_trailer trailer = {0};
+	int32_t ret = SUCCESS;
+
+	if (!rec)
+		return FAILURE;
+
+	if (iio_recorder_process(rec) < 0)
+		ret = FAILURE;
+	if (rec->fill_samples) {
+		iio_recorder_swap(rec);
+		if (iio_recorder_process(rec) < 0)
+			ret = FAILURE;
+	}
+
+	trailer.magic = IIO_REC_INDEX_MAGIC;
+	trailer.nb_entries = rec->nb_index;
+	trailer.index_offset = f_tell(&rec->file);
+	trailer.total_samples = rec->stats.samples;
+
+	if (iio_recorder_write(rec, rec->index,
+			       rec->nb_index * sizeof(*rec->index)) != SUCCESS ||
+	    iio_recorder_write(rec, &trailer, sizeof(trailer)) != SUCCESS)
+		ret = FAILURE;
+
+	if (f_close(&rec->file) != FR_OK)
+		ret = FAILURE;
+
+	if (rec->iio_dev->end_transfer)
+		rec->iio_dev->end_transfer(rec->dev_instance);
+
+	free(rec->buff[0]);
+	free(rec->index);
+	free(rec);
+
+	return ret;
+}
@@ -0,0 +1,215 @@
+/***************************************************************************//**
+ *   @file   iio_recorder.h
+ *   @brief  Recorder of IIO buffers to FatFs capture files.
+********************************************************************************
+ * Copyright 2021(c) Analog Devices, Inc.
+ *
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *  - Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ *  - Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ *  - Neither the name of Analog Devices, Inc. nor the names of its
+ *    contributors may be used to endorse or promote products derived
+ *    from this software without specific prior written permission.
+ *  - The use of this software may or may not infringe the patent rights
+ *    of one or more patent holders.  This license does not release you
+ *    from the requirement that you obtain separate licenses from these
+ *    patent holders to use this software.
+ *  - Use of the software either in source or binary form, must be run
+ *    on or directly connected to an Analog Devices Inc. component.
+ *
+ * THIS SOFTWARE IS PROVIDED BY ANALOG DEVICES "AS IS" AND ANY EXPRESS OR
+ * IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, NON-INFRINGEMENT,
+ * MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED.
+ * IN NO EVENT SHALL ANALOG DEVICES BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, INTELLECTUAL PROPERTY RIGHTS, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*******************************************************************************/
+
+#ifndef IIO_RECORDER_H_
+#define IIO_RECORDER_H_
+
+/******************************************************************************/
+/***************************** Include Files **********************************/
+/******************************************************************************/
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "iio_types.h"
+#include "ff.h"
+
+/******************************************************************************/
+/********************** Macros and Constants Definitions **********************/
+/******************************************************************************/
+
+/*
+ * Capture file layout, all fields little endian:
+ *
+ * file header	magic, version, header_len, nb_channels, frame_bytes,
+ *		sample_rate_hz, start_us, device name
+ * channels	nb_channels x (scan_index, sign, realbits, storagebits,
+ *		shift, is_big_endian, name)
+ * chunks	chunk header (magic, payload bytes, samples, first sample,
+ *		timestamp) followed by the interleaved sample frames
+ * index	index entries (file offset, first sample, timestamp)
+ * trailer	magic, nb_entries, index offset, total samples
+ *
+ * The index and the trailer are written on close. A file without them
+ * (e.g. after a power loss) can still be read by walking the chunks.
+ */
+#define IIO_REC_MAGIC		0x43524949	/* "IIRC" */
+#define IIO_REC_CHUNK_MAGIC	0x4b4e4843	/* "CHNK" */
+#define IIO_REC_INDEX_MAGIC	0x58444e49	/* "INDX" */
+#define IIO_REC_VERSION		1
+
+#define IIO_REC_NAME_LEN	32
+#define IIO_REC_CH_NAME_LEN	16
+
+/******************************************************************************/
+/*************************** Types Declarations *******************************/
+/******************************************************************************/
+
+struct iio_rec_file_header {
+	uint32_t	magic;
+	uint16_t	version;
+	uint16_t	header_len;
+	uint32_t	nb_channels;
+	uint32_t	frame_bytes;
+	uint64_t	sample_rate_hz;
+	uint64_t	start_us;
+	char		name[IIO_REC_NAME_LEN];
+} __attribute__((packed));
+
+struct iio_rec_channel {
+	uint16_t	scan_index;
+	char		sign;
+	uint8_t		realbits;
+	uint8_t		storagebits;
+	uint8_t		shift;
+	uint8_t		is_big_endian;
+	uint8_t		reserved;
+	char		name[IIO_REC_CH_NAME_LEN];
+} __attribute__((packed));
+
+struct iio_rec_chunk_header {
+	uint32_t	magic;
+	uint32_t	payload_bytes;
+	uint32_t	nb_samples;
+	uint32_t	reserved;
+	uint64_t	first_sample;
+	uint64_t	timestamp_us;
+} __attribute__((packed));
+
+struct iio_rec_index_entry {
+	uint64_t	offset;
+	uint64_t	first_sample;
+	uint64_t	timestamp_us;
+} __attribute__((packed));
+
+struct iio_rec_trailer {
+	uint32_t	magic;
+	uint32_t	nb_entries;
+	uint64_t	index_offset;
+	uint64_t	total_samples;
+} __attribute__((packed));
+
+/**
+ * @struct iio_recorder_init_param
+ * @brief iio_recorder configuration.
+ */
+struct iio_recorder_init_param {
+	/** Capture file, created or truncated */
+	const char *path;
+	/** Device name stored in the file header */
+	const char *name;
+	/** IIO device the samples come from, for the channel scan types */
+	struct iio_device *iio_dev;
+	/** Device instance passed to the iio_dev callbacks */
+	void *dev_instance;
+	/** Mask of the recorded channels, bit n is iio_dev->channels[n] */
+	uint32_t ch_mask;
+	/** Sample rate stored in the file header */
+	uint64_t sample_rate_hz;
+	/** Samples per chunk, the size of each of the two buffers */
+	uint32_t chunk_samples;
+	/** Index entries kept in memory, the index is decimated when full */
+	uint32_t max_index;
+	/** Chunks written between two f_sync() calls, 0 to only sync on close */
+	uint32_t sync_chunks;
+	/** Time base of the timestamps, may be NULL */
+	uint64_t (*get_time_us)(void);
+};
+
+/**
+ * @struct iio_recorder_stats
+ * @brief iio_recorder counters.
+ */
+struct iio_recorder_stats {
+	/** Samples written to the file */
+	uint64_t samples;
+	/** Chunks written to the file */
+	uint32_t chunks;
+	/** Chunks dropped because the file writes fell behind */
+	uint32_t overruns;
+	/** Failed file operations */
+	uint32_t errors;
+};
+
+/**
+ * @struct iio_recorder
+ * @brief iio_recorder descriptor.
+ */
+struct iio_recorder {
+	FIL file;
+	struct iio_device *iio_dev;
+	void *dev_instance;
+	uint32_t ch_mask;
+	uint32_t frame_bytes;
+	uint32_t chunk_samples;
+	uint32_t sync_chunks;
+	uint64_t (*get_time_us)(void);
+	/** Chunk buffers, one filled by the acquisition, one written out */
+	uint8_t *buff[2];
+	uint32_t fill_samples;
+	uint8_t fill;
+	/** Buffer waiting for iio_recorder_process(), -1 if none */
+	volatile int8_t pending;
+	uint64_t fill_first_sample;
+	uint64_t fill_timestamp_us;
+	uint64_t pending_first_sample;
+	uint64_t pending_timestamp_us;
+	uint32_t pending_samples;
+	/** Samples accepted from the acquisition */
+	uint64_t next_sample;
+	struct iio_rec_index_entry *index;
+	uint32_t max_index;
+	uint32_t nb_index;
+	uint32_t index_stride;
+	struct iio_recorder_stats stats;
+};
+
+/******************************************************************************/
+/************************ Functions Declarations ******************************/
+/******************************************************************************/
+
+int32_t iio_recorder_init(struct iio_recorder **rec,
+			  struct iio_recorder_init_param *param);
+int32_t iio_recorder_acquire(struct iio_recorder *rec, uint32_t nb_samples);
+int32_t iio_recorder_push(struct iio_recorder *rec, const void *data,
+			  uint32_t nb_samples);
+int32_t iio_recorder_process(struct iio_recorder *rec);
+int32_t iio_recorder_get_stats(struct iio_recorder *rec,
+			       struct iio_recorder_stats *stats);
+int32_t iio_recorder_close(struct iio_recorder *rec);
+
+#endif /* IIO_RECORDER_H_ */
@@ -56,4 +56,8 @@ int32_t axi_io_read(uint32_t base, uint32_t offset, uint32_t *data);
 /* AXI IO Write data */
 int32_t axi_io_write(uint32_t base, uint32_t offset, uint32_t data);
 
+/* AXI IO Write a buffer of consecutive words */
+int32_t axi_io_write_buff(uint32_t base, uint32_t offset, const uint32_t *data,
+			  uint32_t nb_words);
+
 #endif // AXI_IO_H_
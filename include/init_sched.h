@@ -0,0 +1,180 @@
+/***************************************************************************//**
+ *   @file   init_sched.h
+ *   @brief  Header file of the cooperative initialization scheduler.
+********************************************************************************
+ * Copyright 2021(c) Analog Devices, Inc.
+ *
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *  - Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ *  - Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ *  - Neither the name of Analog Devices, Inc. nor the names of its
+ *    contributors may be used to endorse or promote products derived
+ *    from this software without specific prior written permission.
+ *  - The use of this software may or may not infringe the patent rights
+ *    of one or more patent holders.  This license does not release you
+ *    from the requirement that you obtain separate licenses from these
+ *    patent holders to use this software.
+ *  - Use of the software either in source or binary form, must be run
+ *    on or directly connected to an Analog Devices Inc. component.
+ *
+ * THIS SOFTWARE IS PROVIDED BY ANALOG DEVICES "AS IS" AND ANY EXPRESS OR
+ * IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, NON-INFRINGEMENT,
+ * MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED.
+ * IN NO EVENT SHALL ANALOG DEVICES BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, INTELLECTUAL PROPERTY RIGHTS, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*******************************************************************************/
+
+#ifndef INIT_SCHED_H_
+#define INIT_SCHED_H_
+
+/******************************************************************************/
+/***************************** Include Files **********************************/
+/******************************************************************************/
+
+#include <stdint.h>
+
+/******************************************************************************/
+/********************** Macros and Constants Definitions **********************/
+/******************************************************************************/
+
+/* Idle delay between wait condition polls when nothing else can run */
+#define INIT_SCHED_POLL_US	100
+
+/******************************************************************************/
+/*************************** Types Declarations *******************************/
+/******************************************************************************/
+
+/**
+ * @struct init_sched_step
+ * @brief One initialization step of a device. Steps of a device run in
+ * order; a step only starts once all the events it requires were provided
+ * by completed steps, of any device.
+ */
+struct init_sched_step {
+	/** Step name, used in the timing report */
+	const char *name;
+	/** Issue the step, NULL if there is nothing to issue. Must not block
+	 *  on long waits, those belong to settle_us and ready. */
+	int32_t (*run)(void *ctx);
+	/** Wait condition (PLL lock, calibration done...): 1 when met, 0 while
+	 *  pending, negative error code on failure. NULL if there is none. */
+	int32_t (*ready)(void *ctx);
+	/** Fixed settle time after run, before ready is polled, in us */
+	uint32_t settle_us;
+	/** Time allowed for ready to be met after settling, in us. 0 waits
+	 *  forever. */
+	uint32_t timeout_us;
+	/** Mask of events needed before the step starts */
+	uint32_t requires;
+	/** Mask of events signalled when the step completes */
+	uint32_t provides;
+};
+
+/**
+ * @struct init_sched_device
+ * @brief A device taking part in the bring-up.
+ */
+struct init_sched_device {
+	/** Device name, used in the timing report */
+	const char *name;
+	/** Context passed to the step callbacks */
+	void *ctx;
+	/** Steps, run in order */
+	const struct init_sched_step *steps;
+	/** Number of steps */
+	uint8_t nb_steps;
+};
+
+/**
+ * @struct init_sched_stats
+ * @brief Timing of one step, times in us relative to the scheduler start.
+ */
+struct init_sched_stats {
+	/** Time the step was issued */
+	uint32_t start_us;
+	/** Time spent in run */
+	uint32_t run_us;
+	/** Time from the end of run until the wait condition was met */
+	uint32_t wait_us;
+	/** Step result, 1 while not completed */
+	int32_t status;
+};
+
+/**
+ * @struct init_sched_init_param
+ * @brief Scheduler initialization parameters.
+ */
+struct init_sched_init_param {
+	/** Devices to bring up */
+	const struct init_sched_device *devices;
+	/** Number of devices */
+	uint8_t nb_devices;
+	/** Free running time source in us, wrapping at 2^32. If NULL, only the
+	 *  idle delays are accounted for. */
+	uint32_t (*get_time_us)(void);
+	/** Idle delay between polls in us, 0 for INIT_SCHED_POLL_US */
+	uint32_t poll_us;
+};
+
+/**
+ * @struct init_sched_desc
+ * @brief Scheduler descriptor.
+ */
+struct init_sched_desc {
+	/** Devices to bring up */
+	const struct init_sched_device *devices;
+	/** Number of devices */
+	uint8_t nb_devices;
+	/** Time source in us */
+	uint32_t (*get_time_us)(void);
+	/** Idle delay between polls in us */
+	uint32_t poll_us;
+	/** Events provided so far */
+	uint32_t events;
+	/** Current step of each device */
+	uint8_t *cur;
+	/** Set while the current step of each device waits for completion */
+	uint8_t *waiting;
+	/** Time each device entered its wait, in us */
+	uint32_t *wait_start;
+	/** Per step timing, devices one after the other */
+	struct init_sched_stats *stats;
+	/** Index of the first step of each device in stats */
+	uint16_t *first;
+	/** Total number of steps */
+	uint16_t nb_stats;
+	/** Sum of the idle delays, in us */
+	uint32_t idle_us;
+	/** Time at the start of init_sched_run(), in us */
+	uint32_t t0;
+	/** Duration of the whole bring-up, in us */
+	uint32_t total_us;
+};
+
+/******************************************************************************/
+/************************ Functions Declarations ******************************/
+/******************************************************************************/
+
+/* Allocate a scheduler for a set of devices. */
+int32_t init_sched_init(struct init_sched_desc **desc,
+			const struct init_sched_init_param *param);
+/* Bring all the devices up, overlapping the waits of independent steps. */
+int32_t init_sched_run(struct init_sched_desc *desc);
+/* Print the per step timing report. */
+void init_sched_report(struct init_sched_desc *desc);
+/* Free the resources allocated by init_sched_init(). */
+int32_t init_sched_remove(struct init_sched_desc *desc);
+
+#endif /* INIT_SCHED_H_ */
@@ -56,6 +56,15 @@ enum tdm_mode {
 	TDM_SLAVE_RX
 };
 
+/**
+ * @brief Callback invoked by the platform driver when a cyclic read has
+ * filled one half of its buffer.
+ * @param ctx - Context given to tdm_read_cyclic_start().
+ * @param data - Start of the buffer half that was filled.
+ * @param nb_samples - Number of samples in the buffer half.
+ */
+typedef void (*tdm_rx_callback)(void *ctx, void *data, uint16_t nb_samples);
+
 /**
  * @struct tdm_init_param
  * @brief Structure holding the parameters for TDM initialization
@@ -92,6 +101,8 @@ struct tdm_init_param {
 struct tdm_desc {
 	/** Platform operation function pointers */
 	const struct tdm_platform_ops *platform_ops;
+	/** Useful data size in a slot, specified in number of bits */
+	uint8_t data_size;
 	/**  TDM extra parameters (device specific) */
 	void *extra;
 };
@@ -110,6 +121,11 @@ struct tdm_platform_ops {
 	int32_t (*tdm_ops_write)(struct tdm_desc *, void *, uint16_t);
 	/** TDM remove operation function pointer */
 	int32_t (*tdm_ops_remove)(struct tdm_desc *);
+	/** TDM cyclic (circular DMA) read start function pointer */
+	int32_t (*tdm_ops_read_cyclic_start)(struct tdm_desc *, void *, uint16_t,
+					     tdm_rx_callback, void *);
+	/** TDM cyclic read stop function pointer */
+	int32_t (*tdm_ops_read_cyclic_stop)(struct tdm_desc *);
 };
 
 /* Initialize the TDM communication peripheral. */
@@ -129,4 +145,14 @@ int32_t tdm_write(struct tdm_desc *desc,
 		  void *data,
 		  uint16_t bytes_number);
 
+/* Start a cyclic read of data in a circular buffer. */
+int32_t tdm_read_cyclic_start(struct tdm_desc *desc,
+			      void *data,
+			      uint16_t nb_samples,
+			      tdm_rx_callback callback,
+			      void *ctx);
+
+/* Stop a cyclic read. */
+int32_t tdm_read_cyclic_stop(struct tdm_desc *desc);
+
 #endif // TDM_H_
@@ -0,0 +1,247 @@
+/***************************************************************************//**
+ *   @file   wavegen.h
+ *   @brief  Header file of the waveform generator.
+********************************************************************************
+ * Copyright 2021(c) Analog Devices, Inc.
+ *
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *  - Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ *  - Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ *  - Neither the name of Analog Devices, Inc. nor the names of its
+ *    contributors may be used to endorse or promote products derived
+ *    from this software without specific prior written permission.
+ *  - The use of this software may or may not infringe the patent rights
+ *    of one or more patent holders.  This license does not release you
+ *    from the requirement that you obtain separate licenses from these
+ *    patent holders to use this software.
+ *  - Use of the software either in source or binary form, must be run
+ *    on or directly connected to an Analog Devices Inc. component.
+ *
+ * THIS SOFTWARE IS PROVIDED BY ANALOG DEVICES "AS IS" AND ANY EXPRESS OR
+ * IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, NON-INFRINGEMENT,
+ * MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED.
+ * IN NO EVENT SHALL ANALOG DEVICES BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, INTELLECTUAL PROPERTY RIGHTS, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*******************************************************************************/
+
+#ifndef WAVEGEN_H_
+#define WAVEGEN_H_
+
+/******************************************************************************/
+/***************************** Include Files **********************************/
+/******************************************************************************/
+
+#include <stdint.h>
+#include <stdbool.h>
+
+/******************************************************************************/
+/********************** Macros and Constants Definitions **********************/
+/******************************************************************************/
+
+#define WAVEGEN_MAX_TONES	8
+/* Number of samples generated per inner pass */
+#define WAVEGEN_BLOCK_SIZE	128
+/* Sine table size, expressed as number of phase bits used for indexing */
+#define WAVEGEN_LUT_BITS	10
+#define WAVEGEN_LUT_SIZE	(1 << WAVEGEN_LUT_BITS)
+/* Full scale amplitude, Q15 */
+#define WAVEGEN_FULL_SCALE	32767
+
+/******************************************************************************/
+/*************************** Types Declarations *******************************/
+/******************************************************************************/
+
+/**
+ * @struct wavegen_tone
+ * @brief Single tone parameters.
+ */
+struct wavegen_tone {
+	/** Frequency in Hz, negative values rotate clockwise on I/Q outputs */
+	int32_t freq_hz;
+	/** Amplitude, Q15 fraction of full scale */
+	uint16_t amplitude;
+	/** Initial phase, 0 to 65535 maps 0 to 2 * pi */
+	uint16_t phase;
+};
+
+/**
+ * @struct wavegen_chirp
+ * @brief Linear frequency sweep parameters. A sweep restarts from the start
+ * frequency once duration_samples samples have been generated.
+ */
+struct wavegen_chirp {
+	/** Start frequency in Hz */
+	int32_t start_hz;
+	/** Stop frequency in Hz */
+	int32_t stop_hz;
+	/** Sweep duration in samples, 0 disables the chirp */
+	uint32_t duration_samples;
+	/** Amplitude, Q15 fraction of full scale */
+	uint16_t amplitude;
+};
+
+/**
+ * @struct wavegen_init_param
+ * @brief Waveform generator initialization parameters. The output is the sum
+ * of the tones, the chirp and the noise, saturated to full scale.
+ */
+struct wavegen_init_param {
+	/** Sample rate in Hz */
+	uint32_t sample_rate_hz;
+	/** Tones */
+	struct wavegen_tone tones[WAVEGEN_MAX_TONES];
+	/** Number of tones */
+	uint8_t nb_tones;
+	/** Chirp */
+	struct wavegen_chirp chirp;
+	/** Uniform noise amplitude, Q15 fraction of full scale, 0 disables it */
+	uint16_t noise_amplitude;
+	/** Noise generator seed, must be non zero */
+	uint32_t noise_seed;
+	/** DAC resolution in bits, samples are right aligned */
+	uint8_t resolution;
+	/** Offset binary output instead of two's complement */
+	bool offset_binary;
+};
+
+/**
+ * @struct wavegen_nco
+ * @brief Phase accumulator state.
+ */
+struct wavegen_nco {
+	/** Phase accumulator */
+	uint32_t phase;
+	/** Phase increment per sample */
+	uint32_t step;
+	/** Amplitude, Q15 */
+	int32_t amplitude;
+};
+
+/**
+ * @struct wavegen_desc
+ * @brief Waveform generator descriptor.
+ */
+struct wavegen_desc {
+	/** Sample rate in Hz */
+	uint32_t sample_rate_hz;
+	/** Tone oscillators */
+	struct wavegen_nco tones[WAVEGEN_MAX_TONES];
+	/** Number of tones */
+	uint8_t nb_tones;
+	/** Chirp oscillator */
+	struct wavegen_nco chirp;
+	/** Chirp phase increment at the start of the sweep */
+	uint32_t chirp_start_step;
+	/** Chirp phase increment change per sample */
+	int32_t chirp_rate;
+	/** Chirp sweep length in samples */
+	uint32_t chirp_samples;
+	/** Samples left in the current sweep */
+	uint32_t chirp_left;
+	/** Noise amplitude, Q15 */
+	int32_t noise_amplitude;
+	/** Noise generator state */
+	uint32_t noise_state;
+	/** Output shift applied to the Q15 samples */
+	uint8_t shift;
+	/** Output offset (offset binary) */
+	uint16_t offset;
+	/** Accumulators for the in-phase and quadrature components */
+	int32_t acc_i[WAVEGEN_BLOCK_SIZE];
+	int32_t acc_q[WAVEGEN_BLOCK_SIZE];
+};
+
+/**
+ * @struct wavegen_ring_init_param
+ * @brief Streaming ring initialization parameters.
+ */
+struct wavegen_ring_init_param {
+	/** Generator feeding the ring */
+	struct wavegen_desc *gen;
+	/** Ring buffer (cyclic DMA buffer) of nb_segments * segment_samples *
+	 *  nb_copies words, I in the lower half and Q in the upper half */
+	uint32_t *buff;
+	/** Number of segments the ring is split in */
+	uint32_t nb_segments;
+	/** Number of samples in a segment */
+	uint32_t segment_samples;
+	/** Number of times each I/Q word is replicated (TX channels) */
+	uint8_t nb_copies;
+	/** Called after a segment is written, e.g. data cache flush */
+	void (*flush)(void *addr, uint32_t bytes);
+};
+
+/**
+ * @struct wavegen_ring
+ * @brief Streaming ring descriptor. The DMA side reports consumed segments
+ * with wavegen_ring_release() and the application regenerates them with
+ * wavegen_ring_refill().
+ */
+struct wavegen_ring {
+	/** Generator feeding the ring */
+	struct wavegen_desc *gen;
+	/** Ring buffer */
+	uint32_t *buff;
+	/** Number of segments */
+	uint32_t nb_segments;
+	/** Number of samples in a segment */
+	uint32_t segment_samples;
+	/** I/Q word replication factor */
+	uint8_t nb_copies;
+	/** Cache maintenance callback */
+	void (*flush)(void *addr, uint32_t bytes);
+	/** Segments consumed by the DMA */
+	volatile uint32_t released;
+	/** Segments regenerated */
+	uint32_t refilled;
+	/** Next segment to regenerate */
+	uint32_t next;
+	/** Times the DMA lapped the generator */
+	uint32_t underruns;
+};
+
+/******************************************************************************/
+/************************ Functions Declarations ******************************/
+/******************************************************************************/
+
+/* Initialize the waveform generator. */
+int32_t wavegen_init(struct wavegen_desc **desc,
+		     const struct wavegen_init_param *param);
+/* Restart the waveform from its initial phase. */
+int32_t wavegen_reset(struct wavegen_desc *desc,
+		      const struct wavegen_init_param *param);
+/* Change a tone frequency and amplitude, keeping the phase continuous. */
+int32_t wavegen_set_tone(struct wavegen_desc *desc, uint8_t index,
+			 int32_t freq_hz, uint16_t amplitude);
+/* Generate I/Q samples in separate buffers. */
+int32_t wavegen_fill(struct wavegen_desc *desc, uint16_t *data_i,
+		     uint16_t *data_q, uint32_t nb_samples);
+/* Generate packed I/Q words, replicated nb_copies times. */
+int32_t wavegen_fill_iq(struct wavegen_desc *desc, uint32_t *buff,
+			uint32_t nb_samples, uint8_t nb_copies);
+/* Free the resources allocated by wavegen_init(). */
+int32_t wavegen_remove(struct wavegen_desc *desc);
+
+/* Initialize a streaming ring and fill it completely. */
+int32_t wavegen_ring_init(struct wavegen_ring **ring,
+			  const struct wavegen_ring_init_param *param);
+/* Mark segments as consumed by the DMA. Safe to call from interrupts. */
+void wavegen_ring_release(struct wavegen_ring *ring, uint32_t nb_segments);
+/* Regenerate the consumed segments. */
+int32_t wavegen_ring_refill(struct wavegen_ring *ring);
+/* Free the resources allocated by wavegen_ring_init(). */
+int32_t wavegen_ring_remove(struct wavegen_ring *ring);
+
+#endif /* WAVEGEN_H_ */
@@ -44,21 +44,52 @@
 #include "ff.h"			/* Obtains integer types */
 #include "diskio.h"		/* Declarations of disk functions */
 
-#include "sd.h"
 #include "error.h"
+#include "adi_diskio.h"
 #include <stdio.h>
+#include <string.h>
+#ifndef LINUX_PLATFORM
+#include "sd.h"
+#endif
 
 /******************************************************************************/
 /********************** Macros and Constants Definitions **********************/
 /******************************************************************************/
 
-#define DEV_SD		0	/* Example: Map MMC/SD card to physical drive 0 */
+#define DEV_SD		0	/* Map MMC/SD card (or the image file on Linux) to physical drive 0 */
 #define DEV_RAM		1	/* Example: Map Ramdisk to physical drive 1 */
 #define DEV_USB		2	/* Example: Map USB MSD to physical drive 2 */
 
+#define SECTOR_SIZE		512u
 #define ERASE_SECTOR_SIZE	1u
+
+#ifndef LINUX_PLATFORM
 uint8_t			sd_init_var = false;
 extern struct sd_desc	*sd_desc;
+#else
+static FILE		*img_file;
+#endif
+
+/******************************************************************************/
+/*************************** Types Declarations *******************************/
+/******************************************************************************/
+
+struct cache_entry {
+	LBA_t		sector;
+	uint32_t	age;
+	bool		valid;
+	bool		dirty;
+};
+
+/******************************************************************************/
+/************************ Variable Declarations *******************************/
+/******************************************************************************/
+
+static struct cache_entry	cache[DISKIO_CACHE_SECTORS];
+static BYTE			cache_buff[DISKIO_CACHE_SECTORS][SECTOR_SIZE]
+__attribute__ ((aligned));
+static uint32_t			cache_clock;
+static struct diskio_cache_stats	stats;
 
 /******************************************************************************/
 /************************ Functions Definitions *******************************/
@@ -67,7 +98,193 @@ extern struct sd_desc	*sd_desc;
 DSTATUS SD_disk_status();
 DSTATUS SD_disk_initialize();
 DRESULT SD_disk_read(BYTE *buff, LBA_t sector, UINT count);
-DRESULT SD_disk_write(BYTE *buff, LBA_t sector, UINT count);
+DRESULT SD_disk_write(const BYTE *buff, LBA_t sector, UINT count);
+DRESULT SD_disk_size(LBA_t *count);
+
+/*-----------------------------------------------------------------------*/
+/* Sector cache                                                          */
+/*-----------------------------------------------------------------------*/
+
+/* Only physical drive DEV_SD is backed by a device, so the cache is not
+ * tagged with the drive number. */
+
+static struct cache_entry *cache_find(LBA_t sector)
+{
+	uint32_t i;
+
+	for (i = 0; i < DISKIO_CACHE_SECTORS; i++)
+		if (cache[i].valid && cache[i].sector == sector)
+			return &cache[i];
+
+	return NULL;
+}
+
+static DRESULT cache_flush_entry(struct cache_entry *entry)
+{
+	DRESULT res;
+
+	if (!entry->valid || !entry->dirty)
+		return RES_OK;
+
+	res = SD_disk_write(cache_buff[entry - cache], entry->sector, 1);
+	if (res != RES_OK)
+		return res;
+
+	entry->dirty = false;
+	stats.writebacks++;
+
+	return RES_OK;
+}
+
+static DRESULT cache_flush(void)
+{
+	struct cache_entry *next;
+	DRESULT res;
+	uint32_t i;
+
+	/* Write back in ascending sector order */
+	do {
+		next = NULL;
+		for (i = 0; i < DISKIO_CACHE_SECTORS; i++)
+			if (cache[i].valid && cache[i].dirty &&
+			    (!next || cache[i].sector < next->sector))
+				next = &cache[i];
+		if (next) {
+			res = cache_flush_entry(next);
+			if (res != RES_OK)
+				return res;
+		}
+	} while (next);
+
+	return RES_OK;
+}
+
+/* Get a slot for sector, evicting the least recently used entry */
+static struct cache_entry *cache_alloc(LBA_t sector)
+{
+	struct cache_entry *entry = &cache[0];
+	uint32_t i;
+
+	for (i = 0; i < DISKIO_CACHE_SECTORS; i++) {
+		if (!cache[i].valid) {
+			entry = &cache[i];
+			break;
+		}
+		if (cache[i].age < entry->age)
+			entry = &cache[i];
+	}
+
+	if (cache_flush_entry(entry) != RES_OK)
+		return NULL;
+
+	entry->sector = sector;
+	entry->valid = true;
+	entry->dirty = false;
+
+	return entry;
+}
+
+static DRESULT cache_read(BYTE *buff, LBA_t sector, UINT count)
+{
+	struct cache_entry *entry;
+	DRESULT res;
+	UINT i;
+
+	if (count > 1) {
+		/* Straight multi-block read, then apply the newer cached data */
+		res = SD_disk_read(buff, sector, count);
+		if (res != RES_OK)
+			return res;
+		stats.direct += count;
+
+		for (i = 0; i < DISKIO_CACHE_SECTORS; i++)
+			if (cache[i].valid && cache[i].dirty &&
+			    cache[i].sector >= sector &&
+			    cache[i].sector < sector + count)
+				memcpy(buff + (cache[i].sector - sector) * SECTOR_SIZE,
+				       cache_buff[i], SECTOR_SIZE);
+
+		return RES_OK;
+	}
+
+	entry = cache_find(sector);
+	if (entry) {
+		stats.hits++;
+	} else {
+		stats.misses++;
+		entry = cache_alloc(sector);
+		if (!entry)
+			return RES_ERROR;
+		res = SD_disk_read(cache_buff[entry - cache], sector, 1);
+		if (res != RES_OK) {
+			entry->valid = false;
+			return res;
+		}
+	}
+
+	entry->age = ++cache_clock;
+	memcpy(buff, cache_buff[entry - cache], SECTOR_SIZE);
+
+	return RES_OK;
+}
+
+static DRESULT cache_write(const BYTE *buff, LBA_t sector, UINT count)
+{
+	struct cache_entry *entry;
+	DRESULT res;
+	UINT i;
+
+	if (count > 1) {
+		/* Straight multi-block write, it supersedes the cached copies */
+		res = SD_disk_write(buff, sector, count);
+		if (res != RES_OK)
+			return res;
+		stats.direct += count;
+
+		for (i = 0; i < DISKIO_CACHE_SECTORS; i++)
+			if (cache[i].valid && cache[i].sector >= sector &&
+			    cache[i].sector < sector + count)
+				cache[i].valid = false;
+
+		return RES_OK;
+	}
+
+	entry = cache_find(sector);
+	if (entry) {
+		stats.hits++;
+	} else {
+		stats.misses++;
+		entry = cache_alloc(sector);
+		if (!entry)
+			return RES_ERROR;
+	}
+
+	entry->age = ++cache_clock;
+	entry->dirty = true;
+	memcpy(cache_buff[entry - cache], buff, SECTOR_SIZE);
+
+	return RES_OK;
+}
+
+static void cache_invalidate(void)
+{
+	uint32_t i;
+
+	for (i = 0; i < DISKIO_CACHE_SECTORS; i++)
+		cache[i].valid = false;
+}
+
+/**
+ * Get the sector cache counters
+ * @param stats_out	- Where the counters are copied
+ * @param clear		- Reset the counters after reading them
+ */
+void diskio_cache_stats(struct diskio_cache_stats *stats_out, bool clear)
+{
+	*stats_out = stats;
+	if (clear)
+		memset(&stats, 0, sizeof(stats));
+}
 
 /*-----------------------------------------------------------------------*/
 /* Get Drive Status                                                      */
@@ -98,6 +315,7 @@ DSTATUS disk_initialize (
 {
 	switch (pdrv) {
 	case DEV_SD :
+		cache_invalidate();
 		return SD_disk_initialize();
 	case DEV_RAM :
 		return STA_NODISK;
@@ -120,7 +338,9 @@ DRESULT disk_read (
 
 	switch (pdrv) {
 	case DEV_SD :
-		return SD_disk_read(buff, sector, count);
+		if (SD_disk_status())
+			return RES_NOTRDY;
+		return cache_read(buff, sector, count);
 	case DEV_RAM :
 		return RES_NOTRDY;
 	case DEV_USB :
@@ -144,7 +364,9 @@ DRESULT disk_write (
 {
 	switch (pdrv) {
 	case DEV_SD:
-		return SD_disk_write(buff, sector, count);
+		if (SD_disk_status())
+			return RES_NOTRDY;
+		return cache_write(buff, sector, count);
 	case DEV_RAM :
 		return RES_NOTRDY;
 	case DEV_USB :
@@ -167,15 +389,16 @@ DRESULT disk_ioctl (
 {
 	switch(pdrv) {
 	case DEV_SD:
-		switch (cmd){
-		case CTRL_SYNC: return RES_OK;
+		switch (cmd) {
+		case CTRL_SYNC:
+			/* Write back the cached FAT and directory sectors */
+			return cache_flush();
 		case GET_SECTOR_COUNT:
-			*(LBA_t *)buff = sd_desc->memory_size / DATA_BLOCK_LEN;
-			return RES_OK;
+			return SD_disk_size((LBA_t *)buff);
 		case GET_SECTOR_SIZE:
 			/* Sector size in FatFs is the name for
 			 * data block size in the SD card specification */
-			*(WORD *)buff = DATA_BLOCK_LEN;
+			*(WORD *)buff = SECTOR_SIZE;
 			return RES_OK;
 		case GET_BLOCK_SIZE:
 			/* Block size in FatFs is the name for
@@ -193,6 +416,8 @@ DRESULT disk_ioctl (
 	return RES_PARERR;
 }
 
+#ifndef LINUX_PLATFORM
+
 DSTATUS SD_disk_status()
 {
 	if (sd_init_var)
@@ -210,24 +435,126 @@ DSTATUS SD_disk_initialize()
 	return 0;
 }
 
+/* Multi-sector requests are issued as one CMD18/CMD25 transfer by sd.c */
 DRESULT SD_disk_read(BYTE *buff, LBA_t sector, UINT count)
 {
 	if (!sd_init_var)
 		return RES_NOTRDY;
-	if (SUCCESS != sd_read(sd_desc, buff, (uint64_t)sector * 512, (uint64_t)count * 512))
+	if (SUCCESS != sd_read(sd_desc, buff, (uint64_t)sector * SECTOR_SIZE,
+			       (uint64_t)count * SECTOR_SIZE))
 		return RES_ERROR;
 
 	return RES_OK;
 }
 
-DRESULT SD_disk_write(BYTE *buff, LBA_t sector, UINT count)
+DRESULT SD_disk_write(const BYTE *buff, LBA_t sector, UINT count)
 {
 	if (!sd_init_var)
 		return RES_NOTRDY;
-	if (SUCCESS != sd_write(sd_desc, buff, (uint64_t)sector * 512, (uint64_t)count * 512))
+	if (SUCCESS != sd_write(sd_desc, (uint8_t *)buff,
+				(uint64_t)sector * SECTOR_SIZE,
+				(uint64_t)count * SECTOR_SIZE))
 		return RES_ERROR;
 
 	return RES_OK;
 }
 
+DRESULT SD_disk_size(LBA_t *count)
+{
+	*count = sd_desc->memory_size / DATA_BLOCK_LEN;
+
+	return RES_OK;
+}
+
+#else
 
+/*
+ * On Linux physical drive 0 is backed by a FAT formatted image file (e.g.
+ * made with mkfs.vfat), for benchmarking the FatFs and cache layers on a
+ * host.
+ */
+
+/**
+ * Attach an image file to physical drive 0
+ * @param path	- Path of the image file
+ * @return SUCCESS in case of success, FAILURE otherwise.
+ */
+int32_t diskio_image_open(const char *path)
+{
+	if (img_file)
+		return FAILURE;
+
+	img_file = fopen(path, "r+b");
+	if (!img_file)
+		return FAILURE;
+
+	return SUCCESS;
+}
+
+/**
+ * Write back the cache and detach the image file
+ * @return SUCCESS in case of success, FAILURE otherwise.
+ */
+int32_t diskio_image_close(void)
+{
+	int32_t ret = SUCCESS;
+
+	if (!img_file)
+		return FAILURE;
+
+	if (cache_flush() != RES_OK)
+		ret = FAILURE;
+	cache_invalidate();
+
+	if (fclose(img_file))
+		ret = FAILURE;
+	img_file = NULL;
+
+	return ret;
+}
+
+DSTATUS SD_disk_status()
+{
+	return img_file ? 0 : STA_NOINIT;
+}
+
+DSTATUS SD_disk_initialize()
+{
+	return SD_disk_status();
+}
+
+DRESULT SD_disk_read(BYTE *buff, LBA_t sector, UINT count)
+{
+	if (fseek(img_file, (long)sector * SECTOR_SIZE, SEEK_SET))
+		return RES_ERROR;
+	if (fread(buff, SECTOR_SIZE, count, img_file) != count)
+		return RES_ERROR;
+
+	return RES_OK;
+}
+
+DRESULT SD_disk_write(const BYTE *buff, LBA_t sector, UINT count)
+{
+	if (fseek(img_file, (long)sector * SECTOR_SIZE, SEEK_SET))
+		return RES_ERROR;
+	if (fwrite(buff, SECTOR_SIZE, count, img_file) != count)
+		return RES_ERROR;
+
+	return RES_OK;
+}
+
+DRESULT SD_disk_size(LBA_t *count)
+{
+	long size;
+
+	if (fseek(img_file, 0, SEEK_END))
+		return RES_ERROR;
+	size = ftell(img_file);
+	if (size < 0)
+		return RES_ERROR;
+	*count = size / SECTOR_SIZE;
+
+	return RES_OK;
+}
+
+#endif
@@ -55,8 +55,10 @@
 #include <inttypes.h>
 
 #ifdef ENABLE_IIO_NETWORK
-#include "delay.h"
 #include "tcp_socket.h"
+#endif
+#if defined(ENABLE_IIO_NETWORK) || defined(ENABLE_IIO_UART_RING)
+#include "delay.h"
 #include "circular_buffer.h"
 #endif
 
@@ -67,6 +69,14 @@
 #define IIOD_PORT		30431
 #define MAX_SOCKET_TO_HANDLE	4
 #define REG_ACCESS_ATTRIBUTE	"direct_reg_access"
+/* IP and UDP headers */
+#define UDP_IP_HEADERS_SIZE	28
+/* Receive buffer of the stream socket, nothing is expected from the host */
+#define UDP_STREAM_RX_BUFF_SIZE	64
+/* Bytes copied to or from a UART ring with the interrupts disabled */
+#define UART_RING_COPY_MAX	256
+/* Time given to the tx ring to drain when the UART link is removed (ms) */
+#define UART_RING_DRAIN_TIMEOUT	1000
 
 /******************************************************************************/
 /*************************** Types Declarations *******************************/
@@ -131,6 +141,51 @@ struct iio_interface {
 	struct iio_data_buffer	*read_buffer;
 };
 
+#ifdef ENABLE_IIO_UART_RING
+/* Interrupt driven rings of the UART link */
+struct iio_uart_ring {
+	struct uart_desc	*uart;
+	struct irq_ctrl_desc	*irq_desc;
+	uint32_t		uart_irq_id;
+	struct circular_buffer	*rx;
+	struct circular_buffer	*tx;
+	uint32_t		tx_size;
+	/* Set while a uart_write_nonblocking() from the tx ring is active */
+	volatile bool		tx_busy;
+	/* Circular DMA receive buffer of the platform, NULL if not used */
+	uint8_t			*dma_rx_ring;
+	uint32_t		dma_rx_ring_size;
+	/* Position in dma_rx_ring of the next byte to consume */
+	uint32_t		dma_rx_tail;
+	/* Byte of the rx ring armed for the one byte read, NULL if not armed */
+	uint8_t			*rx_slot;
+	/* Set on receive overrun or UART error, reported by the next read */
+	volatile bool		rx_error;
+};
+#endif
+
+#ifdef ENABLE_IIO_NETWORK
+/* State of the UDP buffer stream */
+struct iio_udp_stream {
+	struct iio_interface		*iface;
+	struct network_interface	*net;
+	uint32_t			sock_id;
+	/* Header followed by the payload of the packet being sent */
+	uint8_t				*packet;
+	uint32_t			block_bytes;
+	/* Payload bytes of a full packet, multiple of the frame size */
+	uint32_t			payload_bytes;
+	/* Offset of the next packet in the block, block_bytes if a new
+	 * block must be acquired */
+	uint32_t			offset;
+	uint32_t			seq;
+	uint32_t			block;
+	uint64_t			timestamp_us;
+	uint64_t			(*get_time_us)(void);
+	struct iio_udp_stream_stats	stats;
+};
+#endif
+
 struct iio_desc {
 	struct tinyiiod		*iiod;
 	struct tinyiiod_ops	*iiod_ops;
@@ -142,6 +197,10 @@ struct iio_desc {
 	uint32_t		xml_size_to_last_dev;
 	uint32_t		dev_count;
 	struct uart_desc	*uart_desc;
+#ifdef ENABLE_IIO_UART_RING
+	/* UART rings, NULL if the blocking UART functions are used */
+	struct iio_uart_ring	*uart_ring;
+#endif
 #ifdef ENABLE_IIO_NETWORK
 	/* FIFO for socket descriptors */
 	struct circular_buffer	*sockets;
@@ -149,6 +208,10 @@ struct iio_desc {
 	struct tcp_socket_desc	*current_sock;
 	/* Instance of server socket */
 	struct tcp_socket_desc	*server;
+	/* Network interface of the server, used for the UDP stream */
+	struct network_interface *net;
+	/* UDP buffer stream, NULL if not started */
+	struct iio_udp_stream	*stream;
 #endif
 };
 
@@ -160,6 +223,8 @@ static struct iio_desc			*g_desc;
 
 #ifdef ENABLE_IIO_NETWORK
 
+static void _udp_stream_poll(struct iio_desc *desc);
+
 static inline int32_t _pop_sock(struct iio_desc *desc,
 				struct tcp_socket_desc **sock)
 {
@@ -197,7 +262,10 @@ static int32_t _get_next_socket(struct iio_desc *desc)
 			nb_active_sockets = _nb_active_sockets(desc);
 			if (nb_active_sockets == 0) {
 				/* Wait until a connection exists */
-				mdelay(1);
+				if (desc->stream)
+					_udp_stream_poll(desc);
+				else
+					mdelay(1);
 				continue;
 			} else {
 				break;
@@ -238,6 +306,9 @@ static int32_t network_read(const void *data, uint32_t len)
 	do {
 		ret = socket_recv(g_desc->current_sock,
 				  (void *)((uint8_t *)data + i), len - i);
+		/* Stream buffer data while waiting for the next command */
+		if (ret == -EAGAIN || ret == 0)
+			_udp_stream_poll(g_desc);
 		if (IS_ERR_VALUE(ret)) {
 			*(int8_t *)data = '*';
 			break;
@@ -257,8 +328,265 @@ static int32_t network_read(const void *data, uint32_t len)
 }
 #endif
 
+#ifdef ENABLE_IIO_UART_RING
+
+/* Send the next contiguous part of the tx ring. Called with the interrupts
+ * disabled or from the UART interrupt */
+static void _uart_ring_tx_start(struct iio_uart_ring *ring)
+{
+	uint8_t		*buff;
+	uint32_t	len;
+	int32_t		ret;
+
+	if (ring->tx_busy)
+		return;
+
+	ret = cb_prepare_async_read(ring->tx, ring->tx_size, (void **)&buff,
+				    &len);
+	if (IS_ERR_VALUE(ret))
+		return;
+
+	ring->tx_busy = true;
+	ret = uart_write_nonblocking(ring->uart, buff, len);
+	if (IS_ERR_VALUE(ret)) {
+		cb_end_async_read(ring->tx);
+		ring->tx_busy = false;
+	}
+}
+
+/* Arm a one byte read into the rx ring */
+static void _uart_ring_rx_start(struct iio_uart_ring *ring)
+{
+	uint8_t		*buff;
+	uint32_t	len;
+
+	if (IS_ERR_VALUE(cb_prepare_async_write(ring->rx, 1, (void **)&buff,
+						&len))) {
+		ring->rx_slot = NULL;
+		return;
+	}
+
+	ring->rx_slot = buff;
+	uart_read_nonblocking(ring->uart, buff, 1);
+}
+
+/* Handle the UART events */
+static void _uart_ring_callback(struct iio_uart_ring *ring, uint32_t event,
+				void *extra)
+{
+	switch (event) {
+	case WRITE_DONE:
+		cb_end_async_read(ring->tx);
+		ring->tx_busy = false;
+		_uart_ring_tx_start(ring);
+		break;
+	case READ_DONE:
+		/* In DMA mode data comes from iio_uart_rx_ring_update */
+		if (ring->dma_rx_ring)
+			break;
+		cb_end_async_write(ring->rx);
+		_uart_ring_rx_start(ring);
+		break;
+	case ERROR:
+	default:
+		/* The driver aborts the active transfers on error */
+		ring->rx_error = true;
+		if (ring->tx_busy) {
+			cb_end_async_read(ring->tx);
+			ring->tx_busy = false;
+			_uart_ring_tx_start(ring);
+		}
+		/* No byte was received, re-arm the same slot */
+		if (!ring->dma_rx_ring && ring->rx_slot)
+			uart_read_nonblocking(ring->uart, ring->rx_slot, 1);
+		break;
+	}
+}
+
+/*
+ * Blocking read from the rx ring.
+ * The rings are also updated from the UART and DMA interrupts, so they are
+ * accessed with the interrupts disabled, UART_RING_COPY_MAX bytes at a time.
+ */
+static ssize_t _uart_ring_read(struct iio_uart_ring *ring, uint8_t *buf,
+			       uint32_t len)
+{
+	uint32_t	available;
+	uint32_t	n;
+	uint32_t	i;
+	int32_t		ret;
+
+	i = 0;
+	while (i < len) {
+		irq_global_disable(ring->irq_desc);
+		ret = cb_size(ring->rx, &available);
+		n = min(min(available, len - i), UART_RING_COPY_MAX);
+		if (n)
+			ret = cb_read(ring->rx, buf + i, n);
+		irq_global_enable(ring->irq_desc);
+		if (ret == -EOVERRUN || ring->rx_error) {
+			ring->rx_error = false;
+			return -EOVERRUN;
+		}
+		i += n;
+	}
+
+	return len;
+}
+
+/* Copy to the tx ring. Returns when the data is queued, not yet sent */
+static ssize_t _uart_ring_write(struct iio_uart_ring *ring,
+				const uint8_t *buf, uint32_t len)
+{
+	uint32_t	used;
+	uint32_t	n;
+	uint32_t	i;
+
+	i = 0;
+	while (i < len) {
+		irq_global_disable(ring->irq_desc);
+		cb_size(ring->tx, &used);
+		n = min(min(ring->tx_size - used, len - i), UART_RING_COPY_MAX);
+		if (n) {
+			cb_write(ring->tx, buf + i, n);
+			_uart_ring_tx_start(ring);
+		}
+		irq_global_enable(ring->irq_desc);
+		i += n;
+	}
+
+	return len;
+}
+
+static void _uart_ring_remove(struct iio_uart_ring *ring)
+{
+	uint32_t timeout;
+
+	if (!ring)
+		return;
+
+	/* Let the queued data go out, unless the UART is stalled */
+	timeout = UART_RING_DRAIN_TIMEOUT;
+	while (ring->tx_busy && timeout--)
+		mdelay(1);
+	irq_disable(ring->irq_desc, ring->uart_irq_id);
+	irq_unregister(ring->irq_desc, ring->uart_irq_id);
+	cb_remove(ring->rx);
+	cb_remove(ring->tx);
+	free(ring);
+}
+
+static int32_t _uart_ring_init(struct iio_uart_ring **ring,
+			       struct uart_desc *uart,
+			       struct iio_uart_ring_param *param)
+{
+	struct iio_uart_ring	*lring;
+	struct callback_desc	callback_desc;
+	int32_t			ret;
+
+	if (!param->rx_size || !param->tx_size ||
+	    (param->dma_rx_ring && !param->dma_rx_ring_size))
+		return -EINVAL;
+
+	lring = (struct iio_uart_ring *)calloc(1, sizeof(*lring));
+	if (!lring)
+		return -ENOMEM;
+
+	lring->uart = uart;
+	lring->irq_desc = param->irq_desc;
+	lring->uart_irq_id = param->uart_irq_id;
+	lring->tx_size = param->tx_size;
+	lring->dma_rx_ring = param->dma_rx_ring;
+	lring->dma_rx_ring_size = param->dma_rx_ring_size;
+
+	ret = cb_init(&lring->rx, param->rx_size);
+	if (IS_ERR_VALUE(ret))
+		goto free_ring;
+	ret = cb_init(&lring->tx, param->tx_size);
+	if (IS_ERR_VALUE(ret))
+		goto free_rx;
+
+	callback_desc.callback =
+		(void (*)(void*, uint32_t, void*))_uart_ring_callback;
+	callback_desc.ctx = lring;
+	callback_desc.config = param->uart_irq_conf;
+	ret = irq_register_callback(lring->irq_desc, lring->uart_irq_id,
+				    &callback_desc);
+	if (IS_ERR_VALUE(ret))
+		goto free_tx;
+
+	ret = irq_enable(lring->irq_desc, lring->uart_irq_id);
+	if (IS_ERR_VALUE(ret))
+		goto free_irq;
+
+	/* In DMA mode the platform calls iio_uart_rx_ring_update */
+	if (!lring->dma_rx_ring) {
+		irq_disable(lring->irq_desc, lring->uart_irq_id);
+		_uart_ring_rx_start(lring);
+		irq_enable(lring->irq_desc, lring->uart_irq_id);
+	}
+
+	*ring = lring;
+
+	return SUCCESS;
+
+free_irq:
+	irq_unregister(lring->irq_desc, lring->uart_irq_id);
+free_tx:
+	cb_remove(lring->tx);
+free_rx:
+	cb_remove(lring->rx);
+free_ring:
+	free(lring);
+
+	return ret;
+}
+
+/**
+ * @brief Consume the circular DMA receive buffer up to the DMA write position.
+ *
+ * Must be called by the platform from the half/full transfer and idle-line
+ * interrupts of the DMA.
+ * The data is moved to the rx ring, so the DMA buffer only has to cover the
+ * interrupt latency while the rx ring covers the command processing.
+ * @param desc - IIO descriptor.
+ * @param head - Position in dma_rx_ring where the DMA will write next.
+ * @return SUCCESS in case of success or negative value otherwise.
+ */
+ssize_t iio_uart_rx_ring_update(struct iio_desc *desc, uint32_t head)
+{
+	struct iio_uart_ring	*ring;
+	uint32_t		len;
+
+	if (!desc || !desc->uart_ring || !desc->uart_ring->dma_rx_ring)
+		return -EINVAL;
+
+	ring = desc->uart_ring;
+	if (head >= ring->dma_rx_ring_size)
+		return -EINVAL;
+
+	if (head < ring->dma_rx_tail) {
+		len = ring->dma_rx_ring_size - ring->dma_rx_tail;
+		cb_write(ring->rx, ring->dma_rx_ring + ring->dma_rx_tail, len);
+		ring->dma_rx_tail = 0;
+	}
+	if (head > ring->dma_rx_tail) {
+		len = head - ring->dma_rx_tail;
+		cb_write(ring->rx, ring->dma_rx_ring + ring->dma_rx_tail, len);
+		ring->dma_rx_tail = head;
+	}
+
+	return SUCCESS;
+}
+
+#endif /* ENABLE_IIO_UART_RING */
+
 static ssize_t iio_phy_read(char *buf, size_t len)
 {
+#ifdef ENABLE_IIO_UART_RING
+	if (g_desc->phy_type == USE_UART && g_desc->uart_ring)
+		return _uart_ring_read(g_desc->uart_ring, (uint8_t *)buf, len);
+#endif
 	if (g_desc->phy_type == USE_UART)
 		return (ssize_t)uart_read(g_desc->uart_desc, (uint8_t *)buf,
 					  (size_t)len);
@@ -273,6 +601,11 @@ static ssize_t iio_phy_read(char *buf, size_t len)
 /** Write to a peripheral device (UART, USB, NETWORK) */
 static ssize_t iio_phy_write(const char *buf, size_t len)
 {
+#ifdef ENABLE_IIO_UART_RING
+	if (g_desc->phy_type == USE_UART && g_desc->uart_ring)
+		return _uart_ring_write(g_desc->uart_ring, (const uint8_t *)buf,
+					len);
+#endif
 	if (g_desc->phy_type == USE_UART)
 		return (ssize_t)uart_write(g_desc->uart_desc,
 					   (uint8_t *)buf, (size_t)len);
@@ -729,6 +1062,12 @@ static int32_t iio_open_dev(const char *device, size_t sample_size,
 	if (!iface)
 		return -ENODEV;
 
+#ifdef ENABLE_IIO_NETWORK
+	/* The buffer is owned by the UDP stream */
+	if (g_desc->stream && g_desc->stream->iface == iface)
+		return -EBUSY;
+#endif
+
 	ch_mask = 0xFFFFFFFF >> (32 - iface->dev_descriptor->num_ch);
 
 	if (mask & ~ch_mask)
@@ -756,6 +1095,11 @@ static int32_t iio_close_dev(const char *device)
 	if (!iface)
 		return FAILURE;
 
+#ifdef ENABLE_IIO_NETWORK
+	if (g_desc->stream && g_desc->stream->iface == iface)
+		return -EBUSY;
+#endif
+
 	iface->ch_mask = 0;
 	if (iface->dev_descriptor->end_transfer)
 		return iface->dev_descriptor->end_transfer(iface->dev_instance);
@@ -1193,6 +1537,237 @@ ssize_t iio_unregister(struct iio_desc *desc, char *name)
 	return SUCCESS;
 }
 
+#ifdef ENABLE_IIO_NETWORK
+
+/* Send the next packet of the UDP stream, acquiring a new block if needed */
+static void _udp_stream_poll(struct iio_desc *desc)
+{
+	struct iio_udp_stream	*stream = desc->stream;
+	struct iio_udp_header	*hdr;
+	uint32_t		len;
+	ssize_t			ret;
+
+	if (!stream)
+		return;
+
+	if (stream->offset == stream->block_bytes) {
+		ret = iio_transfer_dev_to_mem(stream->iface->dev_id,
+					      stream->block_bytes);
+		if (IS_ERR_VALUE(ret)) {
+			stream->stats.errors++;
+			return;
+		}
+		stream->timestamp_us = stream->get_time_us ?
+				       stream->get_time_us() : 0;
+		stream->offset = 0;
+		stream->stats.blocks++;
+	}
+
+	hdr = (struct iio_udp_header *)stream->packet;
+	len = min(stream->payload_bytes, stream->block_bytes - stream->offset);
+	ret = iio_read_dev(stream->iface->dev_id, (char *)(hdr + 1),
+			   stream->offset, len);
+	if (IS_ERR_VALUE(ret)) {
+		/* Drop the rest of the block */
+		stream->stats.errors++;
+		stream->offset = stream->block_bytes;
+		stream->block++;
+		return;
+	}
+
+	hdr->magic = IIO_UDP_MAGIC;
+	hdr->seq = stream->seq++;
+	hdr->block = stream->block;
+	hdr->offset = stream->offset;
+	hdr->dropped = stream->stats.dropped;
+	hdr->len = len;
+	hdr->flags = 0;
+	if (stream->offset == 0)
+		hdr->flags |= IIO_UDP_FLAG_START;
+	if (stream->offset + len == stream->block_bytes)
+		hdr->flags |= IIO_UDP_FLAG_END;
+	hdr->version = IIO_UDP_VERSION;
+	hdr->timestamp_us = stream->timestamp_us;
+
+	/* No retransmission, a packet that can't be sent is dropped */
+	ret = stream->net->socket_send(stream->net->net, stream->sock_id,
+				       stream->packet, sizeof(*hdr) + len);
+	if (IS_ERR_VALUE(ret)) {
+		stream->stats.dropped++;
+	} else {
+		stream->stats.packets++;
+		stream->stats.bytes += len;
+	}
+
+	stream->offset += len;
+	if (stream->offset == stream->block_bytes)
+		stream->block++;
+}
+
+static struct iio_interface *_find_interface_by_name(struct iio_desc *desc,
+		const char *name)
+{
+	struct iio_interface	*iface;
+	uint32_t		i;
+
+	for (i = 0; SUCCESS == list_read_idx(desc->interfaces_list,
+					     (void **)&iface, i); i++)
+		if (!strcmp(iface->name, name))
+			return iface;
+
+	return NULL;
+}
+
+/**
+ * @brief Stream the buffer of a device to a host over UDP.
+ *
+ * Blocks of param->block_bytes are acquired from the device and sent as
+ * packets of whole sample frames that fit the MTU. The packets are sent
+ * while the server waits for the next command, attributes and the other
+ * devices stay available on TCP. Lost packets are not retransmitted, the
+ * host detects them from the sequence numbers.
+ * The device buffer can't be opened from TCP while it is streamed.
+ * @param desc - IIO descriptor, initialized with USE_NETWORK.
+ * @param param - Stream configuration.
+ * @return SUCCESS in case of success or negative value otherwise.
+ */
+ssize_t iio_udp_stream_start(struct iio_desc *desc,
+			     struct iio_udp_stream_param *param)
+{
+	struct iio_udp_stream	*stream;
+	struct iio_interface	*iface;
+	struct iio_device	*dev;
+	uint32_t		frame_bytes;
+	uint32_t		mtu;
+	uint32_t		i;
+	int32_t			ret;
+
+	if (!desc || !param || !param->name || !param->ch_mask ||
+	    !param->block_bytes || desc->phy_type != USE_NETWORK ||
+	    !desc->net || !desc->net->socket_send)
+		return -EINVAL;
+
+	if (desc->stream)
+		return -EBUSY;
+
+	iface = _find_interface_by_name(desc, param->name);
+	if (!iface)
+		return -ENODEV;
+
+	dev = iface->dev_descriptor;
+	if (param->ch_mask & ~(0xFFFFFFFF >> (32 - dev->num_ch)))
+		return -ENOENT;
+
+	frame_bytes = 0;
+	for (i = 0; i < dev->num_ch; i++) {
+		if (!(param->ch_mask & BIT(i)))
+			continue;
+		if (!dev->channels[i].scan_type)
+			return -EINVAL;
+		frame_bytes += dev->channels[i].scan_type->storagebits / 8;
+	}
+
+	mtu = param->mtu ? param->mtu : IIO_UDP_DEFAULT_MTU;
+	if (!frame_bytes || param->block_bytes % frame_bytes ||
+	    mtu < UDP_IP_HEADERS_SIZE + sizeof(struct iio_udp_header) +
+	    frame_bytes ||
+	    /* The payload length must fit in iio_udp_header.len */
+	    mtu > UINT16_MAX + UDP_IP_HEADERS_SIZE)
+		return -EINVAL;
+
+	stream = (struct iio_udp_stream *)calloc(1, sizeof(*stream));
+	if (!stream)
+		return -ENOMEM;
+
+	stream->payload_bytes = mtu - UDP_IP_HEADERS_SIZE -
+				sizeof(struct iio_udp_header);
+	stream->payload_bytes -= stream->payload_bytes % frame_bytes;
+	stream->packet = (uint8_t *)malloc(sizeof(struct iio_udp_header) +
+					   stream->payload_bytes);
+	if (!stream->packet) {
+		ret = -ENOMEM;
+		goto free_stream;
+	}
+
+	stream->iface = iface;
+	stream->net = desc->net;
+	stream->block_bytes = param->block_bytes;
+	stream->offset = param->block_bytes;
+	stream->get_time_us = param->get_time_us;
+
+	ret = iio_open_dev(iface->dev_id, frame_bytes, param->ch_mask);
+	if (IS_ERR_VALUE(ret))
+		goto free_packet;
+
+	ret = stream->net->socket_open(stream->net->net, &stream->sock_id,
+				       PROTOCOL_UDP, UDP_STREAM_RX_BUFF_SIZE);
+	if (IS_ERR_VALUE(ret))
+		goto close_dev;
+
+	/* Connected UDP socket, so every packet is sent with socket_send */
+	ret = stream->net->socket_connect(stream->net->net, stream->sock_id,
+					  &param->host);
+	if (IS_ERR_VALUE(ret))
+		goto close_sock;
+
+	desc->stream = stream;
+
+	return SUCCESS;
+
+close_sock:
+	stream->net->socket_close(stream->net->net, stream->sock_id);
+close_dev:
+	iio_close_dev(iface->dev_id);
+free_packet:
+	free(stream->packet);
+free_stream:
+	free(stream);
+
+	return ret;
+}
+
+/**
+ * @brief Stop the UDP stream and close the device buffer.
+ * @param desc - IIO descriptor.
+ * @return SUCCESS in case of success or negative value otherwise.
+ */
+ssize_t iio_udp_stream_stop(struct iio_desc *desc)
+{
+	struct iio_udp_stream *stream;
+
+	if (!desc || !desc->stream)
+		return -EINVAL;
+
+	stream = desc->stream;
+	desc->stream = NULL;
+
+	stream->net->socket_close(stream->net->net, stream->sock_id);
+	iio_close_dev(stream->iface->dev_id);
+	free(stream->packet);
+	free(stream);
+
+	return SUCCESS;
+}
+
+/**
+ * @brief Get the UDP stream counters.
+ * @param desc - IIO descriptor.
+ * @param stats - Where to copy the counters.
+ * @return SUCCESS in case of success or negative value otherwise.
+ */
+ssize_t iio_udp_stream_get_stats(struct iio_desc *desc,
+				 struct iio_udp_stream_stats *stats)
+{
+	if (!desc || !desc->stream || !stats)
+		return -EINVAL;
+
+	*stats = desc->stream->stats;
+
+	return SUCCESS;
+}
+
+#endif
+
 static int32_t iio_cmp_interfaces(struct iio_interface *a,
 				  struct iio_interface *b)
 {
@@ -1257,6 +1832,15 @@ ssize_t iio_init(struct iio_desc **desc, struct iio_init_param *init_param)
 				init_param->uart_init_param);
 		if (IS_ERR_VALUE(ret))
 			goto free_desc;
+#ifdef ENABLE_IIO_UART_RING
+		if (init_param->uart_ring_param) {
+			ret = _uart_ring_init(&ldesc->uart_ring,
+					      ldesc->uart_desc,
+					      init_param->uart_ring_param);
+			if (IS_ERR_VALUE(ret))
+				goto free_pylink;
+		}
+#endif
 	}
 #ifdef ENABLE_IIO_NETWORK
 	else if (init_param->phy_type == USE_NETWORK) {
@@ -1264,6 +1848,7 @@ ssize_t iio_init(struct iio_desc **desc, struct iio_init_param *init_param)
 				  init_param->tcp_socket_init_param);
 		if (IS_ERR_VALUE(ret))
 			goto free_desc;
+		ldesc->net = init_param->tcp_socket_init_param->net;
 		ret = socket_bind(ldesc->server, IIOD_PORT);
 		if (IS_ERR_VALUE(ret))
 			goto free_pylink;
@@ -1302,8 +1887,12 @@ ssize_t iio_init(struct iio_desc **desc, struct iio_init_param *init_param)
 free_list:
 	list_remove(ldesc->interfaces_list);
 free_pylink:
-	if (ldesc->phy_type == USE_UART)
+	if (ldesc->phy_type == USE_UART) {
+#ifdef ENABLE_IIO_UART_RING
+		_uart_ring_remove(ldesc->uart_ring);
+#endif
 		uart_remove(ldesc->uart_desc);
+	}
 #ifdef ENABLE_IIO_NETWORK
 	else {
 		socket_remove(ldesc->server);
@@ -1328,6 +1917,11 @@ ssize_t iio_remove(struct iio_desc *desc)
 {
 	struct iio_interface	*iio_interface;
 
+#ifdef ENABLE_IIO_NETWORK
+	if (desc->stream)
+		iio_udp_stream_stop(desc);
+#endif
+
 	while (SUCCESS == list_get_first(desc->interfaces_list,
 					 (void **)&iio_interface))
 		free(iio_interface);
@@ -1339,6 +1933,9 @@ ssize_t iio_remove(struct iio_desc *desc)
 	free(desc->xml_desc);
 
 	if (desc->phy_type == USE_UART) {
+#ifdef ENABLE_IIO_UART_RING
+		_uart_ring_remove(desc->uart_ring);
+#endif
 		uart_remove(desc->phy_desc);
 	}
 #ifdef ENABLE_IIO_NETWORK
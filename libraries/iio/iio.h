@@ -47,10 +47,39 @@
 
 #include "iio_types.h"
 #include "uart.h"
+#ifdef ENABLE_IIO_UART_RING
+#include "irq.h"
+#endif
 #ifdef ENABLE_IIO_NETWORK
 #include "tcp_socket.h"
 #endif
 
+/******************************************************************************/
+/********************** Macros and Constants Definitions **********************/
+/******************************************************************************/
+
+#ifdef ENABLE_IIO_NETWORK
+/*
+ * UDP stream packet layout, all fields little endian:
+ *
+ * header	magic, sequence number, block number, offset of the payload in
+ *		the block, packets dropped by the device so far, payload bytes,
+ *		flags, version, block timestamp
+ * payload	whole sample frames of the streamed channels
+ *
+ * The sequence number is incremented for every packet, including the ones
+ * that could not be sent, so the host can detect the loss.
+ */
+#define IIO_UDP_MAGIC		0x53554949	/* "IIUS" */
+#define IIO_UDP_VERSION		1
+/* First packet of a block */
+#define IIO_UDP_FLAG_START	0x01
+/* Last packet of a block */
+#define IIO_UDP_FLAG_END	0x02
+/* Default link MTU */
+#define IIO_UDP_DEFAULT_MTU	1500
+#endif
+
 /******************************************************************************/
 /*************************** Types Declarations *******************************/
 /******************************************************************************/
@@ -64,6 +93,40 @@ enum pysical_link_type {
 
 struct iio_desc;
 
+#ifdef ENABLE_IIO_UART_RING
+/**
+ * @struct iio_uart_ring_param
+ * @brief Ring buffers for the UART link.
+ *
+ * Data written by the server is queued in the transmit ring and sent with
+ * uart_write_nonblocking() from the UART interrupt, so a large buffer is sent
+ * while the next chunk is produced. Received data is stored in the receive
+ * ring from the interrupts and read from there by the server.
+ */
+struct iio_uart_ring_param {
+	/** Irq controller where the UART interrupt is registered */
+	struct irq_ctrl_desc	*irq_desc;
+	/** Id of the UART interrupt */
+	uint32_t		uart_irq_id;
+	/** Configuration param for registering the uart callback */
+	void			*uart_irq_conf;
+	/** Size of the receive ring */
+	uint32_t		rx_size;
+	/** Size of the transmit ring */
+	uint32_t		tx_size;
+	/**
+	 * Optional circular DMA receive buffer. When set, no UART reads are
+	 * armed. The platform must run a circular DMA receive into it and call
+	 * iio_uart_rx_ring_update() with the DMA write position from its
+	 * half/full transfer and idle-line interrupts. Otherwise data is
+	 * received one byte per interrupt.
+	 */
+	uint8_t			*dma_rx_ring;
+	/** Size of dma_rx_ring in bytes */
+	uint32_t		dma_rx_ring_size;
+};
+#endif
+
 struct iio_init_param {
 	enum pysical_link_type	phy_type;
 	union {
@@ -72,8 +135,65 @@ struct iio_init_param {
 		struct tcp_socket_init_param	*tcp_socket_init_param;
 #endif
 	};
+#ifdef ENABLE_IIO_UART_RING
+	/**
+	 * Used with USE_UART. NULL to use the blocking uart_read() and
+	 * uart_write().
+	 */
+	struct iio_uart_ring_param		*uart_ring_param;
+#endif
+};
+
+#ifdef ENABLE_IIO_NETWORK
+struct iio_udp_header {
+	uint32_t	magic;
+	uint32_t	seq;
+	uint32_t	block;
+	uint32_t	offset;
+	uint32_t	dropped;
+	uint16_t	len;
+	uint8_t		flags;
+	uint8_t		version;
+	uint64_t	timestamp_us;
+} __attribute__((packed));
+
+/**
+ * @struct iio_udp_stream_param
+ * @brief Configuration of the UDP buffer stream.
+ */
+struct iio_udp_stream_param {
+	/** Name of the registered device to stream */
+	const char		*name;
+	/** Host receiving the stream */
+	struct socket_address	host;
+	/** Mask of the streamed channels */
+	uint32_t		ch_mask;
+	/** Bytes acquired from the device for every block */
+	uint32_t		block_bytes;
+	/** Link MTU, 0 for IIO_UDP_DEFAULT_MTU. At most 65535 + 28 bytes */
+	uint32_t		mtu;
+	/** Time base of the block timestamps, may be NULL */
+	uint64_t		(*get_time_us)(void);
 };
 
+/**
+ * @struct iio_udp_stream_stats
+ * @brief UDP buffer stream counters.
+ */
+struct iio_udp_stream_stats {
+	/** Blocks acquired from the device */
+	uint32_t	blocks;
+	/** Packets sent */
+	uint32_t	packets;
+	/** Payload bytes sent */
+	uint64_t	bytes;
+	/** Packets dropped because the send failed */
+	uint32_t	dropped;
+	/** Failed block acquisitions */
+	uint32_t	errors;
+};
+#endif
+
 /******************************************************************************/
 /************************ Functions Declarations ******************************/
 /******************************************************************************/
@@ -92,5 +212,19 @@ ssize_t iio_register(struct iio_desc *desc, struct iio_device *dev_descriptor,
 		     struct iio_data_buffer *write_buff);
 /* Unregister interface. */
 ssize_t iio_unregister(struct iio_desc *desc, char *name);
+#ifdef ENABLE_IIO_UART_RING
+/* Consume the circular DMA receive buffer up to the DMA write position. */
+ssize_t iio_uart_rx_ring_update(struct iio_desc *desc, uint32_t head);
+#endif
+#ifdef ENABLE_IIO_NETWORK
+/* Stream the buffer of a device to a host over UDP. */
+ssize_t iio_udp_stream_start(struct iio_desc *desc,
+			     struct iio_udp_stream_param *param);
+/* Stop the UDP stream. */
+ssize_t iio_udp_stream_stop(struct iio_desc *desc);
+/* Get the UDP stream counters. */
+ssize_t iio_udp_stream_get_stats(struct iio_desc *desc,
+				 struct iio_udp_stream_stats *stats);
+#endif
 
 #endif /* IIO_H_ */
@@ -46,14 +46,79 @@
 #include "mqtt_client.h"
 #include "MQTTClient.h"
 #include "error.h"
+#include "util.h"
+
+/******************************************************************************/
+/********************** Macros and Constants Definitions **********************/
+/******************************************************************************/
+
+/* Fixed header, remaining length, topic length and packet id */
+#define MQTT_BATCH_HEADER_LEN	(1 + 4 + 2 + 2)
 
 /******************************************************************************/
 /*************************** Types Declarations *******************************/
 /******************************************************************************/
 
+/* Batch of readings, stored contiguously (modulo ring size) in the ring */
+struct mqtt_batch_slot {
+	/* Offset of the first byte in the ring */
+	uint32_t	start;
+	/* Payload length */
+	uint32_t	len;
+	/* Time when the first reading was queued */
+	uint32_t	first_ms;
+	/* Time of the last transmission */
+	uint32_t	sent_ms;
+	/* Packet id used for QOS1 */
+	uint16_t	packet_id;
+	/* Batch state */
+	enum {
+		/* Readings can still be added */
+		BATCH_OPEN,
+		/* Waiting to be published */
+		BATCH_READY,
+		/* Waiting for PUBACK */
+		BATCH_IN_FLIGHT,
+		/* Done, the ring space can be reused */
+		BATCH_DONE
+	}		state;
+};
+
+/* Batched publish queue */
+struct mqtt_batch {
+	/* Initialization parameter */
+	struct mqtt_batch_init_param	param;
+	/* Length of param.topic */
+	uint32_t			topic_len;
+	/* Readings storage */
+	uint8_t				*ring;
+	/* Offset where next reading is written */
+	uint32_t			head;
+	/* Bytes used in ring by the queued batches */
+	uint32_t			used;
+	/* Batches. The oldest is slots[first] */
+	struct mqtt_batch_slot		*slots;
+	/* Index of the oldest batch */
+	uint32_t			first;
+	/* Number of queued batches */
+	uint32_t			nb_used;
+	/* Number of batches waiting for PUBACK */
+	uint32_t			in_flight;
+	/* Buffer where the publish packet is built */
+	uint8_t				*packet;
+	/* Counters */
+	struct mqtt_batch_stats		stats;
+	/* Sum of the latencies, for the average */
+	uint32_t			latency_sum;
+	/* Time when the counters were cleared */
+	uint32_t			stats_start_ms;
+};
+
 struct mqtt_desc {
 	MQTTClient		mqtt_client[1];
 	Network			network;
+	/* Batched publish queue. NULL if not initialized */
+	struct mqtt_batch	*batch;
 };
 
 /******************************************************************************/
@@ -148,6 +213,7 @@ int32_t mqtt_remove(struct mqtt_desc *desc)
 	if (!desc)
 		return FAILURE;
 
+	mqtt_batch_remove(desc);
 	free(desc);
 	mqtt_timer_remove();
 
@@ -181,6 +247,9 @@ int32_t mqtt_connect(struct mqtt_desc *desc,
 	data.password.cstring = (char *)conf->password;
 	data.keepAliveInterval = (unsigned short)conf->keep_alive_ms;
 
+	/* A read torn by the previous connection must not offset the framing */
+	memset(&desc->network.rx, 0, sizeof(desc->network.rx));
+
 	ret = MQTTConnectWithResults(desc->mqtt_client, &data, &res);
 	if (result_optional) {
 		result_optional->rc = res.rc;
@@ -293,3 +362,393 @@ int32_t mqtt_yield(struct mqtt_desc *desc, uint32_t timeout_ms)
 {
 	return MQTTYield(desc->mqtt_client, timeout_ms);
 }
+
+/* Get the slot with index idx counted from the oldest */
+static inline struct mqtt_batch_slot *mqtt_batch_slot(struct mqtt_batch *b,
+		uint32_t idx)
+{
+	return &b->slots[(b->first + idx) % b->param.nb_batches];
+}
+
+/* Update the latency counters of a batch that is done */
+static void mqtt_batch_done(struct mqtt_batch *b, struct mqtt_batch_slot *slot)
+{
+	uint32_t latency;
+
+	latency = mqtt_timer_get_ms() - slot->first_ms;
+	b->latency_sum += latency;
+	b->stats.latency_max_ms = max(b->stats.latency_max_ms, latency);
+	b->stats.acked += slot->state == BATCH_IN_FLIGHT;
+	slot->state = BATCH_DONE;
+}
+
+/* Free the ring space of the oldest batches that are done */
+static void mqtt_batch_release(struct mqtt_batch *b)
+{
+	struct mqtt_batch_slot *slot;
+
+	while (b->nb_used) {
+		slot = mqtt_batch_slot(b, 0);
+		if (slot->state != BATCH_DONE)
+			break;
+		b->used -= slot->len;
+		b->first = (b->first + 1) % b->param.nb_batches;
+		b->nb_used--;
+	}
+}
+
+/* Called from mqtt_noos_read when a PUBACK is received */
+static void mqtt_batch_puback(void *ctx, uint16_t packet_id)
+{
+	struct mqtt_batch	*b = ((struct mqtt_desc *)ctx)->batch;
+	struct mqtt_batch_slot	*slot;
+	uint32_t		i;
+
+	if (!b)
+		return ;
+
+	/* PUBACKs for other packets, sent by MQTTPublish, are ignored */
+	for (i = 0; i < b->nb_used; i++) {
+		slot = mqtt_batch_slot(b, i);
+		if (slot->state == BATCH_IN_FLIGHT &&
+		    slot->packet_id == packet_id) {
+			mqtt_batch_done(b, slot);
+			b->in_flight--;
+			break;
+		}
+	}
+	mqtt_batch_release(b);
+}
+
+/* Get a new packet id in the same way as MQTTClient does */
+static uint16_t mqtt_batch_packet_id(struct mqtt_desc *desc)
+{
+	MQTTClient *c = desc->mqtt_client;
+
+	c->next_packetid = (c->next_packetid == MAX_PACKET_ID) ?
+			   1 : c->next_packetid + 1;
+
+	return (uint16_t)c->next_packetid;
+}
+
+/* Serialize and send a batch */
+static int32_t mqtt_batch_send(struct mqtt_desc *desc,
+			       struct mqtt_batch_slot *slot, bool dup)
+{
+	struct mqtt_batch	*b = desc->batch;
+	uint8_t			*p = b->packet;
+	uint32_t		rem_len;
+	uint32_t		len;
+	uint32_t		part;
+	int32_t			ret;
+
+	rem_len = 2 + b->topic_len + slot->len;
+	if (b->param.qos == MQTT_QOS1)
+		rem_len += 2;
+
+	*p++ = (PUBLISH << 4) | (dup << 3) | (b->param.qos << 1) |
+	       b->param.retained;
+	p += MQTTPacket_encode(p, rem_len);
+	*p++ = b->topic_len >> 8;
+	*p++ = b->topic_len & 0xff;
+	memcpy(p, b->param.topic, b->topic_len);
+	p += b->topic_len;
+	if (b->param.qos == MQTT_QOS1) {
+		*p++ = slot->packet_id >> 8;
+		*p++ = slot->packet_id & 0xff;
+	}
+
+	/* Payload, that may wrap around the end of the ring */
+	part = min(slot->len, b->param.ring_size - slot->start);
+	memcpy(p, b->ring + slot->start, part);
+	memcpy(p + part, b->ring, slot->len - part);
+	p += slot->len;
+
+	len = p - b->packet;
+	ret = desc->network.mqttwrite(&desc->network, b->packet, len,
+				      desc->mqtt_client->command_timeout_ms);
+	if (ret != (int32_t)len)
+		return IS_ERR_VALUE(ret) ? ret : FAILURE;
+
+	slot->sent_ms = mqtt_timer_get_ms();
+
+	return SUCCESS;
+}
+
+/**
+ * @brief Initialize the batched publish queue.
+ * Memory is allocated only here, readings are copied to a ring buffer.
+ * \ref mqtt_batch_process must be called periodically after this.
+ * @param desc - Reference to MQTT client
+ * @param param - Queue configuration
+ * @return
+ *  - \ref SUCCESS : On success
+ *  - -EINVAL : Wrong parameters
+ *  - -ENOMEM : Memory allocation failed
+ */
+int32_t mqtt_batch_init(struct mqtt_desc *desc,
+			const struct mqtt_batch_init_param *param)
+{
+	struct mqtt_batch	*b;
+
+	if (!desc || !param || desc->batch || !param->topic ||
+	    param->qos > MQTT_QOS1 || !param->ring_size || !param->nb_batches ||
+	    !param->max_batch_len || param->max_batch_len > param->ring_size)
+		return -EINVAL;
+
+	b = (struct mqtt_batch *)calloc(1, sizeof(*b));
+	if (!b)
+		return -ENOMEM;
+
+	b->param = *param;
+	if (!b->param.window)
+		b->param.window = 1;
+	b->topic_len = strlen((const char *)param->topic);
+	b->ring = (uint8_t *)malloc(param->ring_size);
+	b->slots = (struct mqtt_batch_slot *)calloc(param->nb_batches,
+			sizeof(*b->slots));
+	b->packet = (uint8_t *)malloc(MQTT_BATCH_HEADER_LEN + b->topic_len +
+				      param->max_batch_len);
+	if (!b->ring || !b->slots || !b->packet) {
+		free(b->ring);
+		free(b->slots);
+		free(b->packet);
+		free(b);
+		return -ENOMEM;
+	}
+	b->stats_start_ms = mqtt_timer_get_ms();
+
+	desc->batch = b;
+	desc->network.puback_ctx = desc;
+	desc->network.puback = mqtt_batch_puback;
+
+	return SUCCESS;
+}
+
+/**
+ * @brief Free the batched publish queue. Queued readings are lost.
+ * @param desc - Reference to MQTT client
+ * @return
+ *  - \ref SUCCESS : On success
+ *  - \ref FAILURE : Otherwise
+ */
+int32_t mqtt_batch_remove(struct mqtt_desc *desc)
+{
+	if (!desc)
+		return FAILURE;
+
+	if (!desc->batch)
+		return SUCCESS;
+
+	desc->network.puback = NULL;
+	free(desc->batch->ring);
+	free(desc->batch->slots);
+	free(desc->batch->packet);
+	free(desc->batch);
+	desc->batch = NULL;
+
+	return SUCCESS;
+}
+
+/**
+ * @brief Queue a reading to be published.
+ * The reading is appended to the open batch, or to a new one if it doesn't
+ * fit. Readings of a batch are concatenated, the application must choose a
+ * format where they can be separated (fixed size records, lines...).
+ * @param desc - Reference to MQTT client
+ * @param data - Reading
+ * @param len - Length of the reading. At most max_batch_len
+ * @return
+ *  - \ref SUCCESS : On success
+ *  - -EINVAL : Wrong parameters
+ *  - -ENOSPC : The queue is full and the reading was dropped
+ */
+int32_t mqtt_batch_push(struct mqtt_desc *desc, const void *data,
+			uint32_t len)
+{
+	struct mqtt_batch	*b;
+	struct mqtt_batch_slot	*slot;
+	uint32_t		part;
+
+	if (!desc || !desc->batch || !data || !len)
+		return -EINVAL;
+
+	b = desc->batch;
+	if (len > b->param.max_batch_len)
+		return -EINVAL;
+
+	slot = b->nb_used ? mqtt_batch_slot(b, b->nb_used - 1) : NULL;
+	if (slot && slot->state == BATCH_OPEN &&
+	    slot->len + len > b->param.max_batch_len)
+		slot->state = BATCH_READY;
+
+	if (b->used + len > b->param.ring_size ||
+	    ((!slot || slot->state != BATCH_OPEN) &&
+	     b->nb_used == b->param.nb_batches)) {
+		b->stats.dropped++;
+		return -ENOSPC;
+	}
+
+	if (!slot || slot->state != BATCH_OPEN) {
+		slot = mqtt_batch_slot(b, b->nb_used++);
+		slot->start = b->head;
+		slot->len = 0;
+		slot->first_ms = mqtt_timer_get_ms();
+		slot->state = BATCH_OPEN;
+	}
+
+	part = min(len, b->param.ring_size - b->head);
+	memcpy(b->ring + b->head, data, part);
+	memcpy(b->ring, (const uint8_t *)data + part, len - part);
+	b->head = (b->head + len) % b->param.ring_size;
+	b->used += len;
+	slot->len += len;
+	b->stats.readings++;
+
+	if (slot->len == b->param.max_batch_len)
+		slot->state = BATCH_READY;
+
+	return SUCCESS;
+}
+
+/**
+ * @brief Publish due batches and handle acknowledgements.
+ * Reads the packets sent by the broker, publishes the batches that are full
+ * or older than max_batch_delay_ms while less than window batches wait for
+ * PUBACK and resends the batches not acknowledged in retry_ms.
+ * It also keeps the connection alive, like \ref mqtt_yield.
+ * @param desc - Reference to MQTT client
+ * @return
+ *  - \ref SUCCESS : On success
+ *  - \ref FAILURE or a negative error code : Otherwise
+ */
+int32_t mqtt_batch_process(struct mqtt_desc *desc)
+{
+	struct mqtt_batch	*b;
+	struct mqtt_batch_slot	*slot;
+	uint32_t		now;
+	uint32_t		i;
+	int32_t			ret;
+
+	if (!desc || !desc->batch)
+		return -EINVAL;
+
+	b = desc->batch;
+	/* Read PUBACKs and other incoming packets */
+	ret = MQTTYield(desc->mqtt_client, 1);
+	if (IS_ERR_VALUE(ret))
+		return ret;
+
+	now = mqtt_timer_get_ms();
+	for (i = 0; i < b->nb_used; i++) {
+		slot = mqtt_batch_slot(b, i);
+		switch (slot->state) {
+		case BATCH_OPEN:
+			if (now - slot->first_ms < b->param.max_batch_delay_ms)
+				break;
+			slot->state = BATCH_READY;
+		/* fall through */
+		case BATCH_READY:
+			if (b->param.qos == MQTT_QOS1) {
+				if (b->in_flight >= b->param.window)
+					break;
+				slot->packet_id = mqtt_batch_packet_id(desc);
+			}
+			ret = mqtt_batch_send(desc, slot, false);
+			if (IS_ERR_VALUE(ret))
+				return ret;
+			b->stats.batches++;
+			b->stats.bytes += slot->len;
+			if (b->param.qos == MQTT_QOS1) {
+				slot->state = BATCH_IN_FLIGHT;
+				b->in_flight++;
+			} else {
+				mqtt_batch_done(b, slot);
+			}
+			break;
+		case BATCH_IN_FLIGHT:
+			if (now - slot->sent_ms < b->param.retry_ms)
+				break;
+			ret = mqtt_batch_send(desc, slot, true);
+			if (IS_ERR_VALUE(ret))
+				return ret;
+			b->stats.retries++;
+			break;
+		default:
+			break;
+		}
+	}
+	mqtt_batch_release(b);
+
+	return SUCCESS;
+}
+
+/**
+ * @brief Publish all queued readings and wait for them to be acknowledged.
+ * @param desc - Reference to MQTT client
+ * @param timeout_ms - Maximum time to wait
+ * @return
+ *  - \ref SUCCESS : On success
+ *  - -ETIMEDOUT : Not all the batches were acknowledged in time
+ *  - A negative error code from \ref mqtt_batch_process
+ */
+int32_t mqtt_batch_flush(struct mqtt_desc *desc, uint32_t timeout_ms)
+{
+	struct mqtt_batch	*b;
+	uint32_t		start;
+	int32_t			ret;
+
+	if (!desc || !desc->batch)
+		return -EINVAL;
+
+	b = desc->batch;
+	if (b->nb_used && mqtt_batch_slot(b, b->nb_used - 1)->state ==
+	    BATCH_OPEN)
+		mqtt_batch_slot(b, b->nb_used - 1)->state = BATCH_READY;
+
+	start = mqtt_timer_get_ms();
+	while (b->nb_used) {
+		if (mqtt_timer_get_ms() - start >= timeout_ms)
+			return -ETIMEDOUT;
+		ret = mqtt_batch_process(desc);
+		if (IS_ERR_VALUE(ret))
+			return ret;
+	}
+
+	return SUCCESS;
+}
+
+/**
+ * @brief Get the counters of the batched publish queue
+ * @param desc - Reference to MQTT client
+ * @param stats - Where to store the counters
+ * @param clear - If set, the counters are cleared after being read
+ * @return
+ *  - \ref SUCCESS : On success
+ *  - -EINVAL : Wrong parameters
+ */
+int32_t mqtt_batch_get_stats(struct mqtt_desc *desc,
+			     struct mqtt_batch_stats *stats, bool clear)
+{
+	struct mqtt_batch	*b;
+	uint32_t		nb_done;
+
+	if (!desc || !desc->batch || !stats)
+		return -EINVAL;
+
+	b = desc->batch;
+	b->stats.in_flight = b->in_flight;
+	nb_done = b->param.qos == MQTT_QOS1 ? b->stats.acked :
+		  b->stats.batches;
+	b->stats.latency_avg_ms = nb_done ? b->latency_sum / nb_done : 0;
+	b->stats.elapsed_ms = mqtt_timer_get_ms() - b->stats_start_ms;
+	*stats = b->stats;
+
+	if (clear) {
+		memset(&b->stats, 0, sizeof(b->stats));
+		b->latency_sum = 0;
+		b->stats_start_ms = mqtt_timer_get_ms();
+	}
+
+	return SUCCESS;
+}
@@ -234,6 +234,63 @@ struct mqtt_init_param {
 	void			(*message_handler)(struct mqtt_message_data *);
 };
 
+/**
+ * @struct mqtt_batch_init_param
+ * @brief Parameter used to initialize the batched publish queue.
+ * Readings pushed with \ref mqtt_batch_push are copied to a ring buffer and
+ * coalesced in batches which are published as a single message.
+ */
+struct mqtt_batch_init_param {
+	/** Topic where the batches are published. Must be kept valid */
+	const int8_t		*topic;
+	/** MQTT_QOS0 or MQTT_QOS1 */
+	enum mqtt_qos		qos;
+	/** If set, batches are published as retained messages */
+	bool			retained;
+	/** Size of the ring buffer where readings are stored until sent */
+	uint32_t		ring_size;
+	/** Maximum number of batches waiting to be sent or acknowledged */
+	uint32_t		nb_batches;
+	/** Maximum number of QOS1 batches waiting for PUBACK at once */
+	uint32_t		window;
+	/** Maximum payload of a batch. A reading is never split */
+	uint32_t		max_batch_len;
+	/** Publish a batch that is not full after this time, in ms */
+	uint32_t		max_batch_delay_ms;
+	/** Resend a QOS1 batch not acknowledged after this time, in ms */
+	uint32_t		retry_ms;
+};
+
+/**
+ * @struct mqtt_batch_stats
+ * @brief Counters of the batched publish queue
+ */
+struct mqtt_batch_stats {
+	/** Readings queued */
+	uint32_t	readings;
+	/** Readings dropped because the queue was full */
+	uint32_t	dropped;
+	/** Batches published, not counting retries */
+	uint32_t	batches;
+	/** Payload bytes published, not counting retries */
+	uint32_t	bytes;
+	/** Batches acknowledged by the broker */
+	uint32_t	acked;
+	/** Batches published again because of a missing PUBACK */
+	uint32_t	retries;
+	/** Batches currently waiting for PUBACK */
+	uint32_t	in_flight;
+	/**
+	 * Average time from the first reading of a batch until it is
+	 * acknowledged (QOS1) or sent (QOS0), in ms
+	 */
+	uint32_t	latency_avg_ms;
+	/** Maximum of the same latency, in ms */
+	uint32_t	latency_max_ms;
+	/** Time since the counters were cleared, to compute rates, in ms */
+	uint32_t	elapsed_ms;
+};
+
 /**
  * @struct mqtt_desc
  * @brief Reference to MQTT client
@@ -268,4 +325,20 @@ int32_t mqtt_unsubscribe(struct mqtt_desc *desc, const int8_t* topic);
 /* Allow messages to be received */
 int32_t mqtt_yield(struct mqtt_desc *desc, uint32_t timeout_ms);
 
+/* Init the batched publish queue */
+int32_t mqtt_batch_init(struct mqtt_desc *desc,
+			const struct mqtt_batch_init_param *param);
+/* Free the batched publish queue */
+int32_t mqtt_batch_remove(struct mqtt_desc *desc);
+/* Queue a reading to be published */
+int32_t mqtt_batch_push(struct mqtt_desc *desc, const void *data,
+			uint32_t len);
+/* Publish due batches and handle acknowledgements */
+int32_t mqtt_batch_process(struct mqtt_desc *desc);
+/* Publish all queued readings and wait for them to be acknowledged */
+int32_t mqtt_batch_flush(struct mqtt_desc *desc, uint32_t timeout_ms);
+/* Get the counters of the batched publish queue */
+int32_t mqtt_batch_get_stats(struct mqtt_desc *desc,
+			     struct mqtt_batch_stats *stats, bool clear);
+
 #endif
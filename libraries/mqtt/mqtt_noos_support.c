@@ -103,6 +103,16 @@ void mqtt_timer_remove()
 	}
 }
 
+/* Get the time in milliseconds from the timer used by the porting file */
+uint32_t mqtt_timer_get_ms(void)
+{
+	uint32_t ms = 0;
+
+	timer_counter_get(timer, &ms);
+
+	return ms;
+}
+
 /* Implementation of TimerInit used by MQTTClient.c */
 void TimerInit(Timer* t)
 {
@@ -147,6 +157,40 @@ char TimerIsExpired(Timer* t)
 	return false;
 }
 
+/* Follow the packets read by MQTTClient and report PUBACKs */
+static void mqtt_noos_rx_parse(Network *net, const uint8_t *buff, int len)
+{
+	struct mqtt_noos_rx	*rx = &net->rx;
+	uint8_t			ch;
+
+	while (len--) {
+		ch = *buff++;
+		if (!rx->in_len && !rx->left) {
+			/* Fixed header */
+			rx->header = ch;
+			rx->in_len = true;
+			rx->multiplier = 1;
+			continue;
+		}
+		if (rx->in_len) {
+			/* Remaining length */
+			rx->left += (ch & 0x7f) * rx->multiplier;
+			rx->multiplier *= 128;
+			if (!(ch & 0x80))
+				rx->in_len = false;
+			continue;
+		}
+
+		rx->left--;
+		/* PUBACK: 0x40, remaining length 2, packet id */
+		if (rx->header != 0x40)
+			continue;
+		rx->packet_id = (rx->packet_id << 8) | ch;
+		if (!rx->left && net->puback)
+			net->puback(net->puback_ctx, rx->packet_id);
+	}
+}
+
 /* Implementation of mqtt_noos_read used by MQTTClient.c */
 int mqtt_noos_read(Network* net, unsigned char* buff, int len, int timeout)
 {
@@ -158,22 +202,25 @@ int mqtt_noos_read(Network* net, unsigned char* buff, int len, int timeout)
 
 	sent = 0;
 	do {
- 		rc = socket_recv(net->sock, (void *)(buff + sent),
-				(uint32_t)(len - sent));
- 		if (rc != -EAGAIN) { //If data available or error
- 			if (IS_ERR_VALUE(rc))
- 				return rc;
-				 
- 			sent += rc;
- 			if (sent >= len)
- 				return sent;
- 		}
-
+		rc = socket_recv(net->sock, (void *)(buff + sent),
+				 (uint32_t)(len - sent));
+		if (rc != -EAGAIN) { //If data available or error
+			if (IS_ERR_VALUE(rc))
+				return rc;
+
+			mqtt_noos_rx_parse(net, buff + sent, rc);
+			sent += rc;
+			if (sent >= len)
+				return sent;
+		}
+
+		if (timeout <= 0)
+			break;
 		mdelay(1);
 	} while (--timeout);
 
-	/* 0 bytes have been read */
-	return 0;
+	/* Bytes read before the timeout */
+	return sent;
 }
 
 /* Implementation of mqtt_noos_write used by MQTTClient.c */
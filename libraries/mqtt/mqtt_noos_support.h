@@ -45,6 +45,7 @@
 /******************************************************************************/
 
 #include <stdint.h>
+#include <stdbool.h>
 #include "tcp_socket.h"
 
 /******************************************************************************/
@@ -68,6 +69,24 @@ struct timer_port_noos {
 	uint32_t	ms;
 };
 
+/**
+ * @struct mqtt_noos_rx
+ * @brief State of the parser following the packets read by MQTTClient.
+ * MQTTClient ignores PUBACK packets, so they are picked up while reading.
+ */
+struct mqtt_noos_rx {
+	/** Fixed header of the current packet */
+	uint8_t		header;
+	/** Set while the remaining length is decoded */
+	bool		in_len;
+	/** Multiplier of the next remaining length byte */
+	uint32_t	multiplier;
+	/** Bytes left of the current packet */
+	uint32_t	left;
+	/** Packet identifier of a PUBACK */
+	uint16_t	packet_id;
+};
+
 /**
  * @struct network_port_noos
  * @brief Network structure used by MQTTClient.
@@ -80,6 +99,12 @@ struct network_port_noos {
 	/** Reference to no-os network wrapper write function */
 	int			(*mqttwrite)(Network*, unsigned char*, int,
 					     int);
+	/** Called when a PUBACK is read. Can be NULL */
+	void			(*puback)(void *ctx, uint16_t packet_id);
+	/** Context passed to puback */
+	void			*puback_ctx;
+	/** Incoming packets parser state */
+	struct mqtt_noos_rx	rx;
 };
 
 /******************************************************************************/
@@ -90,6 +115,8 @@ struct network_port_noos {
 int32_t mqtt_timer_init(uint32_t timer_id, void *extra_init_param);
 /* Uninit porting file */
 void mqtt_timer_remove();
+/* Get the time in milliseconds from the timer used by the porting file */
+uint32_t mqtt_timer_get_ms(void);
 
 /* Function to be linked to Network.mqttread */
 int mqtt_noos_read(Network*, unsigned char*, int, int);
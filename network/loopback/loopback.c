@@ -0,0 +1,811 @@
+/***************************************************************************//**
+ *   @file   loopback.c
+ *   @brief  In-memory loopback network with latency and loss injection.
+********************************************************************************
+ * Copyright 2021(c) Analog Devices, Inc.
+ *
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *  - Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ *  - Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ *  - Neither the name of Analog Devices, Inc. nor the names of its
+ *    contributors may be used to endorse or promote products derived
+ *    from this software without specific prior written permission.
+ *  - The use of this software may or may not infringe the patent rights
+ *    of one or more patent holders.  This license does not release you
+ *    from the requirement that you obtain separate licenses from these
+ *    patent holders to use this software.
+ *  - Use of the software either in source or binary form, must be run
+ *    on or directly connected to an Analog Devices Inc. component.
+ *
+ * THIS SOFTWARE IS PROVIDED BY ANALOG DEVICES "AS IS" AND ANY EXPRESS OR
+ * IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, NON-INFRINGEMENT,
+ * MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED.
+ * IN NO EVENT SHALL ANALOG DEVICES BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, INTELLECTUAL PROPERTY RIGHTS, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*******************************************************************************/
+
+/******************************************************************************/
+/***************************** Include Files **********************************/
+/******************************************************************************/
+
+#include <stdlib.h>
+#include <string.h>
+#include <stdbool.h>
+#include "loopback.h"
+#include "list.h"
+#include "error.h"
+#include "util.h"
+
+/******************************************************************************/
+/********************** Macros and Constants Definitions **********************/
+/******************************************************************************/
+
+/* IP and TCP headers, counted by the link rate */
+#define TCP_HEADERS_SIZE	40
+/* IP and UDP headers */
+#define UDP_HEADERS_SIZE	28
+/* First port given to sockets that send before a bind */
+#define EPHEMERAL_PORT		49152
+
+/******************************************************************************/
+/*************************** Types Declarations *******************************/
+/******************************************************************************/
+
+enum loopback_sock_state {
+	SOCK_UNUSED,
+	SOCK_OPEN,
+	SOCK_LISTENING,
+	SOCK_WAITING_ACCEPT,
+	SOCK_CONNECTED,
+	/* The remote closed the connection */
+	SOCK_PEER_CLOSED
+};
+
+/* Data in flight to a socket */
+struct loopback_segment {
+	/* Time from which the data can be received */
+	uint64_t	deliver_us;
+	/* Port of the sender, for socket_recvfrom */
+	uint16_t	from_port;
+	uint32_t	len;
+	/* Bytes already received */
+	uint32_t	off;
+	uint8_t		data[];
+};
+
+struct loopback_end;
+
+struct loopback_sock {
+	enum loopback_sock_state	state;
+	enum socket_protocol		proto;
+	struct loopback_end		*end;
+	/* Local port, 0 if not bound yet */
+	uint16_t			port;
+	/* Remote port of a connected UDP socket */
+	uint16_t			remote_port;
+	/* Other end of a TCP connection */
+	struct loopback_sock		*peer;
+	/* Listening socket of a connection waiting for accept */
+	struct loopback_sock		*listener;
+	uint32_t			back_log;
+	/* Received segments ordered by delivery time */
+	struct list_desc		*rx;
+	/* Delivery time of the last TCP segment, to keep the order */
+	uint64_t			last_deliver_us;
+};
+
+struct loopback_end {
+	struct network_interface	interface;
+	struct loopback_desc		*link;
+	/* Time at which the sending direction of this end is free */
+	uint64_t			tx_free_us;
+	struct loopback_sock		sockets[LOOPBACK_MAX_SOCKETS];
+};
+
+struct loopback_desc {
+	struct loopback_end		end[2];
+	struct loopback_init_param	param;
+	uint32_t			rand;
+	uint16_t			next_port;
+	struct loopback_stats		stats;
+};
+
+/******************************************************************************/
+/************************ Functions Definitions *******************************/
+/******************************************************************************/
+
+static inline uint64_t _now(struct loopback_desc *link)
+{
+	return link->param.get_time_us ? link->param.get_time_us() : 0;
+}
+
+/* xorshift32, enough to spread the loss and the jitter */
+static uint32_t _rand(struct loopback_desc *link)
+{
+	link->rand ^= link->rand << 13;
+	link->rand ^= link->rand >> 17;
+	link->rand ^= link->rand << 5;
+
+	return link->rand;
+}
+
+static int32_t _cmp_segments(struct loopback_segment *a,
+			     struct loopback_segment *b)
+{
+	if (a->deliver_us == b->deliver_us)
+		return 0;
+
+	return a->deliver_us > b->deliver_us ? 1 : -1;
+}
+
+static struct loopback_sock *_get_sock(struct loopback_end *end,
+				       uint32_t sock_id)
+{
+	if (!end || sock_id >= LOOPBACK_MAX_SOCKETS ||
+	    end->sockets[sock_id].state == SOCK_UNUSED)
+		return NULL;
+
+	return &end->sockets[sock_id];
+}
+
+/* Find the socket bound to a port on any end of the link */
+static struct loopback_sock *_find_port(struct loopback_desc *link,
+					enum socket_protocol proto,
+					uint16_t port)
+{
+	struct loopback_sock	*sock;
+	uint32_t		i;
+	uint32_t		j;
+
+	for (i = 0; i < 2; i++)
+		for (j = 0; j < LOOPBACK_MAX_SOCKETS; j++) {
+			sock = &link->end[i].sockets[j];
+			if (sock->state == SOCK_UNUSED || sock->port != port ||
+			    sock->proto != proto)
+				continue;
+			if (proto == PROTOCOL_UDP ||
+			    sock->state == SOCK_LISTENING)
+				return sock;
+		}
+
+	return NULL;
+}
+
+static uint16_t _ephemeral_port(struct loopback_desc *link,
+				enum socket_protocol proto)
+{
+	uint16_t port;
+
+	do {
+		port = link->next_port++;
+		if (link->next_port == 0)
+			link->next_port = EPHEMERAL_PORT;
+	} while (_find_port(link, proto, port));
+
+	return port;
+}
+
+static int32_t _alloc_sock(struct loopback_end *end, enum socket_protocol proto,
+			   uint32_t *sock_id)
+{
+	struct loopback_sock	*sock;
+	uint32_t		i;
+	int32_t			ret;
+
+	for (i = 0; i < LOOPBACK_MAX_SOCKETS; i++)
+		if (end->sockets[i].state == SOCK_UNUSED)
+			break;
+	if (i == LOOPBACK_MAX_SOCKETS)
+		return -ENOMEM;
+
+	sock = &end->sockets[i];
+	memset(sock, 0, sizeof(*sock));
+	/* TCP data is always in order, UDP datagrams may be reordered */
+	if (proto == PROTOCOL_TCP)
+		ret = list_init(&sock->rx, LIST_QUEUE, NULL);
+	else
+		ret = list_init(&sock->rx, LIST_PRIORITY_LIST,
+				(f_cmp)_cmp_segments);
+	if (IS_ERR_VALUE(ret))
+		return ret;
+
+	sock->state = SOCK_OPEN;
+	sock->proto = proto;
+	sock->end = end;
+	*sock_id = i;
+
+	return SUCCESS;
+}
+
+static void _flush_rx(struct loopback_sock *sock)
+{
+	struct loopback_segment *seg;
+
+	while (SUCCESS == list_get_first(sock->rx, (void **)&seg))
+		free(seg);
+}
+
+/* Detach a TCP socket from its peer, the peer sees the connection closed */
+static void _detach(struct loopback_sock *sock)
+{
+	if (sock->peer) {
+		sock->peer->peer = NULL;
+		if (sock->peer->state == SOCK_CONNECTED ||
+		    sock->peer->state == SOCK_WAITING_ACCEPT)
+			sock->peer->state = SOCK_PEER_CLOSED;
+		sock->peer = NULL;
+	}
+}
+
+static void _release_sock(struct loopback_sock *sock)
+{
+	_detach(sock);
+	_flush_rx(sock);
+	list_remove(sock->rx);
+	memset(sock, 0, sizeof(*sock));
+}
+
+/* Put a segment on the link, in the direction from end to dst */
+static int32_t _transmit(struct loopback_end *end, struct loopback_sock *dst,
+			 const void *data, uint32_t len, uint16_t from_port)
+{
+	struct loopback_desc	*link = end->link;
+	struct loopback_segment	*seg;
+	uint64_t		now;
+	uint64_t		deliver;
+	uint32_t		hdr;
+	bool			lost;
+	int32_t			ret;
+
+	now = _now(link);
+	hdr = dst->proto == PROTOCOL_TCP ? TCP_HEADERS_SIZE : UDP_HEADERS_SIZE;
+
+	/* Serialization on the sending direction of the link */
+	if (link->param.bandwidth_bps) {
+		end->tx_free_us = max(end->tx_free_us, now);
+		end->tx_free_us += ((uint64_t)(len + hdr) * 8 * 1000000) /
+				   link->param.bandwidth_bps;
+		deliver = end->tx_free_us;
+	} else {
+		deliver = now;
+	}
+	deliver += link->param.latency_us;
+	if (link->param.jitter_us)
+		deliver += _rand(link) % (link->param.jitter_us + 1);
+
+	link->stats.segments++;
+	link->stats.bytes += len;
+
+	lost = link->param.loss_ppm &&
+	       (_rand(link) % 1000000) < link->param.loss_ppm;
+	if (lost) {
+		link->stats.lost++;
+		if (dst->proto == PROTOCOL_UDP)
+			return SUCCESS;
+		deliver += link->param.retransmit_us;
+	}
+
+	if (dst->proto == PROTOCOL_TCP) {
+		deliver = max(deliver, dst->last_deliver_us);
+		dst->last_deliver_us = deliver;
+	}
+
+	seg = (struct loopback_segment *)malloc(sizeof(*seg) + len);
+	if (!seg)
+		return -ENOMEM;
+
+	seg->deliver_us = deliver;
+	seg->from_port = from_port;
+	seg->len = len;
+	seg->off = 0;
+	memcpy(seg->data, data, len);
+
+	ret = dst->rx->push(dst->rx, seg);
+	if (IS_ERR_VALUE(ret))
+		free(seg);
+
+	return ret;
+}
+
+/* Get the first segment that can be received, NULL if none */
+static struct loopback_segment *_ready_segment(struct loopback_sock *sock)
+{
+	struct loopback_segment	*seg;
+
+	if (IS_ERR_VALUE(list_read_first(sock->rx, (void **)&seg)))
+		return NULL;
+
+	if (seg->deliver_us > _now(sock->end->link))
+		return NULL;
+
+	return seg;
+}
+
+/** @brief See \ref network_interface.socket_open */
+static int32_t loopback_socket_open(struct loopback_end *end,
+				    uint32_t *sock_id,
+				    enum socket_protocol proto,
+				    uint32_t buff_size)
+{
+	UNUSED_PARAM(buff_size);
+
+	if (!end || !sock_id)
+		return -EINVAL;
+
+	return _alloc_sock(end, proto, sock_id);
+}
+
+/** @brief See \ref network_interface.socket_close */
+static int32_t loopback_socket_close(struct loopback_end *end,
+				     uint32_t sock_id)
+{
+	struct loopback_sock	*sock;
+	uint32_t		i;
+
+	sock = _get_sock(end, sock_id);
+	if (!sock)
+		return -EINVAL;
+
+	/* Refuse the connections not accepted yet */
+	if (sock->state == SOCK_LISTENING)
+		for (i = 0; i < LOOPBACK_MAX_SOCKETS; i++)
+			if (end->sockets[i].listener == sock &&
+			    end->sockets[i].state != SOCK_UNUSED)
+				_release_sock(&end->sockets[i]);
+
+	_release_sock(sock);
+
+	return SUCCESS;
+}
+
+/** @brief See \ref network_interface.socket_connect */
+static int32_t loopback_socket_connect(struct loopback_end *end,
+				       uint32_t sock_id,
+				       struct socket_address *addr)
+{
+	struct loopback_desc	*link;
+	struct loopback_sock	*sock;
+	struct loopback_sock	*listener;
+	struct loopback_sock	*srv;
+	struct loopback_end	*srv_end;
+	uint32_t		srv_id;
+	uint32_t		waiting;
+	uint32_t		i;
+	int32_t			ret;
+
+	sock = _get_sock(end, sock_id);
+	if (!sock || !addr)
+		return -EINVAL;
+
+	if (sock->state != SOCK_OPEN)
+		return -EISCONN;
+
+	link = end->link;
+	if (!sock->port)
+		sock->port = _ephemeral_port(link, sock->proto);
+
+	if (sock->proto == PROTOCOL_UDP) {
+		sock->remote_port = addr->port;
+		return SUCCESS;
+	}
+
+	listener = _find_port(link, PROTOCOL_TCP, addr->port);
+	if (!listener)
+		return -ECONNREFUSED;
+
+	srv_end = listener->end;
+	waiting = 0;
+	for (i = 0; i < LOOPBACK_MAX_SOCKETS; i++)
+		if (srv_end->sockets[i].state == SOCK_WAITING_ACCEPT &&
+		    srv_end->sockets[i].listener == listener)
+			waiting++;
+	if (waiting >= listener->back_log)
+		return -ECONNREFUSED;
+
+	ret = _alloc_sock(srv_end, PROTOCOL_TCP, &srv_id);
+	if (IS_ERR_VALUE(ret))
+		return ret;
+
+	srv = &srv_end->sockets[srv_id];
+	srv->state = SOCK_WAITING_ACCEPT;
+	srv->port = listener->port;
+	srv->listener = listener;
+	srv->peer = sock;
+	sock->peer = srv;
+	sock->state = SOCK_CONNECTED;
+
+	return SUCCESS;
+}
+
+/** @brief See \ref network_interface.socket_disconnect */
+static int32_t loopback_socket_disconnect(struct loopback_end *end,
+		uint32_t sock_id)
+{
+	struct loopback_sock *sock;
+
+	sock = _get_sock(end, sock_id);
+	if (!sock)
+		return -EINVAL;
+
+	_detach(sock);
+	if (sock->state == SOCK_CONNECTED || sock->state == SOCK_PEER_CLOSED)
+		sock->state = SOCK_OPEN;
+	sock->remote_port = 0;
+
+	return SUCCESS;
+}
+
+/** @brief See \ref network_interface.socket_sendto */
+static int32_t loopback_socket_sendto(struct loopback_end *end,
+				      uint32_t sock_id, const void *data,
+				      uint32_t size,
+				      const struct socket_address *to)
+{
+	struct loopback_sock	*sock;
+	struct loopback_sock	*dst;
+	int32_t			ret;
+
+	sock = _get_sock(end, sock_id);
+	if (!sock || !to || sock->proto != PROTOCOL_UDP)
+		return -EINVAL;
+
+	if (!sock->port)
+		sock->port = _ephemeral_port(end->link, PROTOCOL_UDP);
+
+	/* Like on a network, nobody listening is not an error */
+	dst = _find_port(end->link, PROTOCOL_UDP, to->port);
+	if (!dst)
+		return size;
+
+	ret = _transmit(end, dst, data, size, sock->port);
+	if (IS_ERR_VALUE(ret))
+		return ret;
+
+	return size;
+}
+
+/** @brief See \ref network_interface.socket_send */
+static int32_t loopback_socket_send(struct loopback_end *end,
+				    uint32_t sock_id, const void *data,
+				    uint32_t size)
+{
+	struct loopback_sock	*sock;
+	struct socket_address	to;
+	uint32_t		mss;
+	uint32_t		len;
+	uint32_t		i;
+	int32_t			ret;
+
+	sock = _get_sock(end, sock_id);
+	if (!sock)
+		return -EINVAL;
+
+	if (sock->proto == PROTOCOL_UDP) {
+		if (!sock->remote_port)
+			return -ENOTCONN;
+		to.addr = NULL;
+		to.port = sock->remote_port;
+		return loopback_socket_sendto(end, sock_id, data, size, &to);
+	}
+
+	if (sock->state != SOCK_CONNECTED || !sock->peer)
+		return -ENOTCONN;
+
+	mss = end->link->param.mtu - TCP_HEADERS_SIZE;
+	for (i = 0; i < size; i += len) {
+		len = min(size - i, mss);
+		ret = _transmit(end, sock->peer, (const uint8_t *)data + i,
+				len, sock->port);
+		if (IS_ERR_VALUE(ret))
+			return ret;
+	}
+
+	return size;
+}
+
+/**
+ * @brief See \ref network_interface.socket_recvfrom
+ *
+ * from->addr is set to NULL, only the port of the sender is known.
+ */
+static int32_t loopback_socket_recvfrom(struct loopback_end *end,
+					uint32_t sock_id, void *data,
+					uint32_t size,
+					struct socket_address *from)
+{
+	struct loopback_sock	*sock;
+	struct loopback_segment	*seg;
+	uint32_t		len;
+
+	sock = _get_sock(end, sock_id);
+	if (!sock || sock->proto != PROTOCOL_UDP)
+		return -EINVAL;
+
+	seg = _ready_segment(sock);
+	if (!seg)
+		return -EAGAIN;
+
+	/* One datagram per call, the rest of a larger one is discarded */
+	len = min(size, seg->len);
+	memcpy(data, seg->data, len);
+	if (from) {
+		from->addr = NULL;
+		from->port = seg->from_port;
+	}
+	list_get_first(sock->rx, (void **)&seg);
+	free(seg);
+
+	return len;
+}
+
+/** @brief See \ref network_interface.socket_recv */
+static int32_t loopback_socket_recv(struct loopback_end *end,
+				    uint32_t sock_id, void *data,
+				    uint32_t size)
+{
+	struct loopback_sock	*sock;
+	struct loopback_segment	*seg;
+	uint32_t		len;
+	uint32_t		i;
+
+	sock = _get_sock(end, sock_id);
+	if (!sock || !size)
+		return -EINVAL;
+
+	if (sock->proto == PROTOCOL_UDP)
+		return loopback_socket_recvfrom(end, sock_id, data, size, NULL);
+
+	if (sock->state != SOCK_CONNECTED && sock->state != SOCK_PEER_CLOSED)
+		return -ENOTCONN;
+
+	i = 0;
+	while (i < size) {
+		seg = _ready_segment(sock);
+		if (!seg)
+			break;
+		len = min(size - i, seg->len - seg->off);
+		memcpy((uint8_t *)data + i, seg->data + seg->off, len);
+		seg->off += len;
+		i += len;
+		if (seg->off == seg->len) {
+			list_get_first(sock->rx, (void **)&seg);
+			free(seg);
+		}
+	}
+
+	if (i)
+		return i;
+
+	/* The data sent before the close is received first */
+	if (sock->state == SOCK_PEER_CLOSED &&
+	    IS_ERR_VALUE(list_read_first(sock->rx, (void **)&seg)))
+		return -ENOTCONN;
+
+	return -EAGAIN;
+}
+
+/** @brief See \ref network_interface.socket_bind */
+static int32_t loopback_socket_bind(struct loopback_end *end,
+				    uint32_t sock_id, uint16_t port)
+{
+	struct loopback_sock *sock;
+
+	sock = _get_sock(end, sock_id);
+	if (!sock)
+		return -EINVAL;
+
+	if (_find_port(end->link, sock->proto, port))
+		return -EADDRINUSE;
+
+	sock->port = port;
+
+	return SUCCESS;
+}
+
+/** @brief See \ref network_interface.socket_listen */
+static int32_t loopback_socket_listen(struct loopback_end *end,
+				      uint32_t sock_id, uint32_t back_log)
+{
+	struct loopback_sock *sock;
+
+	sock = _get_sock(end, sock_id);
+	if (!sock || sock->proto != PROTOCOL_TCP)
+		return -EINVAL;
+
+	if (!sock->port)
+		return -ENOTCONN;
+
+	sock->back_log = back_log ? back_log : LOOPBACK_MAX_SOCKETS;
+	sock->state = SOCK_LISTENING;
+
+	return SUCCESS;
+}
+
+/** @brief See \ref network_interface.socket_accept */
+static int32_t loopback_socket_accept(struct loopback_end *end,
+				      uint32_t sock_id,
+				      uint32_t *client_socket_id)
+{
+	struct loopback_sock	*sock;
+	struct loopback_sock	*cli;
+	uint32_t		i;
+
+	sock = _get_sock(end, sock_id);
+	if (!sock || !client_socket_id)
+		return -EINVAL;
+
+	if (sock->state != SOCK_LISTENING)
+		return -ENOTCONN;
+
+	for (i = 0; i < LOOPBACK_MAX_SOCKETS; i++) {
+		cli = &end->sockets[i];
+		if (cli->listener != sock)
+			continue;
+		if (cli->state == SOCK_WAITING_ACCEPT) {
+			cli->state = SOCK_CONNECTED;
+		} else if (cli->state != SOCK_PEER_CLOSED) {
+			continue;
+		}
+		cli->listener = NULL;
+		*client_socket_id = i;
+
+		return SUCCESS;
+	}
+
+	return -EAGAIN;
+}
+
+static void _init_interface(struct loopback_end *end)
+{
+	end->interface.net = end;
+	end->interface.socket_open =
+		(int32_t (*)(void *, uint32_t *, enum socket_protocol,
+			     uint32_t))loopback_socket_open;
+	end->interface.socket_close =
+		(int32_t (*)(void *, uint32_t))loopback_socket_close;
+	end->interface.socket_connect =
+		(int32_t (*)(void *, uint32_t, struct socket_address *))
+		loopback_socket_connect;
+	end->interface.socket_disconnect =
+		(int32_t (*)(void *, uint32_t))loopback_socket_disconnect;
+	end->interface.socket_send =
+		(int32_t (*)(void *, uint32_t, const void *, uint32_t))
+		loopback_socket_send;
+	end->interface.socket_recv =
+		(int32_t (*)(void *, uint32_t, void *, uint32_t))
+		loopback_socket_recv;
+	end->interface.socket_sendto =
+		(int32_t (*)(void *, uint32_t, const void *, uint32_t,
+			     const struct socket_address *))
+		loopback_socket_sendto;
+	end->interface.socket_recvfrom =
+		(int32_t (*)(void *, uint32_t, void *, uint32_t,
+			     struct socket_address *))
+		loopback_socket_recvfrom;
+	end->interface.socket_bind =
+		(int32_t (*)(void *, uint32_t, uint16_t))
+		loopback_socket_bind;
+	end->interface.socket_listen =
+		(int32_t (*)(void *, uint32_t, uint32_t))
+		loopback_socket_listen;
+	end->interface.socket_accept =
+		(int32_t (*)(void *, uint32_t, uint32_t*))
+		loopback_socket_accept;
+}
+
+/**
+ * @brief Initialize a loopback link between two network interfaces.
+ * @param desc - Address where to store the link descriptor.
+ * @param param - Link configuration.
+ * @return SUCCESS in case of success, error code otherwise.
+ */
+int32_t loopback_init(struct loopback_desc **desc,
+		      struct loopback_init_param *param)
+{
+	struct loopback_desc	*link;
+	uint32_t		i;
+
+	if (!desc || !param)
+		return -EINVAL;
+
+	if (!param->get_time_us && (param->latency_us || param->jitter_us ||
+				    param->bandwidth_bps || param->loss_ppm))
+		return -EINVAL;
+
+	if (param->mtu && param->mtu <= TCP_HEADERS_SIZE)
+		return -EINVAL;
+
+	link = (struct loopback_desc *)calloc(1, sizeof(*link));
+	if (!link)
+		return -ENOMEM;
+
+	link->param = *param;
+	if (!link->param.mtu)
+		link->param.mtu = LOOPBACK_DEFAULT_MTU;
+	if (!link->param.retransmit_us)
+		link->param.retransmit_us = LOOPBACK_DEFAULT_RTO_US;
+	link->rand = param->seed ? param->seed : 1;
+	link->next_port = EPHEMERAL_PORT;
+
+	for (i = 0; i < 2; i++) {
+		link->end[i].link = link;
+		_init_interface(&link->end[i]);
+	}
+
+	*desc = link;
+
+	return SUCCESS;
+}
+
+/**
+ * @brief Close all the sockets and free the link.
+ * @param desc - Link descriptor.
+ * @return SUCCESS in case of success, error code otherwise.
+ */
+int32_t loopback_remove(struct loopback_desc *desc)
+{
+	struct loopback_sock	*sock;
+	uint32_t		i;
+	uint32_t		j;
+
+	if (!desc)
+		return -EINVAL;
+
+	for (i = 0; i < 2; i++)
+		for (j = 0; j < LOOPBACK_MAX_SOCKETS; j++) {
+			sock = &desc->end[i].sockets[j];
+			if (sock->state != SOCK_UNUSED)
+				_release_sock(sock);
+		}
+	free(desc);
+
+	return SUCCESS;
+}
+
+/**
+ * @brief Get the network interface of one end of the link.
+ * @param desc - Link descriptor.
+ * @param end - 0 or 1.
+ * @param net - Address where to store the reference to the interface.
+ * @return SUCCESS in case of success, error code otherwise.
+ */
+int32_t loopback_get_network_interface(struct loopback_desc *desc,
+				       uint32_t end,
+				       struct network_interface **net)
+{
+	if (!desc || end > 1 || !net)
+		return -EINVAL;
+
+	*net = &desc->end[end].interface;
+
+	return SUCCESS;
+}
+
+/**
+ * @brief Get the link counters.
+ * @param desc - Link descriptor.
+ * @param stats - Where to copy the counters.
+ * @return SUCCESS in case of success, error code otherwise.
+ */
+int32_t loopback_get_stats(struct loopback_desc *desc,
+			   struct loopback_stats *stats)
+{
+	if (!desc || !stats)
+		return -EINVAL;
+
+	*stats = desc->stats;
+
+	return SUCCESS;
+}
@@ -0,0 +1,130 @@
+/***************************************************************************//**
+ *   @file   loopback.h
+ *   @brief  Header file of the in-memory loopback network.
+********************************************************************************
+ * Copyright 2021(c) Analog Devices, Inc.
+ *
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *  - Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ *  - Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ *  - Neither the name of Analog Devices, Inc. nor the names of its
+ *    contributors may be used to endorse or promote products derived
+ *    from this software without specific prior written permission.
+ *  - The use of this software may or may not infringe the patent rights
+ *    of one or more patent holders.  This license does not release you
+ *    from the requirement that you obtain separate licenses from these
+ *    patent holders to use this software.
+ *  - Use of the software either in source or binary form, must be run
+ *    on or directly connected to an Analog Devices Inc. component.
+ *
+ * THIS SOFTWARE IS PROVIDED BY ANALOG DEVICES "AS IS" AND ANY EXPRESS OR
+ * IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, NON-INFRINGEMENT,
+ * MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED.
+ * IN NO EVENT SHALL ANALOG DEVICES BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, INTELLECTUAL PROPERTY RIGHTS, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*******************************************************************************/
+
+#ifndef LOOPBACK_H
+#define LOOPBACK_H
+
+/******************************************************************************/
+/***************************** Include Files **********************************/
+/******************************************************************************/
+
+#include <stdint.h>
+#include "network_interface.h"
+
+/******************************************************************************/
+/********************** Macros and Constants Definitions **********************/
+/******************************************************************************/
+
+/* Sockets that can be open at the same time on each end */
+#define LOOPBACK_MAX_SOCKETS	16
+/* Default MTU of the link */
+#define LOOPBACK_DEFAULT_MTU	1500
+/* Default time to retransmit a lost TCP segment */
+#define LOOPBACK_DEFAULT_RTO_US	200000
+
+/******************************************************************************/
+/*************************** Types Declarations *******************************/
+/******************************************************************************/
+
+/**
+ * @struct loopback_desc
+ * @brief Loopback link descriptor
+ */
+struct loopback_desc;
+
+/**
+ * @struct loopback_init_param
+ * @brief Parameter to initialize the loopback link
+ *
+ * The link connects two network interfaces, end 0 and end 1. Ports are shared
+ * by both ends and addresses are ignored: a connect or a sendto reaches the
+ * socket bound to the port, on any end.
+ * Every TCP segment and UDP datagram is delayed by the link rate, the latency
+ * and the jitter. A lost UDP datagram is dropped. A lost TCP segment, and the
+ * data after it, is delayed by retransmit_us so the stream stays reliable.
+ */
+struct loopback_init_param {
+	/** One way latency */
+	uint32_t	latency_us;
+	/** Maximum random delay added to the latency */
+	uint32_t	jitter_us;
+	/** Rate of each direction in bits per second, 0 for unlimited */
+	uint32_t	bandwidth_bps;
+	/** Probability for a segment to be lost, in parts per million */
+	uint32_t	loss_ppm;
+	/** Delay of a lost TCP segment, 0 for LOOPBACK_DEFAULT_RTO_US */
+	uint32_t	retransmit_us;
+	/** TCP sends are split to fit the MTU, 0 for LOOPBACK_DEFAULT_MTU */
+	uint32_t	mtu;
+	/** Seed of the loss and jitter generator, runs are reproducible */
+	uint32_t	seed;
+	/** Time base, needed if any of the delays, the rate or the loss is set */
+	uint64_t	(*get_time_us)(void);
+};
+
+/**
+ * @struct loopback_stats
+ * @brief Loopback link counters
+ */
+struct loopback_stats {
+	/** TCP segments and UDP datagrams sent */
+	uint32_t	segments;
+	/** Payload bytes sent */
+	uint64_t	bytes;
+	/** Lost segments, dropped or retransmitted */
+	uint32_t	lost;
+};
+
+/******************************************************************************/
+/************************ Functions Declarations ******************************/
+/******************************************************************************/
+
+/* Loopback init */
+int32_t loopback_init(struct loopback_desc **desc,
+		      struct loopback_init_param *param);
+/* Loopback remove */
+int32_t loopback_remove(struct loopback_desc *desc);
+/* Loopback get network interface of one end */
+int32_t loopback_get_network_interface(struct loopback_desc *desc,
+				       uint32_t end,
+				       struct network_interface **net);
+/* Loopback get counters */
+int32_t loopback_get_stats(struct loopback_desc *desc,
+			   struct loopback_stats *stats);
+
+#endif
@@ -99,6 +99,20 @@
  */
 #define ENABLE_MEMORY_OPTIMIZATIONS
 
+/*
+ * Resume the last TLS session on reconnect. Session ID resumption is always
+ * tried, this enables session tickets (RFC 5077) too, which work with
+ * servers that don't keep a session cache.
+ */
+#define ENABLE_SESSION_TICKETS
+
+/*
+ * Allow negotiating a smaller record size with the server (RFC 6066), see
+ * secure_init_param.max_frag_len. The TLS buffers are shrunk to the
+ * negotiated size after the handshake.
+ */
+#define ENABLE_MAX_FRAGMENT_LENGTH
+
 /******************************************************************************/
 /********************* Minimal tls client requirements ************************/
 /******************************************************************************/
@@ -154,6 +168,19 @@
 
 #endif /* ENABLE_MEMORY_OPTIMIZATIONS */
 
+#ifdef ENABLE_SESSION_TICKETS
+
+#define MBEDTLS_SSL_SESSION_TICKETS
+
+#endif /* ENABLE_SESSION_TICKETS */
+
+#ifdef ENABLE_MAX_FRAGMENT_LENGTH
+
+#define MBEDTLS_SSL_MAX_FRAGMENT_LENGTH
+#define MBEDTLS_SSL_VARIABLE_BUFFER_LENGTH
+
+#endif /* ENABLE_MAX_FRAGMENT_LENGTH */
+
 #ifdef ENABLE_PEM_CERT
 
 #define MBEDTLS_BASE64_C
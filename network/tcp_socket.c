@@ -43,6 +43,7 @@
 /******************************************************************************/
 
 #include <stdlib.h>
+#include <string.h>
 #include "error.h"
 #include "tcp_socket.h"
 #include "util.h"
@@ -77,23 +78,49 @@
 
 #ifndef DISABLE_SECURE_SOCKET
 /**
- * @struct secure_socket_desc
- * @brief Fields used by secure socket
+ * @struct secure_socket_config
+ * @brief TLS configuration shared by the sockets initialized with the same
+ * \ref secure_init_param content
  */
-struct secure_socket_desc {
+struct secure_socket_config {
+	/** Next configuration in the cache */
+	struct secure_socket_config	*next;
+	/** Number of sockets using this configuration */
+	uint32_t			refs;
+	/** Copy of the parameters the configuration was created with */
+	struct secure_init_param	param;
 	/** True random number generator reference */
-	struct trng_desc	*trng;
+	struct trng_desc		*trng;
 	/* Mbed structures */
 	/** CA certificate */
-	mbedtls_x509_crt	cacert;
+	mbedtls_x509_crt		cacert;
 	/** Client certificate */
-	mbedtls_x509_crt	clicert;
+	mbedtls_x509_crt		clicert;
 	/** Client private key */
-	mbedtls_pk_context	pkey;
+	mbedtls_pk_context		pkey;
 	/** SSL configuration structure */
-	mbedtls_ssl_config	conf;
+	mbedtls_ssl_config		conf;
+	/** Last session established, used to resume the next handshake */
+	mbedtls_ssl_session		session;
+	/** Set if session is valid */
+	bool				has_session;
+	/** Server address of the session */
+	char				*session_addr;
+	/** Server port of the session */
+	uint16_t			session_port;
+};
+
+/**
+ * @struct secure_socket_desc
+ * @brief Fields used by secure socket
+ */
+struct secure_socket_desc {
+	/** Shared configuration */
+	struct secure_socket_config	*config;
 	/** Mbedtls tls context */
-	mbedtls_ssl_context	ssl;
+	mbedtls_ssl_context		ssl;
+	/** Set after a handshake, the context must be reset before the next */
+	bool				used;
 };
 #endif /* DISABLE_SECURE_SOCKET */
 
@@ -134,48 +161,107 @@ static int tls_net_send(struct tcp_socket_desc *sock, unsigned char *buff,
 	return sock->net->socket_send(sock->net->net, sock->id, buff, len);
 }
 
-/* Remove secure descriptor*/
-static void stcp_socket_remove(struct secure_socket_desc *desc)
+/* Configurations shared between secure sockets */
+static struct secure_socket_config *stcp_configs;
+
+/* Forget the session saved in config */
+static void stcp_config_drop_session(struct secure_socket_config *config)
 {
-	mbedtls_pk_free(&desc->pkey);
-	mbedtls_x509_crt_free(&desc->clicert);
-	mbedtls_x509_crt_free(&desc->cacert);
-	mbedtls_ssl_config_free(&desc->conf);
-	if (desc->trng)
-		trng_remove(desc->trng);
+	if (config->has_session)
+		mbedtls_ssl_session_free(&config->session);
+	config->has_session = false;
+	free(config->session_addr);
+	config->session_addr = NULL;
+}
 
-	free(desc);
+/* Free a configuration when it is not used by any socket */
+static void stcp_config_put(struct secure_socket_config *config)
+{
+	struct secure_socket_config **it;
+
+	if (--config->refs)
+		return ;
+
+	for (it = &stcp_configs; *it; it = &(*it)->next)
+		if (*it == config) {
+			*it = config->next;
+			break;
+		}
+
+	stcp_config_drop_session(config);
+	mbedtls_pk_free(&config->pkey);
+	mbedtls_x509_crt_free(&config->clicert);
+	mbedtls_x509_crt_free(&config->cacert);
+	mbedtls_ssl_config_free(&config->conf);
+	if (config->trng)
+		trng_remove(config->trng);
+
+	free(config);
 }
 
-/* Init secure descriptor */
-static int32_t stcp_socket_init(struct secure_socket_desc **desc,
-				struct tcp_socket_desc *sock,
-				struct secure_init_param *param)
+/* Convert the maximum fragment length in bytes to the mbedtls code */
+static int32_t stcp_mfl_code(uint32_t max_frag_len, unsigned char *code)
 {
-	struct secure_socket_desc	*ldesc;
+	switch (max_frag_len) {
+	case 0:
+		*code = MBEDTLS_SSL_MAX_FRAG_LEN_NONE;
+		break;
+	case 512:
+		*code = MBEDTLS_SSL_MAX_FRAG_LEN_512;
+		break;
+	case 1024:
+		*code = MBEDTLS_SSL_MAX_FRAG_LEN_1024;
+		break;
+	case 2048:
+		*code = MBEDTLS_SSL_MAX_FRAG_LEN_2048;
+		break;
+	case 4096:
+		*code = MBEDTLS_SSL_MAX_FRAG_LEN_4096;
+		break;
+	default:
+		return -EINVAL;
+	}
+
+	return SUCCESS;
+}
+
+/* Parse the certificates and set up a new mbedtls_ssl_config */
+static int32_t stcp_config_create(struct secure_socket_config **config,
+				  struct secure_init_param *param)
+{
+	struct secure_socket_config	*lconfig;
+	unsigned char			mfl_code;
 	int32_t				ret;
 
-	if (!desc || !param)
-		return FAILURE;
+	ret = stcp_mfl_code(param->max_frag_len, &mfl_code);
+	if (IS_ERR_VALUE(ret))
+		return ret;
+#ifndef MBEDTLS_SSL_MAX_FRAGMENT_LENGTH
+	if (mfl_code != MBEDTLS_SSL_MAX_FRAG_LEN_NONE)
+		return -ENOSYS;
+#endif
 
-	ldesc = (typeof(ldesc))calloc(1, sizeof(*ldesc));
-	if (!ldesc)
-		return FAILURE;
+	lconfig = (typeof(lconfig))calloc(1, sizeof(*lconfig));
+	if (!lconfig)
+		return -ENOMEM;
+
+	lconfig->refs = 1;
+	lconfig->param = *param;
 
 	/* Initialize structures */
-	mbedtls_ssl_config_init(&ldesc->conf);
-	mbedtls_x509_crt_init(&ldesc->cacert);
-	mbedtls_x509_crt_init(&ldesc->clicert);
-	mbedtls_pk_init(&ldesc->pkey);
+	mbedtls_ssl_config_init(&lconfig->conf);
+	mbedtls_x509_crt_init(&lconfig->cacert);
+	mbedtls_x509_crt_init(&lconfig->clicert);
+	mbedtls_pk_init(&lconfig->pkey);
 
-	ret = trng_init(&ldesc->trng, param->trng_init_param);
+	ret = trng_init(&lconfig->trng, param->trng_init_param);
 	if (IS_ERR_VALUE(ret)) {
-		ldesc->trng = NULL;
+		lconfig->trng = NULL;
 		goto exit;
 	}
 
 	/* Set default configuration: TLS client socket */
-	ret = mbedtls_ssl_config_defaults(&ldesc->conf,
+	ret = mbedtls_ssl_config_defaults(&lconfig->conf,
 					  MBEDTLS_SSL_IS_CLIENT,
 					  MBEDTLS_SSL_TRANSPORT_STREAM,
 					  MBEDTLS_SSL_PRESET_DEFAULT);
@@ -184,22 +270,23 @@ static int32_t stcp_socket_init(struct secure_socket_desc **desc,
 
 	if (param->ca_cert) {
 #ifdef ENABLE_PEM_CERT
-		ret = mbedtls_x509_crt_parse( &ldesc->cacert,
+		ret = mbedtls_x509_crt_parse( &lconfig->cacert,
 #else
-		ret = mbedtls_x509_crt_parse_der_nocopy(&ldesc->cacert,
+		ret = mbedtls_x509_crt_parse_der_nocopy(&lconfig->cacert,
 #endif /* ENABLE_PEM_CERT */
 					      (const unsigned char *)param->ca_cert,
 					      (size_t)param->ca_cert_len);
 		if (ret < 0)
 			goto exit;
 
-		mbedtls_ssl_conf_ca_chain(&ldesc->conf, &ldesc->cacert, NULL );
+		mbedtls_ssl_conf_ca_chain(&lconfig->conf, &lconfig->cacert,
+					  NULL );
 		/* Verify server identity */
-		mbedtls_ssl_conf_authmode(&ldesc->conf,
+		mbedtls_ssl_conf_authmode(&lconfig->conf,
 					  MBEDTLS_SSL_VERIFY_REQUIRED);
 	} else {
 		/* Do not verify server identity */
-		mbedtls_ssl_conf_authmode(&ldesc->conf,
+		mbedtls_ssl_conf_authmode(&lconfig->conf,
 					  MBEDTLS_SSL_VERIFY_NONE);
 	}
 
@@ -209,34 +296,116 @@ static int32_t stcp_socket_init(struct secure_socket_desc **desc,
 			goto exit;
 		}
 #ifdef ENABLE_PEM_CERT
-		ret = mbedtls_x509_crt_parse( &ldesc->clicert,
+		ret = mbedtls_x509_crt_parse( &lconfig->clicert,
 #else
-		ret = mbedtls_x509_crt_parse_der_nocopy(&ldesc->clicert,
+		ret = mbedtls_x509_crt_parse_der_nocopy(&lconfig->clicert,
 #endif /* ENABLE_PEM_CERT */
 					      (const unsigned char *)param->cli_cert,
 					      (size_t)param->cli_cert_len);
 		if (IS_ERR_VALUE(ret))
 			goto exit;
-		ret = mbedtls_pk_parse_key(&ldesc->pkey,
+		ret = mbedtls_pk_parse_key(&lconfig->pkey,
 					   (const unsigned char *)param->cli_pk,
 					   param->cli_pk_len, NULL, 0 );
 		if (IS_ERR_VALUE(ret))
 			goto exit;
 
-		ret = mbedtls_ssl_conf_own_cert(&ldesc->conf, &ldesc->clicert,
-						&ldesc->pkey);
+		ret = mbedtls_ssl_conf_own_cert(&lconfig->conf,
+						&lconfig->clicert,
+						&lconfig->pkey);
 		if (IS_ERR_VALUE(ret))
 			goto exit;
 	}
 
+#ifdef MBEDTLS_SSL_MAX_FRAGMENT_LENGTH
+	ret = mbedtls_ssl_conf_max_frag_len(&lconfig->conf, mfl_code);
+	if (IS_ERR_VALUE(ret))
+		goto exit;
+#endif
+#ifdef MBEDTLS_SSL_SESSION_TICKETS
+	mbedtls_ssl_conf_session_tickets(&lconfig->conf,
+					 MBEDTLS_SSL_SESSION_TICKETS_ENABLED);
+#endif
+
 	/* Config Random number generator */
-	mbedtls_ssl_conf_rng(&ldesc->conf,
+	mbedtls_ssl_conf_rng(&lconfig->conf,
 			     (int (*)(void *, unsigned char *, size_t))
 			     trng_fill_buffer,
-			     (void *)ldesc->trng);
+			     (void *)lconfig->trng);
+
+	lconfig->next = stcp_configs;
+	stcp_configs = lconfig;
+	*config = lconfig;
+
+	return SUCCESS;
+
+exit:
+	stcp_config_put(lconfig);
+
+	return ret;
+}
+
+/* True if the configurations created with a and b are the same */
+static bool stcp_param_equal(struct secure_init_param *a,
+			     struct secure_init_param *b)
+{
+	return a->trng_init_param == b->trng_init_param &&
+	       a->ca_cert == b->ca_cert && a->ca_cert_len == b->ca_cert_len &&
+	       a->cli_cert == b->cli_cert &&
+	       a->cli_cert_len == b->cli_cert_len &&
+	       a->cli_pk == b->cli_pk && a->cli_pk_len == b->cli_pk_len &&
+	       a->max_frag_len == b->max_frag_len;
+}
+
+/* Get a configuration from the cache or create a new one */
+static int32_t stcp_config_get(struct secure_socket_config **config,
+			       struct secure_init_param *param)
+{
+	struct secure_socket_config *it;
+
+	for (it = stcp_configs; it; it = it->next)
+		if (stcp_param_equal(&it->param, param)) {
+			it->refs++;
+			*config = it;
+			return SUCCESS;
+		}
+
+	return stcp_config_create(config, param);
+}
+
+/* Remove secure descriptor*/
+static void stcp_socket_remove(struct secure_socket_desc *desc)
+{
+	mbedtls_ssl_free(&desc->ssl);
+	stcp_config_put(desc->config);
+
+	free(desc);
+}
+
+/* Init secure descriptor */
+static int32_t stcp_socket_init(struct secure_socket_desc **desc,
+				struct tcp_socket_desc *sock,
+				struct secure_init_param *param)
+{
+	struct secure_socket_desc	*ldesc;
+	int32_t				ret;
+
+	if (!desc || !param)
+		return FAILURE;
+
+	ldesc = (typeof(ldesc))calloc(1, sizeof(*ldesc));
+	if (!ldesc)
+		return FAILURE;
+
+	ret = stcp_config_get(&ldesc->config, param);
+	if (IS_ERR_VALUE(ret)) {
+		free(ldesc);
+		return ret;
+	}
 
 	/* Set the resulting protocol configuration */
-	ret = mbedtls_ssl_setup(&ldesc->ssl, &ldesc->conf);
+	mbedtls_ssl_init(&ldesc->ssl);
+	ret = mbedtls_ssl_setup(&ldesc->ssl, &ldesc->config->conf);
 	if (IS_ERR_VALUE(ret))
 		goto exit;
 
@@ -254,6 +423,62 @@ exit:
 
 	return ret;
 }
+
+/*
+ * Do the TLS handshake. If a session with the same server was saved, it is
+ * offered to the server to skip the full handshake.
+ */
+static int32_t stcp_socket_handshake(struct secure_socket_desc *desc,
+				     struct socket_address *addr)
+{
+	struct secure_socket_config	*config = desc->config;
+	bool				same_server;
+	int32_t				ret;
+
+	if (desc->used) {
+		/* Reuse the context for a new connection */
+		ret = mbedtls_ssl_session_reset(&desc->ssl);
+		if (IS_ERR_VALUE(ret))
+			return ret;
+	}
+	desc->used = true;
+
+	same_server = config->has_session && config->session_port == addr->port
+		      && !strcmp(config->session_addr, addr->addr);
+	if (same_server) {
+		ret = mbedtls_ssl_set_session(&desc->ssl, &config->session);
+		if (IS_ERR_VALUE(ret))
+			return ret;
+	}
+
+	do {
+		ret = mbedtls_ssl_handshake(&desc->ssl);
+	} while (ret == MBEDTLS_ERR_SSL_WANT_READ);
+	if (IS_ERR_VALUE(ret)) {
+		/* Don't offer again a session that may be the cause */
+		if (same_server)
+			stcp_config_drop_session(config);
+		return ret;
+	}
+
+	/* Save the session (id or new ticket) for the next connection */
+	stcp_config_drop_session(config);
+	config->session_addr = (char *)malloc(strlen(addr->addr) + 1);
+	if (!config->session_addr)
+		return SUCCESS;
+	strcpy(config->session_addr, addr->addr);
+	config->session_port = addr->port;
+	mbedtls_ssl_session_init(&config->session);
+	if (mbedtls_ssl_get_session(&desc->ssl, &config->session)) {
+		mbedtls_ssl_session_free(&config->session);
+		free(config->session_addr);
+		config->session_addr = NULL;
+		return SUCCESS;
+	}
+	config->has_session = true;
+
+	return SUCCESS;
+}
 #endif /* DISABLE_SECURE_SOCKET */
 
 /**
@@ -353,9 +578,7 @@ int32_t socket_connect(struct tcp_socket_desc *desc,
 
 #ifndef DISABLE_SECURE_SOCKET
 	if (desc->secure) {
-		do {
-			ret = mbedtls_ssl_handshake(&desc->secure->ssl);
-		} while (ret == MBEDTLS_ERR_SSL_WANT_READ);
+		ret = stcp_socket_handshake(desc->secure, addr);
 		if (IS_ERR_VALUE(ret))
 			return ret;
 	}
@@ -94,6 +94,13 @@ struct secure_init_param {
 	uint8_t			*cli_pk;
 	/** cli_pk length */
 	uint32_t		cli_pk_len;
+	/**
+	 * Maximum fragment length to negotiate with the server (RFC 6066):
+	 * 512, 1024, 2048 or 4096. 0 to not negotiate it.
+	 * Needs ENABLE_MAX_FRAGMENT_LENGTH in noos_mbedtls_config.h. Smaller
+	 * records reduce the TLS buffers and the socket buffer needed.
+	 */
+	uint32_t		max_frag_len;
 };
 
 #endif /* DISABLE_SECURE_SOCKET */
@@ -109,12 +116,17 @@ struct tcp_socket_init_param {
 	 *  Max buffer size for incoming data.
 	 *  If set to 0, default value will be used:
 	 *  DEFAULT_CONNECTION_BUFFER_SIZE from tcp_socket.c
+	 *  For TLS sockets it must fit the records sent by the server, so it
+	 *  can be reduced when max_frag_len is negotiated.
 	 */
 	uint32_t			max_buff_size;
 #ifndef DISABLE_SECURE_SOCKET
 	/**
 	 * Reference to \ref secure_init_param if a TCP socket over TLS should
 	 * be used. NULL if just raw connection is needed.
+	 * Sockets initialized with the same certificates, trng and
+	 * max_frag_len share the TLS configuration, the parsed certificates
+	 * and the last session used to resume the handshake on reconnect.
 	 */
 	struct secure_init_param	*secure_init_param;
 #endif /* DISABLE_SECURE_SOCKET */
@@ -63,6 +63,8 @@
 #define NB_ASYNC_MESSAGES	3
 /* Should be sizeof(responses)/sizeof(*responses) */
 #define NB_RESPONSE_MESSAGES	4
+/* Should be sizeof(send_msgs)/sizeof(*send_msgs) */
+#define NB_SEND_MESSAGES	3
 /* Max command length: at+cwsap=max_ssid_32,max_pass_64,0,0 -> 110 characters */
 #define CMD_BUFF_LEN		120u
 /* Maybe this could be smaller. Here must one response at a time */
@@ -71,6 +73,8 @@
 #define PUI8(X)			((uint8_t *)(X))
 /* Timeout waiting for module response. (20 seconds) */
 #define MODULE_TIMEOUT		20000
+/* Period used to poll for the response flag set by the receive path */
+#define RESPONSE_POLL_US	100u
 
 /******************************************************************************/
 /*************************** Types Declarations *******************************/
@@ -103,7 +107,8 @@ static const struct cmd_desc g_map[] = {
 	{{PUI8("+CIPSERVER"), 10}, AT_SET_OP},
 	{{PUI8("+CIPMODE"), 8}, AT_QUERY_OP | AT_SET_OP},
 	{{PUI8("+CIPSTO"), 7}, AT_QUERY_OP | AT_SET_OP},
-	{{PUI8("+PING"), 5}, AT_SET_OP}
+	{{PUI8("+PING"), 5}, AT_SET_OP},
+	{{PUI8("+CIPSENDBUF"), 11}, AT_SET_OP}
 };
 
 /* Structure storing a connection status */
@@ -149,6 +154,12 @@ struct at_desc {
 	struct at_buff		cmd;
 	/* Buffer to read one char */
 	uint8_t			read_ch;
+	/* Bulk receive ring or NULL if reading one char at a time */
+	uint8_t			*rx_ring;
+	/* Size of the bulk receive ring */
+	uint32_t		rx_ring_size;
+	/* Position in rx_ring up to where data have been parsed */
+	uint32_t		rx_tail;
 
 	/* - Control fields */
 	/* Variable to store errors */
@@ -173,6 +184,22 @@ struct at_desc {
 	uint8_t			async_idx[NB_ASYNC_MESSAGES];
 	/* Indexes in the response given by the driver */
 	uint8_t			resp_idx[NB_RESPONSE_MESSAGES];
+	/* Indexes in the buffered send messages */
+	uint8_t			send_idx[NB_SEND_MESSAGES];
+	/* Buffered sends issued on each connection. Written by at_run_cmd */
+	volatile uint32_t	send_queued[MAX_CONNECTIONS];
+	/* Buffered sends acknowledged on each connection. Written by callback */
+	volatile uint32_t	send_acked[MAX_CONNECTIONS];
+	/* Set if a buffered send failed on the connection. Cleared when read */
+	volatile bool		send_failed[MAX_CONNECTIONS];
+	/* Set when the module confirms the reception of a send payload */
+	volatile bool		payload_received;
+	/* Last response found by the receive path */
+	volatile enum {
+		RESPONSE_NONE,
+		RESPONSE_OK,
+		RESPONSE_ERROR
+	}			response;
 	/* Ipd idx */
 	uint8_t			ipd_idx;
 	/* State of ipd command message */
@@ -184,6 +211,19 @@ struct at_desc {
 	}			ipd_stat;
 	/* Variable where current message length is built */
 	uint32_t		ipd_len;
+	/* State of the buffered send acknowledge message */
+	enum {
+		ACK_NOT_MATCH,
+		ACK_LINE_START,
+		ACK_WAITING_COMMA,
+		ACK_WAITING_SEG,
+		ACK_READING_SEG,
+		ACK_READING_STATUS
+	}			ack_stat;
+	/* Connection of the acknowledge message */
+	uint32_t		ack_conn;
+	/* Chars of the acknowledge message added to the result buffer */
+	uint32_t		ack_len;
 	/* Will be called when a new connection is created or closed */
 	void			(*connection_callback)(void *ctx, enum at_event,
 			uint32_t conn_id, struct circular_buffer **cb);
@@ -227,10 +267,12 @@ static inline bool is_payload_message(struct at_desc *desc, uint8_t ch)
 	/* Update ipd_idx until at_ipd message is matched */
 	if (desc->ipd_idx < at_ipd.len) {
 		if (match_message(&at_ipd, &desc->ipd_idx, ch)) {
-			if (desc->multiple_conections)
+			if (desc->multiple_conections) {
 				desc->ipd_stat = RAEDING_CONN;
-			else
+			} else {
+				desc->current_conn = 0;
 				desc->ipd_stat = READING_LEN;
+			}
 		}
 		return false;
 	}
@@ -307,6 +349,8 @@ static inline int32_t check_conn_id(struct at_desc *desc, struct at_buff *msg,
 		desc->current_conn = id;
 		desc->conn[id].active = false;
 		desc->conn[id].cbuff = NULL;
+		/* Acknowledges of buffered sends will not come anymore */
+		desc->send_acked[id] = desc->send_queued[id];
 		/* Notify that a connection was closed */
 		desc->connection_callback(desc->callback_ctx,
 					  AT_CLOSED_CONNECTION, id, NULL);
@@ -355,6 +399,185 @@ static bool is_async_messages(struct at_desc *desc, uint8_t ch)
 	return true;
 }
 
+/*
+ * Check if the response of a command was received. The response is removed
+ * from the result buffer and desc->response is updated.
+ */
+static void is_response_message(struct at_desc *desc, uint8_t ch)
+{
+	const static struct at_buff responses[NB_RESPONSE_MESSAGES] = {
+		{PUI8("\r\nERROR\r\n"), 9},
+		{PUI8("\r\nFAIL\r\n"), 8},
+		{PUI8("\r\nOK\r\n"), 6},
+		{PUI8("\r\nSEND OK\r\n"), 11}
+	};
+	uint32_t	i;
+
+	for (i = 0; i < NB_RESPONSE_MESSAGES; i++)
+		if (match_message(&responses[i], &desc->resp_idx[i], ch))
+			break;
+
+	switch (i) {
+	case 0: // \r\nERROR\r\n
+	case 1: // \r\nFAIL\r\n
+		desc->response = RESPONSE_ERROR;
+		break;
+	case 2: // \r\nOK\r\n
+	case 3: // \r\nSEND OK\r\n
+		desc->response = RESPONSE_OK;
+		break;
+	default:
+		return ;
+	}
+
+	/* The result buffer may have been cleared meanwhile */
+	desc->result.len -= min(responses[i].len, desc->result.len);
+	memset(desc->resp_idx, 0, sizeof(desc->resp_idx));
+}
+
+/*
+ * Check the messages sent by the module for AT_SEND_BUFFERED:
+ * "Recv <len> bytes" when the payload was received and
+ * "[<link>,]<segment>,SEND OK" or "SEND FAIL" when a segment was sent.
+ * Like the +IPD header, the acknowledge is parsed as it is received, starting
+ * at the beginning of a line, and removed from the result buffer once matched.
+ */
+static void is_send_message(struct at_desc *desc, uint8_t ch)
+{
+	const static struct at_buff send_msgs[NB_SEND_MESSAGES] = {
+		{PUI8(" bytes\r\n"), 8},
+		{PUI8("SEND OK\r\n"), 9},
+		{PUI8("SEND FAIL\r\n"), 11}
+	};
+	uint32_t	i;
+	uint32_t	id;
+
+	if (match_message(&send_msgs[0], &desc->send_idx[0], ch)) {
+		desc->send_idx[0] = 0;
+		desc->payload_received = true;
+		return ;
+	}
+
+	desc->ack_len++;
+	switch (desc->ack_stat) {
+	case ACK_LINE_START:
+		if (ch < '0' || ch > '9')
+			goto reset;
+		if (desc->multiple_conections) {
+			if (ch >= '0' + MAX_CONNECTIONS)
+				goto reset;
+			desc->ack_conn = ch - '0';
+			desc->ack_stat = ACK_WAITING_COMMA;
+		} else {
+			desc->ack_conn = 0;
+			desc->ack_stat = ACK_READING_SEG;
+		}
+		break;
+	case ACK_WAITING_COMMA:
+		if (ch != ',')
+			goto reset;
+		desc->ack_stat = ACK_WAITING_SEG;
+		break;
+	case ACK_WAITING_SEG:
+		if (ch < '0' || ch > '9')
+			goto reset;
+		desc->ack_stat = ACK_READING_SEG;
+		break;
+	case ACK_READING_SEG:
+		if (ch == ',')
+			desc->ack_stat = ACK_READING_STATUS;
+		else if (ch < '0' || ch > '9')
+			goto reset;
+		break;
+	case ACK_READING_STATUS:
+		for (i = 1; i < NB_SEND_MESSAGES; i++)
+			if (match_message(&send_msgs[i], &desc->send_idx[i], ch))
+				break;
+
+		if (i == NB_SEND_MESSAGES) {
+			if (!desc->send_idx[1] && !desc->send_idx[2])
+				goto reset;
+			break;
+		}
+
+		/* The result buffer may have been cleared meanwhile */
+		desc->result.len -= min(desc->ack_len, desc->result.len);
+
+		id = desc->ack_conn;
+		if (desc->send_acked[id] != desc->send_queued[id])
+			desc->send_acked[id]++;
+		if (i == 2)
+			desc->send_failed[id] = true;
+		goto reset;
+	default:
+		goto reset;
+	}
+
+	return ;
+reset:
+	desc->send_idx[1] = 0;
+	desc->send_idx[2] = 0;
+	desc->ack_len = 0;
+	desc->ack_stat = ch == '\n' ? ACK_LINE_START : ACK_NOT_MATCH;
+}
+
+/*
+ * Return true if ch can start one of the messages matched by
+ * is_payload_message, is_async_messages, is_response_message or
+ * is_send_message, or is the AT_SEND prompt. '\n' starts the line of a
+ * buffered send acknowledge. Must be kept in sync with the message tables.
+ */
+static inline bool is_message_start(uint8_t ch)
+{
+	return ch == '\r' || ch == '\n' || ch == 'C' || ch == 'W' ||
+	       ch == '>' || ch == ' ';
+}
+
+/* True if no message is partially matched */
+static inline bool matchers_idle(struct at_desc *desc)
+{
+	uint32_t i;
+
+	if (desc->ipd_idx || desc->ack_stat != ACK_NOT_MATCH)
+		return false;
+	for (i = 0; i < NB_ASYNC_MESSAGES; i++)
+		if (desc->async_idx[i])
+			return false;
+	for (i = 0; i < NB_RESPONSE_MESSAGES; i++)
+		if (desc->resp_idx[i])
+			return false;
+	for (i = 0; i < NB_SEND_MESSAGES; i++)
+		if (desc->send_idx[i])
+			return false;
+
+	return true;
+}
+
+/* Notify the application about a new connection if not active */
+static void open_conn(struct at_desc *desc)
+{
+	struct connection_desc	*conn;
+
+	conn = &desc->conn[desc->current_conn];
+	if (conn->active)
+		return ;
+
+	/*
+	 * Notify that a new connection has started. Application needs
+	 * to set a cbuff for the connection where data will be written.
+	 */
+	desc->connection_callback(desc->callback_ctx, AT_NEW_CONNECTION,
+				  desc->current_conn, &conn->cbuff);
+	if (conn->cbuff)
+		conn->active = true;
+	/*
+	 * Else, a AT_STOP_CONNECTION command should be sent to the
+	 * esp8266 module. (Application rejects the connection)
+	 * This could be done only if implement at_run_cmd with
+	 * uart_write_nonblocking
+	 */
+}
+
 /* Mark the circular buffer transaction as ended */
 static inline void end_conn_read(struct at_desc *desc)
 {
@@ -375,24 +598,8 @@ static inline void start_conn_read(struct at_desc *desc, bool is_new_message)
 
 	conn = &desc->conn[desc->current_conn];
 
-	if (is_new_message && !conn->active) {
-		/*
-		 * Notify that a new connection has started. Application needs
-		 * to set a cbuff for the connection where data will be written.
-		 */
-		desc->connection_callback(desc->callback_ctx,
-					  AT_NEW_CONNECTION,
-					  desc->current_conn,
-					  &conn->cbuff);
-		if (conn->cbuff)
-			conn->active = true;
-		/*
-		 * Else, a AT_STOP_CONNECTION command should be sent to the
-		 * esp8266 module. (Application rejects the connection)
-		 * This could be done only if implement at_run_cmd with
-		 * uart_write_nonblocking
-		 */
-	}
+	if (is_new_message)
+		open_conn(desc);
 
 	if (!conn->cbuff)
 		/* There is no buffer set for this connection */
@@ -416,39 +623,155 @@ dummy_read:
 	conn->to_read -= 1;
 }
 
-/* Handle the uart events */
-static void at_callback(struct at_desc *desc, uint32_t event, uint8_t *data)
+/*
+ * Interpret one char received while not reading payload. Return true if an
+ * +IPD message was completed and the payload follows.
+ */
+static bool parse_char(struct at_desc *desc, uint8_t ch)
 {
 	static const struct at_buff ready_msg = {PUI8("ready\r\n"), 7};
 
+	if (desc->callback_operation == RESETTING_MODULE) {
+		if (match_message(&ready_msg, &desc->ready_idx, ch))
+			desc->callback_operation = READING_RESPONSES;
+		return false;
+	}
+
+	if (is_payload_message(desc, ch))
+		return true;
+
+	if (ch == '>' && desc->callback_operation == WAITING_SEND) {
+		desc->callback_operation = READING_RESPONSES;
+	} else if (desc->result.len >= RESULT_BUFF_LEN) {
+		desc->errors |= AT_ERROR_INTERNAL_BUFFER_OVERFLOW;
+		desc->result.len = 0;
+		/* The partially matched responses are lost */
+		memset(desc->resp_idx, 0, sizeof(desc->resp_idx));
+	} else if (is_async_messages(desc, ch)) {
+		/* The message ended a line, an acknowledge may follow */
+		desc->ack_stat = ACK_LINE_START;
+	} else {
+		/* Add received character to result buffer */
+		desc->result.buff[desc->result.len++] = ch;
+		is_response_message(desc, ch);
+		is_send_message(desc, ch);
+	}
+
+	return false;
+}
+
+/*
+ * Copy to the result buffer the chars that can't start any message. Only
+ * done when no message is partially matched, so the matchers state is the
+ * same as if the chars were parsed one by one. Return the number of chars
+ * consumed.
+ */
+static uint32_t copy_plain(struct at_desc *desc, const uint8_t *data,
+			   uint32_t len)
+{
+	uint32_t	n;
+	uint32_t	i;
+	uint32_t	cnt;
+
+	if (desc->callback_operation == RESETTING_MODULE ||
+	    !matchers_idle(desc))
+		return 0;
+
+	n = 0;
+	while (n < len && !is_message_start(data[n]))
+		n++;
+
+	i = 0;
+	while (i < n) {
+		cnt = min(n - i, RESULT_BUFF_LEN - desc->result.len);
+		if (!cnt) {
+			/* Same as parse_char, the char is dropped */
+			desc->errors |= AT_ERROR_INTERNAL_BUFFER_OVERFLOW;
+			desc->result.len = 0;
+			i++;
+			continue;
+		}
+		memcpy(desc->result.buff + desc->result.len, data + i, cnt);
+		desc->result.len += cnt;
+		i += cnt;
+	}
+
+	return n;
+}
+
+/*
+ * Copy payload from a received chunk to the connection buffer. Return the
+ * number of chars consumed.
+ */
+static uint32_t copy_payload(struct at_desc *desc, const uint8_t *data,
+			     uint32_t len)
+{
+	struct connection_desc	*conn;
+	uint32_t		n;
+
+	if (desc->current_conn < 0) {
+		desc->callback_operation = READING_RESPONSES;
+		return 0;
+	}
+
+	conn = &desc->conn[desc->current_conn];
+	n = min(len, conn->to_read);
+	/* Data is discarded if there is no buffer set for this connection */
+	if (n && conn->cbuff)
+		cb_write(conn->cbuff, data, n);
+	conn->to_read -= n;
+	if (!conn->to_read) {
+		desc->callback_operation = READING_RESPONSES;
+		desc->current_conn = -1;
+	}
+
+	return n;
+}
+
+/* Parse a chunk of received data */
+static void parse_chunk(struct at_desc *desc, const uint8_t *data,
+			uint32_t len)
+{
+	uint32_t n;
+
+	while (len) {
+		if (desc->callback_operation == READING_PAYLOAD) {
+			n = copy_payload(desc, data, len);
+		} else {
+			n = copy_plain(desc, data, len);
+			if (!n) {
+				n = 1;
+				if (parse_char(desc, *data)) {
+					desc->callback_operation =
+						READING_PAYLOAD;
+					open_conn(desc);
+				}
+			}
+		}
+		data += n;
+		len -= n;
+	}
+}
+
+/* Handle the uart events */
+static void at_callback(struct at_desc *desc, uint32_t event, uint8_t *data)
+{
 	switch (event) {
 	case READ_DONE:
+		/* In bulk mode data is received through at_rx_ring_update */
+		if (desc->rx_ring)
+			return ;
+
 		switch (desc->callback_operation) {
 		case RESETTING_MODULE:
-			if (match_message(&ready_msg, &desc->ready_idx,
-					  desc->read_ch))
-				desc->callback_operation = READING_RESPONSES;
-			break;
 		case WAITING_SEND:
 		case READING_RESPONSES:
-			if (is_payload_message(desc, desc->read_ch)) {
+			if (parse_char(desc, desc->read_ch)) {
 				/* New payload received */
 				desc->callback_operation = READING_PAYLOAD;
 				start_conn_read(desc, true);
 				return ;
 			}
-
-			if (desc->read_ch == '>' && desc->callback_operation ==
-			    WAITING_SEND) {
-				desc->callback_operation = READING_RESPONSES;
-			} else if (desc->result.len >= RESULT_BUFF_LEN) {
-				desc->errors |=
-					AT_ERROR_INTERNAL_BUFFER_OVERFLOW;
-				desc->result.len = 0;
-			} else if (!is_async_messages(desc, desc->read_ch))
-				/* Add received character to result buffer */
-				desc->result.buff[desc->result.len++] =
-					desc->read_ch;
 			break;
 		case READING_PAYLOAD:
 			/* Receiving payload from connection */
@@ -467,6 +790,8 @@ static void at_callback(struct at_desc *desc, uint32_t event, uint8_t *data)
 	case ERROR:
 		if (desc->callback_operation != RESETTING_MODULE)
 			desc->errors |= AT_ERROR_UART;
+		if (desc->rx_ring)
+			return ;
 		break;
 	default:
 		/* We never have to get here */
@@ -479,52 +804,92 @@ static void at_callback(struct at_desc *desc, uint32_t event, uint8_t *data)
 /* Wait the response for the last command for MODULE_TIMEOUT milliseconds */
 static int32_t wait_for_response(struct at_desc *desc)
 {
-	const static struct at_buff responses[NB_RESPONSE_MESSAGES] = {
-		{PUI8("\r\nERROR\r\n"), 9},
-		{PUI8("\r\nFAIL\r\n"), 8},
-		{PUI8("\r\nOK\r\n"), 6},
-		{PUI8("\r\nSEND OK\r\n"), 11}
-	};
 	uint32_t	timeout;
-	uint32_t	result;
-	uint32_t	i;
-	uint32_t	j;
 
-	i = 0;
-	timeout = MODULE_TIMEOUT;
-	result = FAILURE;
-	do {
-		if (i < desc->result.len) {
-			for (j = 0; j < NB_RESPONSE_MESSAGES; j++)
-				if (match_message(&responses[j],
-						  &desc->resp_idx[j],
-						  desc->result.buff[i]))
-					break;
+	timeout = MODULE_TIMEOUT * (1000u / RESPONSE_POLL_US);
+	while (desc->response == RESPONSE_NONE && --timeout)
+		udelay(RESPONSE_POLL_US);
 
-			i++;
-			switch (j) {
-			case 0: // \r\nERROR\r\n
-			case 1: // \r\nFAIL\r\n
-				result = FAILURE;
-				goto end;
-			case 2: // \r\nOK\r\n
-			case 3: // \r\nSEND OK\r\n
-				result = SUCCESS;
-				goto end;
-			default:
-				break;
-			}
-		}
-		mdelay(1);
-	} while (--timeout);
+	return desc->response == RESPONSE_OK ? SUCCESS : FAILURE;
+}
 
-end:
-	if (timeout) //If a response arrived clean the result
-		desc->result.len -= desc->resp_idx[j];
+/* Wait until the '>' prompt of AT_SEND is received */
+static int32_t wait_for_prompt(struct at_desc *desc)
+{
+	uint32_t	timeout;
 
-	memset(desc->resp_idx, 0, sizeof(desc->resp_idx));
+	timeout = MODULE_TIMEOUT * (1000u / RESPONSE_POLL_US);
+	while (desc->callback_operation == WAITING_SEND && --timeout)
+		udelay(RESPONSE_POLL_US);
+
+	return timeout ? SUCCESS : FAILURE;
+}
+
+/* Wait until less than window buffered sends are in flight on connection */
+static int32_t wait_send_window(struct at_desc *desc, uint32_t id,
+				uint32_t window)
+{
+	uint32_t	timeout;
+
+	timeout = MODULE_TIMEOUT * (1000u / RESPONSE_POLL_US);
+	while (desc->send_queued[id] - desc->send_acked[id] >= window &&
+	       --timeout)
+		udelay(RESPONSE_POLL_US);
+	if (!timeout)
+		return FAILURE;
+
+	/* Report a failed segment once */
+	if (desc->send_failed[id]) {
+		desc->send_failed[id] = false;
+		return FAILURE;
+	}
 
-	return result;
+	return SUCCESS;
+}
+
+/* Send the command and the payload of AT_SEND and AT_SEND_BUFFERED */
+static int32_t send_data(struct at_desc *desc, enum at_cmd cmd,
+			 union in_param *in_param)
+{
+	uint32_t	timeout;
+	uint32_t	id;
+
+	id = desc->multiple_conections ? in_param->send_data.id : 0;
+	if (id >= MAX_CONNECTIONS)
+		return FAILURE;
+
+	if (cmd == AT_SEND_BUFFERED)
+		if (SUCCESS != wait_send_window(desc, id, AT_SEND_WINDOW))
+			return FAILURE;
+
+	desc->callback_operation = WAITING_SEND;
+	desc->response = RESPONSE_NONE;
+	uart_write(desc->uart_desc, desc->cmd.buff, desc->cmd.len);
+	/* Waiting for ok and '>' */
+	if (SUCCESS != wait_for_response(desc) ||
+	    SUCCESS != wait_for_prompt(desc)) {
+		desc->callback_operation = READING_RESPONSES;
+		return FAILURE;
+	}
+
+	/* Write payload */
+	desc->response = RESPONSE_NONE;
+	desc->payload_received = false;
+	if (cmd == AT_SEND_BUFFERED)
+		desc->send_queued[id]++;
+	uart_write(desc->uart_desc, in_param->send_data.data.buff,
+		   in_param->send_data.data.len);
+
+	if (cmd == AT_SEND)
+		/* Wait for SEND OK */
+		return wait_for_response(desc);
+
+	/* SEND OK will be handled by the callback. Wait for Recv x bytes */
+	timeout = MODULE_TIMEOUT * (1000u / RESPONSE_POLL_US);
+	while (!desc->payload_received && --timeout)
+		udelay(RESPONSE_POLL_US);
+
+	return timeout ? SUCCESS : FAILURE;
 }
 
 /* Send what is in desc->cmd over the UART and handle special case of AT_SEND */
@@ -533,24 +898,12 @@ static int32_t send_cmd(struct at_desc *desc, enum at_cmd cmd,
 {
 	uint32_t timeout = MODULE_TIMEOUT;
 
+	if (cmd == AT_SEND || cmd == AT_SEND_BUFFERED)
+		return send_data(desc, cmd, in_param);
+
+	desc->response = RESPONSE_NONE;
 	uart_write(desc->uart_desc, desc->cmd.buff, desc->cmd.len);
-	if (cmd == AT_SEND) {
-		desc->callback_operation = WAITING_SEND;
-		/* Waiting for ok */
-		if (SUCCESS != wait_for_response(desc))
-			return FAILURE;
-		/* Wait until '>' is received */
-		while (timeout--) {
-			if (WAITING_SEND != desc->callback_operation)
-				break;
-			mdelay(1);
-		}
-		if (timeout == 0)
-			return FAILURE;
-		/* Write payload */
-		uart_write(desc->uart_desc, in_param->send_data.data.buff,
-			   in_param->send_data.data.len);
-	} else if (cmd == AT_DISCONNECT_NETWORK) {
+	if (cmd == AT_DISCONNECT_NETWORK) {
 		if (desc->is_wifi_connected) {
 			/* Wait for WIFI_DISCONNECT */
 			do {
@@ -566,7 +919,7 @@ static int32_t send_cmd(struct at_desc *desc, enum at_cmd cmd,
 		}
 	}
 
-	/* Wait for OK, SEND OK or ERROR */
+	/* Wait for OK or ERROR */
 	return wait_for_response(desc);
 }
 
@@ -711,6 +1064,15 @@ static void concat_cmd_param(struct at_desc *desc, enum at_cmd cmd,
 					(int32_t)param->send_data.remote_port);
 		}
 		break;
+	case AT_SEND_BUFFERED:
+		if (desc->multiple_conections)
+			set_params(&desc->cmd, PUI8("dd"),
+				   (int32_t)param->send_data.id,
+				   (int32_t)param->send_data.data.len);
+		else
+			set_params(&desc->cmd, PUI8("d"),
+				   (int32_t)param->send_data.data.len);
+		break;
 	case AT_STOP_CONNECTION:
 		set_params(&desc->cmd, PUI8("d"), param->conn_id);
 		break;
@@ -777,6 +1139,7 @@ static void build_cmd(struct at_desc *desc, enum at_cmd cmd,
 /* Send ATE0 command to stop echo */
 static int32_t stop_echo(struct at_desc *desc)
 {
+	desc->response = RESPONSE_NONE;
 	uart_write(desc->uart_desc, (uint8_t *)"ATE0\r\n", 6);
 
 	if (SUCCESS != wait_for_response(desc))
@@ -790,6 +1153,7 @@ static int32_t stop_echo(struct at_desc *desc)
 static int32_t handle_special(struct at_desc *desc, enum at_cmd cmd)
 {
 	uint32_t timeout;
+	uint32_t i;
 
 	switch (cmd) {
 	case AT_RESET:
@@ -807,6 +1171,9 @@ static int32_t handle_special(struct at_desc *desc, enum at_cmd cmd)
 
 		desc->callback_operation = READING_PAYLOAD;
 		desc->result.len = 0;
+		/* Pending buffered sends were lost */
+		for (i = 0; i < MAX_CONNECTIONS; i++)
+			desc->send_acked[i] = desc->send_queued[i];
 		if (SUCCESS != stop_echo(desc))
 			return FAILURE;
 		at_run_cmd(desc, AT_DISCONNECT_NETWORK, AT_EXECUTE_OP, NULL);
@@ -925,6 +1292,10 @@ int32_t at_init(struct at_desc **desc, const struct at_init_param *param)
 	ldesc->uart_desc = param->uart_desc;
 	ldesc->irq_desc = param->irq_desc;
 	ldesc->uart_irq_id = param->uart_irq_id;
+	ldesc->rx_ring = param->rx_ring;
+	ldesc->rx_ring_size = param->rx_ring_size;
+	if (ldesc->rx_ring && !ldesc->rx_ring_size)
+		goto free_desc;
 	callback_desc.callback =
 		(void (*)(void*, uint32_t, void*))at_callback;
 	callback_desc.ctx = ldesc;
@@ -937,17 +1308,22 @@ int32_t at_init(struct at_desc **desc, const struct at_init_param *param)
 	if (SUCCESS != irq_enable(ldesc->irq_desc, ldesc->uart_irq_id))
 		goto free_irq;
 
-	/* The read will be handled by the callback */
-	uart_read_nonblocking(ldesc->uart_desc, &ldesc->read_ch, 1);
-
 	/* Link buffer structure with static buffers */
 	ldesc->result.buff = ldesc->buffers.result_buff;
 	ldesc->result.len = 0;
 	ldesc->cmd.buff = ldesc->buffers.cmd_buff;
 	ldesc->cmd.len = CMD_BUFF_LEN;
 
+	ldesc->current_conn = -1;
 	ldesc->callback_operation = READING_RESPONSES;
 
+	/*
+	 * The read will be handled by the callback. In bulk mode the platform
+	 * calls at_rx_ring_update instead.
+	 */
+	if (!ldesc->rx_ring)
+		uart_read_nonblocking(ldesc->uart_desc, &ldesc->read_ch, 1);
+
 	/* Disable echoing response */
 	if (SUCCESS != stop_echo(ldesc))
 		goto free_irq;
@@ -998,6 +1374,72 @@ int32_t at_remove(struct at_desc *desc)
 	return SUCCESS;
 }
 
+/**
+ * @brief Wait for all \ref AT_SEND_BUFFERED segments of a connection to be
+ * acknowledged by the module
+ * @param desc - AT parser reference
+ * @param conn_id - Connection id. 0 in single connection mode
+ * @return
+ *  - \ref SUCCESS : On success
+ *  - \ref FAILURE : On timeout or if a segment failed to be sent
+ */
+int32_t at_send_flush(struct at_desc *desc, uint32_t conn_id)
+{
+	if (!desc || conn_id >= MAX_CONNECTIONS)
+		return FAILURE;
+
+	return wait_send_window(desc, conn_id, 1);
+}
+
+/**
+ * @brief Parse a chunk of data received from the module.
+ * Used in bulk receive mode. Payload from +IPD messages is copied directly to
+ * the connection buffers and the rest is scanned for responses and
+ * asynchronous messages. Must not be called concurrently with itself or with
+ * \ref at_rx_ring_update.
+ * @param desc - AT parser reference
+ * @param data - Received data
+ * @param len - Number of received bytes
+ * @return
+ *  - \ref SUCCESS : On success
+ *  - \ref FAILURE : Otherwise
+ */
+int32_t at_rx_chunk(struct at_desc *desc, const uint8_t *data, uint32_t len)
+{
+	if (!desc || !desc->rx_ring || (!data && len))
+		return FAILURE;
+
+	parse_chunk(desc, data, len);
+
+	return SUCCESS;
+}
+
+/**
+ * @brief Parse the data written by the DMA in the bulk receive ring.
+ * Call from the DMA half/full transfer and UART idle-line interrupts.
+ * @param desc - AT parser reference
+ * @param head - Index in rx_ring where the DMA will write the next byte
+ * @return
+ *  - \ref SUCCESS : On success
+ *  - \ref FAILURE : Otherwise
+ */
+int32_t at_rx_ring_update(struct at_desc *desc, uint32_t head)
+{
+	if (!desc || !desc->rx_ring || head >= desc->rx_ring_size)
+		return FAILURE;
+
+	if (head < desc->rx_tail) {
+		/* DMA wrapped around */
+		parse_chunk(desc, desc->rx_ring + desc->rx_tail,
+			    desc->rx_ring_size - desc->rx_tail);
+		desc->rx_tail = 0;
+	}
+	parse_chunk(desc, desc->rx_ring + desc->rx_tail, head - desc->rx_tail);
+	desc->rx_tail = head;
+
+	return SUCCESS;
+}
+
 /**
  * @brief Convert null terminated string to at_buff
  * @param dest - Destination buffer
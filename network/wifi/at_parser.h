@@ -101,6 +101,13 @@
 #define MAX_CONNECTIONS				4
 /** @brief Maximum data to send on a chipsend command */
 #define MAX_CIPSEND_DATA			2048
+/**
+ * @brief Maximum number of \ref AT_SEND_BUFFERED segments per connection
+ * waiting to be acknowledged by the module
+ */
+#ifndef AT_SEND_WINDOW
+#define AT_SEND_WINDOW				4
+#endif
 
 /* Remove comment when implementing parsing result */
 //#define PARSE_RESULT
@@ -216,7 +223,15 @@ enum at_cmd {
 	 *  Ping
 	 *  Use \ref in_param.ping_ip as set parameter
 	 */
-	AT_PING				// "+PING"
+	AT_PING,			// "+PING"
+	/**
+	 * Send data over a TCP connection using the module send buffer.
+	 * Returns when the module has received the data, without waiting for
+	 * it to be sent. Acknowledgements are handled in the background, at
+	 * most \ref AT_SEND_WINDOW segments can be in flight.
+	 * Use \ref in_param.send_data as set parameter
+	 */
+	AT_SEND_BUFFERED		// "+CIPSENDBUF"
 };
 
 /**
@@ -329,6 +344,15 @@ struct at_init_param {
 			enum at_event event,
 			uint32_t conn_id,
 			struct circular_buffer **cb);
+	/*
+	 * Optional bulk receive buffer. When set, the parser stops arming one
+	 * byte UART reads. The platform must run a circular DMA receive into
+	 * rx_ring and call \ref at_rx_ring_update with the DMA write position
+	 * from its half/full transfer and idle-line interrupts.
+	 */
+	uint8_t			*rx_ring;
+	/* Size of rx_ring in bytes */
+	uint32_t		rx_ring_size;
 };
 
 /**
@@ -349,6 +373,12 @@ int32_t at_remove(struct at_desc *desc);
 /* Execute an AT command */
 int32_t at_run_cmd(struct at_desc *desc, enum at_cmd cmd, enum cmd_operation op,
 		   union in_out_param *param);
+/* Wait for all buffered sends on a connection to be acknowledged */
+int32_t at_send_flush(struct at_desc *desc, uint32_t conn_id);
+/* Feed a chunk of received bytes to the parser (bulk receive mode) */
+int32_t at_rx_chunk(struct at_desc *desc, const uint8_t *data, uint32_t len);
+/* Consume the bulk receive ring up to the DMA write position */
+int32_t at_rx_ring_update(struct at_desc *desc, uint32_t head);
 /* Convert null terminated string to at_buff */
 int32_t str_to_at(struct at_buff *dest, const uint8_t *src);
 /* Convert at_buff to null terminated string */
@@ -109,6 +109,14 @@ struct wifi_desc {
 	struct network_interface	interface;
 	/* Will be used in callback */
 	int32_t				conn_id_to_sock_id[MAX_CONNECTIONS];
+	/* Support of the module for AT_SEND_BUFFERED */
+	enum {
+		/* No buffered send done yet */
+		SEND_BUFFERED_UNKNOWN,
+		SEND_BUFFERED_SUPPORTED,
+		/* Module firmware without +CIPSENDBUF. Use AT_SEND */
+		SEND_BUFFERED_UNSUPPORTED
+	}				send_buffered;
 };
 
 /******************************************************************************/
@@ -620,6 +628,9 @@ static int32_t wifi_socket_disconnect(struct wifi_desc *desc, uint32_t sock_id)
 		/* Remove server reference */
 		desc->server.id = INVALID_ID;
 	} else {
+		/* Let the buffered data to be sent before closing */
+		if (desc->send_buffered == SEND_BUFFERED_SUPPORTED)
+			at_send_flush(desc->at, sock->conn_id);
 		param.in.conn_id = sock->conn_id;
 		ret = at_run_cmd(desc->at, AT_STOP_CONNECTION, AT_SET_OP,
 				 &param);
@@ -640,6 +651,7 @@ static int32_t wifi_socket_send(struct wifi_desc *desc, uint32_t sock_id,
 	union in_out_param	param;
 	uint32_t		ret;
 	struct socket_desc	*sock;
+	enum at_cmd		cmd;
 	uint32_t		to_send;
 	uint32_t		i;
 
@@ -650,15 +662,33 @@ static int32_t wifi_socket_send(struct wifi_desc *desc, uint32_t sock_id,
 	if (sock->state != SOCKET_CONNECTED)
 		return -ENOTCONN;
 
+	/*
+	 * TCP data is sent through the module buffer when available so the
+	 * next chunk can be sent without waiting for SEND OK.
+	 */
+	cmd = AT_SEND;
+	if (sock->type == PROTOCOL_TCP &&
+	    desc->send_buffered != SEND_BUFFERED_UNSUPPORTED)
+		cmd = AT_SEND_BUFFERED;
+
 	i = 0;
 	do {
 		to_send = min(size - i, MAX_CIPSEND_DATA);
 		param.in.send_data.id = sock->conn_id;
 		param.in.send_data.data.buff = ((uint8_t *)data) + i;
 		param.in.send_data.data.len = to_send;
-		ret = at_run_cmd(desc->at, AT_SEND, AT_SET_OP, &param);
+		ret = at_run_cmd(desc->at, cmd, AT_SET_OP, &param);
+		if (IS_ERR_VALUE(ret) && cmd == AT_SEND_BUFFERED &&
+		    desc->send_buffered == SEND_BUFFERED_UNKNOWN) {
+			/* First buffered send failed. Fall back to AT_SEND */
+			desc->send_buffered = SEND_BUFFERED_UNSUPPORTED;
+			cmd = AT_SEND;
+			continue;
+		}
 		if (IS_ERR_VALUE(ret))
 			return ret;
+		if (cmd == AT_SEND_BUFFERED)
+			desc->send_buffered = SEND_BUFFERED_SUPPORTED;
 
 		i += to_send;
 	} while (i < size);
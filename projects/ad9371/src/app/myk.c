@@ -491,8 +491,8 @@ static spiSettings_t mykSpiSettings =
     1, /* 1 = MSBFirst, 0 = LSBFirst */
     0, /* clock phase, sets which clock edge the data updates (valid 0 or 1) */
     0, /* clock polarity 0 = clock starts low, 1 = clock starts high */
-    0, /* Not implemented in ADIs platform layer. SW feature to improve SPI throughput */
-    1, /* Not implemented in ADIs platform layer. For SPI Streaming, set address increment direction. 1= next addr = addr+1, 0:addr=addr-1 */
+    1, /* SW feature to improve SPI throughput */
+    1, /* For SPI Streaming, set address increment direction. 1= next addr = addr+1, 0:addr=addr-1 */
     1  /* 1: Use 4-wire SPI, 0: 3-wire SPI (SDIO pin is bidirectional). NOTE: ADI's FPGA platform always uses 4-wire mode */
 };
 
@@ -11,6 +11,7 @@
 */
 
 #include <stdio.h>
+#include <string.h>
 #include <time.h>
 #include <errno.h>
 #include <stdint.h>
@@ -28,6 +29,15 @@
 #include <xparameters.h>
 #endif
 
+#define CMB_SPI_CONFIG_A		0x0000
+#define CMB_SPI_CONFIG_B		0x0001
+#define CMB_SPI_ADDR_ASCENSION		0x20
+#define CMB_SPI_SINGLE_INSTRUCTION	0x80
+/* Number of chip selects whose SPI configuration is tracked */
+#define CMB_SPI_MAX_CS			8
+/* Maximum number of data bytes sent in one streaming transfer */
+#define CMB_SPI_MAX_STREAM		256
+
 ADI_LOGLEVEL CMB_LOGLEVEL = ADIHAL_LOG_NONE;
 
 static uint32_t _desired_time_to_elapse_us = 0;
@@ -36,6 +46,59 @@ struct gpio_desc	*gpio_ad9371_resetb;
 struct gpio_desc	*gpio_ad9528_resetb;
 struct gpio_desc	*gpio_ad9528_sysref_req;
 
+/* SPI streaming state of each device, tracked from its SPI configuration
+ * writes. Both AD9371 and AD9528 start in single instruction mode. */
+static uint8_t _spi_config_a[CMB_SPI_MAX_CS];
+static uint8_t _spi_config_b[CMB_SPI_MAX_CS];
+
+/*
+ * Track the device SPI configuration to know if streaming (multiple bytes
+ * with auto incremented/decremented address in one transfer) is enabled.
+ */
+static void CMB_SPITrackConfig(uint8_t chipSelectIndex, uint16_t addr,
+			       uint8_t data)
+{
+	if (!chipSelectIndex || chipSelectIndex > CMB_SPI_MAX_CS)
+		return;
+
+	if (addr == CMB_SPI_CONFIG_A)
+		_spi_config_a[chipSelectIndex - 1] = data;
+	else if (addr == CMB_SPI_CONFIG_B)
+		_spi_config_b[chipSelectIndex - 1] = data;
+}
+
+/*
+ * Get the length of the run of consecutive addresses starting at addr[0] that
+ * can be sent in one streaming transfer. Returns 1 if streaming is not
+ * possible.
+ */
+static uint32_t CMB_SPIStreamRun(uint8_t chipSelectIndex, uint16_t *addr,
+				 uint32_t count)
+{
+	uint32_t run = 1;
+	int32_t step;
+
+	if (!chipSelectIndex || chipSelectIndex > CMB_SPI_MAX_CS)
+		return 1;
+
+	if (_spi_config_b[chipSelectIndex - 1] & CMB_SPI_SINGLE_INSTRUCTION)
+		return 1;
+
+	step = (_spi_config_a[chipSelectIndex - 1] & CMB_SPI_ADDR_ASCENSION) ?
+	       1 : -1;
+
+	/* The SPI configuration registers are always accessed one by one */
+	if (addr[0] <= CMB_SPI_CONFIG_B)
+		return 1;
+
+	while (run < count && run < CMB_SPI_MAX_STREAM &&
+	       addr[run] == (uint16_t)(addr[run - 1] + step) &&
+	       addr[run] > CMB_SPI_CONFIG_B)
+		run++;
+
+	return run;
+}
+
 int32_t platform_init(void)
 {
 	struct spi_init_param spi_param;
@@ -107,6 +170,9 @@ int32_t platform_init(void)
 
 	status |= spi_init(&spi_ad_desc, &spi_param);
 
+	memset(_spi_config_a, 0, sizeof(_spi_config_a));
+	memset(_spi_config_b, CMB_SPI_SINGLE_INSTRUCTION, sizeof(_spi_config_b));
+
 	return status;
 }
 
@@ -155,6 +221,12 @@ commonErr_t CMB_hardReset(uint8_t spiChipSelectIndex)
 	gpio_direction_output(reset_gpio, 1);
 	CMB_wait_ms(1);
 
+	/* The device is back in single instruction mode */
+	if (spiChipSelectIndex && spiChipSelectIndex <= CMB_SPI_MAX_CS) {
+		_spi_config_a[spiChipSelectIndex - 1] = 0;
+		_spi_config_b[spiChipSelectIndex - 1] = CMB_SPI_SINGLE_INSTRUCTION;
+	}
+
 	return(COMMONERR_OK);
 }
 
@@ -181,18 +253,37 @@ commonErr_t CMB_SPIWriteByte(spiSettings_t *spiSettings, uint16_t addr,
 
 	spi_write_and_read(spi_ad_desc, buf, 3);
 
+	CMB_SPITrackConfig(spiSettings->chipSelectIndex, addr, data);
+
 	return(COMMONERR_OK);
 }
 
 commonErr_t CMB_SPIWriteBytes(spiSettings_t *spiSettings, uint16_t *addr,
 			      uint8_t *data, uint32_t count)
 {
+	uint8_t buf[2 + CMB_SPI_MAX_STREAM];
 	uint32_t index;
+	uint32_t run;
+
+	for (index = 0; index < count; index += run) {
+		run = CMB_SPIStreamRun(spiSettings->chipSelectIndex,
+				       addr + index, count - index);
+		if (run == 1) {
+			if (CMB_SPIWriteByte(spiSettings, *(addr + index),
+					     *(data + index)) != COMMONERR_OK)
+				return(COMMONERR_FAILED);
+			continue;
+		}
 
-	for (index = 0; index < count; index++)
-		if (CMB_SPIWriteByte(spiSettings, *(addr + index),
-				     *(data + index)) != COMMONERR_OK)
+		spi_ad_desc->chip_select = spiSettings->chipSelectIndex - 1;
+
+		buf[0] = (uint8_t) ((addr[index] >> 8) & 0x7f);
+		buf[1] = (uint8_t) (addr[index] & 0xff);
+		memcpy(&buf[2], data + index, run);
+
+		if (spi_write_and_read(spi_ad_desc, buf, 2 + run) != 0)
 			return(COMMONERR_FAILED);
+	}
 
 	return(COMMONERR_OK);
 }
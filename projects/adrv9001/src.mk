@@ -32,6 +32,7 @@ SRCS += $(PLATFORM_DRIVERS)/xilinx_gpio.c \
 	$(PLATFORM_DRIVERS)/xilinx_spi.c \
 	$(PLATFORM_DRIVERS)/delay.c \
 	$(NO-OS)/util/util.c \
+	$(NO-OS)/util/crc16.c \
 	$(DRIVERS)/axi_core/axi_adc_core/axi_adc_core.c \
 	$(DRIVERS)/axi_core/axi_dac_core/axi_dac_core.c \
 	$(DRIVERS)/axi_core/axi_dmac/axi_dmac.c \
@@ -43,6 +44,7 @@ INCS +=	$(INCLUDE)/spi.h \
 	$(INCLUDE)/error.h \
 	$(INCLUDE)/delay.h \
 	$(INCLUDE)/util.h \
+	$(INCLUDE)/crc16.h \
 	$(INCLUDE)/print_log.h \
 	$(DRIVERS)/axi_core/axi_adc_core/axi_adc_core.h \
 	$(DRIVERS)/axi_core/axi_dac_core/axi_dac_core.h \
@@ -57,10 +57,14 @@ SRCS += $(NO-OS)/util/xml.c						\
 	$(NO-OS)/util/list.c						\
 	$(NO-OS)/iio/iio_axi_adc/iio_axi_adc.c				\
 	$(NO-OS)/iio/iio_axi_dac/iio_axi_dac.c                          \
+	$(NO-OS)/iio/iio_axi_jesd204_mon/iio_axi_jesd204_mon.c		\
+	$(DRIVERS)/axi_core/jesd204/axi_jesd204_mon.c			\
 	$(PLATFORM_DRIVERS)/uart.c					\
-	$(PLATFORM_DRIVERS)/irq.c
+	$(PLATFORM_DRIVERS)/irq.c					\
+	$(PLATFORM_DRIVERS)/timer.c
 endif
-SRCS +=	$(NO-OS)/util/util.c
+SRCS +=	$(NO-OS)/util/util.c						\
+	$(NO-OS)/util/init_sched.c
 ifeq (xilinx,$(strip $(PLATFORM)))
 SRCS += $(DRIVERS)/axi_core/jesd204/xilinx_transceiver.c		\
 	$(DRIVERS)/axi_core/jesd204/axi_adxcvr.c			\
@@ -137,15 +141,20 @@ INCS +=	$(INCLUDE)/axi_io.h						\
 	$(INCLUDE)/gpio.h						\
 	$(INCLUDE)/error.h						\
 	$(INCLUDE)/delay.h						\
-	$(INCLUDE)/util.h
+	$(INCLUDE)/util.h						\
+	$(INCLUDE)/init_sched.h
 ifeq (y,$(strip $(TINYIIOD)))
 INCS +=	$(INCLUDE)/xml.h						\
 	$(INCLUDE)/fifo.h						\
 	$(INCLUDE)/irq.h						\
+	$(INCLUDE)/timer.h						\
 	$(INCLUDE)/uart.h						\
 	$(INCLUDE)/list.h						\
 	$(PLATFORM_DRIVERS)/irq_extra.h					\
+	$(PLATFORM_DRIVERS)/timer_extra.h				\
 	$(PLATFORM_DRIVERS)/uart_extra.h                                \
 	$(NO-OS)/iio/iio_axi_adc/iio_axi_adc.h				\
-	$(NO-OS)/iio/iio_axi_dac/iio_axi_dac.h
+	$(NO-OS)/iio/iio_axi_dac/iio_axi_dac.h				\
+	$(NO-OS)/iio/iio_axi_jesd204_mon/iio_axi_jesd204_mon.h		\
+	$(DRIVERS)/axi_core/jesd204/axi_jesd204_mon.h
 endif
@@ -83,27 +83,22 @@ bool adrv9009_check_sysref_rate(uint32_t lmfc, uint32_t sysref)
 	return mod <= div || mod >= sysref - div;
 }
 
-adiHalErr_t talise_setup(taliseDevice_t * const pd, taliseInit_t * const pi)
+/*
+ * talise_setup() is split in stages, so that the waits for the RF PLL lock,
+ * the init calibrations and the JESD204 links can overlap with the bring-up
+ * of other devices. talise_setup_arm() closes the device when it fails. Once
+ * it succeeded, the device stays open whatever the result of the following
+ * stages and the caller closes it with talise_shutdown().
+ */
+
+/* Load the device, the stream processor and the ARM, then tune the RF PLL. */
+int32_t talise_setup_arm(taliseDevice_t * const pd, taliseInit_t * const pi)
 {
 	uint32_t talAction = TALACT_NO_ACTION;
-	uint8_t errorFlag = 0;
 	uint8_t mcsStatus = 0;
 	uint8_t pllLockStatus = 0;
-	uint16_t deframerStatus = 0;
-	uint8_t framerStatus = 0;
 	uint32_t count = sizeof(armBinary);
 	taliseArmVersionInfo_t talArmVersionInfo;
-	uint32_t initCalMask =  TAL_TX_BB_FILTER | TAL_ADC_TUNER |  TAL_TIA_3DB_CORNER |
-				TAL_DC_OFFSET | TAL_RX_GAIN_DELAY | TAL_FLASH_CAL |
-				TAL_PATH_DELAY | TAL_TX_LO_LEAKAGE_INTERNAL |
-				TAL_TX_QEC_INIT | TAL_LOOPBACK_RX_LO_DELAY |
-				TAL_LOOPBACK_RX_RX_QEC_INIT | TAL_RX_QEC_INIT |
-				TAL_ORX_QEC_INIT | TAL_TX_DAC  | TAL_ADC_STITCHING;
-	uint32_t trackingCalMask =  TAL_TRACK_RX1_QEC |
-				    TAL_TRACK_RX2_QEC |
-				    TAL_TRACK_TX1_QEC |
-				    TAL_TRACK_TX2_QEC;
-
 	uint32_t api_vers[4];
 	uint8_t rev;
 
@@ -244,15 +239,37 @@ adiHalErr_t talise_setup(taliseDevice_t * const pd, taliseInit_t * const pi)
 		goto error_11;
 	}
 
-	/*** < wait 200ms for PLLs to lock - user code here > ***/
-	mdelay(200);
+	return SUCCESS;
+
+error_11:
+	TALISE_closeHw(pd);
+error_0:
+	return FAILURE;
+}
+
+/* Check the lock of all the PLLs: 1 if locked, 0 if not yet. */
+int32_t talise_rf_pll_locked(taliseDevice_t * const pd)
+{
+	uint8_t pllLockStatus = 0;
+	uint32_t talAction;
 
 	talAction = TALISE_getPllsLockStatus(pd, &pllLockStatus);
-	if ((pllLockStatus & 0x07) != 0x07) {
-		/*< user code - ensure lock of all PLLs before proceeding>*/
-		printf("error: RFPLL not locked\n");
-		goto error_11;
-	}
+	if (talAction != TALACT_NO_ACTION)
+		return FAILURE;
+
+	return (pllLockStatus & 0x07) == 0x07;
+}
+
+/* Start the ARM initialization calibrations. */
+int32_t talise_setup_cals(taliseDevice_t * const pd)
+{
+	uint32_t talAction;
+	uint32_t initCalMask =  TAL_TX_BB_FILTER | TAL_ADC_TUNER |  TAL_TIA_3DB_CORNER |
+				TAL_DC_OFFSET | TAL_RX_GAIN_DELAY | TAL_FLASH_CAL |
+				TAL_PATH_DELAY | TAL_TX_LO_LEAKAGE_INTERNAL |
+				TAL_TX_QEC_INIT | TAL_LOOPBACK_RX_LO_DELAY |
+				TAL_LOOPBACK_RX_RX_QEC_INIT | TAL_RX_QEC_INIT |
+				TAL_ORX_QEC_INIT | TAL_TX_DAC  | TAL_ADC_STITCHING;
 
 	/****************************************************/
 	/**** Run Talise ARM Initialization Calibrations ***/
@@ -261,25 +278,44 @@ adiHalErr_t talise_setup(taliseDevice_t * const pd, taliseInit_t * const pi)
 	if (talAction != TALACT_NO_ACTION) {
 		/*** < User: decide what to do based on Talise recovery action returned > ***/
 		printf("error: TALISE_runInitCals() failed\n");
-		goto error_11;
+		return FAILURE;
 	}
 
-	talAction = TALISE_waitInitCals(pd, 20000, &errorFlag);
+	return SUCCESS;
+}
+
+/* Check the init calibrations: 1 if completed, 0 while running. */
+int32_t talise_cals_done(taliseDevice_t * const pd)
+{
+	uint32_t talAction;
+	uint8_t running = 0;
+	uint8_t errorFlag = 0;
+
+	talAction = TALISE_checkInitCalComplete(pd, &running, &errorFlag);
 	if (talAction != TALACT_NO_ACTION) {
-		/*** < User: decide what to do based on Talise recovery action returned > ***/
-		printf("error: TALISE_waitInitCals() failed\n");
-		goto error_11;
+		printf("error: TALISE_checkInitCalComplete() failed\n");
+		return FAILURE;
 	}
+	if (running)
+		return 0;
 
 	if (errorFlag) {
 		/*< user code - Check error flag to determine ARM  error> */
 		printf("error: Calibrations not completed\n");
-		goto error_11;
-	} else {
-		/*< user code - Calibrations completed successfully > */
-		printf("talise: Calibrations completed successfully\n");
+		return FAILURE;
 	}
 
+	/*< user code - Calibrations completed successfully > */
+	printf("talise: Calibrations completed successfully\n");
+
+	return 1;
+}
+
+/* Enable the framers and deframers and send SYSREF to bring the links up. */
+int32_t talise_setup_link(taliseDevice_t * const pd, taliseInit_t * const pi)
+{
+	uint32_t talAction = TALACT_NO_ACTION;
+
 	/***************************************************/
 	/**** Enable  Talise JESD204B Framer ***/
 	/***************************************************/
@@ -287,13 +323,13 @@ adiHalErr_t talise_setup(taliseDevice_t * const pd, taliseInit_t * const pi)
 		talAction = TALISE_enableFramerLink(pd, TAL_FRAMER_A, 0);
 		if (talAction != TALACT_NO_ACTION) {
 			printf("error: TALISE_enableFramerLink() failed\n");
-			goto error_11;
+			return FAILURE;
 		}
 
 		talAction |= TALISE_enableFramerLink(pd, TAL_FRAMER_A, 1);
 		if (talAction != TALACT_NO_ACTION) {
 			printf("error: TALISE_enableFramerLink() failed\n");
-			goto error_11;
+			return FAILURE;
 		}
 
 		/*************************************************/
@@ -304,7 +340,7 @@ adiHalErr_t talise_setup(taliseDevice_t * const pd, taliseInit_t * const pi)
 		talAction = TALISE_enableSysrefToFramer(pd, TAL_FRAMER_A, 1);
 		if (talAction != TALACT_NO_ACTION) {
 			printf("error: TALISE_enableSysrefToFramer() failed\n");
-			goto error_11;
+			return FAILURE;
 		}
 	}
 
@@ -315,13 +351,13 @@ adiHalErr_t talise_setup(taliseDevice_t * const pd, taliseInit_t * const pi)
 		talAction = TALISE_enableFramerLink(pd, TAL_FRAMER_B, 0);
 		if (talAction != TALACT_NO_ACTION) {
 			printf("error: TALISE_enableFramerLink() failed\n");
-			goto error_11;
+			return FAILURE;
 		}
 
 		talAction |= TALISE_enableFramerLink(pd, TAL_FRAMER_B, 1);
 		if (talAction != TALACT_NO_ACTION) {
 			printf("error: TALISE_enableFramerLink() failed\n");
-			goto error_11;
+			return FAILURE;
 		}
 
 		/*************************************************/
@@ -332,7 +368,7 @@ adiHalErr_t talise_setup(taliseDevice_t * const pd, taliseInit_t * const pi)
 		talAction = TALISE_enableSysrefToFramer(pd, TAL_FRAMER_B, 1);
 		if (talAction != TALACT_NO_ACTION) {
 			printf("error: TALISE_enableSysrefToFramer() failed\n");
-			goto error_11;
+			return FAILURE;
 		}
 	}
 
@@ -344,14 +380,14 @@ adiHalErr_t talise_setup(taliseDevice_t * const pd, taliseInit_t * const pi)
 		if (talAction != TALACT_NO_ACTION) {
 			/*** < User: decide what to do based on Talise recovery action returned > ***/
 			printf("error: TALISE_enableDeframerLink() failed\n");
-			goto error_11;
+			return FAILURE;
 		}
 
 		talAction |= TALISE_enableDeframerLink(pd, TAL_DEFRAMER_A, 1);
 		if (talAction != TALACT_NO_ACTION) {
 			/*** < User: decide what to do based on Talise recovery action returned > ***/
 			printf("error: TALISE_enableDeframerLink() failed\n");
-			goto error_11;
+			return FAILURE;
 		}
 		/***************************************************/
 		/**** Enable SYSREF to Talise JESD204B Deframer ***/
@@ -360,7 +396,7 @@ adiHalErr_t talise_setup(taliseDevice_t * const pd, taliseInit_t * const pi)
 		if (talAction != TALACT_NO_ACTION) {
 			/*** < User: decide what to do based on Talise recovery action returned > ***/
 			printf("error: TALISE_enableDeframerLink() failed\n");
-			goto error_11;
+			return FAILURE;
 		}
 	}
 
@@ -389,7 +425,19 @@ adiHalErr_t talise_setup(taliseDevice_t * const pd, taliseInit_t * const pi)
 
 	ADIHAL_sysrefReq(pd->devHalInfo, SYSREF_CONT_OFF);
 
-	mdelay(100);
+	return SUCCESS;
+}
+
+/* Check the links, enable the tracking calibrations and turn the radio on. */
+int32_t talise_setup_radio(taliseDevice_t * const pd, taliseInit_t * const pi)
+{
+	uint32_t talAction = TALACT_NO_ACTION;
+	uint16_t deframerStatus = 0;
+	uint8_t framerStatus = 0;
+	uint32_t trackingCalMask =  TAL_TRACK_RX1_QEC |
+				    TAL_TRACK_RX2_QEC |
+				    TAL_TRACK_TX1_QEC |
+				    TAL_TRACK_TX2_QEC;
 
 	/*** < Insert User JESD204B Sync Verification Code Here > ***/
 
@@ -401,7 +449,7 @@ adiHalErr_t talise_setup(taliseDevice_t * const pd, taliseInit_t * const pi)
 		if (talAction != TALACT_NO_ACTION) {
 			/*** < User: decide what to do based on Talise recovery action returned > ***/
 			printf("error: TALISE_readDeframerStatus() failed\n");
-			goto error_11;
+			return FAILURE;
 		}
 
 		if ((deframerStatus & 0xF7) != 0x86)
@@ -416,7 +464,7 @@ adiHalErr_t talise_setup(taliseDevice_t * const pd, taliseInit_t * const pi)
 		if (talAction != TALACT_NO_ACTION) {
 			/*** < User: decide what to do based on Talise recovery action returned > ***/
 			printf("error: TALISE_readFramerStatus() failed\n");
-			goto error_11;
+			return FAILURE;
 		}
 
 		if ((framerStatus & 0x07) != 0x05) {
@@ -432,7 +480,7 @@ adiHalErr_t talise_setup(taliseDevice_t * const pd, taliseInit_t * const pi)
 		if (talAction != TALACT_NO_ACTION) {
 			/*** < User: decide what to do based on Talise recovery action returned > ***/
 			printf("error: TALISE_readFramerStatus() failed\n");
-			goto error_11;
+			return FAILURE;
 		}
 
 		if ((framerStatus & 0x07) != 0x05) {
@@ -453,7 +501,7 @@ adiHalErr_t talise_setup(taliseDevice_t * const pd, taliseInit_t * const pi)
 	if (talAction != TALACT_NO_ACTION) {
 		/*** < User: decide what to do based on Talise recovery action returned > ***/
 		printf("error: TALISE_enableTrackingCals() failed\n");
-		goto error_11;
+		return FAILURE;
 	}
 
 	/* Function to turn radio on, Enables transmitters and receivers */
@@ -462,21 +510,67 @@ adiHalErr_t talise_setup(taliseDevice_t * const pd, taliseInit_t * const pi)
 	if (talAction != TALACT_NO_ACTION) {
 		/*** < User: decide what to do based on Talise recovery action returned > ***/
 		printf("error: TALISE_radioOn() failed\n");
-		goto error_11;
+		return FAILURE;
 	}
 
 	talAction = TALISE_setRxTxEnable(pd, TAL_RX1RX2_EN, TAL_TX1TX2);
 	if (talAction != TALACT_NO_ACTION) {
 		/*** < User: decide what to do based on Talise recovery action returned > ***/
 		printf("error: TALISE_setRxTxEnable() failed\n");
-		goto error_0;
+		return FAILURE;
 	}
 
+	return SUCCESS;
+}
+
+adiHalErr_t talise_setup(taliseDevice_t * const pd, taliseInit_t * const pi)
+{
+	uint32_t talAction = TALACT_NO_ACTION;
+	uint8_t errorFlag = 0;
+
+	if (talise_setup_arm(pd, pi))
+		return FAILURE;
+
+	/*** < wait 200ms for PLLs to lock - user code here > ***/
+	mdelay(200);
+
+	if (talise_rf_pll_locked(pd) != 1) {
+		/*< user code - ensure lock of all PLLs before proceeding>*/
+		printf("error: RFPLL not locked\n");
+		goto error_11;
+	}
+
+	if (talise_setup_cals(pd))
+		goto error_11;
+
+	talAction = TALISE_waitInitCals(pd, 20000, &errorFlag);
+	if (talAction != TALACT_NO_ACTION) {
+		/*** < User: decide what to do based on Talise recovery action returned > ***/
+		printf("error: TALISE_waitInitCals() failed\n");
+		goto error_11;
+	}
+
+	if (errorFlag) {
+		/*< user code - Check error flag to determine ARM  error> */
+		printf("error: Calibrations not completed\n");
+		goto error_11;
+	} else {
+		/*< user code - Calibrations completed successfully > */
+		printf("talise: Calibrations completed successfully\n");
+	}
+
+	if (talise_setup_link(pd, pi))
+		goto error_11;
+
+	mdelay(100);
+
+	if (talise_setup_radio(pd, pi))
+		goto error_11;
+
 	return ADIHAL_OK;
 
 error_11:
 	TALISE_closeHw(pd);
-error_0:
 	return FAILURE;
 }
 
@@ -58,6 +58,12 @@ enum taliseDeviceId {
 
 adiHalErr_t talise_setup(taliseDevice_t * const talDev,
 			 taliseInit_t * const talInit);
+int32_t talise_setup_arm(taliseDevice_t * const pd, taliseInit_t * const pi);
+int32_t talise_rf_pll_locked(taliseDevice_t * const pd);
+int32_t talise_setup_cals(taliseDevice_t * const pd);
+int32_t talise_cals_done(taliseDevice_t * const pd);
+int32_t talise_setup_link(taliseDevice_t * const pd, taliseInit_t * const pi);
+int32_t talise_setup_radio(taliseDevice_t * const pd, taliseInit_t * const pi);
 int talise_multi_chip_sync(taliseDevice_t * pd, int step);
 void talise_shutdown(taliseDevice_t * const pd);
 bool adrv9009_check_sysref_rate(uint32_t lmfc, uint32_t sysref);
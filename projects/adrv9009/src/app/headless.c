@@ -11,6 +11,7 @@
 /****< Insert User Includes Here >***/
 
 #include <stdio.h>
+#include <stdbool.h>
 #include "adi_hal.h"
 #include "spi.h"
 #include "spi_extra.h"
@@ -24,6 +25,9 @@
 #include "axi_dmac.h"
 #ifndef ALTERA_PLATFORM
 #include "xil_cache.h"
+#ifndef PLATFORM_MB
+#include "xtime_l.h"
+#endif
 #endif
 #include "talise.h"
 #include "talise_config.h"
@@ -33,14 +37,18 @@
 #include "app_transceiver.h"
 #include "app_talise.h"
 #include "ad9528.h"
+#include "init_sched.h"
 
 #ifdef IIO_SUPPORT
 
 #include "iio.h"
 #include "iio_axi_adc.h"
 #include "iio_axi_dac.h"
+#include "iio_axi_jesd204_mon.h"
 #include "irq.h"
 #include "irq_extra.h"
+#include "timer.h"
+#include "timer_extra.h"
 #include "uart.h"
 #include "uart_extra.h"
 
@@ -68,8 +76,225 @@ static ssize_t iio_uart_read(char *buf, size_t len)
 	return uart_read(uart_desc, (uint8_t *)buf, len);
 }
 
+/* Period of the JESD204 link checks, in ms */
+#define JESD_MON_PERIOD_MS	100
+
+/*
+ * The link monitors are polled every JESD_MON_PERIOD_MS from the SCU private
+ * timer interrupt when the processor has one (Zynq-7000), so that they keep
+ * running while iio_step() waits for a command. Otherwise they are polled
+ * between two iio commands.
+ */
+#ifdef XPAR_SCUTIMER_INTR
+#define JESD_MON_TIMER_IRQ	XPAR_SCUTIMER_INTR
+/* The timer paces the polls, every poll checks the links */
+#define JESD_MON_CHECK_MS	0
+#else
+#define JESD_MON_CHECK_MS	JESD_MON_PERIOD_MS
+#endif
+
+struct jesd_mon_poller {
+	struct axi_jesd204_mon **mon;
+	uint32_t nb_mon;
+	struct timer_desc *timer;
+	/* Number of polls, counts the time when XTime is not available */
+	volatile uint32_t ticks;
+};
+
+static struct jesd_mon_poller jesd_mon_poller;
+
+/**
+ * jesd_mon_time_ms() - Time source of the JESD204 link monitors.
+ * @Return: Time in ms.
+ */
+static uint32_t jesd_mon_time_ms(void)
+{
+#if !defined(ALTERA_PLATFORM) && !defined(PLATFORM_MB)
+	XTime t;
+
+	XTime_GetTime(&t);
+
+	return t / (COUNTS_PER_SECOND / 1000);
+#else
+	return jesd_mon_poller.ticks * JESD_MON_PERIOD_MS;
+#endif
+}
+
+/**
+ * jesd_mon_poll_all() - Check all the JESD204 links.
+ * @p - Link monitors.
+ */
+static void jesd_mon_poll_all(struct jesd_mon_poller *p)
+{
+	uint32_t i;
+
+	for (i = 0; i < p->nb_mon; i++)
+		axi_jesd204_mon_poll(p->mon[i]);
+	p->ticks++;
+}
+
+#ifdef JESD_MON_TIMER_IRQ
+/**
+ * jesd_mon_timer_isr() - Poll the JESD204 link monitors on timer expiry.
+ * @ctx - Link monitors.
+ * @event - Unused.
+ * @extra - Unused.
+ */
+static void jesd_mon_timer_isr(void *ctx, uint32_t event, void *extra)
+{
+	struct jesd_mon_poller *p = ctx;
+	struct xil_timer_desc *xil_timer = p->timer->extra;
+
+	XScuTimer_ClearInterruptStatus((XScuTimer *)xil_timer->instance);
+	jesd_mon_poll_all(p);
+}
+#endif
+
 #endif // IIO_SUPPORT
 
+/* Events signalled by the bring-up steps */
+#define EVENT_XCVR		BIT(0)
+#define EVENT_CALS(t)		BIT(1 + (t))
+#define EVENT_ALL_CALS		(BIT(1 + TALISE_DEVICE_ID_MAX) - EVENT_CALS(0))
+
+struct xcvr_init_ctx {
+	uint32_t rx_lane_rate_khz;
+	uint32_t tx_lane_rate_khz;
+	uint32_t rx_os_lane_rate_khz;
+	uint32_t device_clock;
+};
+
+static int32_t xcvr_init_step(void *ctx)
+{
+	struct xcvr_init_ctx *x = ctx;
+
+	if (fpga_xcvr_init(x->rx_lane_rate_khz, x->tx_lane_rate_khz,
+			   x->rx_os_lane_rate_khz, x->device_clock) != ADIHAL_OK)
+		return FAILURE;
+
+	return SUCCESS;
+}
+
+/* Bring-up context of a Talise device */
+struct talise_init_ctx {
+	taliseDevice_t *dev;
+	/* Set once talise_setup_arm() opened the device */
+	bool open;
+};
+
+static int32_t talise_arm_step(void *ctx)
+{
+	struct talise_init_ctx *c = ctx;
+
+	if (talise_setup_arm(c->dev, &talInit))
+		return FAILURE;
+	c->open = true;
+
+	return SUCCESS;
+}
+
+static int32_t talise_rf_pll_ready(void *ctx)
+{
+	struct talise_init_ctx *c = ctx;
+
+	return talise_rf_pll_locked(c->dev);
+}
+
+static int32_t talise_cals_step(void *ctx)
+{
+	struct talise_init_ctx *c = ctx;
+
+	return talise_setup_cals(c->dev);
+}
+
+static int32_t talise_cals_ready(void *ctx)
+{
+	struct talise_init_ctx *c = ctx;
+
+	return talise_cals_done(c->dev);
+}
+
+static int32_t talise_link_step(void *ctx)
+{
+	struct talise_init_ctx *c = ctx;
+
+	return talise_setup_link(c->dev, &talInit);
+}
+
+static int32_t talise_radio_step(void *ctx)
+{
+	struct talise_init_ctx *c = ctx;
+
+	return talise_setup_radio(c->dev, &talInit);
+}
+
+/* Shut down the devices that were opened, whatever stage they reached. */
+static void talise_shutdown_open(struct talise_init_ctx *ctx)
+{
+	int t;
+
+	for (t = TALISE_A; t < TALISE_DEVICE_ID_MAX; t++) {
+		if (!ctx[t].open)
+			continue;
+		talise_shutdown(ctx[t].dev);
+		ctx[t].open = false;
+	}
+}
+
+/*
+ * The SYSREF requests of a link reach all the devices, so the links are only
+ * brought up once the FPGA transceivers are configured and the calibrations
+ * of every device are done.
+ */
+#define TALISE_INIT_STEPS(t) {						\
+	{								\
+		.name = "arm",						\
+		.run = talise_arm_step,					\
+		.ready = talise_rf_pll_ready,				\
+		.timeout_us = 200000,					\
+	}, {								\
+		.name = "init_cals",					\
+		.run = talise_cals_step,				\
+		.ready = talise_cals_ready,				\
+		.timeout_us = 20000000,					\
+		.provides = EVENT_CALS(t),				\
+	}, {								\
+		.name = "link",						\
+		.run = talise_link_step,				\
+		.settle_us = 100000,					\
+		.requires = EVENT_XCVR | EVENT_ALL_CALS,		\
+	}, {								\
+		.name = "radio",					\
+		.run = talise_radio_step,				\
+	},								\
+}
+
+static const struct init_sched_step talise_init_steps[][4] = {
+	TALISE_INIT_STEPS(TALISE_A),
+#if defined(ZU11EG) || defined(FMCOMMS8_ZCU102)
+	TALISE_INIT_STEPS(TALISE_B),
+#endif
+};
+
+static const struct init_sched_step xcvr_init_steps[] = {
+	{
+		.name = "xcvr",
+		.run = xcvr_init_step,
+		.provides = EVENT_XCVR,
+	},
+};
+
+#if !defined(ALTERA_PLATFORM) && !defined(PLATFORM_MB)
+static uint32_t bringup_time_us(void)
+{
+	XTime t;
+
+	XTime_GetTime(&t);
+
+	return t / (COUNTS_PER_SECOND / 1000000);
+}
+#endif
+
 /**********************************************************/
 /**********************************************************/
 /********** Talise Data Structure Initializations ********/
@@ -187,10 +412,31 @@ int main(void)
 	int t;
 	struct adi_hal hal[TALISE_DEVICE_ID_MAX];
 	taliseDevice_t tal[TALISE_DEVICE_ID_MAX];
+	struct talise_init_ctx tal_ctx[TALISE_DEVICE_ID_MAX];
+	const char *tal_names[] = {"talise_a", "talise_b"};
+	struct xcvr_init_ctx xcvr_ctx = {
+		rx_lane_rate_khz,
+		tx_lane_rate_khz,
+		rx_os_lane_rate_khz,
+		talInit.clocks.deviceClock_kHz
+	};
+	struct init_sched_device sched_devs[TALISE_DEVICE_ID_MAX + 1];
+	struct init_sched_init_param sched_param = {
+		.devices = sched_devs,
+		.nb_devices = TALISE_DEVICE_ID_MAX + 1,
+#if !defined(ALTERA_PLATFORM) && !defined(PLATFORM_MB)
+		.get_time_us = bringup_time_us,
+#endif
+		.poll_us = 1000,
+	};
+	struct init_sched_desc *sched;
+	uint32_t events;
 	for (t = TALISE_A; t < TALISE_DEVICE_ID_MAX; t++) {
 		hal[t].extra_gpio= &hal_gpio_param;
 		hal[t].extra_spi = &hal_spi_param;
 		tal[t].devHalInfo = (void *) &hal[t];
+		tal_ctx[t].dev = &tal[t];
+		tal_ctx[t].open = false;
 	}
 	hal[TALISE_A].gpio_adrv_resetb_num = TRX_A_RESETB_GPIO;
 	hal[TALISE_A].spi_adrv_csn = ADRV_CS;
@@ -221,17 +467,35 @@ int main(void)
 	if (err != ADIHAL_OK)
 		goto error_1;
 
-	err = fpga_xcvr_init(rx_lane_rate_khz,
-			     tx_lane_rate_khz,
-			     rx_os_lane_rate_khz,
-			     talInit.clocks.deviceClock_kHz);
-	if (err != ADIHAL_OK)
-		goto error_2;
-
+	/*
+	 * Configure the FPGA transceivers and set up the Talise devices,
+	 * overlapping the transceiver configuration and the ARM load of a
+	 * device with the PLL lock and calibration waits of the others.
+	 */
 	for (t = TALISE_A; t < TALISE_DEVICE_ID_MAX; t++) {
-		err = talise_setup(&tal[t], &talInit);
-		if (err != ADIHAL_OK)
+		sched_devs[t].name = tal_names[t];
+		sched_devs[t].ctx = &tal_ctx[t];
+		sched_devs[t].steps = talise_init_steps[t];
+		sched_devs[t].nb_steps = ARRAY_SIZE(talise_init_steps[t]);
+	}
+	sched_devs[t].name = "fpga";
+	sched_devs[t].ctx = &xcvr_ctx;
+	sched_devs[t].steps = xcvr_init_steps;
+	sched_devs[t].nb_steps = ARRAY_SIZE(xcvr_init_steps);
+
+	status = init_sched_init(&sched, &sched_param);
+	if (status)
+		goto error_1;
+
+	status = init_sched_run(sched);
+	init_sched_report(sched);
+	events = sched->events;
+	init_sched_remove(sched);
+	if (status) {
+		talise_shutdown_open(tal_ctx);
+		if (events & EVENT_XCVR)
 			goto error_3;
+		goto error_2;
 	}
 #if defined(ZU11EG) || defined(FMCOMMS8_ZCU102)
 	printf("Performing multi-chip synchronization...\n");
@@ -239,7 +503,7 @@ int main(void)
 		for (t = TALISE_A; t < TALISE_DEVICE_ID_MAX; t++) {
 			err = talise_multi_chip_sync(&tal[t], i);
 			if (err != ADIHAL_OK)
-				goto error_3;
+				goto error_4;
 		}
 	}
 #endif
@@ -254,14 +518,14 @@ int main(void)
 	status = axi_dac_init(&tx_dac, &tx_dac_init);
 	if (status) {
 		printf("axi_dac_init() failed with status %d\n", status);
-		goto error_3;
+		goto error_4;
 	}
 
 	/* Initialize the ADC core */
 	status = axi_adc_init(&rx_adc, &rx_adc_init);
 	if (status) {
 		printf("axi_adc_init() failed with status %d\n", status);
-		goto error_3;
+		goto error_4;
 	}
 
 #ifdef DAC_DMA_EXAMPLE
@@ -275,7 +539,7 @@ int main(void)
 	status = gpio_get(&gpio_plddrbypass, &gpio_init_plddrbypass);
 	if (status) {
 		printf("gpio_get() failed with status %d", status);
-		goto error_3;
+		goto error_4;
 	}
 	gpio_direction_output(gpio_plddrbypass, 0);
 
@@ -289,13 +553,13 @@ int main(void)
 	status = axi_dmac_init(&tx_dmac, &tx_dmac_init);
 	if (status) {
 		printf("axi_dmac_init() tx init error: %d\n", status);
-		goto error_3;
+		goto error_4;
 	}
 
 	status = axi_dmac_init(&rx_dmac, &rx_dmac_init);
 	if (status) {
 		printf("axi_dmac_init() rx init error: %d\n", status);
-		goto error_3;
+		goto error_4;
 	}
 
 	axi_dmac_transfer(tx_dmac, DAC_DDR_BASEADDR, sizeof(sine_lut_iq));
@@ -377,6 +641,51 @@ int main(void)
 
 	struct iio_device *adc_dev_desc, *dac_dev_desc;
 
+	/**
+	 * JESD204 link monitors.
+	 */
+	struct axi_jesd204_mon_init_param jesd_mon_init_par[] = {
+		{
+			.rx = rx_jesd,
+			.get_time_ms = jesd_mon_time_ms,
+			.period_ms = JESD_MON_CHECK_MS,
+		}, {
+			.tx = tx_jesd,
+			.get_time_ms = jesd_mon_time_ms,
+			.period_ms = JESD_MON_CHECK_MS,
+		}, {
+			.rx = rx_os_jesd,
+			.get_time_ms = jesd_mon_time_ms,
+			.period_ms = JESD_MON_CHECK_MS,
+		},
+	};
+	char *jesd_mon_names[] = {
+		"axi-jesd204-rx",
+		"axi-jesd204-tx",
+		"axi-jesd204-rx-os",
+	};
+	struct axi_jesd204_mon *jesd_mon[ARRAY_SIZE(jesd_mon_init_par)];
+	struct iio_axi_jesd204_mon_init_param iio_jesd_mon_init_par;
+	struct iio_axi_jesd204_mon_desc *iio_jesd_mon_desc;
+	struct iio_device *jesd_mon_dev_desc;
+#ifdef JESD_MON_TIMER_IRQ
+	struct xil_timer_init_param jesd_mon_xil_timer_par = {
+		.active_tmr = 0,
+		.type = TIMER_PS,
+	};
+	struct timer_init_param jesd_mon_timer_par = {
+		.id = XPAR_XSCUTIMER_0_DEVICE_ID,
+		.freq_hz = XPAR_CPU_CORTEXA9_CORE_CLOCK_FREQ_HZ / 2,
+		.load_value = XPAR_CPU_CORTEXA9_CORE_CLOCK_FREQ_HZ / 2 / 1000 *
+			      JESD_MON_PERIOD_MS,
+		.extra = &jesd_mon_xil_timer_par,
+	};
+	struct callback_desc jesd_mon_timer_cb = {
+		.callback = jesd_mon_timer_isr,
+		.ctx = &jesd_mon_poller,
+	};
+#endif
+
 	status = irq_ctrl_init(&irq_desc, &irq_init_param);
 	if(status < 0)
 		return status;
@@ -455,7 +764,57 @@ int main(void)
 	status = iio_register(iio_desc, dac_dev_desc, "axi_dac",
 			      iio_axi_dac_desc, NULL, &write_buff);
 
+	for (t = 0; t < ARRAY_SIZE(jesd_mon_init_par); t++) {
+		status = axi_jesd204_mon_init(&jesd_mon[t], &jesd_mon_init_par[t]);
+		if (status < 0)
+			return status;
+
+		iio_jesd_mon_init_par = (struct iio_axi_jesd204_mon_init_param) {
+			.mon = jesd_mon[t],
+#ifdef JESD_MON_TIMER_IRQ
+			.irq_desc = irq_desc,
+			.irq_id = JESD_MON_TIMER_IRQ,
+#endif
+		};
+		status = iio_axi_jesd204_mon_init(&iio_jesd_mon_desc,
+						  &iio_jesd_mon_init_par);
+		if (status < 0)
+			return status;
+
+		iio_axi_jesd204_mon_get_dev_descriptor(iio_jesd_mon_desc,
+						       &jesd_mon_dev_desc);
+		status = iio_register(iio_desc, jesd_mon_dev_desc,
+				      jesd_mon_names[t],
+				      iio_jesd_mon_desc, NULL, NULL);
+		if (status < 0)
+			return status;
+	}
+
+	jesd_mon_poller.mon = jesd_mon;
+	jesd_mon_poller.nb_mon = ARRAY_SIZE(jesd_mon);
+#ifdef JESD_MON_TIMER_IRQ
+	status = timer_init(&jesd_mon_poller.timer, &jesd_mon_timer_par);
+	if (status < 0)
+		return status;
+
+	status = irq_register_callback(irq_desc, JESD_MON_TIMER_IRQ,
+				       &jesd_mon_timer_cb);
+	if (status < 0)
+		return status;
+
+	status = irq_enable(irq_desc, JESD_MON_TIMER_IRQ);
+	if (status < 0)
+		return status;
+
+	status = timer_start(jesd_mon_poller.timer);
+	if (status < 0)
+		return status;
+#endif
+
 	do {
+#ifndef JESD_MON_TIMER_IRQ
+		jesd_mon_poll_all(&jesd_mon_poller);
+#endif
 		status = iio_step(iio_desc);
 		if (status < 0)
 			return status;
@@ -465,9 +824,8 @@ int main(void)
 
 #endif // IIO_SUPPORT
 
-	for (t = TALISE_A; t < TALISE_DEVICE_ID_MAX; t++) {
-		talise_shutdown(&tal[t]);
-	}
+error_4:
+	talise_shutdown_open(tal_ctx);
 error_3:
 	fpga_xcvr_deinit();
 error_2:
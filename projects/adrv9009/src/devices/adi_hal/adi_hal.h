@@ -26,6 +26,11 @@ struct adi_hal {
 	uint8_t			spi_adrv_csn;
 	void 			*extra_gpio;
 	uint8_t			gpio_adrv_resetb_num;
+	/* SPI streaming state, tracked from the device SPI configuration writes */
+	uint8_t			spi_config_a;
+	uint8_t			spi_config_b;
+	/* Number of SPI transfers issued, for throughput measurements */
+	uint32_t		spi_xfer_count;
 };
 
 /**
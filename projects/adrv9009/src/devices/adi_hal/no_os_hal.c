@@ -41,6 +41,7 @@
 /***************************** Include Files **********************************/
 /******************************************************************************/
 #include <stdio.h>
+#include <string.h>
 #include "adi_hal.h"
 #include "parameters.h"
 #include "spi.h"
@@ -50,10 +51,76 @@
 #include "error.h"
 #include "delay.h"
 
+/******************************************************************************/
+/********************** Macros and Constants Definitions **********************/
+/******************************************************************************/
+#define ADIHAL_SPI_CONFIG_A		0x0000
+#define ADIHAL_SPI_CONFIG_B		0x0001
+#define ADIHAL_SPI_ADDR_ASCENSION	0x20
+#define ADIHAL_SPI_SINGLE_INSTRUCTION	0x80
+/* Maximum number of data bytes sent in one streaming transfer */
+#define ADIHAL_SPI_MAX_STREAM		256
+
 /******************************************************************************/
 /************************** Functions Implementation **************************/
 /******************************************************************************/
 
+/**
+ * @brief Track the device SPI configuration to know if streaming (multiple
+ *        bytes with auto incremented/decremented address in one transfer) is
+ *        enabled.
+ * @param devHalData - HAL data.
+ * @param addr - Register address written.
+ * @param data - Register value written.
+ */
+static void ADIHAL_spiTrackConfig(struct adi_hal *devHalData,
+				  uint16_t addr, uint8_t data)
+{
+	if (addr == ADIHAL_SPI_CONFIG_A)
+		devHalData->spi_config_a = data;
+	else if (addr == ADIHAL_SPI_CONFIG_B)
+		devHalData->spi_config_b = data;
+}
+
+/**
+ * @brief Get the address step of a streaming transfer.
+ * @param devHalData - HAL data.
+ * @return 1 or -1 if streaming is enabled, 0 otherwise.
+ */
+static int32_t ADIHAL_spiStreamStep(struct adi_hal *devHalData)
+{
+	if (devHalData->spi_config_b & ADIHAL_SPI_SINGLE_INSTRUCTION)
+		return 0;
+
+	return (devHalData->spi_config_a & ADIHAL_SPI_ADDR_ASCENSION) ? 1 : -1;
+}
+
+/**
+ * @brief Get the length of the run of consecutive addresses starting at
+ *        addr[0] that can be sent in one streaming transfer.
+ * @param devHalData - HAL data.
+ * @param addr - Register addresses.
+ * @param count - Number of addresses.
+ * @return The run length, 1 if streaming is not possible.
+ */
+static uint32_t ADIHAL_spiStreamRun(struct adi_hal *devHalData,
+				    uint16_t *addr, uint32_t count)
+{
+	int32_t step = ADIHAL_spiStreamStep(devHalData);
+	uint32_t run = 1;
+
+	/* The SPI configuration registers are always accessed one by one */
+	if (!step || addr[0] <= ADIHAL_SPI_CONFIG_B)
+		return 1;
+
+	while (run < count && run < ADIHAL_SPI_MAX_STREAM &&
+	       addr[run] == (uint16_t)(addr[run - 1] + step) &&
+	       addr[run] > ADIHAL_SPI_CONFIG_B)
+		run++;
+
+	return run;
+}
+
 adiHalErr_t ADIHAL_setTimeout(void *devHalInfo, uint32_t halTimeout_ms)
 {
 	return ADIHAL_OK;
@@ -87,6 +154,10 @@ adiHalErr_t ADIHAL_openHw(void *devHalInfo, uint32_t halTimeout_ms)
 
 	status = gpio_get(&dev_hal_data->gpio_adrv_resetb, &gpio_adrv_resetb_param);
 
+	dev_hal_data->spi_config_a = 0;
+	dev_hal_data->spi_config_b = ADIHAL_SPI_SINGLE_INSTRUCTION;
+	dev_hal_data->spi_xfer_count = 0;
+
 	spi_param.max_speed_hz = 25000000;
 	spi_param.mode = SPI_MODE_0;
 	spi_param.chip_select = dev_hal_data->spi_adrv_csn;
@@ -137,6 +208,10 @@ adiHalErr_t ADIHAL_resetHw(void *devHalInfo)
 	gpio_direction_output(devHalData->gpio_adrv_resetb, 1);
 	mdelay(10);
 
+	/* The device is back in single instruction mode */
+	devHalData->spi_config_a = 0;
+	devHalData->spi_config_b = ADIHAL_SPI_SINGLE_INSTRUCTION;
+
 	return ADIHAL_OK;
 }
 
@@ -170,23 +245,42 @@ adiHalErr_t ADIHAL_spiWriteByte(void *devHalInfo,
 	buf[1] = addr & 0xFF;
 	buf[2] = data;
 	status = spi_write_and_read(devHalData->spi_adrv_desc, buf, 3);
+	devHalData->spi_xfer_count++;
 
 	if (status != SUCCESS)
 		return ADIHAL_SPI_FAIL;
-	else
-		return ADIHAL_OK;
+
+	ADIHAL_spiTrackConfig(devHalData, addr, data);
+
+	return ADIHAL_OK;
 }
 
 adiHalErr_t ADIHAL_spiWriteBytes(void *devHalInfo,
 				 uint16_t *addr, uint8_t *data, uint32_t count)
 {
+	struct adi_hal *devHalData = (struct adi_hal *)devHalInfo;
+	uint8_t buf[2 + ADIHAL_SPI_MAX_STREAM];
 	adiHalErr_t errVal;
+	int32_t status;
+	uint32_t run;
 	uint32_t i;
 
-	for (i = 0; i < count; i++) {
-		errVal = ADIHAL_spiWriteByte(devHalInfo, addr[i], data[i]);
-		if (errVal)
-			return errVal;
+	for (i = 0; i < count; i += run) {
+		run = ADIHAL_spiStreamRun(devHalData, &addr[i], count - i);
+		if (run == 1) {
+			errVal = ADIHAL_spiWriteByte(devHalInfo, addr[i], data[i]);
+			if (errVal)
+				return errVal;
+			continue;
+		}
+
+		buf[0] = (addr[i] >> 8) & 0x7F;
+		buf[1] = addr[i] & 0xFF;
+		memcpy(&buf[2], &data[i], run);
+		status = spi_write_and_read(devHalData->spi_adrv_desc, buf, 2 + run);
+		devHalData->spi_xfer_count++;
+		if (status != SUCCESS)
+			return ADIHAL_SPI_FAIL;
 	}
 
 	return ADIHAL_OK;
@@ -205,6 +299,7 @@ adiHalErr_t ADIHAL_spiReadByte(void *devHalInfo,
 	buf[1] = addr & 0xFF;
 	buf[2] = 0x00;
 	status = spi_write_and_read(devHalData->spi_adrv_desc, buf, 3);
+	devHalData->spi_xfer_count++;
 	*readdata = buf[2];
 
 	if (status != SUCCESS)
@@ -216,13 +311,31 @@ adiHalErr_t ADIHAL_spiReadByte(void *devHalInfo,
 adiHalErr_t ADIHAL_spiReadBytes(void *devHalInfo,
 				uint16_t *addr, uint8_t *readdata, uint32_t count)
 {
+	struct adi_hal *devHalData = (struct adi_hal *)devHalInfo;
+	uint8_t buf[2 + ADIHAL_SPI_MAX_STREAM];
 	adiHalErr_t errVal;
+	int32_t status;
+	uint32_t run;
 	uint32_t i;
 
-	for (i = 0; i < count; i++) {
-		errVal = ADIHAL_spiReadByte(devHalInfo, addr[i], &readdata[i]);
-		if (errVal)
-			return errVal;
+	for (i = 0; i < count; i += run) {
+		run = ADIHAL_spiStreamRun(devHalData, &addr[i], count - i);
+		if (run == 1) {
+			errVal = ADIHAL_spiReadByte(devHalInfo, addr[i], &readdata[i]);
+			if (errVal)
+				return errVal;
+			continue;
+		}
+
+		buf[0] = 0x80 | ((addr[i] >> 8) & 0x7F);
+		buf[1] = addr[i] & 0xFF;
+		memset(&buf[2], 0, run);
+		status = spi_write_and_read(devHalData->spi_adrv_desc, buf, 2 + run);
+		devHalData->spi_xfer_count++;
+		if (status != SUCCESS)
+			return ADIHAL_SPI_FAIL;
+
+		memcpy(&readdata[i], &buf[2], run);
 	}
 
 	return ADIHAL_OK;
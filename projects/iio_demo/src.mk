@@ -6,7 +6,8 @@ SRC_DIRS += $(NO-OS)/iio/iio_app
 SRCS +=	$(NO-OS)/util/xml.c						\
 	$(NO-OS)/util/list.c						\
 	$(NO-OS)/util/fifo.c						\
-	$(NO-OS)/util/util.c
+	$(NO-OS)/util/util.c						\
+	$(NO-OS)/util/wavegen.c
 
 #drivers
 SRCS += $(DRIVERS)/adc/adc_demo/adc_demo.c				\
@@ -17,8 +18,12 @@ INCS += $(INCLUDE)/xml.h						\
 	$(INCLUDE)/uart.h						\
 	$(INCLUDE)/list.h						\
 	$(INCLUDE)/util.h						\
+	$(INCLUDE)/wavegen.h						\
 	$(INCLUDE)/error.h
 
+# wavegen builds its sine table with sin()
+LIB_FLAGS += -lm
+
 INCS += $(DRIVERS)/adc/adc_demo/iio_adc_demo.h			\
 		$(DRIVERS)/dac/dac_demo/dac_demo.h		\
 		$(DRIVERS)/dac/dac_demo/iio_dac_demo.h			\
@@ -49,6 +49,7 @@
 #include "iio_adc_demo.h"
 #include "iio_dac_demo.h"
 #include "util.h"
+#include "wavegen.h"
 
 #ifdef XILINX_PLATFORM
 #include <xparameters.h>
@@ -151,6 +152,11 @@ int32_t platform_init()
 
 uint16_t buf[DEFAULT_CHANNEL_NO][MAX_SAMPLES_PER_CHANNEL];
 
+/* Rate at which the demo waveform is generated */
+#define DEMO_SAMPLE_RATE_HZ	1000000
+/* Four periods fit exactly in the DEFAULT_LOCAL_SAMPLES loopback buffers */
+#define DEMO_TONE_HZ		(DEMO_SAMPLE_RATE_HZ / DEFAULT_LOCAL_SAMPLES * 4)
+
 /***************************************************************************//**
  * @brief main
 *******************************************************************************/
@@ -182,6 +188,20 @@ int main(void)
 	/* dac instance descriptor. */
 	struct dac_demo_desc *dac_desc;
 
+	/* Buffers shared by the dac and adc demo devices. */
+	uint16_t *loopback_bufs[DEFAULT_CHANNEL_NO] = {buf[0], buf[1]};
+
+	/* Waveform initially loaded in the loopback buffers. */
+	struct wavegen_init_param wavegen_init_par = {
+		.sample_rate_hz = DEMO_SAMPLE_RATE_HZ,
+		.tones = {
+			{ .freq_hz = DEMO_TONE_HZ, .amplitude = 16384 },
+		},
+		.nb_tones = 1,
+		.resolution = 16,
+	};
+	struct wavegen_desc *wavegen_desc;
+
 	status = platform_init();
 	if (status != SUCCESS)
 		return status;
@@ -222,7 +242,7 @@ int main(void)
 	};
 
 	adc_init_par = (struct adc_demo_init_param) {
-		.loopback_buffers = NULL,
+		.loopback_buffers = loopback_bufs,
 		.channel_no = 2,
 		.dev_global_attr = 3333,
 		.dev_ch_attr = {1111,1112,1113,1114,1115,1116,1117,1118,1119,1120,1121,1122,1123,1124,1125,1126}
@@ -232,12 +252,22 @@ int main(void)
 		return status;
 
 	dac_init_par = (struct dac_demo_init_param) {
-		.loopback_buffers = NULL,
+		.loopback_buffers = loopback_bufs,
 		.channel_no = 2,
 		.dev_global_attr = 4444,
 		.dev_ch_attr = {1111,1112,1113,1114,1115,1116,1117,1118,1119,1120,1121,1122,1123,1124,1125,1126}
 	};
 	status = dac_demo_init(&dac_desc, &dac_init_par);
+	if (status != SUCCESS)
+		return status;
+
+	/* Play a tone until the first DAC buffer is pushed */
+	status = wavegen_init(&wavegen_desc, &wavegen_init_par);
+	if (status != SUCCESS)
+		return status;
+
+	status = dac_demo_generate(dac_desc, wavegen_desc);
+	wavegen_remove(wavegen_desc);
 	if (status != SUCCESS)
 		return status;
 	ADC_CHANNEL_NO = adc_desc->active_ch;
@@ -0,0 +1,138 @@
+#!/bin/python
+
+import argparse
+import os
+import struct
+import sys
+
+description_help='''Inspect and convert ADRV9002 init sequence images
+Images are recorded on a reference board with adrv9002_seq_record_start()/
+adrv9002_seq_record_stop() and replayed with adrv9002_seq_play().
+Examples:\n
+	Check an image and print its statistics
+	>python adrv9002_seq.py info lvds.seq
+	Dump every record
+	>python adrv9002_seq.py dump lvds.seq
+	Convert an image to a C header to be linked in flash
+	>python adrv9002_seq.py header lvds.seq lvds_seq.h -name=lvds_seq
+'''
+
+SEQ_MAGIC = 0x51533941
+SEQ_VERSION = 1
+SEQ_HDR = struct.Struct('<IBBHI')
+SEQ_REC_HDR = struct.Struct('<BH')
+SEQ_CRC16_POLY = 0x1021
+
+SPI_WRITE = 1
+WAIT = 2
+POLL = 3
+RESETB = 4
+
+REC_NAMES = {SPI_WRITE: 'write', WAIT: 'wait', POLL: 'poll', RESETB: 'resetb'}
+
+def crc16(data, crc = 0):
+	for b in data:
+		crc ^= b << 8
+		for _ in range(8):
+			if crc & 0x8000:
+				crc = ((crc << 1) ^ SEQ_CRC16_POLY) & 0xffff
+			else:
+				crc = (crc << 1) & 0xffff
+	return crc
+
+def parse(data):
+	if len(data) < SEQ_HDR.size:
+		sys.exit('image too short')
+	magic, version, _, crc, size = SEQ_HDR.unpack_from(data)
+	if magic != SEQ_MAGIC or version != SEQ_VERSION:
+		sys.exit('not an ADRV9002 sequence image (v%d)' % SEQ_VERSION)
+	body = data[SEQ_HDR.size:SEQ_HDR.size + size]
+	if len(body) != size:
+		sys.exit('image truncated')
+	if crc16(body) != crc:
+		sys.exit('crc mismatch')
+
+	records = []
+	off = 0
+	while off < size:
+		rtype, rlen = SEQ_REC_HDR.unpack_from(body, off)
+		off += SEQ_REC_HDR.size
+		payload = body[off:off + rlen]
+		if len(payload) != rlen:
+			sys.exit('record at %d truncated' % off)
+		records.append((rtype, payload))
+		off += rlen
+	return records
+
+def describe(rtype, payload):
+	if rtype == SPI_WRITE:
+		return '%d bytes' % len(payload)
+	if rtype == WAIT:
+		return '%d us' % struct.unpack('<I', payload)[0]
+	if rtype == POLL:
+		addr, mask, value, timeout = struct.unpack('<HBBI', payload)
+		return '0x%04x & 0x%02x == 0x%02x, timeout %d us' % (addr, mask,
+								    value, timeout)
+	if rtype == RESETB:
+		return 'level %d' % payload[0]
+	return 'unknown type %d' % rtype
+
+def cmd_info(args, data, records):
+	count = dict.fromkeys(REC_NAMES, 0)
+	wr_bytes = 0
+	wait_us = 0
+	for rtype, payload in records:
+		count[rtype] = count.get(rtype, 0) + 1
+		if rtype == SPI_WRITE:
+			wr_bytes += len(payload)
+		elif rtype == WAIT:
+			wait_us += struct.unpack('<I', payload)[0]
+	print('image size:   %d bytes' % len(data))
+	print('records:      %d' % len(records))
+	for rtype, name in REC_NAMES.items():
+		print('  %-10s  %d' % (name, count[rtype]))
+	print('write bytes:  %d' % wr_bytes)
+	print('total wait:   %d us' % wait_us)
+
+def cmd_dump(args, data, records):
+	for i, (rtype, payload) in enumerate(records):
+		print('%6d %-7s %s' % (i, REC_NAMES.get(rtype, '?'),
+				       describe(rtype, payload)))
+
+def cmd_header(args, data, records):
+	name = args.name
+	guard = name.upper() + '_H_'
+	with open(args.output, 'w') as f:
+		f.write('#ifndef %s\n#define %s\n\n' % (guard, guard))
+		f.write('const unsigned char %s[] = {\n' % name)
+		for i in range(0, len(data), 8):
+			line = ', '.join('0x%02x' % b for b in data[i:i + 8])
+			end = ',' if i + 8 < len(data) else ''
+			f.write('\t%s%s\n' % (line, end))
+		f.write('};\n\n#endif\n')
+
+def parse_input():
+	parser = argparse.ArgumentParser(description=description_help,\
+				formatter_class=argparse.RawTextHelpFormatter)
+	parser.add_argument('command', choices=['info', 'dump', 'header'])
+	parser.add_argument('image', help="Sequence image")
+	parser.add_argument('output', nargs='?', help="Output file for header")
+	parser.add_argument('-name', default=None, help="C array name for header")
+	args = parser.parse_args()
+	if args.command == 'header':
+		if not args.output:
+			parser.error('header needs an output file')
+		if not args.name:
+			args.name = os.path.splitext(os.path.basename(
+					args.output))[0].replace('-', '_')
+	return args
+
+def main():
+	args = parse_input()
+	with open(args.image, 'rb') as f:
+		data = f.read()
+	records = parse(data)
+	{'info': cmd_info, 'dump': cmd_dump, 'header': cmd_header}[args.command](
+			args, data, records)
+
+main()
@@ -185,6 +185,10 @@ ifeq (y,$(strip $(ENABLE_IIO_NETWORK)))
 CFLAGS += -DENABLE_IIO_NETWORK
 endif
 
+ifeq (y,$(strip $(ENABLE_IIO_UART_RING)))
+CFLAGS += -DENABLE_IIO_UART_RING
+endif
+
 ifeq (y,$(strip $(DISABLE_SECURE_SOCKET)))
 CFLAGS += -DDISABLE_SECURE_SOCKET
 endif
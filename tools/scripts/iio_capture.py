@@ -0,0 +1,196 @@
+#!/bin/python
+
+import argparse
+import bisect
+import struct
+import sys
+
+description_help='''Read IIO capture files written by iio_recorder
+Examples:\n
+	Print the header, channels and chunk statistics
+	>python iio_capture.py info capture.bin
+	Export 1000 samples starting at sample 5000 as CSV
+	>python iio_capture.py csv capture.bin out.csv -start=5000 -count=1000
+
+The module can also be imported:
+	cap = CaptureFile('capture.bin')
+	data = cap.read(5000, 1000)	# one list of samples per channel
+'''
+
+REC_MAGIC = 0x43524949
+CHUNK_MAGIC = 0x4b4e4843
+INDEX_MAGIC = 0x58444e49
+REC_VERSION = 1
+
+FILE_HDR = struct.Struct('<IHHIIQQ32s')
+CHANNEL = struct.Struct('<HcBBBBB16s')
+CHUNK_HDR = struct.Struct('<IIIIQQ')
+INDEX_ENTRY = struct.Struct('<QQQ')
+TRAILER = struct.Struct('<IIQQ')
+
+class Channel:
+	def __init__(self, raw):
+		(self.scan_index, sign, self.realbits, self.storagebits,
+		 self.shift, big_endian, _, name) = CHANNEL.unpack(raw)
+		self.signed = sign == b's'
+		self.big_endian = bool(big_endian)
+		self.name = name.split(b'\0')[0].decode()
+		self.bytes = self.storagebits // 8
+
+	def decode(self, raw):
+		val = int.from_bytes(raw, 'big' if self.big_endian else 'little')
+		val = (val >> self.shift) & ((1 << self.realbits) - 1)
+		if self.signed and val & (1 << (self.realbits - 1)):
+			val -= 1 << self.realbits
+		return val
+
+class Chunk:
+	def __init__(self, offset, first_sample, nb_samples, timestamp_us):
+		self.offset = offset
+		self.first_sample = first_sample
+		self.nb_samples = nb_samples
+		self.timestamp_us = timestamp_us
+
+class CaptureFile:
+	def __init__(self, path):
+		self.f = open(path, 'rb')
+		raw = self.f.read(FILE_HDR.size)
+		if len(raw) != FILE_HDR.size:
+			raise ValueError('file too short')
+		(magic, version, self.header_len, nb_channels, self.frame_bytes,
+		 self.sample_rate_hz, self.start_us, name) = FILE_HDR.unpack(raw)
+		if magic != REC_MAGIC or version != REC_VERSION:
+			raise ValueError('not an IIO capture file (v%d)' % REC_VERSION)
+		self.name = name.split(b'\0')[0].decode()
+		self.channels = [Channel(self.f.read(CHANNEL.size))
+				 for _ in range(nb_channels)]
+		# Seek index: (first sample, chunk offset), possibly decimated
+		self.closed = self._load_index()
+		if not self.closed:
+			self.f.seek(0, 2)
+			self.data_end = self.f.tell()
+			chunks = list(self.chunks())
+			self.index = [(c.first_sample, c.offset) for c in chunks]
+			self.total_samples = sum(c.nb_samples for c in chunks)
+
+	def _load_index(self):
+		self.f.seek(0, 2)
+		size = self.f.tell()
+		if size < self.header_len + TRAILER.size:
+			return False
+		self.f.seek(size - TRAILER.size)
+		magic, nb_entries, index_offset, total_samples = \
+			TRAILER.unpack(self.f.read(TRAILER.size))
+		if magic != INDEX_MAGIC or \
+		   index_offset + nb_entries * INDEX_ENTRY.size + TRAILER.size != size:
+			return False
+		self.f.seek(index_offset)
+		self.index = []
+		for _ in range(nb_entries):
+			offset, first, _ = INDEX_ENTRY.unpack(self.f.read(INDEX_ENTRY.size))
+			self.index.append((first, offset))
+		self.data_end = index_offset
+		self.total_samples = total_samples
+		return True
+
+	def _chunk_at(self, offset):
+		if offset + CHUNK_HDR.size > self.data_end:
+			return None
+		self.f.seek(offset)
+		magic, payload, nb_samples, _, first, ts = \
+			CHUNK_HDR.unpack(self.f.read(CHUNK_HDR.size))
+		if magic != CHUNK_MAGIC or payload != nb_samples * self.frame_bytes or \
+		   offset + CHUNK_HDR.size + payload > self.data_end:
+			return None
+		return Chunk(offset, first, nb_samples, ts)
+
+	def chunks(self, offset = None):
+		'''Walk the chunk headers from offset (the first chunk by default)'''
+		offset = self.header_len if offset is None else offset
+		while True:
+			chunk = self._chunk_at(offset)
+			if chunk is None:
+				return
+			yield chunk
+			offset += CHUNK_HDR.size + chunk.nb_samples * self.frame_bytes
+
+	def read(self, start, count):
+		'''Return count samples from sample number start, one list per
+		channel. Samples dropped on recorder overruns are missing from the
+		file, the result stops at the first gap.'''
+		data = [[] for _ in self.channels]
+		i = bisect.bisect_right(self.index, (start, float('inf'))) - 1
+		if i < 0:
+			return data
+		pos = start
+		for c in self.chunks(self.index[i][1]):
+			if count <= 0 or pos < c.first_sample:
+				break
+			if pos >= c.first_sample + c.nb_samples:
+				continue
+			skip = pos - c.first_sample
+			n = min(count, c.nb_samples - skip)
+			self.f.seek(c.offset + CHUNK_HDR.size + skip * self.frame_bytes)
+			raw = self.f.read(n * self.frame_bytes)
+			for s in range(n):
+				off = s * self.frame_bytes
+				for ch, out in zip(self.channels, data):
+					out.append(ch.decode(raw[off:off + ch.bytes]))
+					off += ch.bytes
+			pos += n
+			count -= n
+		return data
+
+	def gaps(self):
+		'''Sample ranges lost on recorder overruns'''
+		gaps = []
+		end = None
+		for c in self.chunks():
+			if end is not None and c.first_sample != end:
+				gaps.append((end, c.first_sample))
+			end = c.first_sample + c.nb_samples
+		return gaps
+
+def cmd_info(args, cap):
+	print('device:       %s' % cap.name)
+	print('sample rate:  %d Hz' % cap.sample_rate_hz)
+	print('start:        %d us' % cap.start_us)
+	print('frame bytes:  %d' % cap.frame_bytes)
+	for ch in cap.channels:
+		print('  %-16s index %d  %s%d/%d>>%d %s' % (ch.name, ch.scan_index,
+		      's' if ch.signed else 'u', ch.realbits, ch.storagebits,
+		      ch.shift, 'be' if ch.big_endian else 'le'))
+	print('chunks:       %d' % sum(1 for _ in cap.chunks()))
+	print('samples:      %d' % cap.total_samples)
+	print('index:        %s' % ('yes' if cap.closed else 'missing, recovered'))
+	for a, b in cap.gaps():
+		print('  gap: samples %d-%d' % (a, b - 1))
+
+def cmd_csv(args, cap):
+	if not args.output:
+		sys.exit('csv needs an output file')
+	count = args.count if args.count else cap.total_samples
+	data = cap.read(args.start, count)
+	with open(args.output, 'w') as f:
+		f.write(','.join(ch.name or str(ch.scan_index)
+				 for ch in cap.channels) + '\n')
+		for row in zip(*data):
+			f.write(','.join(str(v) for v in row) + '\n')
+
+def parse_input():
+	parser = argparse.ArgumentParser(description=description_help,\
+				formatter_class=argparse.RawTextHelpFormatter)
+	parser.add_argument('command', choices=['info', 'csv'])
+	parser.add_argument('capture', help="Capture file")
+	parser.add_argument('output', nargs='?', help="Output file for csv")
+	parser.add_argument('-start', type=int, default=0, help="First sample")
+	parser.add_argument('-count', type=int, default=0, help="Number of samples")
+	return parser.parse_args()
+
+def main():
+	args = parse_input()
+	cap = CaptureFile(args.capture)
+	{'info': cmd_info, 'csv': cmd_csv}[args.command](args, cap)
+
+if __name__ == '__main__':
+	main()
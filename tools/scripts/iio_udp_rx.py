@@ -0,0 +1,135 @@
+#!/bin/python
+
+import argparse
+import socket
+import struct
+import sys
+import time
+
+description_help='''Receive IIO buffer data streamed with iio_udp_stream_start()
+Attributes are still accessed over the iiod TCP connection, only the samples
+of the streamed device are received here.
+Loss is reported from the sequence numbers: packets the device could not send
+are counted by the device, the rest were lost on the network.
+Examples:\n
+	Print the stream statistics every second
+	>python iio_udp_rx.py -port=5000
+	Save 10 seconds of samples, filling lost data with zeros
+	>python iio_udp_rx.py -port=5000 -output=samples.bin -seconds=10 -fill
+'''
+
+UDP_MAGIC = 0x53554949
+UDP_VERSION = 1
+UDP_HDR = struct.Struct('<IIIIIHBBQ')
+FLAG_END = 0x02
+
+class Stream:
+	def __init__(self, output, fill):
+		self.output = output
+		self.fill = fill
+		self.packets = 0
+		self.bytes = 0
+		self.lost = 0
+		self.late = 0
+		self.invalid = 0
+		self.dev_dropped = 0
+		self.block_bytes = 0
+		self.next_seq = None
+		self.next_pos = None
+
+	def missing(self, block, offset):
+		# Bytes between the end of the last packet and this one
+		if self.next_pos is None:
+			return 0
+		blk, off = self.next_pos
+		if block == blk:
+			return max(offset - off, 0)
+		if not self.block_bytes:
+			return 0
+		return (self.block_bytes - off + (block - blk - 1) *
+			self.block_bytes + offset)
+
+	def receive(self, data):
+		if len(data) < UDP_HDR.size:
+			self.invalid += 1
+			return
+		(magic, seq, block, offset, dropped, length, flags, version,
+		 ts) = UDP_HDR.unpack_from(data)
+		payload = data[UDP_HDR.size:UDP_HDR.size + length]
+		if (magic != UDP_MAGIC or version != UDP_VERSION or
+		    len(payload) != length):
+			self.invalid += 1
+			return
+
+		if self.next_seq is not None:
+			gap = (seq - self.next_seq) & 0xffffffff
+			if gap >= 0x80000000:
+				# Older than the last packet, already counted lost
+				self.late += 1
+				return
+			self.lost += gap
+		self.next_seq = (seq + 1) & 0xffffffff
+		self.dev_dropped = dropped
+		if flags & FLAG_END:
+			self.block_bytes = offset + length
+
+		if self.output:
+			if self.fill:
+				self.output.write(bytes(self.missing(block,
+								     offset)))
+			self.output.write(payload)
+		self.next_pos = (block, offset + length)
+		self.packets += 1
+		self.bytes += length
+
+	def report(self, elapsed):
+		net_lost = max(self.lost - self.dev_dropped, 0)
+		print('%8.1f s  packets %d  %.1f kB/s  lost %d (device %d, '
+		      'network %d)  late %d  invalid %d' % (elapsed, self.packets,
+		      self.bytes / 1000.0 / max(elapsed, 1e-3), self.lost,
+		      self.dev_dropped, net_lost, self.late, self.invalid))
+
+def parse_input():
+	parser = argparse.ArgumentParser(description=description_help,\
+				formatter_class=argparse.RawTextHelpFormatter)
+	parser.add_argument('-port', type=int, required=True, help="UDP port")
+	parser.add_argument('-bind', default='', help="Local address")
+	parser.add_argument('-output', help="File for the received samples")
+	parser.add_argument('-seconds', type=float, default=0,
+			    help="Stop after this time, 0 to run until Ctrl+C")
+	parser.add_argument('-fill', action='store_true',
+			    help="Write zeros in place of the lost data")
+	return parser.parse_args()
+
+def main():
+	args = parse_input()
+	sock = socket.socket(socket.AF_INET, socket.SOCK_DGRAM)
+	sock.setsockopt(socket.SOL_SOCKET, socket.SO_RCVBUF, 1 << 22)
+	sock.bind((args.bind, args.port))
+	sock.settimeout(0.2)
+	output = open(args.output, 'wb') if args.output else None
+	stream = Stream(output, args.fill)
+
+	start = time.time()
+	last = start
+	try:
+		while True:
+			try:
+				stream.receive(sock.recv(65536))
+			except socket.timeout:
+				pass
+			now = time.time()
+			if now - last >= 1:
+				stream.report(now - start)
+				last = now
+			if args.seconds and now - start >= args.seconds:
+				break
+	except KeyboardInterrupt:
+		pass
+	stream.report(time.time() - start)
+	if output:
+		output.close()
+	sys.exit(0)
+
+if __name__ == '__main__':
+	main()
@@ -33,6 +33,10 @@ TINYIIOD = y
 # If the variable is set to y then iio network backend will be enabled
 ENABLE_IIO_NETWORK = y
 
+# If the variable is set to y the iio UART link uses interrupt driven ring
+# buffers. Needs util/circular_buffer.c and the platform irq and delay drivers
+ENABLE_IIO_UART_RING = n
+
 # If set, link to noos srcs will be created for new project instead of copy them
 # to the project directory. This way modification to the files can be viewed on
 # git for example
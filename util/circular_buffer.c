@@ -167,6 +167,12 @@ int32_t cb_size(struct circular_buffer *desc, uint32_t *size)
 		nb_spins = UINT32_MAX - desc->read.spin_count +
 			   desc->write.spin_count + 1;
 
+	/* The writer is more than one buffer ahead */
+	if (nb_spins > 1) {
+		*size = desc->size;
+		return -EOVERRUN;
+	}
+
 	if (nb_spins > 0)
 		*size = desc->size + desc->write.idx - desc->read.idx;
 	else
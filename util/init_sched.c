@@ -0,0 +1,380 @@
+/***************************************************************************//**
+ *   @file   init_sched.c
+ *   @brief  Cooperative scheduler overlapping the waits of device initializations.
+********************************************************************************
+ * Copyright 2021(c) Analog Devices, Inc.
+ *
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *  - Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ *  - Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ *  - Neither the name of Analog Devices, Inc. nor the names of its
+ *    contributors may be used to endorse or promote products derived
+ *    from this software without specific prior written permission.
+ *  - The use of this software may or may not infringe the patent rights
+ *    of one or more patent holders.  This license does not release you
+ *    from the requirement that you obtain separate licenses from these
+ *    patent holders to use this software.
+ *  - Use of the software either in source or binary form, must be run
+ *    on or directly connected to an Analog Devices Inc. component.
+ *
+ * THIS SOFTWARE IS PROVIDED BY ANALOG DEVICES "AS IS" AND ANY EXPRESS OR
+ * IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, NON-INFRINGEMENT,
+ * MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED.
+ * IN NO EVENT SHALL ANALOG DEVICES BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, INTELLECTUAL PROPERTY RIGHTS, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*******************************************************************************/
+
+/******************************************************************************/
+/***************************** Include Files **********************************/
+/******************************************************************************/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdbool.h>
+#include <inttypes.h>
+#include "init_sched.h"
+#include "error.h"
+#include "delay.h"
+#include "util.h"
+
+/******************************************************************************/
+/************************ Functions Definitions *******************************/
+/******************************************************************************/
+
+/**
+ * @brief Get the current time.
+ * @param desc - The scheduler descriptor.
+ * @return Time in us, or the idle time when there is no time source.
+ */
+static uint32_t init_sched_now(struct init_sched_desc *desc)
+{
+	if (!desc->get_time_us)
+		return desc->idle_us;
+
+	return desc->get_time_us();
+}
+
+/**
+ * @brief Allocate a scheduler for a set of devices.
+ * @param desc - The scheduler descriptor.
+ * @param param - The structure that contains the scheduler parameters.
+ * @return SUCCESS in case of success, negative error code otherwise.
+ */
+int32_t init_sched_init(struct init_sched_desc **desc,
+			const struct init_sched_init_param *param)
+{
+	struct init_sched_desc *sched;
+	uint8_t i;
+
+	if (!desc || !param || !param->devices || !param->nb_devices)
+		return -EINVAL;
+
+	sched = (struct init_sched_desc *)calloc(1, sizeof(*sched));
+	if (!sched)
+		return -ENOMEM;
+
+	sched->devices = param->devices;
+	sched->nb_devices = param->nb_devices;
+	sched->get_time_us = param->get_time_us;
+	sched->poll_us = param->poll_us ? param->poll_us : INIT_SCHED_POLL_US;
+
+	sched->cur = (uint8_t *)calloc(param->nb_devices, sizeof(*sched->cur));
+	sched->waiting = (uint8_t *)calloc(param->nb_devices,
+					   sizeof(*sched->waiting));
+	sched->wait_start = (uint32_t *)calloc(param->nb_devices,
+					       sizeof(*sched->wait_start));
+	sched->first = (uint16_t *)calloc(param->nb_devices,
+					  sizeof(*sched->first));
+	if (!sched->cur || !sched->waiting || !sched->wait_start ||
+	    !sched->first)
+		goto error_mem;
+
+	for (i = 0; i < param->nb_devices; i++) {
+		if (!param->devices[i].steps && param->devices[i].nb_steps)
+			goto error;
+		sched->first[i] = sched->nb_stats;
+		sched->nb_stats += param->devices[i].nb_steps;
+	}
+	if (!sched->nb_stats)
+		goto error;
+	sched->stats = (struct init_sched_stats *)calloc(sched->nb_stats,
+			sizeof(*sched->stats));
+	if (!sched->stats)
+		goto error_mem;
+
+	*desc = sched;
+
+	return SUCCESS;
+error_mem:
+	init_sched_remove(sched);
+
+	return -ENOMEM;
+error:
+	init_sched_remove(sched);
+
+	return -EINVAL;
+}
+
+/**
+ * @brief Get the timing of the current step of a device.
+ * @param desc - The scheduler descriptor.
+ * @param dev - Device index.
+ * @return Timing of the step.
+ */
+static struct init_sched_stats *init_sched_cur_stats(
+	struct init_sched_desc *desc, uint8_t dev)
+{
+	return &desc->stats[desc->first[dev] + desc->cur[dev]];
+}
+
+/**
+ * @brief Issue the current step of a device.
+ * @param desc - The scheduler descriptor.
+ * @param dev - Device index.
+ * @return SUCCESS in case of success, negative error code otherwise.
+ */
+static int32_t init_sched_issue(struct init_sched_desc *desc, uint8_t dev)
+{
+	const struct init_sched_device *d = &desc->devices[dev];
+	const struct init_sched_step *step = &d->steps[desc->cur[dev]];
+	struct init_sched_stats *st = init_sched_cur_stats(desc, dev);
+	uint32_t start;
+	int32_t ret = SUCCESS;
+
+	start = init_sched_now(desc);
+	st->start_us = start - desc->t0;
+	if (step->run)
+		ret = step->run(d->ctx);
+	desc->wait_start[dev] = init_sched_now(desc);
+	st->run_us = desc->wait_start[dev] - start;
+	if (ret < 0)
+		st->status = ret;
+	else
+		desc->waiting[dev] = 1;
+
+	return ret < 0 ? ret : SUCCESS;
+}
+
+/**
+ * @brief Check the wait condition of the current step of a device.
+ * @param desc - The scheduler descriptor.
+ * @param dev - Device index.
+ * @param wait_us - Time after which the step should be checked again.
+ * @return 1 if the step completed, 0 if it is still waiting, negative error
+ *         code on failure or timeout.
+ */
+static int32_t init_sched_check(struct init_sched_desc *desc, uint8_t dev,
+				uint32_t *wait_us)
+{
+	const struct init_sched_device *d = &desc->devices[dev];
+	const struct init_sched_step *step = &d->steps[desc->cur[dev]];
+	struct init_sched_stats *st = init_sched_cur_stats(desc, dev);
+	uint32_t elapsed;
+	int32_t ret = 1;
+
+	elapsed = init_sched_now(desc) - desc->wait_start[dev];
+	if (elapsed < step->settle_us) {
+		*wait_us = step->settle_us - elapsed;
+		return 0;
+	}
+
+	if (step->ready)
+		ret = step->ready(d->ctx);
+	if (!ret && step->timeout_us &&
+	    elapsed - step->settle_us >= step->timeout_us)
+		ret = -ETIMEDOUT;
+	if (ret < 0) {
+		st->status = ret;
+		return ret;
+	}
+	if (!ret) {
+		*wait_us = desc->poll_us;
+		return 0;
+	}
+
+	st->wait_us = elapsed;
+	st->status = SUCCESS;
+	desc->events |= step->provides;
+	desc->waiting[dev] = 0;
+	desc->cur[dev]++;
+
+	return 1;
+}
+
+/**
+ * @brief Print the devices that can not make progress.
+ * @param desc - The scheduler descriptor.
+ * @return -EINVAL, as the bring-up can not complete.
+ */
+static int32_t init_sched_deadlock(struct init_sched_desc *desc)
+{
+	const struct init_sched_step *step;
+	uint8_t dev;
+
+	for (dev = 0; dev < desc->nb_devices; dev++) {
+		if (desc->cur[dev] >= desc->devices[dev].nb_steps)
+			continue;
+		step = &desc->devices[dev].steps[desc->cur[dev]];
+		printf("init_sched: %s/%s blocked, missing events 0x%"PRIx32"\n",
+		       desc->devices[dev].name, step->name,
+		       step->requires & ~desc->events);
+	}
+
+	return -EINVAL;
+}
+
+/**
+ * @brief Bring all the devices up. While a step waits for its settle time
+ * or wait condition, the steps of the other devices whose events are
+ * available run in the meantime.
+ * @param desc - The scheduler descriptor.
+ * @return SUCCESS in case of success, negative error code otherwise.
+ */
+int32_t init_sched_run(struct init_sched_desc *desc)
+{
+	const struct init_sched_device *d;
+	const struct init_sched_step *step;
+	uint32_t wait_us, idle_us;
+	bool progress, waiting;
+	int32_t ret;
+	uint16_t i;
+	uint8_t dev;
+
+	if (!desc)
+		return -EINVAL;
+
+	for (i = 0; i < desc->nb_stats; i++) {
+		desc->stats[i].start_us = 0;
+		desc->stats[i].run_us = 0;
+		desc->stats[i].wait_us = 0;
+		desc->stats[i].status = 1;
+	}
+	for (dev = 0; dev < desc->nb_devices; dev++) {
+		desc->cur[dev] = 0;
+		desc->waiting[dev] = 0;
+	}
+	desc->events = 0;
+	desc->idle_us = 0;
+	desc->t0 = init_sched_now(desc);
+
+	do {
+		progress = false;
+		waiting = false;
+		idle_us = desc->poll_us;
+		for (dev = 0; dev < desc->nb_devices; dev++) {
+			d = &desc->devices[dev];
+			if (desc->cur[dev] >= d->nb_steps)
+				continue;
+			step = &d->steps[desc->cur[dev]];
+
+			if (!desc->waiting[dev]) {
+				if ((desc->events & step->requires) !=
+				    step->requires)
+					continue;
+				ret = init_sched_issue(desc, dev);
+				if (ret < 0)
+					goto error;
+			}
+
+			wait_us = 0;
+			ret = init_sched_check(desc, dev, &wait_us);
+			if (ret < 0)
+				goto error;
+			if (ret) {
+				progress = true;
+			} else {
+				waiting = true;
+				idle_us = min(idle_us, wait_us);
+			}
+		}
+		if (progress)
+			continue;
+		if (!waiting)
+			break;
+		udelay(idle_us);
+		desc->idle_us += idle_us;
+	} while (1);
+
+	desc->total_us = init_sched_now(desc) - desc->t0;
+
+	for (dev = 0; dev < desc->nb_devices; dev++)
+		if (desc->cur[dev] < desc->devices[dev].nb_steps)
+			return init_sched_deadlock(desc);
+
+	return SUCCESS;
+error:
+	desc->total_us = init_sched_now(desc) - desc->t0;
+	printf("init_sched: %s/%s failed (%"PRIi32")\n", d->name, step->name,
+	       ret);
+
+	return ret;
+}
+
+/**
+ * @brief Print the per step timing report.
+ * @param desc - The scheduler descriptor.
+ * @return None.
+ */
+void init_sched_report(struct init_sched_desc *desc)
+{
+	const struct init_sched_device *d;
+	const struct init_sched_stats *st;
+	uint32_t serial_us = 0;
+	uint8_t dev, i;
+
+	if (!desc)
+		return;
+
+	printf("%-12s %-20s %10s %10s %10s\n", "device", "step", "start_us",
+	       "run_us", "wait_us");
+	for (dev = 0; dev < desc->nb_devices; dev++) {
+		d = &desc->devices[dev];
+		for (i = 0; i < d->nb_steps; i++) {
+			st = &desc->stats[desc->first[dev] + i];
+			if (st->status == 1) {
+				printf("%-12s %-20s %10s\n", d->name,
+				       d->steps[i].name, "not done");
+				continue;
+			}
+			printf("%-12s %-20s %10"PRIu32" %10"PRIu32" %10"PRIu32
+			       "%s\n", d->name, d->steps[i].name, st->start_us,
+			       st->run_us, st->wait_us,
+			       st->status ? " failed" : "");
+			serial_us += st->run_us + st->wait_us;
+		}
+	}
+	printf("bring-up: %"PRIu32" us, %"PRIu32" us if run one after the "
+	       "other\n", desc->total_us, serial_us);
+}
+
+/**
+ * @brief Free the resources allocated by init_sched_init().
+ * @param desc - The scheduler descriptor.
+ * @return SUCCESS in case of success, negative error code otherwise.
+ */
+int32_t init_sched_remove(struct init_sched_desc *desc)
+{
+	if (!desc)
+		return -EINVAL;
+
+	free(desc->stats);
+	free(desc->first);
+	free(desc->wait_start);
+	free(desc->waiting);
+	free(desc->cur);
+	free(desc);
+
+	return SUCCESS;
+}
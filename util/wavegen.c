@@ -0,0 +1,604 @@
+/***************************************************************************//**
+ *   @file   wavegen.c
+ *   @brief  Waveform generator: NCO tones, chirp and noise synthesis.
+********************************************************************************
+ * Copyright 2021(c) Analog Devices, Inc.
+ *
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *  - Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ *  - Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ *  - Neither the name of Analog Devices, Inc. nor the names of its
+ *    contributors may be used to endorse or promote products derived
+ *    from this software without specific prior written permission.
+ *  - The use of this software may or may not infringe the patent rights
+ *    of one or more patent holders.  This license does not release you
+ *    from the requirement that you obtain separate licenses from these
+ *    patent holders to use this software.
+ *  - Use of the software either in source or binary form, must be run
+ *    on or directly connected to an Analog Devices Inc. component.
+ *
+ * THIS SOFTWARE IS PROVIDED BY ANALOG DEVICES "AS IS" AND ANY EXPRESS OR
+ * IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, NON-INFRINGEMENT,
+ * MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED.
+ * IN NO EVENT SHALL ANALOG DEVICES BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, INTELLECTUAL PROPERTY RIGHTS, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*******************************************************************************/
+
+/******************************************************************************/
+/***************************** Include Files **********************************/
+/******************************************************************************/
+
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#include "wavegen.h"
+#include "error.h"
+#include "util.h"
+
+/******************************************************************************/
+/********************** Macros and Constants Definitions **********************/
+/******************************************************************************/
+
+#define WAVEGEN_PI		3.14159265358979323846
+#define WAVEGEN_LUT_MASK	(WAVEGEN_LUT_SIZE - 1)
+#define WAVEGEN_LUT_SHIFT	(32 - WAVEGEN_LUT_BITS)
+/* A quarter of the table is 90 degrees: cos(x) = sin(x + pi / 2) */
+#define WAVEGEN_LUT_COS_OFF	(WAVEGEN_LUT_SIZE / 4)
+
+/******************************************************************************/
+/************************ Variables Definitions *******************************/
+/******************************************************************************/
+
+/* Full period sine table, Q15, shared by all the generators */
+static int16_t wavegen_lut[WAVEGEN_LUT_SIZE];
+static bool wavegen_lut_populated;
+
+/******************************************************************************/
+/************************ Functions Definitions *******************************/
+/******************************************************************************/
+
+/**
+ * @brief Populate the sine table, once.
+ */
+static void wavegen_lut_populate(void)
+{
+	uint32_t i;
+
+	if (wavegen_lut_populated)
+		return;
+
+	for (i = 0; i < WAVEGEN_LUT_SIZE; i++)
+		wavegen_lut[i] = (int16_t)lround(WAVEGEN_FULL_SCALE *
+						 sin(2 * WAVEGEN_PI * i /
+						     WAVEGEN_LUT_SIZE));
+
+	wavegen_lut_populated = true;
+}
+
+/**
+ * @brief Convert a frequency to a signed phase increment.
+ * @param freq_hz - Frequency in Hz.
+ * @param sample_rate_hz - Sample rate in Hz.
+ * @return Phase increment per sample, 2^32 is a full period.
+ */
+static int64_t wavegen_freq_to_step(int32_t freq_hz, uint32_t sample_rate_hz)
+{
+	return (int64_t)freq_hz * (1LL << 32) / (int64_t)sample_rate_hz;
+}
+
+/**
+ * @brief Load the oscillators from the initialization parameters.
+ * @param desc - The generator descriptor.
+ * @param param - The initialization parameters.
+ * @return SUCCESS in case of success, negative error code otherwise.
+ */
+static int32_t wavegen_setup(struct wavegen_desc *desc,
+			     const struct wavegen_init_param *param)
+{
+	const struct wavegen_chirp *chirp = &param->chirp;
+	int64_t start, stop, rate;
+	uint8_t i;
+
+	if (!param->sample_rate_hz || param->nb_tones > WAVEGEN_MAX_TONES ||
+	    !param->resolution || param->resolution > 16)
+		return -EINVAL;
+
+	desc->sample_rate_hz = param->sample_rate_hz;
+	desc->nb_tones = param->nb_tones;
+	for (i = 0; i < param->nb_tones; i++) {
+		desc->tones[i].step = (uint32_t)wavegen_freq_to_step(
+					      param->tones[i].freq_hz,
+					      param->sample_rate_hz);
+		desc->tones[i].phase = (uint32_t)param->tones[i].phase << 16;
+		desc->tones[i].amplitude = param->tones[i].amplitude;
+	}
+
+	desc->chirp_samples = chirp->duration_samples;
+	desc->chirp_left = chirp->duration_samples;
+	if (chirp->duration_samples) {
+		start = wavegen_freq_to_step(chirp->start_hz,
+					     param->sample_rate_hz);
+		stop = wavegen_freq_to_step(chirp->stop_hz,
+					    param->sample_rate_hz);
+		rate = (stop - start) / (int64_t)chirp->duration_samples;
+		if (rate > INT32_MAX || rate < INT32_MIN)
+			return -EINVAL;
+
+		desc->chirp_start_step = (uint32_t)start;
+		desc->chirp_rate = (int32_t)rate;
+		desc->chirp.step = desc->chirp_start_step;
+		desc->chirp.phase = 0;
+		desc->chirp.amplitude = chirp->amplitude;
+	}
+
+	desc->noise_amplitude = param->noise_amplitude;
+	desc->noise_state = param->noise_seed ? param->noise_seed : 1;
+
+	desc->shift = 16 - param->resolution;
+	desc->offset = param->offset_binary ?
+		       (uint16_t)(1u << (param->resolution - 1)) : 0;
+
+	return SUCCESS;
+}
+
+/**
+ * @brief Initialize the waveform generator.
+ * @param desc - The generator descriptor.
+ * @param param - The initialization parameters.
+ * @return SUCCESS in case of success, negative error code otherwise.
+ */
+int32_t wavegen_init(struct wavegen_desc **desc,
+		     const struct wavegen_init_param *param)
+{
+	struct wavegen_desc *gen;
+	int32_t ret;
+
+	if (!desc || !param)
+		return -EINVAL;
+
+	gen = (struct wavegen_desc *)calloc(1, sizeof(*gen));
+	if (!gen)
+		return -ENOMEM;
+
+	ret = wavegen_setup(gen, param);
+	if (ret != SUCCESS) {
+		free(gen);
+		return ret;
+	}
+
+	wavegen_lut_populate();
+
+	*desc = gen;
+
+	return SUCCESS;
+}
+
+/**
+ * @brief Restart the waveform from its initial phase, optionally with new
+ * parameters.
+ * @param desc - The generator descriptor.
+ * @param param - The initialization parameters.
+ * @return SUCCESS in case of success, negative error code otherwise.
+ */
+int32_t wavegen_reset(struct wavegen_desc *desc,
+		      const struct wavegen_init_param *param)
+{
+	if (!desc || !param)
+		return -EINVAL;
+
+	return wavegen_setup(desc, param);
+}
+
+/**
+ * @brief Change a tone frequency and amplitude. The phase accumulator is not
+ * touched, so the output stays continuous.
+ * @param desc - The generator descriptor.
+ * @param index - Tone index.
+ * @param freq_hz - New frequency in Hz.
+ * @param amplitude - New amplitude, Q15.
+ * @return SUCCESS in case of success, negative error code otherwise.
+ */
+int32_t wavegen_set_tone(struct wavegen_desc *desc, uint8_t index,
+			 int32_t freq_hz, uint16_t amplitude)
+{
+	if (!desc || index >= desc->nb_tones)
+		return -EINVAL;
+
+	desc->tones[index].step = (uint32_t)wavegen_freq_to_step(freq_hz,
+				  desc->sample_rate_hz);
+	desc->tones[index].amplitude = amplitude;
+
+	return SUCCESS;
+}
+
+/**
+ * @brief Add a block of samples of one oscillator to the accumulators.
+ * @param nco - The oscillator.
+ * @param acc_i - In-phase accumulator.
+ * @param acc_q - Quadrature accumulator, NULL if not needed.
+ * @param nb_samples - Number of samples.
+ */
+static void wavegen_nco_add(struct wavegen_nco *nco, int32_t *acc_i,
+			    int32_t *acc_q, uint32_t nb_samples)
+{
+	uint32_t phase = nco->phase;
+	uint32_t step = nco->step;
+	int32_t amplitude = nco->amplitude;
+	uint32_t idx;
+	uint32_t i;
+
+	if (acc_q) {
+		for (i = 0; i < nb_samples; i++) {
+			idx = phase >> WAVEGEN_LUT_SHIFT;
+			acc_i[i] += (amplitude * wavegen_lut[(idx +
+					WAVEGEN_LUT_COS_OFF) & WAVEGEN_LUT_MASK]) >> 15;
+			acc_q[i] += (amplitude * wavegen_lut[idx]) >> 15;
+			phase += step;
+		}
+	} else {
+		for (i = 0; i < nb_samples; i++) {
+			idx = phase >> WAVEGEN_LUT_SHIFT;
+			acc_i[i] += (amplitude * wavegen_lut[(idx +
+					WAVEGEN_LUT_COS_OFF) & WAVEGEN_LUT_MASK]) >> 15;
+			phase += step;
+		}
+	}
+
+	nco->phase = phase;
+}
+
+/**
+ * @brief Add a block of the linear chirp to the accumulators.
+ * @param desc - The generator descriptor.
+ * @param acc_i - In-phase accumulator.
+ * @param acc_q - Quadrature accumulator, NULL if not needed.
+ * @param nb_samples - Number of samples.
+ */
+static void wavegen_chirp_add(struct wavegen_desc *desc, int32_t *acc_i,
+			      int32_t *acc_q, uint32_t nb_samples)
+{
+	struct wavegen_nco *nco = &desc->chirp;
+	uint32_t phase = nco->phase;
+	int32_t amplitude = nco->amplitude;
+	uint32_t idx;
+	uint32_t len;
+	uint32_t i;
+
+	while (nb_samples) {
+		len = min(nb_samples, desc->chirp_left);
+		for (i = 0; i < len; i++) {
+			idx = phase >> WAVEGEN_LUT_SHIFT;
+			acc_i[i] += (amplitude * wavegen_lut[(idx +
+					WAVEGEN_LUT_COS_OFF) & WAVEGEN_LUT_MASK]) >> 15;
+			if (acc_q)
+				acc_q[i] += (amplitude * wavegen_lut[idx]) >> 15;
+			phase += nco->step;
+			nco->step += desc->chirp_rate;
+		}
+
+		acc_i += len;
+		if (acc_q)
+			acc_q += len;
+		nb_samples -= len;
+		desc->chirp_left -= len;
+		if (!desc->chirp_left) {
+			desc->chirp_left = desc->chirp_samples;
+			nco->step = desc->chirp_start_step;
+		}
+	}
+
+	nco->phase = phase;
+}
+
+/**
+ * @brief Add a block of uniform noise to the accumulators (xorshift32).
+ * @param desc - The generator descriptor.
+ * @param acc - Accumulator.
+ * @param nb_samples - Number of samples.
+ */
+static void wavegen_noise_add(struct wavegen_desc *desc, int32_t *acc,
+			      uint32_t nb_samples)
+{
+	uint32_t x = desc->noise_state;
+	int32_t amplitude = desc->noise_amplitude;
+	uint32_t i;
+
+	for (i = 0; i < nb_samples; i++) {
+		x ^= x << 13;
+		x ^= x >> 17;
+		x ^= x << 5;
+		acc[i] += (amplitude * (int16_t)(x >> 16)) >> 15;
+	}
+
+	desc->noise_state = x;
+}
+
+/**
+ * @brief Generate a block of at most WAVEGEN_BLOCK_SIZE samples in the
+ * accumulators.
+ * @param desc - The generator descriptor.
+ * @param quadrature - Also generate the quadrature component.
+ * @param nb_samples - Number of samples.
+ */
+static void wavegen_block(struct wavegen_desc *desc, bool quadrature,
+			  uint32_t nb_samples)
+{
+	int32_t *acc_q = quadrature ? desc->acc_q : NULL;
+	uint8_t i;
+
+	memset(desc->acc_i, 0, nb_samples * sizeof(desc->acc_i[0]));
+	if (quadrature)
+		memset(desc->acc_q, 0, nb_samples * sizeof(desc->acc_q[0]));
+
+	for (i = 0; i < desc->nb_tones; i++)
+		wavegen_nco_add(&desc->tones[i], desc->acc_i, acc_q,
+				nb_samples);
+
+	if (desc->chirp_samples)
+		wavegen_chirp_add(desc, desc->acc_i, acc_q, nb_samples);
+
+	if (desc->noise_amplitude) {
+		wavegen_noise_add(desc, desc->acc_i, nb_samples);
+		if (quadrature)
+			wavegen_noise_add(desc, desc->acc_q, nb_samples);
+	}
+}
+
+/**
+ * @brief Saturate an accumulator value and convert it to the output format.
+ * @param desc - The generator descriptor.
+ * @param acc - Accumulator value, Q15.
+ * @return The DAC code.
+ */
+static inline uint16_t wavegen_to_code(struct wavegen_desc *desc, int32_t acc)
+{
+	if (acc > WAVEGEN_FULL_SCALE)
+		acc = WAVEGEN_FULL_SCALE;
+	else if (acc < -WAVEGEN_FULL_SCALE)
+		acc = -WAVEGEN_FULL_SCALE;
+
+	return (uint16_t)((acc >> desc->shift) + desc->offset);
+}
+
+/**
+ * @brief Generate I/Q samples in separate buffers.
+ * @param desc - The generator descriptor.
+ * @param data_i - In-phase samples.
+ * @param data_q - Quadrature samples, NULL for a real signal.
+ * @param nb_samples - Number of samples.
+ * @return SUCCESS in case of success, negative error code otherwise.
+ */
+int32_t wavegen_fill(struct wavegen_desc *desc, uint16_t *data_i,
+		     uint16_t *data_q, uint32_t nb_samples)
+{
+	uint32_t len;
+	uint32_t i;
+
+	if (!desc || !data_i)
+		return -EINVAL;
+
+	while (nb_samples) {
+		len = min(nb_samples, (uint32_t)WAVEGEN_BLOCK_SIZE);
+		wavegen_block(desc, data_q != NULL, len);
+
+		for (i = 0; i < len; i++)
+			data_i[i] = wavegen_to_code(desc, desc->acc_i[i]);
+		data_i += len;
+		if (data_q) {
+			for (i = 0; i < len; i++)
+				data_q[i] = wavegen_to_code(desc, desc->acc_q[i]);
+			data_q += len;
+		}
+
+		nb_samples -= len;
+	}
+
+	return SUCCESS;
+}
+
+/**
+ * @brief Generate packed I/Q words (I in the lower half, Q in the upper half),
+ * the layout expected by the AXI DAC DMA buffers.
+ * @param desc - The generator descriptor.
+ * @param buff - Output buffer of nb_samples * nb_copies words.
+ * @param nb_samples - Number of samples.
+ * @param nb_copies - Number of times each word is replicated.
+ * @return SUCCESS in case of success, negative error code otherwise.
+ */
+int32_t wavegen_fill_iq(struct wavegen_desc *desc, uint32_t *buff,
+			uint32_t nb_samples, uint8_t nb_copies)
+{
+	uint32_t word;
+	uint32_t len;
+	uint32_t i;
+	uint8_t c;
+
+	if (!desc || !buff || !nb_copies)
+		return -EINVAL;
+
+	while (nb_samples) {
+		len = min(nb_samples, (uint32_t)WAVEGEN_BLOCK_SIZE);
+		wavegen_block(desc, true, len);
+
+		if (nb_copies == 1) {
+			for (i = 0; i < len; i++)
+				buff[i] = wavegen_to_code(desc, desc->acc_i[i]) |
+					  ((uint32_t)wavegen_to_code(desc,
+							  desc->acc_q[i]) << 16);
+			buff += len;
+		} else {
+			for (i = 0; i < len; i++) {
+				word = wavegen_to_code(desc, desc->acc_i[i]) |
+				       ((uint32_t)wavegen_to_code(desc,
+						       desc->acc_q[i]) << 16);
+				for (c = 0; c < nb_copies; c++)
+					*buff++ = word;
+			}
+		}
+
+		nb_samples -= len;
+	}
+
+	return SUCCESS;
+}
+
+/**
+ * @brief Free the resources allocated by wavegen_init().
+ * @param desc - The generator descriptor.
+ * @return SUCCESS in case of success, negative error code otherwise.
+ */
+int32_t wavegen_remove(struct wavegen_desc *desc)
+{
+	if (!desc)
+		return -EINVAL;
+
+	free(desc);
+
+	return SUCCESS;
+}
+
+/**
+ * @brief Regenerate one segment of the ring.
+ * @param ring - The ring descriptor.
+ * @param segment - Segment index.
+ * @return SUCCESS in case of success, negative error code otherwise.
+ */
+static int32_t wavegen_ring_fill_segment(struct wavegen_ring *ring,
+		uint32_t segment)
+{
+	uint32_t words = ring->segment_samples * ring->nb_copies;
+	uint32_t *addr = ring->buff + segment * words;
+	int32_t ret;
+
+	ret = wavegen_fill_iq(ring->gen, addr, ring->segment_samples,
+			      ring->nb_copies);
+	if (ret != SUCCESS)
+		return ret;
+
+	if (ring->flush)
+		ring->flush(addr, words * sizeof(*addr));
+
+	return SUCCESS;
+}
+
+/**
+ * @brief Initialize a streaming ring and fill all of its segments.
+ *
+ * The ring buffer is meant to be played by a cyclic DMA. Each time the DMA
+ * is done with a segment, wavegen_ring_release() is called (e.g. from the
+ * DMA interrupt or from a timer running at the segment rate) and
+ * wavegen_ring_refill() writes the next samples of the waveform over it.
+ * @param ring - The ring descriptor.
+ * @param param - The initialization parameters.
+ * @return SUCCESS in case of success, negative error code otherwise.
+ */
+int32_t wavegen_ring_init(struct wavegen_ring **ring,
+			  const struct wavegen_ring_init_param *param)
+{
+	struct wavegen_ring *r;
+	uint32_t i;
+	int32_t ret;
+
+	if (!ring || !param || !param->gen || !param->buff ||
+	    param->nb_segments < 2 || !param->segment_samples ||
+	    !param->nb_copies)
+		return -EINVAL;
+
+	r = (struct wavegen_ring *)calloc(1, sizeof(*r));
+	if (!r)
+		return -ENOMEM;
+
+	r->gen = param->gen;
+	r->buff = param->buff;
+	r->nb_segments = param->nb_segments;
+	r->segment_samples = param->segment_samples;
+	r->nb_copies = param->nb_copies;
+	r->flush = param->flush;
+
+	for (i = 0; i < r->nb_segments; i++) {
+		ret = wavegen_ring_fill_segment(r, i);
+		if (ret != SUCCESS) {
+			free(r);
+			return ret;
+		}
+	}
+
+	*ring = r;
+
+	return SUCCESS;
+}
+
+/**
+ * @brief Mark segments as consumed by the DMA. Safe to call from interrupts.
+ * @param ring - The ring descriptor.
+ * @param nb_segments - Number of consumed segments.
+ */
+void wavegen_ring_release(struct wavegen_ring *ring, uint32_t nb_segments)
+{
+	ring->released += nb_segments;
+}
+
+/**
+ * @brief Regenerate the segments consumed by the DMA, in order.
+ *
+ * If the DMA lapped the generator, the stale segments are dropped and the
+ * refill restarts right after the segment being played.
+ * @param ring - The ring descriptor.
+ * @return Number of regenerated segments, negative error code otherwise.
+ */
+int32_t wavegen_ring_refill(struct wavegen_ring *ring)
+{
+	uint32_t released;
+	int32_t count = 0;
+	int32_t ret;
+
+	if (!ring)
+		return -EINVAL;
+
+	released = ring->released;
+	if (released - ring->refilled >= ring->nb_segments) {
+		ring->underruns++;
+		ring->refilled = released - (ring->nb_segments - 1);
+		ring->next = (released + 1) % ring->nb_segments;
+	}
+
+	while (ring->refilled != released) {
+		ret = wavegen_ring_fill_segment(ring, ring->next);
+		if (ret != SUCCESS)
+			return ret;
+
+		ring->next = (ring->next + 1) % ring->nb_segments;
+		ring->refilled++;
+		count++;
+	}
+
+	return count;
+}
+
+/**
+ * @brief Free the resources allocated by wavegen_ring_init(). The ring
+ * buffer and the generator belong to the caller.
+ * @param ring - The ring descriptor.
+ * @return SUCCESS in case of success, negative error code otherwise.
+ */
+int32_t wavegen_ring_remove(struct wavegen_ring *ring)
+{
+	if (!ring)
+		return -EINVAL;
+
+	free(ring);
+
+	return SUCCESS;
+}